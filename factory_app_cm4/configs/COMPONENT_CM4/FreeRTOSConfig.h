@@ -100,6 +100,8 @@
 #define configUSE_16_BIT_TICKS                  0
 #define configIDLE_SHOULD_YIELD                 1
 #define configUSE_TASK_NOTIFICATIONS            1
+/* Index 1 is reserved for the completion of flash service requests */
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES   2
 #define configUSE_MUTEXES                       1
 #define configUSE_RECURSIVE_MUTEXES             1
 #define configUSE_COUNTING_SEMAPHORES           1
@@ -123,7 +125,45 @@
 #define configUSE_DAEMON_TASK_STARTUP_HOOK      0
 
 /* Run time and task stats gathering related definitions. */
+#ifdef RTOS_MONITOR_ENABLE
+/* Task run times in us from the CPU cycle counter, and a context switch
+ * count, for the RTOS monitor of the factory app (see rtos_monitor.c) */
+extern void rtos_monitor_timer_init(void);
+extern uint32_t rtos_monitor_run_time(void);
+extern volatile uint32_t rtos_monitor_switches;
+#define configGENERATE_RUN_TIME_STATS           1
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() rtos_monitor_timer_init()
+#define portGET_RUN_TIME_COUNTER_VALUE()        rtos_monitor_run_time()
+#define RTOS_MONITOR_SWITCHED_IN()              rtos_monitor_switches++
+#else
 #define configGENERATE_RUN_TIME_STATS           0
+#define RTOS_MONITOR_SWITCHED_IN()
+#endif
+
+#ifdef EVENT_TRACE_ENABLE
+/* Kernel events for the event trace of the factory app (see event_trace.c).
+ * The numbers are event_trace_type_t values. traceTASK_SWITCHED_IN() is only
+ * expanded in tasks.c, where pxCurrentTCB is visible. The ISR hooks are
+ * called by ports that provide them, the FROM_ISR hooks by any interrupt that
+ * wakes a task, e.g. the SDIO interrupt of the Wi-Fi driver. */
+extern void event_trace_task_switch(uint32_t task_number);
+extern void event_trace_isr(uint32_t type);
+extern void event_trace_tick(void);
+#define EVENT_TRACE_SWITCHED_IN()               event_trace_task_switch(pxCurrentTCB->uxTCBNumber)
+#define traceTASK_INCREMENT_TICK(xTickCount)    event_trace_tick()
+#define traceISR_ENTER()                        event_trace_isr(1u)
+#define traceISR_EXIT()                         event_trace_isr(2u)
+#define traceISR_EXIT_TO_SCHEDULER()            event_trace_isr(2u)
+#define traceQUEUE_SEND_FROM_ISR(pxQueue)       event_trace_isr(3u)
+#define traceTASK_NOTIFY_FROM_ISR(...)          event_trace_isr(3u)
+#define traceTASK_NOTIFY_GIVE_FROM_ISR(...)     event_trace_isr(3u)
+#else
+#define EVENT_TRACE_SWITCHED_IN()
+#endif
+
+#if defined(RTOS_MONITOR_ENABLE) || defined(EVENT_TRACE_ENABLE)
+#define traceTASK_SWITCHED_IN()                 do { RTOS_MONITOR_SWITCHED_IN(); EVENT_TRACE_SWITCHED_IN(); } while (0)
+#endif
 #define configUSE_TRACE_FACILITY                1
 #define configUSE_STATS_FORMATTING_FUNCTIONS    0
 
@@ -0,0 +1,63 @@
+/******************************************************************************
+* File Name:   cy_ota_flash.h
+*
+* Description: Host replacement of the OTA library flash driver interface. Only
+*              used for host builds with OTA_FLASH_BACKEND_SIM.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef CY_OTA_FLASH_HOST_FLASH_H_
+#define CY_OTA_FLASH_HOST_FLASH_H_
+
+#include "cy_pdl.h"
+
+typedef enum
+{
+    CY_OTA_MEM_TYPE_INTERNAL_FLASH = 0,
+    CY_OTA_MEM_TYPE_EXTERNAL_FLASH,
+    CY_OTA_MEM_TYPE_NONE
+} cy_ota_mem_type_t;
+
+cy_rslt_t cy_ota_mem_init( void );
+cy_rslt_t cy_ota_mem_read( cy_ota_mem_type_t mem_type, uint32_t addr, void *data, size_t len );
+cy_rslt_t cy_ota_mem_write( cy_ota_mem_type_t mem_type, uint32_t addr, void *data, size_t len );
+cy_rslt_t cy_ota_mem_erase( cy_ota_mem_type_t mem_type, uint32_t addr, size_t len );
+size_t cy_ota_mem_get_prog_size ( cy_ota_mem_type_t mem_type, uint32_t addr );
+size_t cy_ota_mem_get_erase_size ( cy_ota_mem_type_t mem_type, uint32_t addr );
+
+#endif /* CY_OTA_FLASH_HOST_FLASH_H_ */
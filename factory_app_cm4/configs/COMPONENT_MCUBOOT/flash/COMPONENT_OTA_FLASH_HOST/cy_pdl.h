@@ -0,0 +1,81 @@
+/******************************************************************************
+* File Name:   cy_pdl.h
+*
+* Description: Minimal host replacement of the PDL definitions used by the flash
+*              driver. Only used for host builds with OTA_FLASH_BACKEND_SIM.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef CY_OTA_FLASH_HOST_PDL_H_
+#define CY_OTA_FLASH_HOST_PDL_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <assert.h>
+
+typedef uint32_t cy_rslt_t;
+
+#define CY_RSLT_SUCCESS                             ((cy_rslt_t)0x00000000u)
+#define CY_RSLT_TYPE_ERROR                          (2u)
+
+#define CY_ALIGN(align)                             __attribute__((aligned(align)))
+#define CY_ASSERT(x)                                assert(x)
+#define CY_MIN(a, b)                                (((a) < (b)) ? (a) : (b))
+#define __STATIC_FORCEINLINE                        static inline __attribute__((always_inline))
+
+/* Memory map of the simulated device, matches PSoC 6 */
+#define CY_FLASH_BASE                               (0x10000000u)
+#define CY_FLASH_SIZE                               (0x00200000u)
+#define CY_FLASH_SIZEOF_ROW                         (512u)
+#define CY_XIP_BASE                                 (0x18000000u)
+
+/* Cycle counter frequency used by the flash statistics */
+#define SystemCoreClock                             (100000000u)
+
+static inline uint32_t Cy_SysLib_EnterCriticalSection(void)
+{
+    return 0u;
+}
+
+static inline void Cy_SysLib_ExitCriticalSection(uint32_t savedIntrStatus)
+{
+    (void)savedIntrStatus;
+}
+
+#endif /* CY_OTA_FLASH_HOST_PDL_H_ */
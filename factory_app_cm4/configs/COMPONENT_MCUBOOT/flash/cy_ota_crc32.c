@@ -0,0 +1,75 @@
+/******************************************************************************
+* File Name:   cy_ota_crc32.c
+*
+* Description: This file contains a table-driven CRC32 implementation with a small
+*              (64 byte) nibble table, to keep flash and RAM usage low
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/* Header file includes */
+#include "cy_ota_crc32.h"
+
+/**********************************************************************************************************************************
+ * local variables & data
+ **********************************************************************************************************************************/
+/* CRC-32 of every 4-bit value, reflected polynomial 0xEDB88320 */
+static const uint32_t crc32_nibble_table[16] =
+{
+    0x00000000lu, 0x1DB71064lu, 0x3B6E20C8lu, 0x26D930AClu,
+    0x76DC4190lu, 0x6B6B51F4lu, 0x4DB26158lu, 0x5005713Clu,
+    0xEDB88320lu, 0xF00F9344lu, 0xD6D6A3E8lu, 0xCB61B38Clu,
+    0x9B64C2B0lu, 0x86D3D2D4lu, 0xA00AE278lu, 0xBDBDF21Clu
+};
+
+/**********************************************************************************************************************************
+ * External Functions
+ **********************************************************************************************************************************/
+uint32_t cy_ota_crc32(uint32_t crc, const void *data, size_t len)
+{
+    const uint8_t *buf = (const uint8_t *)data;
+
+    crc = ~crc;
+    while (len-- > 0u)
+    {
+        crc ^= *buf++;
+        crc = (crc >> 4) ^ crc32_nibble_table[crc & 0x0Fu];
+        crc = (crc >> 4) ^ crc32_nibble_table[crc & 0x0Fu];
+    }
+
+    return ~crc;
+}
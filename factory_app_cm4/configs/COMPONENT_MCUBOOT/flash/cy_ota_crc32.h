@@ -0,0 +1,67 @@
+/******************************************************************************
+* File Name:   cy_ota_crc32.h
+*
+* Description: This file contains the declaration of the CRC32 helper used by the
+*              OTA flash driver and the OTA application
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef CY_OTA_CRC32_H_
+#define CY_OTA_CRC32_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Initial value to pass to cy_ota_crc32() for a new computation */
+#define CY_OTA_CRC32_INIT                           (0x00000000lu)
+
+/**
+ * @brief Update a CRC-32 (IEEE 802.3, reflected, polynomial 0x04C11DB7)
+ *
+ * The result is compatible with zlib's crc32(), so it can be checked with
+ * Python's binascii.crc32() on the host.
+ *
+ * @param[in]   crc     CY_OTA_CRC32_INIT or the value returned by a previous call.
+ * @param[in]   data    Data to process.
+ * @param[in]   len     Number of bytes to process.
+ *
+ * @return  Updated CRC value.
+ */
+uint32_t cy_ota_crc32(uint32_t crc, const void *data, size_t len);
+
+#endif /* CY_OTA_CRC32_H_ */
@@ -45,11 +45,27 @@
 #include <string.h>
 #include <assert.h>
 #include "cy_pdl.h"
+#ifndef OTA_FLASH_BACKEND_SIM
 #include "cyhal.h"
 #include "cybsp.h"
+#endif
 #include "cy_ota_flash.h"
+#include "cy_ota_flash_pool.h"
+#include "cy_ota_flash_lock.h"
+#include "cy_ota_flash_stats.h"
+#ifdef OTA_FLASH_VERIFY_ENABLE
+#include "cy_ota_flash_verify.h"
+#endif
+#ifdef OTA_FLASH_BACKEND_SIM
+#include "cy_ota_flash_sim.h"
+#endif
+
+/* FreeRTOS */
+#include <FreeRTOS.h>
+#include <task.h>
+#include <semphr.h>
 
-#if !(defined (CYW20829B0LKML) || defined (CYW89829B01MKSBG))
+#if !(defined (CYW20829B0LKML) || defined (CYW89829B01MKSBG)) && !defined (OTA_FLASH_BACKEND_SIM)
 #include <cycfg_pins.h>
 #endif
 
@@ -82,7 +98,85 @@
 #define DCACHE_BYTE_ALIGNEMNT       (__SCB_DCACHE_LINE_SIZE)
 #endif
 
-#if (defined (CY_IP_MXSMIF) && !defined (XMC7100) && !defined (XMC7200))
+/* Each pool buffer holds one flash row, rounded up to the pool alignment */
+#define OTA_FLASH_BUF_POOL_SIZE     ((CY_FLASH_SIZEOF_ROW + (OTA_FLASH_BUF_POOL_ALIGN - 1u)) & ~(OTA_FLASH_BUF_POOL_ALIGN - 1u))
+
+/* Most whole rows ota_mem_write() programs straight from the caller's buffer
+ * with one backend call. The read-back check records each call as one entry,
+ * so this must not exceed OTA_FLASH_VERIFY_READ_SIZE. */
+#ifndef OTA_FLASH_PROG_RUN_MAX
+#define OTA_FLASH_PROG_RUN_MAX      (4096u)
+#endif
+
+#if (OTA_FLASH_PROG_RUN_MAX < CY_FLASH_SIZEOF_ROW) || ((OTA_FLASH_PROG_RUN_MAX % CY_FLASH_SIZEOF_ROW) != 0u)
+#error "OTA_FLASH_PROG_RUN_MAX must be a multiple of the flash row size"
+#endif
+
+#if defined(OTA_FLASH_VERIFY_ENABLE) && (OTA_FLASH_PROG_RUN_MAX > OTA_FLASH_VERIFY_READ_SIZE)
+#error "OTA_FLASH_PROG_RUN_MAX must not exceed OTA_FLASH_VERIFY_READ_SIZE"
+#endif
+
+#if (OTA_FLASH_BUF_POOL_COUNT < 2u) || (OTA_FLASH_BUF_POOL_COUNT > 32u)
+#error "OTA_FLASH_BUF_POOL_COUNT must be in the range 2 to 32"
+#endif
+
+#if defined(DCACHE_BYTE_ALIGNEMNT) && (OTA_FLASH_BUF_POOL_ALIGN < DCACHE_BYTE_ALIGNEMNT)
+#error "OTA_FLASH_BUF_POOL_ALIGN must not be smaller than the data cache line size"
+#endif
+
+/*
+ * Flash backend table, resolved at compile time
+ *
+ *  Platform                        Internal flash      External flash
+ *  ------------------------------  ------------------  ------------------
+ *  PSoC 6                          PSOC6               SMIF
+ *  XMC7100 / XMC7200               XMC                 NONE
+ *  CYW20829 / CYW89829             NONE                SMIF
+ *  OTA_FLASH_BACKEND_SIM (host)    SIM                 SIM
+ *
+ * Each backend implements the same static functions: ota_int_*() for the
+ * internal and ota_ext_*() for the external flash. The cy_ota_mem_*() entry
+ * points branch once on mem_type and call them directly, so the selected
+ * backend is inlined into the entry point without any further dispatch.
+ */
+#if defined (OTA_FLASH_BACKEND_SIM)
+#define OTA_FLASH_INT_BACKEND_SIM
+#define OTA_FLASH_EXT_BACKEND_SIM
+#else
+#if defined (XMC7100) || defined (XMC7200)
+#define OTA_FLASH_INT_BACKEND_XMC
+#elif defined (CYW20829B0LKML) || defined (CYW89829B01MKSBG)
+#define OTA_FLASH_INT_BACKEND_NONE
+#else
+#define OTA_FLASH_INT_BACKEND_PSOC6
+#endif
+
+#if defined (CY_IP_MXSMIF) && !defined (XMC7100) && !defined (XMC7200)
+#define OTA_FLASH_EXT_BACKEND_SMIF
+#else
+#define OTA_FLASH_EXT_BACKEND_NONE
+#endif
+#endif /* OTA_FLASH_BACKEND_SIM */
+
+#if defined (OTA_FLASH_BACKEND_SIM) && defined (ENABLE_ON_THE_FLY_ENCRYPTION)
+#error "The simulated flash backend does not support on-the-fly encryption"
+#endif
+
+/*
+ * Internal flash program and erase sizes are fixed by the device. External
+ * flash sizes are read from the SMIF memory configuration once at init. For
+ * a fixed part with uniform sectors, define OTA_FLASH_EXT_PROG_SIZE and
+ * OTA_FLASH_EXT_ERASE_SIZE to make them compile-time constants as well.
+ */
+#if defined (OTA_FLASH_INT_BACKEND_NONE)
+#define OTA_FLASH_INT_PROG_SIZE                     (0u)
+#define OTA_FLASH_INT_ERASE_SIZE                    (0u)
+#else
+#define OTA_FLASH_INT_PROG_SIZE                     (CY_FLASH_SIZEOF_ROW)
+#define OTA_FLASH_INT_ERASE_SIZE                    (CY_FLASH_SIZEOF_ROW)
+#endif
+
+#ifdef OTA_FLASH_EXT_BACKEND_SMIF
 /* UN-comment to test the write functionality */
 //#define READBACK_SMIF_WRITE_TEST
 
@@ -119,13 +213,15 @@
 #define PRE_SMIF_ACCESS_TURN_OFF_XIP \
                     uint32_t interruptState;                            \
                     interruptState = Cy_SysLib_EnterCriticalSection();  \
+                    OTA_FLASH_STATS_START(cs_start);                    \
                     while(Cy_SMIF_BusyCheck(SMIF0));    \
                     (void)Cy_SMIF_SetMode(SMIF0, CY_SMIF_NORMAL);
 
 #define POST_SMIF_ACCESS_TURN_ON_XIP \
                     while(Cy_SMIF_BusyCheck(SMIF0));    \
                     (void)Cy_SMIF_SetMode(SMIF0, CY_SMIF_MEMORY);   \
-                    Cy_SysLib_ExitCriticalSection(interruptState);
+                    Cy_SysLib_ExitCriticalSection(interruptState);      \
+                    OTA_FLASH_STATS_CS(cs_start);
 
 
 #else
@@ -162,47 +258,120 @@ extern const cy_stc_smif_block_config_t smifBlockConfig;
 /* Used for testing the write functionality */
 static uint8_t read_back_test[1024];
 #endif
-#endif /* CY_IP_MXSMIF & !XMC7100 & !XMC7200 */
 
-#ifdef ENABLE_ON_THE_FLY_ENCRYPTION
+/* External flash geometry, cached from the memory configuration at init */
+static uint32_t ota_ext_mem_size;
+#ifndef OTA_FLASH_EXT_PROG_SIZE
+static uint32_t ota_ext_prog_size_cached;
+#endif
+#ifndef OTA_FLASH_EXT_ERASE_SIZE
+static uint32_t ota_ext_erase_size_cached;
+static bool     ota_ext_hybrid;
+#endif
+#endif /* OTA_FLASH_EXT_BACKEND_SMIF */
+
 /**
- * @brief Local buffer for data flash write
+ * @brief Preallocated, aligned row buffers for the write path. They replace the
+ * per-write heap allocations so no heap is used while an image is downloaded.
  */
-uint8_t *write_buffer = NULL;
-#endif
+CY_ALIGN(OTA_FLASH_BUF_POOL_ALIGN) static uint8_t ota_flash_buf_pool[OTA_FLASH_BUF_POOL_COUNT][OTA_FLASH_BUF_POOL_SIZE];
+
+/* Bit n set - ota_flash_buf_pool[n] is in use */
+static uint32_t ota_flash_buf_pool_used;
+
+static cy_ota_flash_pool_stats_t ota_flash_buf_pool_stats;
+
+/* Serializes internal and external flash access between tasks */
+static SemaphoreHandle_t ota_mem_mutex = NULL;
+static StaticSemaphore_t ota_mem_mutex_buffer;
 
 /**********************************************************************************************************************************
  * Internal Functions
  **********************************************************************************************************************************/
-#ifdef ENABLE_ON_THE_FLY_ENCRYPTION
-static bool ota_allocate_write_buffer(uint64_t size)
+/*******************************************************************************
+* Function Name: ota_flash_buf_alloc
+****************************************************************************//**
+*
+* Takes a buffer from the preallocated pool. Never blocks and never uses the heap.
+*
+* \param size
+* Number of bytes needed, must not exceed one flash row.
+*
+* \return Pointer to a buffer aligned to OTA_FLASH_BUF_POOL_ALIGN, or NULL if
+* the pool is exhausted or the size is too large.
+*
+*******************************************************************************/
+static uint8_t *ota_flash_buf_alloc(size_t size)
 {
-    if(write_buffer != NULL)
+    uint8_t *buf = NULL;
+    uint32_t idx;
+    uint32_t intr_status;
+
+    intr_status = Cy_SysLib_EnterCriticalSection();
+
+    if (size <= OTA_FLASH_BUF_POOL_SIZE)
     {
-        free(write_buffer);
-        write_buffer = NULL;
+        for (idx = 0u; idx < OTA_FLASH_BUF_POOL_COUNT; idx++)
+        {
+            if ((ota_flash_buf_pool_used & (1lu << idx)) == 0u)
+            {
+                ota_flash_buf_pool_used |= (1lu << idx);
+                buf = &ota_flash_buf_pool[idx][0];
+                break;
+            }
+        }
     }
 
-    write_buffer = (uint8_t *)malloc(size);
-    if(write_buffer == NULL)
+    if (buf != NULL)
     {
-        return false;
+        ota_flash_buf_pool_stats.allocs++;
+        ota_flash_buf_pool_stats.in_use++;
+        if (ota_flash_buf_pool_stats.in_use > ota_flash_buf_pool_stats.peak_in_use)
+        {
+            ota_flash_buf_pool_stats.peak_in_use = ota_flash_buf_pool_stats.in_use;
+        }
     }
     else
     {
-        return true;
+        ota_flash_buf_pool_stats.failures++;
     }
+
+    Cy_SysLib_ExitCriticalSection(intr_status);
+
+    return buf;
 }
 
-static void ota_free_write_buffer(void)
+/*******************************************************************************
+* Function Name: ota_flash_buf_free
+****************************************************************************//**
+*
+* Returns a buffer taken with ota_flash_buf_alloc() to the pool.
+*
+* \param buf
+* Buffer to release. NULL is ignored.
+*
+*******************************************************************************/
+static void ota_flash_buf_free(uint8_t *buf)
 {
-    if(write_buffer != NULL)
+    uint32_t idx;
+    uint32_t intr_status;
+
+    if (buf == NULL)
     {
-        free(write_buffer);
-        write_buffer = NULL;
+        return;
     }
+
+    idx = (uint32_t)(buf - &ota_flash_buf_pool[0][0]) / OTA_FLASH_BUF_POOL_SIZE;
+    CY_ASSERT(idx < OTA_FLASH_BUF_POOL_COUNT);
+
+    intr_status = Cy_SysLib_EnterCriticalSection();
+    ota_flash_buf_pool_used &= ~(1lu << idx);
+    ota_flash_buf_pool_stats.frees++;
+    ota_flash_buf_pool_stats.in_use--;
+    Cy_SysLib_ExitCriticalSection(intr_status);
 }
 
+#ifdef ENABLE_ON_THE_FLY_ENCRYPTION
 static uint32_t cy_flash_addr_to_cbus_addr(uint32_t secondary_addr)
 {
     uint32_t cbus_addr = 0;
@@ -211,7 +380,7 @@ static uint32_t cy_flash_addr_to_cbus_addr(uint32_t secondary_addr)
 }
 #endif
 
-#if defined(CY_IP_MXSMIF) && !defined(PSOC_062_1M) && !defined(XMC7100) && !defined(XMC7200)
+#if defined (OTA_FLASH_EXT_BACKEND_SMIF) && !defined(PSOC_062_1M)
 #if defined(OTA_USE_EXTERNAL_FLASH)
 /*******************************************************************************
 * Function Name: IsMemoryReady
@@ -314,9 +483,12 @@ static cy_en_smif_status_t EnableQuadMode(cy_stc_smif_mem_config_t const *memCon
     return status;
 }
 #endif /* OTA_USE_EXTERNAL_FLASH */
-#endif /* CY_IP_MXSMIF & !PSOC_062_1M & !XMC7100 & !XMC7200 */
+#endif /* OTA_FLASH_EXT_BACKEND_SMIF & !PSOC_062_1M */
 
-#if !(defined (CYW20829B0LKML) || defined (CYW89829B01MKSBG) || defined (XMC7100) || defined (XMC7200))
+/**********************************************************************************************************************************
+ * Internal flash backend: PSoC 6
+ **********************************************************************************************************************************/
+#ifdef OTA_FLASH_INT_BACKEND_PSOC6
 static int psoc6_internal_flash_write(uint8_t data[], uint32_t address, size_t len)
 {
     int retCode;
@@ -481,9 +653,33 @@ static int psoc6_internal_flash_erase(uint32_t addr, size_t size)
     }
     return rc;
 }
-#endif
 
-#if defined (XMC7100) || defined (XMC7200)
+static inline cy_rslt_t ota_int_program( uint32_t addr, void *data, size_t len )
+{
+    /* flash_area_write() uses offsets, we need absolute address here */
+    addr += CY_FLASH_BASE;
+
+    if (psoc6_internal_flash_write((uint8_t *)data, addr, len) != 0)
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+    return CY_RSLT_SUCCESS;
+}
+
+static inline cy_rslt_t ota_int_erase( uint32_t addr, size_t len )
+{
+    if (psoc6_internal_flash_erase(addr, len) != 0)
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+    return CY_RSLT_SUCCESS;
+}
+#endif /* OTA_FLASH_INT_BACKEND_PSOC6 */
+
+/**********************************************************************************************************************************
+ * Internal flash backend: XMC7100 / XMC7200
+ **********************************************************************************************************************************/
+#ifdef OTA_FLASH_INT_BACKEND_XMC
 CY_SECTION_RAMFUNC_BEGIN
 static int xmc_internal_flash_erase(uint32_t addr, size_t size)
 {
@@ -543,16 +739,16 @@ static int xmc_internal_flash_write(uint8_t data[], uint32_t address, size_t len
     bool cond1;
 
 #if !defined (CY_DISABLE_XMC7000_DATA_CACHE) && defined (__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
-    uint8_t *local_buffer = 0, *aligned_local_buffer = 0;
+    uint8_t *local_buffer = 0;
     bool iscacheable = false;
 
-    local_buffer = (uint8_t *)malloc((CY_FLASH_SIZEOF_ROW) + (2 * DCACHE_BYTE_ALIGNEMNT));
+    /* Pool buffers are already aligned to the cache line size */
+    local_buffer = ota_flash_buf_alloc(CY_FLASH_SIZEOF_ROW);
     if(NULL == local_buffer)
     {
         return -1;
     }
-    aligned_local_buffer = (uint8_t*)((size_t)local_buffer + ((size_t)32 - ((size_t)local_buffer & 0x1F)));
-    writeBufferPointer = aligned_local_buffer;
+    writeBufferPointer = local_buffer;
     iscacheable = true;
 #else
     uint32_t writeBuffer[CY_FLASH_SIZEOF_ROW / sizeof(uint32_t)];
@@ -595,8 +791,10 @@ static int xmc_internal_flash_write(uint8_t data[], uint32_t address, size_t len
             {
                 int intr_status = 0;
                 intr_status = Cy_SysLib_EnterCriticalSection();
+                OTA_FLASH_STATS_START(cs_start);
                 rc = Cy_Flash_ProgramRow((rowId * CY_FLASH_SIZEOF_ROW) + CY_FLASH_BASE, (uint32_t*)writeBufferPointer);
                 Cy_SysLib_ExitCriticalSection(intr_status);
+                OTA_FLASH_STATS_CS(cs_start);
                 if(rc != CY_FLASH_DRV_SUCCESS)
                 {
                     break;
@@ -632,43 +830,93 @@ static int xmc_internal_flash_write(uint8_t data[], uint32_t address, size_t len
 #if !defined (CY_DISABLE_XMC7000_DATA_CACHE) && defined (__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1U)
     if(iscacheable == true)
     {
-        free(local_buffer);
+        ota_flash_buf_free(local_buffer);
     }
 #endif
 
     return(retCode);
 }
 CY_SECTION_RAMFUNC_END
-#endif /* XMC7100/XMC7200 */
 
-#if (defined (CY_IP_MXSMIF) && !defined (XMC7100) && !defined (XMC7200))
-static uint32_t ota_smif_get_memory_size(void)
+static inline cy_rslt_t ota_int_program( uint32_t addr, void *data, size_t len )
 {
-    uint32_t size = 0;
+    int rc = 0;
+
+    /* flash_area_write() uses offsets, we need absolute address here */
+    addr += CY_FLASH_BASE;
+
+    rc = xmc_internal_flash_write((uint8_t *)data, addr, len);
+    if (rc != 0 )
+    {
+        printf("xmc_internal_flash_write(0x%08x, 0x%08x, %u) FAILED rc:%u\n", (unsigned int)data, (unsigned int)addr, len, rc);
+        return CY_RSLT_TYPE_ERROR;
+    }
+    return CY_RSLT_SUCCESS;
+}
 
-    if (SMIF0 != NULL)
+static inline cy_rslt_t ota_int_erase( uint32_t addr, size_t len )
+{
+    int rc = 0;
+    int intr_status = 0;
+
+    intr_status = Cy_SysLib_EnterCriticalSection();
+    OTA_FLASH_STATS_START(cs_start);
+    rc = xmc_internal_flash_erase(addr, len);
+    Cy_SysLib_ExitCriticalSection(intr_status);
+    OTA_FLASH_STATS_CS(cs_start);
+    if (rc != 0 )
     {
-        size = smifBlockConfig.memConfig[MEM_SLOT]->deviceCfg->memSize;
+        printf("xmc_internal_flash_erase(0x%08x, %u) FAILED rc:%d\n", (unsigned int)addr, len, rc);
+        return CY_RSLT_TYPE_ERROR;
     }
+    return CY_RSLT_SUCCESS;
+}
+#endif /* OTA_FLASH_INT_BACKEND_XMC */
+
+#if defined (OTA_FLASH_INT_BACKEND_PSOC6) || defined (OTA_FLASH_INT_BACKEND_XMC)
+static inline cy_rslt_t ota_int_read( uint32_t addr, void *data, size_t len )
+{
+    /* flash_area_read() uses offsets, we need absolute address here */
+    addr += CY_FLASH_BASE;
+
+    /* flash read by simple memory copying */
+    memcpy((void *)data, (const void*)addr, (size_t)len);
+    return CY_RSLT_SUCCESS;
+}
+#endif /* OTA_FLASH_INT_BACKEND_PSOC6 | OTA_FLASH_INT_BACKEND_XMC */
+
+#ifdef OTA_FLASH_INT_BACKEND_NONE
+/* No internal flash access from the application on this device */
+static inline cy_rslt_t ota_int_read( uint32_t addr, void *data, size_t len )
+{
+    (void)addr; (void)data; (void)len;
+    printf("%s() READ not supported for memory type %d\n", __func__, (int)CY_OTA_MEM_TYPE_INTERNAL_FLASH);
+    return CY_RSLT_TYPE_ERROR;
+}
+
+static inline cy_rslt_t ota_int_program( uint32_t addr, void *data, size_t len )
+{
+    (void)addr; (void)data; (void)len;
+    printf("%s() Write not supported for memory type %d\n", __func__, (int)CY_OTA_MEM_TYPE_INTERNAL_FLASH);
+    return CY_RSLT_TYPE_ERROR;
+}
 
-    return size;
+static inline cy_rslt_t ota_int_erase( uint32_t addr, size_t len )
+{
+    (void)addr; (void)len;
+    printf("%s() Erase not supported for memory type %d\n", __func__, (int)CY_OTA_MEM_TYPE_INTERNAL_FLASH);
+    return CY_RSLT_TYPE_ERROR;
 }
-#endif /* CY_IP_MXSMIF & !XMC7100 & !XMC7200 */
+#endif /* OTA_FLASH_INT_BACKEND_NONE */
 
 /**********************************************************************************************************************************
- * External Functions
+ * External flash backend: SMIF
  **********************************************************************************************************************************/
-/**
- * @brief Initializes flash, QSPI flash, or any other external memory type
- *
- * @return  CY_RSLT_SUCCESS on success
- *          CY_RSLT_TYPE_ERROR on failure
- */
-cy_rslt_t cy_ota_mem_init( void )
+#ifdef OTA_FLASH_EXT_BACKEND_SMIF
+static cy_rslt_t ota_ext_init( void )
 {
     cy_rslt_t result = CY_RSLT_SUCCESS;
 
-#if (defined (CY_IP_MXSMIF) && !defined (XMC7100) && !defined (XMC7200))
 #if defined(OTA_USE_EXTERNAL_FLASH)
     cy_rslt_t smif_status = CY_SMIF_BAD_PARAM;    /* Does not return error if SMIF Quad fails */
     bool QE_status = false;
@@ -767,247 +1015,510 @@ cy_rslt_t cy_ota_mem_init( void )
     /* post-access to SMIF */
     POST_SMIF_ACCESS_TURN_ON_XIP;
 #endif
+
+    if (IS_FLAG_SET(FLAG_HAL_INIT_DONE))
+    {
+        /* The geometry is in RAM tables, cache it so the data path does not walk them */
+        const cy_stc_smif_mem_device_cfg_t *dev_cfg = smifBlockConfig.memConfig[MEM_SLOT]->deviceCfg;
+
+        ota_ext_mem_size = dev_cfg->memSize;
+#ifndef OTA_FLASH_EXT_PROG_SIZE
+        ota_ext_prog_size_cached = dev_cfg->programSize;
+#endif
+#ifndef OTA_FLASH_EXT_ERASE_SIZE
+        ota_ext_erase_size_cached = dev_cfg->eraseSize;
+        ota_ext_hybrid = (dev_cfg->hybridRegionCount != 0u);
 #endif
-#endif /* CY_IP_MXSMIF & !XMC7100 & !XMC7200 */
+    }
+#endif /* OTA_USE_EXTERNAL_FLASH */
     return result;
 }
 
-/**
- * @brief Read from flash, QSPI flash, or any other external memory type
- *
- * @param[in]   mem_type   Memory type @ref cy_ota_mem_type_t
- * @param[in]   addr       Starting address to read from.
- * @param[out]  data       Pointer to the buffer to store the data read from the memory.
- * @param[in]   len        Number of data bytes to read.
- *
- * @return  CY_RSLT_SUCCESS on success
- *          CY_RSLT_TYPE_ERROR on failure
- */
-cy_rslt_t cy_ota_mem_read( cy_ota_mem_type_t mem_type, uint32_t addr, void *data, size_t len )
+static inline uint32_t ota_ext_prog_size( uint32_t addr )
 {
-    cy_rslt_t result = CY_RSLT_SUCCESS;
-
-    if( mem_type == CY_OTA_MEM_TYPE_INTERNAL_FLASH )
-    {
-#if !(defined (CYW20829B0LKML) || defined (CYW89829B01MKSBG))
-        /* flash_area_read() uses offsets, we need absolute address here */
-        addr += CY_FLASH_BASE;
-
-        /* flash read by simple memory copying */
-        memcpy((void *)data, (const void*)addr, (size_t)len);
-        return result;
+    (void)addr; /* Hybrid parts not yet supported */
+#ifdef OTA_FLASH_EXT_PROG_SIZE
+    return IS_FLAG_SET(FLAG_HAL_INIT_DONE) ? OTA_FLASH_EXT_PROG_SIZE : 0u;
 #else
-        (void)result;
-        printf("%s() READ not supported for memory type %d\n", __func__, (int)mem_type);
-        return CY_RSLT_TYPE_ERROR;
+    return ota_ext_prog_size_cached;
 #endif
-    }
-    else if( mem_type == CY_OTA_MEM_TYPE_EXTERNAL_FLASH )
+}
+
+static inline uint32_t ota_ext_erase_size( uint32_t addr )
+{
+#ifdef OTA_FLASH_EXT_ERASE_SIZE
+    (void)addr;
+    return IS_FLAG_SET(FLAG_HAL_INIT_DONE) ? OTA_FLASH_EXT_ERASE_SIZE : 0u;
+#else
+    cy_stc_smif_hybrid_region_info_t*   hybrid_info = NULL;
+
+    if (ota_ext_hybrid)
     {
-#if (defined (CY_IP_MXSMIF) && !defined (XMC7100) && !defined (XMC7200))
-        cy_en_smif_status_t cy_smif_result = CY_SMIF_SUCCESS;
         if (addr >= CY_SMIF_BASE_MEM_OFFSET)
         {
             addr -= CY_SMIF_BASE_MEM_OFFSET;
         }
 
-        if (IS_FLAG_SET(FLAG_HAL_INIT_DONE))
+        /* Cy_SMIF_MemLocateHybridRegion() does not access the external flash, just data tables from RAM  */
+        if (Cy_SMIF_MemLocateHybridRegion(smifBlockConfig.memConfig[MEM_SLOT], &hybrid_info, addr) == CY_SMIF_SUCCESS)
         {
-            /* pre-access to SMIF */
-            PRE_SMIF_ACCESS_TURN_OFF_XIP;
-
-            cy_smif_result = Cy_SMIF_MemRead(SMIF0, smifBlockConfig.memConfig[MEM_SLOT],
-                    addr, data, len, &ota_QSPI_context);
-            /* post-access to SMIF */
-            POST_SMIF_ACCESS_TURN_ON_XIP;
+            return hybrid_info->eraseSize;
         }
+    }
+    return ota_ext_erase_size_cached;
+#endif
+}
 
-        return (cy_smif_result == CY_SMIF_SUCCESS) ? CY_RSLT_SUCCESS : CY_RSLT_TYPE_ERROR;
-#else
-        return CY_RSLT_TYPE_ERROR;
-#endif /* CY_IP_MXSMIF & !XMC7100 & !XMC7200 */
+static inline cy_rslt_t ota_ext_read( uint32_t addr, void *data, size_t len )
+{
+    cy_en_smif_status_t cy_smif_result = CY_SMIF_SUCCESS;
+    if (addr >= CY_SMIF_BASE_MEM_OFFSET)
+    {
+        addr -= CY_SMIF_BASE_MEM_OFFSET;
     }
-    else
+
+    if (IS_FLAG_SET(FLAG_HAL_INIT_DONE))
     {
-        printf("%s() READ not supported for memory type %d\n", __func__, (int)mem_type);
-        return CY_RSLT_TYPE_ERROR;
+        /* pre-access to SMIF */
+        PRE_SMIF_ACCESS_TURN_OFF_XIP;
+
+        cy_smif_result = Cy_SMIF_MemRead(SMIF0, smifBlockConfig.memConfig[MEM_SLOT],
+                addr, data, len, &ota_QSPI_context);
+        /* post-access to SMIF */
+        POST_SMIF_ACCESS_TURN_ON_XIP;
     }
+
+    return (cy_smif_result == CY_SMIF_SUCCESS) ? CY_RSLT_SUCCESS : CY_RSLT_TYPE_ERROR;
 }
 
-static cy_rslt_t cy_ota_mem_write_row_size( cy_ota_mem_type_t mem_type, uint32_t addr, void *data, size_t len )
+static cy_rslt_t ota_ext_program( uint32_t addr, void *data, size_t len )
 {
+#ifdef READBACK_SMIF_WRITE_TEST
     cy_rslt_t result = CY_RSLT_SUCCESS;
+#endif
+    cy_en_smif_status_t cy_smif_result = CY_SMIF_SUCCESS;
+#ifdef ENABLE_ON_THE_FLY_ENCRYPTION
+    uint32_t cbus_addr = 0;
+    uint8_t *write_buffer = NULL;
+#endif
 
-    if( mem_type == CY_OTA_MEM_TYPE_INTERNAL_FLASH )
+    if (addr >= CY_SMIF_BASE_MEM_OFFSET)
+    {
+        addr -= CY_SMIF_BASE_MEM_OFFSET;
+    }
+
+    if (IS_FLAG_SET(FLAG_HAL_INIT_DONE))
     {
-#if !(defined (CYW20829B0LKML) || defined (CYW89829B01MKSBG))
-        int rc = 0;
+#ifdef ENABLE_ON_THE_FLY_ENCRYPTION
+        cbus_addr = cy_flash_addr_to_cbus_addr(addr);
+        write_buffer = ota_flash_buf_alloc(len);
+        if(write_buffer == NULL)
+        {
+            printf("\n%s() - Write buffer not available at %d\n", __func__, __LINE__);
+            return CY_RSLT_TYPE_ERROR;
+        }
 
-        /* flash_area_write() uses offsets, we need absolute address here */
-        addr += CY_FLASH_BASE;
+        memcpy(write_buffer, data, len);
 
-#if defined (XMC7100) || defined (XMC7200)
-        rc = xmc_internal_flash_write((uint8_t *)data, addr, len);
-        if (rc != 0 )
+        /* pre-access to SMIF */
+        PRE_SMIF_ACCESS_TURN_OFF_XIP;
+
+        /* Encrypt ota_Buffer */
+        cy_smif_result = Cy_SMIF_Encrypt(SMIF0, cbus_addr, write_buffer, len, &ota_QSPI_context);
+
+        /* post-access to SMIF */
+        POST_SMIF_ACCESS_TURN_ON_XIP;
+
+        if(cy_smif_result == CY_SMIF_SUCCESS)
         {
-            printf("xmc_internal_flash_write(0x%08x, 0x%08x, %u) FAILED rc:%u\n", (unsigned int)data, (unsigned int)addr, len, rc);
-            result = CY_RSLT_TYPE_ERROR;
+            cy_smif_result = Cy_SMIF_MemWrite(SMIF0, smifBlockConfig.memConfig[MEM_SLOT], addr, write_buffer, len, &ota_QSPI_context);
         }
-        return result;
-#else
-        rc = psoc6_internal_flash_write((uint8_t *)data, addr, len);
-        if (rc != 0 )
+
+#ifdef OTA_FLASH_VERIFY_ENABLE
+        if(cy_smif_result == CY_SMIF_SUCCESS)
         {
-            result = CY_RSLT_TYPE_ERROR;
+            /* Record the encrypted data, it is what the read-back returns */
+            cy_ota_flash_verify_record(addr, write_buffer, len);
         }
-        return result;
 #endif
-
+        ota_flash_buf_free(write_buffer);
 #else
-        (void)result;
-        printf("%s() Write not supported for memory type %d\n", __func__, (int)mem_type);
-        return CY_RSLT_TYPE_ERROR;
+        if(cy_smif_result == CY_SMIF_SUCCESS)
+        {
+            /* pre-access to SMIF */
+            PRE_SMIF_ACCESS_TURN_OFF_XIP;
+            cy_smif_result = Cy_SMIF_MemWrite(SMIF0, smifBlockConfig.memConfig[MEM_SLOT], addr, data, len, &ota_QSPI_context);
+            /* post-access to SMIF */
+            POST_SMIF_ACCESS_TURN_ON_XIP;
+        }
+#ifdef OTA_FLASH_VERIFY_ENABLE
+        if(cy_smif_result == CY_SMIF_SUCCESS)
+        {
+            cy_ota_flash_verify_record(addr, (const uint8_t *)data, len);
+        }
+#endif
 #endif
     }
-    else if( mem_type == CY_OTA_MEM_TYPE_EXTERNAL_FLASH )
+    else
     {
-#if (defined (CY_IP_MXSMIF) && !defined (XMC7100) && !defined (XMC7200))
-        cy_en_smif_status_t cy_smif_result = CY_SMIF_SUCCESS;
-#ifdef ENABLE_ON_THE_FLY_ENCRYPTION
-        uint32_t cbus_addr = 0;
-#endif
-
-        if (addr >= CY_SMIF_BASE_MEM_OFFSET)
-        {
-            addr -= CY_SMIF_BASE_MEM_OFFSET;
-        }
+        cy_smif_result = (cy_en_smif_status_t)CY_RSLT_SERIAL_FLASH_ERR_NOT_INITED;
+    }
 
-        if (IS_FLAG_SET(FLAG_HAL_INIT_DONE))
+#ifdef READBACK_SMIF_WRITE_TEST
+    if (cy_smif_result == CY_SMIF_SUCCESS)
+    {
+        uint32_t i = 0;
+        cy_smif_result = ota_ext_read(addr, &read_back_test[0], ((16 < len) ? 16 : len));
+        if(cy_smif_result == CY_RSLT_SUCCESS)
         {
 #ifdef ENABLE_ON_THE_FLY_ENCRYPTION
-            cbus_addr = cy_flash_addr_to_cbus_addr(addr);
-            if(ota_allocate_write_buffer(len) != true)
+            printf("\n\rEncrypted Data : ");
+            for(i = 0; (i < 16 && i < len); i++)
             {
-                printf("\n%s() - Memory allocation failed at %d\n", __func__, __LINE__);
-                return CY_RSLT_TYPE_ERROR;
+                printf("0x%02x ", read_back_test[i]);
             }
+            printf("\n\n\r");
 
-            memcpy(write_buffer, data, len);
+            cbus_addr = cy_flash_addr_to_cbus_addr(addr);
 
             /* pre-access to SMIF */
             PRE_SMIF_ACCESS_TURN_OFF_XIP;
 
-            /* Encrypt ota_Buffer */
-            cy_smif_result = Cy_SMIF_Encrypt(SMIF0, cbus_addr, write_buffer, len, &ota_QSPI_context);
+            /* Encrypt again read_back_test buffer to get plain txBuffer */
+            cy_smif_result = Cy_SMIF_Encrypt(SMIF0, cbus_addr, read_back_test, len, &ota_QSPI_context);
 
             /* post-access to SMIF */
             POST_SMIF_ACCESS_TURN_ON_XIP;
 
-            if(cy_smif_result == CY_SMIF_SUCCESS)
-            {
-                cy_smif_result = Cy_SMIF_MemWrite(SMIF0, smifBlockConfig.memConfig[MEM_SLOT], addr, write_buffer, len, &ota_QSPI_context);
-            }
-
-            ota_free_write_buffer();
-#else
-            if(cy_smif_result == CY_SMIF_SUCCESS)
+            if(cy_smif_result != CY_SMIF_SUCCESS)
             {
-                /* pre-access to SMIF */
-                PRE_SMIF_ACCESS_TURN_OFF_XIP;
-                cy_smif_result = Cy_SMIF_MemWrite(SMIF0, smifBlockConfig.memConfig[MEM_SLOT], addr, data, len, &ota_QSPI_context);
-                /* post-access to SMIF */
-                POST_SMIF_ACCESS_TURN_ON_XIP;
+                printf("[Error] Data encryption failed with error %d\r\n\r\n", cy_smif_result);
             }
-#endif
-        }
-        else
-        {
-            cy_smif_result = (cy_en_smif_status_t)CY_RSLT_SERIAL_FLASH_ERR_NOT_INITED;
-        }
-
-#ifdef READBACK_SMIF_WRITE_TEST
-        if (cy_smif_result == CY_SMIF_SUCCESS)
-        {
-            uint32_t i = 0;
-            cy_smif_result = cy_ota_mem_read(CY_OTA_MEM_TYPE_EXTERNAL_FLASH, addr, &read_back_test[0], ((16 < len) ? 16 : len));
-            if(cy_smif_result == CY_RSLT_SUCCESS)
+            else
             {
-#ifdef ENABLE_ON_THE_FLY_ENCRYPTION
-                printf("\n\rEncrypted Data : ");
+                printf("\n\rDecrypted Data : ");
                 for(i = 0; (i < 16 && i < len); i++)
                 {
                     printf("0x%02x ", read_back_test[i]);
                 }
                 printf("\n\n\r");
+            }
+#endif
+            for(i = 0; (i < 16 && i < len); i++)
+            {
+                if((((uint8_t *)data)[i]) != read_back_test[i])
+                {
+                    result  = -1;
+                    printf("[Error] Data mismatch at index %d expected : %d got : %d \r\n", i, (((uint8_t *)data)[i]), read_back_test[i]);
+                }
+            }
+        }
+    }
+#endif
+    return (cy_smif_result == CY_SMIF_SUCCESS) ? CY_RSLT_SUCCESS : CY_RSLT_TYPE_ERROR;
+}
 
-                cbus_addr = cy_flash_addr_to_cbus_addr(addr);
-
-                /* pre-access to SMIF */
-                PRE_SMIF_ACCESS_TURN_OFF_XIP;
+static cy_rslt_t ota_ext_erase( uint32_t addr, size_t len )
+{
+    cy_en_smif_status_t cy_smif_result = CY_SMIF_SUCCESS;
 
-                /* Encrypt again read_back_test buffer to get plain txBuffer */
-                cy_smif_result = Cy_SMIF_Encrypt(SMIF0, cbus_addr, read_back_test, len, &ota_QSPI_context);
+    if (addr >= CY_SMIF_BASE_MEM_OFFSET)
+    {
+        addr -= CY_SMIF_BASE_MEM_OFFSET;
+    }
 
-                /* post-access to SMIF */
-                POST_SMIF_ACCESS_TURN_ON_XIP;
+    if (IS_FLAG_SET(FLAG_HAL_INIT_DONE))
+    {
+        /* pre-access to SMIF */
+        PRE_SMIF_ACCESS_TURN_OFF_XIP;
 
-                if(cy_smif_result != CY_SMIF_SUCCESS)
-                {
-                    printf("[Error] Data encryption failed with error %d\r\n\r\n", cy_smif_result);
-                }
-                else
-                {
-                    printf("\n\rDecrypted Data : ");
-                    for(i = 0; (i < 16 && i < len); i++)
-                    {
-                        printf("0x%02x ", read_back_test[i]);
-                    }
-                    printf("\n\n\r");
-                }
+        // If the erase is for the entire chip, use chip erase command
+        if ((addr == 0u) && (len == ota_ext_mem_size))
+        {
+#ifdef OTA_FLASH_VERIFY_ENABLE
+            cy_ota_flash_verify_discard(addr, len);
 #endif
-                for(i = 0; (i < 16 && i < len); i++)
-                {
-                    if((((uint8_t *)data)[i]) != read_back_test[i])
-                    {
-                        result  = -1;
-                        printf("[Error] Data mismatch at index %d expected : %d got : %d \r\n", i, (((uint8_t *)data)[i]), read_back_test[i]);
-                    }
-                }
-            }
+            cy_smif_result = Cy_SMIF_MemEraseChip(SMIF0,
+                                                smifBlockConfig.memConfig[MEM_SLOT],
+                                                &ota_QSPI_context);
         }
+        else
+        {
+            // Cy_SMIF_MemEraseSector() returns error if (addr + length) > total flash size or if
+            // addr is not aligned to erase sector size or if (addr + length) is not aligned to
+            // erase sector size.
+            /* Make sure the base offset is correct */
+            uint32_t erase_size;
+            uint32_t diff;
+            erase_size = ota_ext_erase_size(addr);
+            diff = addr & (erase_size - 1);
+            addr -= diff;
+            len += diff;
+            /* Make sure the length is correct */
+            len = (len + (erase_size - 1)) & ~(erase_size - 1);
+#ifdef OTA_FLASH_VERIFY_ENABLE
+            /* Pending pages anywhere in the erased sectors are gone */
+            cy_ota_flash_verify_discard(addr, len);
 #endif
-        return (cy_smif_result == CY_SMIF_SUCCESS) ? CY_RSLT_SUCCESS : CY_RSLT_TYPE_ERROR;
-#else
-        return CY_RSLT_TYPE_ERROR;
-#endif /* CY_IP_MXSMIF & !XMC7100 & !XMC7200 */
+            Cy_SMIF_SetReadyPollingDelay(20000, &ota_QSPI_context);
+            cy_smif_result = Cy_SMIF_MemEraseSector(SMIF0,
+                                                  smifBlockConfig.memConfig[MEM_SLOT],
+                                                  addr, len, &ota_QSPI_context);
+            Cy_SMIF_SetReadyPollingDelay(0, &ota_QSPI_context);
+        }
+
+        /* post-access to SMIF */
+        POST_SMIF_ACCESS_TURN_ON_XIP;
     }
     else
     {
-        printf("%s() Write not supported for memory type %d\n", __func__, (int)mem_type);
-        return CY_RSLT_TYPE_ERROR;
+        return CY_RSLT_SERIAL_FLASH_ERR_NOT_INITED;
     }
+
+    return (cy_smif_result == CY_SMIF_SUCCESS) ? CY_RSLT_SUCCESS : CY_RSLT_TYPE_ERROR;
 }
+#endif /* OTA_FLASH_EXT_BACKEND_SMIF */
 
-/**
- * @brief Write to flash, QSPI flash, or any other external memory type
- *
- * @param[in]   mem_type   Memory type @ref cy_ota_mem_type_t
- * @param[in]   addr       Starting address to write to.
- * @param[in]   data       Pointer to the buffer containing the data to be written.
- * @param[in]   len        Number of bytes to write.
- *
- * @return  CY_RSLT_SUCCESS on success
- *          CY_RSLT_TYPE_ERROR on failure
+#ifdef OTA_FLASH_EXT_BACKEND_NONE
+/* No external flash on this device */
+static inline cy_rslt_t ota_ext_init( void )
+{
+    return CY_RSLT_SUCCESS;
+}
+
+static inline uint32_t ota_ext_prog_size( uint32_t addr )
+{
+    (void)addr;
+    return 0u;
+}
+
+static inline uint32_t ota_ext_erase_size( uint32_t addr )
+{
+    (void)addr;
+    return 0u;
+}
+
+static inline cy_rslt_t ota_ext_read( uint32_t addr, void *data, size_t len )
+{
+    (void)addr; (void)data; (void)len;
+    return CY_RSLT_TYPE_ERROR;
+}
+
+static inline cy_rslt_t ota_ext_program( uint32_t addr, void *data, size_t len )
+{
+    (void)addr; (void)data; (void)len;
+    return CY_RSLT_TYPE_ERROR;
+}
+
+static inline cy_rslt_t ota_ext_erase( uint32_t addr, size_t len )
+{
+    (void)addr; (void)len;
+    return CY_RSLT_TYPE_ERROR;
+}
+#endif /* OTA_FLASH_EXT_BACKEND_NONE */
+
+/**********************************************************************************************************************************
+ * Simulated flash backend (host builds)
+ **********************************************************************************************************************************/
+#ifdef OTA_FLASH_BACKEND_SIM
+/*
+ * Both memories live in RAM. The internal flash behaves like the PSoC 6 row
+ * flash (program replaces a whole row), the external flash like a NOR part:
+ * programming can only clear bits and an erase sets a whole sector to 0xFF.
  */
-cy_rslt_t cy_ota_mem_write( cy_ota_mem_type_t mem_type, uint32_t addr, void *data, size_t len )
+static uint8_t ota_sim_int[OTA_FLASH_SIM_INT_SIZE];
+static uint8_t ota_sim_ext[OTA_FLASH_SIM_EXT_SIZE];
+static bool    ota_sim_formatted;
+
+static void ota_sim_format( void )
+{
+    memset(ota_sim_int, OTA_FLASH_SIM_INT_ERASED_VALUE, sizeof(ota_sim_int));
+    memset(ota_sim_ext, 0xFF, sizeof(ota_sim_ext));
+    ota_sim_formatted = true;
+}
+
+static inline bool ota_sim_in_range( uint32_t addr, size_t len, size_t size )
+{
+    return (addr <= size) && (len <= (size - addr));
+}
+
+static inline cy_rslt_t ota_int_read( uint32_t addr, void *data, size_t len )
+{
+    if (!ota_sim_in_range(addr, len, sizeof(ota_sim_int)))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+    memcpy(data, &ota_sim_int[addr], len);
+    return CY_RSLT_SUCCESS;
+}
+
+static inline cy_rslt_t ota_int_program( uint32_t addr, void *data, size_t len )
+{
+    if (!ota_sim_in_range(addr, len, sizeof(ota_sim_int)))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+    memcpy(&ota_sim_int[addr], data, len);
+    return CY_RSLT_SUCCESS;
+}
+
+static inline cy_rslt_t ota_int_erase( uint32_t addr, size_t len )
+{
+    uint32_t start = addr - (addr % OTA_FLASH_INT_ERASE_SIZE);
+    uint32_t end = ((addr + len + OTA_FLASH_INT_ERASE_SIZE - 1u) / OTA_FLASH_INT_ERASE_SIZE) * OTA_FLASH_INT_ERASE_SIZE;
+
+    if (!ota_sim_in_range(start, end - start, sizeof(ota_sim_int)))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+    memset(&ota_sim_int[start], OTA_FLASH_SIM_INT_ERASED_VALUE, end - start);
+    return CY_RSLT_SUCCESS;
+}
+
+static inline cy_rslt_t ota_ext_init( void )
+{
+    if (!ota_sim_formatted)
+    {
+        ota_sim_format();
+    }
+    return CY_RSLT_SUCCESS;
+}
+
+static inline uint32_t ota_ext_prog_size( uint32_t addr )
+{
+    (void)addr;
+    return OTA_FLASH_SIM_EXT_PROG_SIZE;
+}
+
+static inline uint32_t ota_ext_erase_size( uint32_t addr )
+{
+    (void)addr;
+    return OTA_FLASH_SIM_EXT_ERASE_SIZE;
+}
+
+static inline uint32_t ota_sim_ext_offset( uint32_t addr )
+{
+    if (addr >= CY_XIP_BASE)
+    {
+        addr -= CY_XIP_BASE;
+    }
+    return addr;
+}
+
+static inline cy_rslt_t ota_ext_read( uint32_t addr, void *data, size_t len )
+{
+    addr = ota_sim_ext_offset(addr);
+    if (!ota_sim_in_range(addr, len, sizeof(ota_sim_ext)))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+    memcpy(data, &ota_sim_ext[addr], len);
+    return CY_RSLT_SUCCESS;
+}
+
+static inline cy_rslt_t ota_ext_program( uint32_t addr, void *data, size_t len )
+{
+    const uint8_t *src = (const uint8_t *)data;
+    size_t i;
+
+    addr = ota_sim_ext_offset(addr);
+    if (!ota_sim_in_range(addr, len, sizeof(ota_sim_ext)))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    for (i = 0; i < len; i++)
+    {
+#if (OTA_FLASH_SIM_STRICT != 0)
+        if ((src[i] & ~ota_sim_ext[addr + i]) != 0u)
+        {
+            printf("%s() programming 0x%08x without erase\n", __func__, (unsigned int)(addr + i));
+            return CY_RSLT_TYPE_ERROR;
+        }
+#endif
+        ota_sim_ext[addr + i] &= src[i];
+    }
+#ifdef OTA_FLASH_VERIFY_ENABLE
+    cy_ota_flash_verify_record(addr, src, len);
+#endif
+    return CY_RSLT_SUCCESS;
+}
+
+static inline cy_rslt_t ota_ext_erase( uint32_t addr, size_t len )
+{
+    uint32_t start;
+    uint32_t end;
+
+    addr = ota_sim_ext_offset(addr);
+    start = addr & ~(OTA_FLASH_SIM_EXT_ERASE_SIZE - 1u);
+    end = (addr + len + OTA_FLASH_SIM_EXT_ERASE_SIZE - 1u) & ~(OTA_FLASH_SIM_EXT_ERASE_SIZE - 1u);
+    if (!ota_sim_in_range(start, end - start, sizeof(ota_sim_ext)))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+#ifdef OTA_FLASH_VERIFY_ENABLE
+    cy_ota_flash_verify_discard(start, end - start);
+#endif
+    memset(&ota_sim_ext[start], 0xFF, end - start);
+    return CY_RSLT_SUCCESS;
+}
+#endif /* OTA_FLASH_BACKEND_SIM */
+
+/**********************************************************************************************************************************
+ * Backend dispatch
+ **********************************************************************************************************************************/
+static inline cy_rslt_t ota_mem_read( cy_ota_mem_type_t mem_type, uint32_t addr, void *data, size_t len )
+{
+    if( mem_type == CY_OTA_MEM_TYPE_INTERNAL_FLASH )
+    {
+        return ota_int_read(addr, data, len);
+    }
+    else if( mem_type == CY_OTA_MEM_TYPE_EXTERNAL_FLASH )
+    {
+        return ota_ext_read(addr, data, len);
+    }
+    printf("%s() READ not supported for memory type %d\n", __func__, (int)mem_type);
+    return CY_RSLT_TYPE_ERROR;
+}
+
+static inline cy_rslt_t ota_mem_program( cy_ota_mem_type_t mem_type, uint32_t addr, void *data, size_t len )
+{
+    if( mem_type == CY_OTA_MEM_TYPE_INTERNAL_FLASH )
+    {
+        return ota_int_program(addr, data, len);
+    }
+    else if( mem_type == CY_OTA_MEM_TYPE_EXTERNAL_FLASH )
+    {
+        return ota_ext_program(addr, data, len);
+    }
+    printf("%s() Write not supported for memory type %d\n", __func__, (int)mem_type);
+    return CY_RSLT_TYPE_ERROR;
+}
+
+static inline cy_rslt_t ota_mem_erase( cy_ota_mem_type_t mem_type, uint32_t addr, size_t len )
+{
+    if( mem_type == CY_OTA_MEM_TYPE_INTERNAL_FLASH )
+    {
+        return ota_int_erase(addr, len);
+    }
+    else if( mem_type == CY_OTA_MEM_TYPE_EXTERNAL_FLASH )
+    {
+        return ota_ext_erase(addr, len);
+    }
+    printf("%s() Erase not supported for memory type %d\n", __func__, (int)mem_type);
+    return CY_RSLT_TYPE_ERROR;
+}
+
+static cy_rslt_t ota_mem_write( cy_ota_mem_type_t mem_type, uint32_t addr, void *data, size_t len )
 {
     cy_rslt_t result = CY_RSLT_SUCCESS;
 
     /**
      * This is used if a block is < Block size to satisfy requirements
-     * of flash_area_write(). "static" so it is not on the stack.
+     * of flash_area_write(). Taken from the buffer pool on the first
+     * partial row so it is neither on the stack nor on the heap.
      */
-    static uint8_t block_buffer[CY_FLASH_SIZEOF_ROW];
+    uint8_t *block_buffer = NULL;
     uint32_t chunk_size = 0;
 
     uint32_t bytes_to_write = len;
@@ -1024,7 +1535,18 @@ cy_rslt_t cy_ota_mem_write( cy_ota_mem_type_t mem_type, uint32_t addr, void *dat
         chunk_size = bytes_to_write;
         if(chunk_size > CY_FLASH_SIZEOF_ROW)
         {
+#ifdef ENABLE_ON_THE_FLY_ENCRYPTION
+            /* The encrypted copy is taken from the row sized buffer pool */
             chunk_size = CY_FLASH_SIZEOF_ROW;
+#else
+            /* Whole rows are programmed from the source without a copy, only
+             * a partial row at the end goes through the row buffer */
+            if(chunk_size > OTA_FLASH_PROG_RUN_MAX)
+            {
+                chunk_size = OTA_FLASH_PROG_RUN_MAX;
+            }
+            chunk_size -= (chunk_size % CY_FLASH_SIZEOF_ROW);
+#endif
         }
 
         /* Is the chunk_size smaller than a flash row? */
@@ -1041,11 +1563,23 @@ cy_rslt_t cy_ota_mem_write( cy_ota_mem_type_t mem_type, uint32_t addr, void *dat
                 chunk_size = (CY_FLASH_SIZEOF_ROW - row_offset);
             }
 
+            if(block_buffer == NULL)
+            {
+                block_buffer = ota_flash_buf_alloc(CY_FLASH_SIZEOF_ROW);
+                if(block_buffer == NULL)
+                {
+                    printf("%s() Row buffer not available\n", __func__);
+                    result = CY_RSLT_TYPE_ERROR;
+                    break;
+                }
+            }
+
             /* we will read a CY_FLASH_SIZEOF_ROW byte block, write the new data into the block, then write the whole block */
-            result = cy_ota_mem_read( mem_type, row_base, (void *)(&block_buffer[0]), sizeof(block_buffer));
+            result = ota_mem_read( mem_type, row_base, (void *)(&block_buffer[0]), CY_FLASH_SIZEOF_ROW);
             if(result != CY_RSLT_SUCCESS)
             {
-                 return CY_RSLT_TYPE_ERROR;
+                result = CY_RSLT_TYPE_ERROR;
+                break;
             }
 
 #ifdef ENABLE_ON_THE_FLY_ENCRYPTION
@@ -1055,7 +1589,7 @@ cy_rslt_t cy_ota_mem_write( cy_ota_mem_type_t mem_type, uint32_t addr, void *dat
             PRE_SMIF_ACCESS_TURN_OFF_XIP;
 
             /* Encrypt again block_buffer to get plain txBuffer */
-            cy_smif_result = Cy_SMIF_Encrypt(SMIF0, cbus_addr, &(block_buffer[0]), sizeof(block_buffer), &ota_QSPI_context);
+            cy_smif_result = Cy_SMIF_Encrypt(SMIF0, cbus_addr, &(block_buffer[0]), CY_FLASH_SIZEOF_ROW, &ota_QSPI_context);
 
             /* post-access to SMIF */
             POST_SMIF_ACCESS_TURN_ON_XIP;
@@ -1073,27 +1607,30 @@ cy_rslt_t cy_ota_mem_write( cy_ota_mem_type_t mem_type, uint32_t addr, void *dat
                 /* Erase while updating Image trailers */
                 if(len <= CY_BOOT_TRAILER_MAX_UPDATE_SIZE)
                 {
-                    result = cy_ota_mem_erase(mem_type, curr_addr, bytes_to_write);
+                    result = ota_mem_erase(mem_type, curr_addr, bytes_to_write);
                     if(result != CY_RSLT_SUCCESS)
                     {
                         printf("%s() Erase failed for memory type %d\n", __func__, (int)mem_type);
-                        return CY_RSLT_TYPE_ERROR;
+                        result = CY_RSLT_TYPE_ERROR;
+                        break;
                     }
                 }
             }
 #endif
-            result = cy_ota_mem_write_row_size(mem_type, row_base, (void *)(&block_buffer[0]), sizeof(block_buffer));
+            result = ota_mem_program(mem_type, row_base, (void *)(&block_buffer[0]), CY_FLASH_SIZEOF_ROW);
             if(result != CY_RSLT_SUCCESS)
             {
-                return CY_RSLT_TYPE_ERROR;
+                result = CY_RSLT_TYPE_ERROR;
+                break;
             }
         }
         else
         {
-            result = cy_ota_mem_write_row_size(mem_type, curr_addr, curr_src, chunk_size);
+            result = ota_mem_program(mem_type, curr_addr, curr_src, chunk_size);
             if(result != CY_RSLT_SUCCESS)
             {
-                return CY_RSLT_TYPE_ERROR;
+                result = CY_RSLT_TYPE_ERROR;
+                break;
             }
         }
 
@@ -1102,115 +1639,115 @@ cy_rslt_t cy_ota_mem_write( cy_ota_mem_type_t mem_type, uint32_t addr, void *dat
         bytes_to_write -= chunk_size;
     }
 
-    return CY_RSLT_SUCCESS;
+    ota_flash_buf_free(block_buffer);
+
+    return result;
 }
 
+/**********************************************************************************************************************************
+ * External Functions
+ **********************************************************************************************************************************/
 /**
- * @brief Erase flash, QSPI flash, or any other external memory type
- *
- * @param[in]   mem_type   Memory type @ref cy_ota_mem_type_t
- * @param[in]   addr       Starting address to begin erasing.
- * @param[in]   len        Number of bytes to erase.
+ * @brief Initializes flash, QSPI flash, or any other external memory type
  *
- * @return  CY_RSLT_SUCCESS
- *          CY_RSLT_TYPE_ERROR
+ * @return  CY_RSLT_SUCCESS on success
+ *          CY_RSLT_TYPE_ERROR on failure
  */
-cy_rslt_t cy_ota_mem_erase( cy_ota_mem_type_t mem_type, uint32_t addr, size_t len )
+cy_rslt_t cy_ota_mem_init( void )
 {
-    cy_rslt_t result = CY_RSLT_SUCCESS;
-
-    if( mem_type == CY_OTA_MEM_TYPE_INTERNAL_FLASH )
+    if (ota_mem_mutex == NULL)
     {
-#if !(defined (CYW20829B0LKML) || defined (CYW89829B01MKSBG))
-        int rc = 0;
-
-#if defined (XMC7100) || defined (XMC7200)
-        int intr_status = 0;
-        intr_status = Cy_SysLib_EnterCriticalSection();
-        rc = xmc_internal_flash_erase(addr, len);
-        Cy_SysLib_ExitCriticalSection(intr_status);
-        if (rc != 0 )
+        ota_mem_mutex = xSemaphoreCreateRecursiveMutexStatic(&ota_mem_mutex_buffer);
+        if (ota_mem_mutex == NULL)
         {
-            printf("xmc_internal_flash_erase(0x%08x, %u) FAILED rc:%d\n", (unsigned int)addr, len, rc);
-            result = CY_RSLT_TYPE_ERROR;
-        }
-#else
-        rc = psoc6_internal_flash_erase(addr, len);
-        if (rc != 0 )
-        {
-            result = CY_RSLT_TYPE_ERROR;
+            return CY_RSLT_TYPE_ERROR;
         }
-#endif
-        return result;
-#else
-        (void)result;
-        printf("%s() Erase not supported for memory type %d\n", __func__, (int)mem_type);
-        return CY_RSLT_TYPE_ERROR;
-#endif
     }
-    else if( mem_type == CY_OTA_MEM_TYPE_EXTERNAL_FLASH )
+
+#ifdef OTA_FLASH_VERIFY_ENABLE
+    if (cy_ota_flash_verify_init() != CY_RSLT_SUCCESS)
     {
-#if (defined (CY_IP_MXSMIF) && !defined (XMC7100) && !defined (XMC7200))
-        cy_en_smif_status_t cy_smif_result = CY_SMIF_SUCCESS;
+        return CY_RSLT_TYPE_ERROR;
+    }
+#endif
 
-        if (addr >= CY_SMIF_BASE_MEM_OFFSET)
-        {
-            addr -= CY_SMIF_BASE_MEM_OFFSET;
-        }
+#ifdef OTA_FLASH_STATS_ENABLE
+    cy_ota_flash_stats_init();
+#endif
 
-        if (IS_FLAG_SET(FLAG_HAL_INIT_DONE))
-        {
-            /* pre-access to SMIF */
-            PRE_SMIF_ACCESS_TURN_OFF_XIP;
+    return ota_ext_init();
+}
 
-            // If the erase is for the entire chip, use chip erase command
-            if ((addr == 0u) && (len == ota_smif_get_memory_size()))
-            {
-                cy_smif_result = Cy_SMIF_MemEraseChip(SMIF0,
-                                                    smifBlockConfig.memConfig[MEM_SLOT],
-                                                    &ota_QSPI_context);
-            }
-            else
-            {
-                // Cy_SMIF_MemEraseSector() returns error if (addr + length) > total flash size or if
-                // addr is not aligned to erase sector size or if (addr + length) is not aligned to
-                // erase sector size.
-                /* Make sure the base offset is correct */
-                uint32_t erase_size;
-                uint32_t diff;
-                erase_size = cy_ota_mem_get_erase_size(CY_OTA_MEM_TYPE_EXTERNAL_FLASH, addr);
-                diff = addr & (erase_size - 1);
-                addr -= diff;
-                len += diff;
-                /* Make sure the length is correct */
-                len = (len + (erase_size - 1)) & ~(erase_size - 1);
-                Cy_SMIF_SetReadyPollingDelay(20000, &ota_QSPI_context);
-                cy_smif_result = Cy_SMIF_MemEraseSector(SMIF0,
-                                                      smifBlockConfig.memConfig[MEM_SLOT],
-                                                      addr, len, &ota_QSPI_context);
-                Cy_SMIF_SetReadyPollingDelay(0, &ota_QSPI_context);
-            }
+/**
+ * @brief Read from flash, QSPI flash, or any other external memory type
+ *
+ * @param[in]   mem_type   Memory type @ref cy_ota_mem_type_t
+ * @param[in]   addr       Starting address to read from.
+ * @param[out]  data       Pointer to the buffer to store the data read from the memory.
+ * @param[in]   len        Number of data bytes to read.
+ *
+ * @return  CY_RSLT_SUCCESS on success
+ *          CY_RSLT_TYPE_ERROR on failure
+ */
+cy_rslt_t cy_ota_mem_read( cy_ota_mem_type_t mem_type, uint32_t addr, void *data, size_t len )
+{
+    cy_rslt_t result;
 
-            /* post-access to SMIF */
-            POST_SMIF_ACCESS_TURN_ON_XIP;
-        }
-        else
-        {
-            return CY_RSLT_SERIAL_FLASH_ERR_NOT_INITED;
-        }
+    cy_ota_mem_lock();
+    OTA_FLASH_STATS_START(start);
+    result = ota_mem_read(mem_type, addr, data, len);
+    OTA_FLASH_STATS_OP(start, mem_type, CY_OTA_FLASH_OP_READ, addr, len, result);
+    cy_ota_mem_unlock();
 
-        return (cy_smif_result == CY_SMIF_SUCCESS) ? CY_RSLT_SUCCESS : CY_RSLT_TYPE_ERROR;
-#else
-        return CY_RSLT_TYPE_ERROR;
-#endif /* CY_IP_MXSMIF & !XMC7100 & !XMC7200 */
-    }
-    else
-    {
-        printf("%s() Erase not supported for memory type %d\n", __func__, (int)mem_type);
-        return CY_RSLT_TYPE_ERROR;
-    }
+    return result;
 }
 
+/**
+ * @brief Write to flash, QSPI flash, or any other external memory type
+ *
+ * @param[in]   mem_type   Memory type @ref cy_ota_mem_type_t
+ * @param[in]   addr       Starting address to write to.
+ * @param[in]   data       Pointer to the buffer containing the data to be written.
+ * @param[in]   len        Number of bytes to write.
+ *
+ * @return  CY_RSLT_SUCCESS on success
+ *          CY_RSLT_TYPE_ERROR on failure
+ */
+cy_rslt_t cy_ota_mem_write( cy_ota_mem_type_t mem_type, uint32_t addr, void *data, size_t len )
+{
+    cy_rslt_t result;
+
+    cy_ota_mem_lock();
+    OTA_FLASH_STATS_START(start);
+    result = ota_mem_write(mem_type, addr, data, len);
+    OTA_FLASH_STATS_OP(start, mem_type, CY_OTA_FLASH_OP_WRITE, addr, len, result);
+    cy_ota_mem_unlock();
+
+    return result;
+}
+
+/**
+ * @brief Erase flash, QSPI flash, or any other external memory type
+ *
+ * @param[in]   mem_type   Memory type @ref cy_ota_mem_type_t
+ * @param[in]   addr       Starting address to begin erasing.
+ * @param[in]   len        Number of bytes to erase.
+ *
+ * @return  CY_RSLT_SUCCESS
+ *          CY_RSLT_TYPE_ERROR
+ */
+cy_rslt_t cy_ota_mem_erase( cy_ota_mem_type_t mem_type, uint32_t addr, size_t len )
+{
+    cy_rslt_t result;
+
+    cy_ota_mem_lock();
+    OTA_FLASH_STATS_START(start);
+    result = ota_mem_erase(mem_type, addr, len);
+    OTA_FLASH_STATS_OP(start, mem_type, CY_OTA_FLASH_OP_ERASE, addr, len, result);
+    cy_ota_mem_unlock();
+
+    return result;
+}
 /**
  * @brief To get page size for programming flash, QSPI flash, or any other external memory type
  *
@@ -1223,31 +1760,11 @@ size_t cy_ota_mem_get_prog_size ( cy_ota_mem_type_t mem_type, uint32_t addr )
 {
     if( mem_type == CY_OTA_MEM_TYPE_INTERNAL_FLASH )
     {
-#if !(defined (CYW20829B0LKML) || defined (CYW89829B01MKSBG))
-        return CY_FLASH_SIZEOF_ROW;
-#else
-        return 0;
-#endif
+        return OTA_FLASH_INT_PROG_SIZE;
     }
     else if( mem_type == CY_OTA_MEM_TYPE_EXTERNAL_FLASH )
     {
-#if (defined (CY_IP_MXSMIF) && !defined (XMC7100) && !defined (XMC7200))
-        uint32_t    program_size = 0;
-        (void)addr; /* Hybrid parts not yet supported */
-        /* pre-access to SMIF is not needed, as we are just reading data from RAM */
-        if (IS_FLAG_SET(FLAG_HAL_INIT_DONE))
-        {
-            if (SMIF0 != NULL)
-            {
-                program_size = smifBlockConfig.memConfig[MEM_SLOT]->deviceCfg->programSize;
-            }
-        }
-        /* post-access to SMIF  is not needed, as we are just reading data from RAM */
-
-        return program_size;
-#else
-        return 0;
-#endif /* CY_IP_MXSMIF & !XMC7100 & !XMC7200 */
+        return ota_ext_prog_size(addr);
     }
     else
     {
@@ -1267,48 +1784,101 @@ size_t cy_ota_mem_get_erase_size ( cy_ota_mem_type_t mem_type, uint32_t addr )
 {
     if( mem_type == CY_OTA_MEM_TYPE_INTERNAL_FLASH )
     {
-#if !(defined (CYW20829B0LKML) || defined (CYW89829B01MKSBG))
-        return CY_FLASH_SIZEOF_ROW;
-#else
-        return 0;
-#endif
+        return OTA_FLASH_INT_ERASE_SIZE;
     }
     else if( mem_type == CY_OTA_MEM_TYPE_EXTERNAL_FLASH )
     {
-#if (defined (CY_IP_MXSMIF) && !defined (XMC7100) && !defined (XMC7200))
-        uint32_t                            erase_sector_size = 0;
-        cy_stc_smif_hybrid_region_info_t*   hybrid_info = NULL;
-        cy_en_smif_status_t                 smif_status;
+        return ota_ext_erase_size(addr);
+    }
+    else
+    {
+        return 0;
+    }
+}
 
-        if (addr >= CY_SMIF_BASE_MEM_OFFSET)
-        {
-            addr -= CY_SMIF_BASE_MEM_OFFSET;
-        }
+/**
+ * @brief Take the flash access lock
+ */
+void cy_ota_mem_lock(void)
+{
+    if ((ota_mem_mutex != NULL) && (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING))
+    {
+        (void)xSemaphoreTakeRecursive(ota_mem_mutex, portMAX_DELAY);
+    }
+}
 
-        /* pre-access to SMIF is not needed, as we are just reading data from RAM */
-        if (IS_FLAG_SET(FLAG_HAL_INIT_DONE))
-        {
-            /* Cy_SMIF_MemLocateHybridRegion() does not access the external flash, just data tables from RAM  */
-            smif_status = Cy_SMIF_MemLocateHybridRegion(smifBlockConfig.memConfig[MEM_SLOT], &hybrid_info, addr);
+/**
+ * @brief Release the flash access lock taken with cy_ota_mem_lock()
+ */
+void cy_ota_mem_unlock(void)
+{
+    if ((ota_mem_mutex != NULL) && (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING))
+    {
+        (void)xSemaphoreGiveRecursive(ota_mem_mutex);
+    }
+}
 
-            if (CY_SMIF_SUCCESS != smif_status)
-            {
-                erase_sector_size = (size_t)smifBlockConfig.memConfig[MEM_SLOT]->deviceCfg->eraseSize;
-            }
-            else
-            {
-                erase_sector_size = (size_t)hybrid_info->eraseSize;
-            }
-        }
-        /* post-access to SMIF is not needed, as we are just reading data from RAM */
+/**
+ * @brief Get a snapshot of the flash write buffer pool statistics
+ *
+ * @param[out]  stats   Statistics of the pool
+ */
+void cy_ota_flash_pool_get_stats(cy_ota_flash_pool_stats_t *stats)
+{
+    uint32_t intr_status;
 
-        return erase_sector_size;
-#else
-        return 0;
-#endif /* CY_IP_MXSMIF & !XMC7100 & !XMC7200 */
+    if (stats == NULL)
+    {
+        return;
     }
-    else
+
+    intr_status = Cy_SysLib_EnterCriticalSection();
+    *stats = ota_flash_buf_pool_stats;
+    Cy_SysLib_ExitCriticalSection(intr_status);
+
+    stats->buf_size  = OTA_FLASH_BUF_POOL_SIZE;
+    stats->buf_count = OTA_FLASH_BUF_POOL_COUNT;
+}
+
+#ifdef OTA_FLASH_BACKEND_SIM
+/**
+ * @brief Erase both simulated memories
+ */
+void cy_ota_flash_sim_reset(void)
+{
+    cy_ota_mem_lock();
+    ota_sim_format();
+    cy_ota_mem_unlock();
+}
+
+/**
+ * @brief Direct access to the simulated memory contents for test code
+ */
+uint8_t *cy_ota_flash_sim_mem(cy_ota_mem_type_t mem_type, size_t *size)
+{
+    uint8_t *mem = NULL;
+    size_t mem_size = 0;
+
+    if (!ota_sim_formatted)
     {
-        return 0;
+        ota_sim_format();
+    }
+
+    if (mem_type == CY_OTA_MEM_TYPE_INTERNAL_FLASH)
+    {
+        mem = ota_sim_int;
+        mem_size = sizeof(ota_sim_int);
+    }
+    else if (mem_type == CY_OTA_MEM_TYPE_EXTERNAL_FLASH)
+    {
+        mem = ota_sim_ext;
+        mem_size = sizeof(ota_sim_ext);
+    }
+
+    if (size != NULL)
+    {
+        *size = mem_size;
     }
+    return mem;
 }
+#endif /* OTA_FLASH_BACKEND_SIM */
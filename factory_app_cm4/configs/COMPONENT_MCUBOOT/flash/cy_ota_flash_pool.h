@@ -0,0 +1,97 @@
+/******************************************************************************
+* File Name:   cy_ota_flash_pool.h
+*
+* Description: This file contains the configuration and statistics API of the
+*              preallocated write buffer pool used by the OTA flash driver
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef CY_OTA_FLASH_POOL_H_
+#define CY_OTA_FLASH_POOL_H_
+
+#include <stdint.h>
+
+/**********************************************************************************************************************************
+ * Configuration
+ **********************************************************************************************************************************/
+/**
+ * Number of row-sized buffers in the pool. A single cy_ota_mem_write() call
+ * holds at most two buffers at once (the partial row buffer and the encryption
+ * or cache aligned buffer), so increase this only when more than one task
+ * writes to flash concurrently. Maximum is 32.
+ */
+#ifndef OTA_FLASH_BUF_POOL_COUNT
+#define OTA_FLASH_BUF_POOL_COUNT                    (2u)
+#endif
+
+/**
+ * Alignment of every buffer in the pool. Must be a power of two and at least
+ * the data cache line size on parts that have a data cache.
+ */
+#ifndef OTA_FLASH_BUF_POOL_ALIGN
+#define OTA_FLASH_BUF_POOL_ALIGN                    (32u)
+#endif
+
+/**********************************************************************************************************************************
+ * Types
+ **********************************************************************************************************************************/
+/**
+ * @brief Allocation statistics of the flash write buffer pool
+ */
+typedef struct cy_ota_flash_pool_stats_s
+{
+    uint32_t    buf_size;       /**< Usable size of each buffer in bytes            */
+    uint32_t    buf_count;      /**< Number of buffers in the pool                   */
+    uint32_t    allocs;         /**< Number of successful allocations                */
+    uint32_t    frees;          /**< Number of buffers returned to the pool          */
+    uint32_t    failures;       /**< Allocations refused (pool empty or too large)   */
+    uint32_t    in_use;         /**< Buffers currently handed out                    */
+    uint32_t    peak_in_use;    /**< Largest number of buffers handed out at once    */
+} cy_ota_flash_pool_stats_t;
+
+/**********************************************************************************************************************************
+ * Functions
+ **********************************************************************************************************************************/
+/**
+ * @brief Get a snapshot of the flash write buffer pool statistics
+ *
+ * @param[out]  stats   Statistics of the pool
+ */
+void cy_ota_flash_pool_get_stats(cy_ota_flash_pool_stats_t *stats);
+
+#endif /* CY_OTA_FLASH_POOL_H_ */
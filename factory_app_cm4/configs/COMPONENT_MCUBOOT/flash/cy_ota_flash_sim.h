@@ -0,0 +1,106 @@
+/******************************************************************************
+* File Name:   cy_ota_flash_sim.h
+*
+* Description: This file contains the configuration and the test hooks of the
+*              simulated flash backend used for host builds of the flash driver
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef CY_OTA_FLASH_SIM_H_
+#define CY_OTA_FLASH_SIM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "cy_ota_flash.h"
+
+/**********************************************************************************************************************************
+ * Configuration
+ **********************************************************************************************************************************/
+/* Size of the simulated internal flash in bytes */
+#ifndef OTA_FLASH_SIM_INT_SIZE
+#define OTA_FLASH_SIM_INT_SIZE                      (0x200000u)
+#endif
+
+/* Value of an erased internal flash byte. 0x00 as on PSoC 6. */
+#ifndef OTA_FLASH_SIM_INT_ERASED_VALUE
+#define OTA_FLASH_SIM_INT_ERASED_VALUE              (0x00u)
+#endif
+
+/* Size of the simulated external flash in bytes */
+#ifndef OTA_FLASH_SIM_EXT_SIZE
+#define OTA_FLASH_SIM_EXT_SIZE                      (0x800000u)
+#endif
+
+/* Program page and erase sector size of the simulated external flash. The
+ * erase size must be a power of two.
+ */
+#ifndef OTA_FLASH_SIM_EXT_PROG_SIZE
+#define OTA_FLASH_SIM_EXT_PROG_SIZE                 (512u)
+#endif
+
+#ifndef OTA_FLASH_SIM_EXT_ERASE_SIZE
+#define OTA_FLASH_SIM_EXT_ERASE_SIZE                (0x40000u)
+#endif
+
+/* 1 - Programming an external flash bit from 0 to 1 without an erase fails,
+ * which catches a missing erase in the write path. 0 - It is silently ANDed
+ * in as on the real part.
+ */
+#ifndef OTA_FLASH_SIM_STRICT
+#define OTA_FLASH_SIM_STRICT                        (1)
+#endif
+
+/**********************************************************************************************************************************
+ * Functions
+ **********************************************************************************************************************************/
+/**
+ * @brief Erase both simulated memories
+ */
+void cy_ota_flash_sim_reset(void);
+
+/**
+ * @brief Direct access to the simulated memory contents for test code
+ *
+ * @param[in]   mem_type   Memory type @ref cy_ota_mem_type_t
+ * @param[out]  size       Size of the memory in bytes, may be NULL
+ *
+ * @return    Start of the memory, NULL for an unknown memory type
+ */
+uint8_t *cy_ota_flash_sim_mem(cy_ota_mem_type_t mem_type, size_t *size);
+
+#endif /* CY_OTA_FLASH_SIM_H_ */
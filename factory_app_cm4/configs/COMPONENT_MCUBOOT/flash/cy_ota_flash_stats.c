@@ -0,0 +1,426 @@
+/******************************************************************************
+* File Name:   cy_ota_flash_stats.c
+*
+* Description: This file contains the flash driver telemetry: per-operation
+*              latency and byte counters, the erase wear map and critical-section
+*              time
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifdef OTA_FLASH_STATS_ENABLE
+
+/* Header file includes */
+#include <stdio.h>
+#include <string.h>
+#include "cy_pdl.h"
+#include "cy_ota_flash.h"
+#include "cy_ota_flash_lock.h"
+#include "cy_ota_flash_stats.h"
+
+/**********************************************************************************************************************************
+ * local defines
+ **********************************************************************************************************************************/
+#define STATS_MEM_INDEX_VALID(mem_type)     ((uint32_t)(mem_type) < CY_OTA_FLASH_STATS_MEM_COUNT)
+
+/* Append to the JSON document, bail out when it does not fit */
+#define STATS_JSON_APPEND(...)                                              \
+    do {                                                                    \
+        int n = snprintf(&buf[used], size - used, __VA_ARGS__);             \
+        if ((n < 0) || ((size_t)n >= (size - used))) { return 0u; }         \
+        used += (size_t)n;                                                  \
+    } while (0)
+
+/**********************************************************************************************************************************
+ * local variables & data
+ **********************************************************************************************************************************/
+/* Protected by the flash lock */
+static cy_ota_flash_stats_t ota_flash_stats;
+
+static const char * const ota_flash_stats_mem_names[CY_OTA_FLASH_STATS_MEM_COUNT] = { "internal", "external" };
+static const char * const ota_flash_stats_op_names[CY_OTA_FLASH_OP_COUNT] = { "read", "write", "erase" };
+
+/**********************************************************************************************************************************
+ * Internal Functions
+ **********************************************************************************************************************************/
+static uint32_t ota_flash_stats_cycles_to_us(uint32_t cycles)
+{
+    uint32_t cycles_per_us = SystemCoreClock / 1000000u;
+
+    return (cycles_per_us != 0u) ? (cycles / cycles_per_us) : 0u;
+}
+
+static uint32_t ota_flash_stats_bucket(uint32_t us)
+{
+    uint32_t bucket = 0u;
+
+    while ((us > 1u) && (bucket < (OTA_FLASH_STATS_HIST_BUCKETS - 1u)))
+    {
+        us >>= 1;
+        bucket++;
+    }
+
+    return bucket;
+}
+
+/*******************************************************************************
+* Function Name: ota_flash_stats_wear
+****************************************************************************//**
+*
+* Adds one erase to every wear map sector touched by [addr, addr + len).
+*
+*******************************************************************************/
+static void ota_flash_stats_wear(uint32_t mem, uint32_t addr, size_t len)
+{
+    uint32_t sector_size;
+    uint32_t first;
+    uint32_t last;
+    uint32_t sector;
+
+    if (len == 0u)
+    {
+        return;
+    }
+
+    if (mem == CY_OTA_MEM_TYPE_INTERNAL_FLASH)
+    {
+        sector_size = OTA_FLASH_STATS_WEAR_SECTOR_INTERNAL;
+#ifdef CY_FLASH_BASE
+        if (addr >= CY_FLASH_BASE)
+        {
+            addr -= CY_FLASH_BASE;
+        }
+#endif
+    }
+    else
+    {
+        sector_size = OTA_FLASH_STATS_WEAR_SECTOR_EXTERNAL;
+#ifdef CY_XIP_BASE
+        if (addr >= CY_XIP_BASE)
+        {
+            addr -= CY_XIP_BASE;
+        }
+#endif
+    }
+
+    first = addr / sector_size;
+    last = (uint32_t)((addr + len - 1u) / sector_size);
+
+    for (sector = first; sector <= last; sector++)
+    {
+        if (sector >= OTA_FLASH_STATS_WEAR_SECTORS)
+        {
+            ota_flash_stats.wear_unmapped++;
+        }
+        else if (ota_flash_stats.wear[mem][sector] < UINT16_MAX)
+        {
+            ota_flash_stats.wear[mem][sector]++;
+        }
+    }
+}
+
+/**********************************************************************************************************************************
+ * External Functions
+ **********************************************************************************************************************************/
+/**
+ * @brief Start the cycle counter used for timing. Called by cy_ota_mem_init().
+ */
+void cy_ota_flash_stats_init(void)
+{
+#if defined (DWT_CTRL_CYCCNTENA_Msk)
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+}
+
+/**
+ * @brief Account a completed flash operation. Called by the driver with the flash lock held.
+ */
+void cy_ota_flash_stats_record_op(uint32_t start, cy_ota_mem_type_t mem_type, cy_ota_flash_op_t op,
+                                  uint32_t addr, size_t len, cy_rslt_t result)
+{
+    uint32_t us = ota_flash_stats_cycles_to_us(cy_ota_flash_stats_cycles() - start);
+    cy_ota_flash_op_stats_t *op_stats;
+
+    if (!STATS_MEM_INDEX_VALID(mem_type) || ((uint32_t)op >= CY_OTA_FLASH_OP_COUNT))
+    {
+        return;
+    }
+
+    op_stats = &ota_flash_stats.op[mem_type][op];
+    if (result != CY_RSLT_SUCCESS)
+    {
+        op_stats->errors++;
+        return;
+    }
+
+    if ((op_stats->count == 0u) || (us < op_stats->min_us))
+    {
+        op_stats->min_us = us;
+    }
+    if (us > op_stats->max_us)
+    {
+        op_stats->max_us = us;
+    }
+    op_stats->count++;
+    op_stats->bytes += len;
+    op_stats->total_us += us;
+    op_stats->hist[ota_flash_stats_bucket(us)]++;
+
+    if ((op == CY_OTA_FLASH_OP_ERASE) ||
+        ((op == CY_OTA_FLASH_OP_WRITE) && (mem_type == CY_OTA_MEM_TYPE_INTERNAL_FLASH)))
+    {
+        ota_flash_stats_wear((uint32_t)mem_type, addr, len);
+    }
+}
+
+/**
+ * @brief Account a critical section that ended now. Called by the driver after re-enabling interrupts.
+ */
+void cy_ota_flash_stats_record_cs(uint32_t start)
+{
+    uint32_t us = ota_flash_stats_cycles_to_us(cy_ota_flash_stats_cycles() - start);
+
+    ota_flash_stats.cs_count++;
+    ota_flash_stats.cs_total_us += us;
+    if (us > ota_flash_stats.cs_max_us)
+    {
+        ota_flash_stats.cs_max_us = us;
+    }
+}
+
+/**
+ * @brief Get a snapshot of the telemetry
+ */
+void cy_ota_flash_stats_get(cy_ota_flash_stats_t *stats)
+{
+    if (stats == NULL)
+    {
+        return;
+    }
+
+    cy_ota_mem_lock();
+    *stats = ota_flash_stats;
+    cy_ota_mem_unlock();
+}
+
+/**
+ * @brief Clear all counters, including the wear map
+ */
+void cy_ota_flash_stats_reset(void)
+{
+    cy_ota_mem_lock();
+    memset(&ota_flash_stats, 0, sizeof(ota_flash_stats));
+    cy_ota_mem_unlock();
+}
+
+/**
+ * @brief Latency below which the given percentage of the calls completed
+ */
+uint32_t cy_ota_flash_stats_percentile(const cy_ota_flash_op_stats_t *op_stats, uint32_t percent)
+{
+    uint32_t target;
+    uint32_t seen = 0u;
+    uint32_t bucket;
+
+    if ((op_stats == NULL) || (op_stats->count == 0u))
+    {
+        return 0u;
+    }
+
+    /* Rank of the percentile, rounded up */
+    target = (uint32_t)(((uint64_t)op_stats->count * percent + 99u) / 100u);
+
+    for (bucket = 0u; bucket < OTA_FLASH_STATS_HIST_BUCKETS; bucket++)
+    {
+        seen += op_stats->hist[bucket];
+        if (seen >= target)
+        {
+            break;
+        }
+    }
+
+    if (bucket >= (OTA_FLASH_STATS_HIST_BUCKETS - 1u))
+    {
+        return op_stats->max_us;
+    }
+
+    return CY_MIN((2u << bucket) - 1u, op_stats->max_us);
+}
+
+/**
+ * @brief Print the telemetry to the debug UART
+ */
+void cy_ota_flash_stats_print(void)
+{
+    static cy_ota_flash_stats_t snapshot;
+    uint32_t mem;
+    uint32_t op;
+    uint32_t sector;
+
+    cy_ota_flash_stats_get(&snapshot);
+
+    printf("\nFlash telemetry (latency in us):\n");
+    printf("  %-8s %-5s %8s %10s %8s %8s %8s %8s %6s\n",
+            "memory", "op", "count", "bytes", "min", "avg", "max", "p99", "errors");
+    for (mem = 0u; mem < CY_OTA_FLASH_STATS_MEM_COUNT; mem++)
+    {
+        for (op = 0u; op < CY_OTA_FLASH_OP_COUNT; op++)
+        {
+            const cy_ota_flash_op_stats_t *s = &snapshot.op[mem][op];
+
+            if ((s->count == 0u) && (s->errors == 0u))
+            {
+                continue;
+            }
+            printf("  %-8s %-5s %8lu %10lu %8lu %8lu %8lu %8lu %6lu\n",
+                    ota_flash_stats_mem_names[mem], ota_flash_stats_op_names[op],
+                    (unsigned long)s->count, (unsigned long)s->bytes,
+                    (unsigned long)s->min_us,
+                    (unsigned long)((s->count != 0u) ? (s->total_us / s->count) : 0u),
+                    (unsigned long)s->max_us,
+                    (unsigned long)cy_ota_flash_stats_percentile(s, 99u),
+                    (unsigned long)s->errors);
+        }
+    }
+
+    printf("  critical sections: %lu, total %lu us, max %lu us\n",
+            (unsigned long)snapshot.cs_count, (unsigned long)snapshot.cs_total_us,
+            (unsigned long)snapshot.cs_max_us);
+
+    for (mem = 0u; mem < CY_OTA_FLASH_STATS_MEM_COUNT; mem++)
+    {
+        uint32_t sector_size = (mem == CY_OTA_MEM_TYPE_INTERNAL_FLASH) ?
+                OTA_FLASH_STATS_WEAR_SECTOR_INTERNAL : OTA_FLASH_STATS_WEAR_SECTOR_EXTERNAL;
+
+        printf("  %s wear (erases per 0x%lx bytes):", ota_flash_stats_mem_names[mem],
+                (unsigned long)sector_size);
+        for (sector = 0u; sector < OTA_FLASH_STATS_WEAR_SECTORS; sector++)
+        {
+            if (snapshot.wear[mem][sector] != 0u)
+            {
+                printf(" [0x%lx]=%u", (unsigned long)(sector * sector_size),
+                        (unsigned int)snapshot.wear[mem][sector]);
+            }
+        }
+        printf("\n");
+    }
+    if (snapshot.wear_unmapped != 0u)
+    {
+        printf("  erases outside of the wear maps: %lu\n", (unsigned long)snapshot.wear_unmapped);
+    }
+}
+
+/**
+ * @brief Format the telemetry as a compact JSON document
+ *
+ * Operations that were never called are left out. Wear maps are arrays of
+ * erase counts, one per sector starting at offset 0, with trailing zeros
+ * trimmed.
+ */
+size_t cy_ota_flash_stats_to_json(char *buf, size_t size)
+{
+    static cy_ota_flash_stats_t snapshot;
+    size_t used = 0u;
+    uint32_t mem;
+    uint32_t op;
+    uint32_t sector;
+
+    if ((buf == NULL) || (size == 0u))
+    {
+        return 0u;
+    }
+
+    cy_ota_flash_stats_get(&snapshot);
+
+    STATS_JSON_APPEND("{");
+    for (mem = 0u; mem < CY_OTA_FLASH_STATS_MEM_COUNT; mem++)
+    {
+        const char *sep = "";
+
+        STATS_JSON_APPEND("\"%s\":{", ota_flash_stats_mem_names[mem]);
+        for (op = 0u; op < CY_OTA_FLASH_OP_COUNT; op++)
+        {
+            const cy_ota_flash_op_stats_t *s = &snapshot.op[mem][op];
+
+            if ((s->count == 0u) && (s->errors == 0u))
+            {
+                continue;
+            }
+            STATS_JSON_APPEND("%s\"%s\":{\"n\":%lu,\"bytes\":%lu,\"min\":%lu,\"avg\":%lu,\"max\":%lu,\"p99\":%lu,\"err\":%lu}",
+                    sep, ota_flash_stats_op_names[op],
+                    (unsigned long)s->count, (unsigned long)s->bytes,
+                    (unsigned long)s->min_us,
+                    (unsigned long)((s->count != 0u) ? (s->total_us / s->count) : 0u),
+                    (unsigned long)s->max_us,
+                    (unsigned long)cy_ota_flash_stats_percentile(s, 99u),
+                    (unsigned long)s->errors);
+            sep = ",";
+        }
+        STATS_JSON_APPEND("},");
+    }
+
+    STATS_JSON_APPEND("\"wear\":{");
+    for (mem = 0u; mem < CY_OTA_FLASH_STATS_MEM_COUNT; mem++)
+    {
+        uint32_t count = OTA_FLASH_STATS_WEAR_SECTORS;
+
+        while ((count > 0u) && (snapshot.wear[mem][count - 1u] == 0u))
+        {
+            count--;
+        }
+
+        STATS_JSON_APPEND("%s\"%s\":{\"sector\":%lu,\"erases\":[", (mem == 0u) ? "" : ",",
+                ota_flash_stats_mem_names[mem],
+                (unsigned long)((mem == CY_OTA_MEM_TYPE_INTERNAL_FLASH) ?
+                        OTA_FLASH_STATS_WEAR_SECTOR_INTERNAL : OTA_FLASH_STATS_WEAR_SECTOR_EXTERNAL));
+        for (sector = 0u; sector < count; sector++)
+        {
+            STATS_JSON_APPEND("%s%u", (sector == 0u) ? "" : ",", (unsigned int)snapshot.wear[mem][sector]);
+        }
+        STATS_JSON_APPEND("]}");
+    }
+    STATS_JSON_APPEND("},\"unmapped\":%lu,", (unsigned long)snapshot.wear_unmapped);
+
+    STATS_JSON_APPEND("\"cs\":{\"n\":%lu,\"total\":%lu,\"max\":%lu}}",
+            (unsigned long)snapshot.cs_count, (unsigned long)snapshot.cs_total_us,
+            (unsigned long)snapshot.cs_max_us);
+
+    return used;
+}
+
+#endif /* OTA_FLASH_STATS_ENABLE */
@@ -0,0 +1,225 @@
+/******************************************************************************
+* File Name:   cy_ota_flash_stats.h
+*
+* Description: This file contains the configuration and API of the flash driver
+*              telemetry: per-operation latency and byte counters, the erase
+*              wear map and critical-section time
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef CY_OTA_FLASH_STATS_H_
+#define CY_OTA_FLASH_STATS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "cy_pdl.h"
+#include "cy_ota_flash.h"
+
+/**********************************************************************************************************************************
+ * Configuration
+ **********************************************************************************************************************************/
+/**
+ * Number of latency histogram buckets. Bucket 0 counts operations shorter than
+ * 2 us, bucket n operations of 2^n to 2^(n+1) - 1 us. The last bucket also
+ * counts everything longer.
+ */
+#ifndef OTA_FLASH_STATS_HIST_BUCKETS
+#define OTA_FLASH_STATS_HIST_BUCKETS                (24u)
+#endif
+
+/**
+ * Number of sectors in each wear map. Erases outside of the mapped range are
+ * only counted in wear_unmapped.
+ */
+#ifndef OTA_FLASH_STATS_WEAR_SECTORS
+#define OTA_FLASH_STATS_WEAR_SECTORS                (64u)
+#endif
+
+/**
+ * Size of a wear map sector for the internal flash. Internal row writes erase
+ * the row, so they are counted as erases as well.
+ */
+#ifndef OTA_FLASH_STATS_WEAR_SECTOR_INTERNAL
+#define OTA_FLASH_STATS_WEAR_SECTOR_INTERNAL        (0x8000u)
+#endif
+
+/* Size of a wear map sector for the external flash */
+#ifndef OTA_FLASH_STATS_WEAR_SECTOR_EXTERNAL
+#define OTA_FLASH_STATS_WEAR_SECTOR_EXTERNAL        (0x40000u)
+#endif
+
+/**********************************************************************************************************************************
+ * Types
+ **********************************************************************************************************************************/
+typedef enum
+{
+    CY_OTA_FLASH_OP_READ = 0,
+    CY_OTA_FLASH_OP_WRITE,
+    CY_OTA_FLASH_OP_ERASE,
+
+    CY_OTA_FLASH_OP_COUNT
+} cy_ota_flash_op_t;
+
+/* Internal and external flash */
+#define CY_OTA_FLASH_STATS_MEM_COUNT                (2u)
+
+/**
+ * @brief Counters of one operation on one memory type
+ */
+typedef struct cy_ota_flash_op_stats_s
+{
+    uint32_t    count;              /**< Completed calls                                     */
+    uint32_t    errors;             /**< Calls that returned an error                        */
+    uint64_t    bytes;              /**< Bytes read, written or erased                       */
+    uint64_t    total_us;           /**< Sum of the latencies                                */
+    uint32_t    min_us;             /**< Shortest call                                       */
+    uint32_t    max_us;             /**< Longest call                                        */
+    uint32_t    hist[OTA_FLASH_STATS_HIST_BUCKETS]; /**< Log2 latency histogram              */
+} cy_ota_flash_op_stats_t;
+
+/**
+ * @brief Flash driver telemetry since boot or the last cy_ota_flash_stats_reset()
+ */
+typedef struct cy_ota_flash_stats_s
+{
+    cy_ota_flash_op_stats_t op[CY_OTA_FLASH_STATS_MEM_COUNT][CY_OTA_FLASH_OP_COUNT]; /**< Indexed by cy_ota_mem_type_t and cy_ota_flash_op_t */
+
+    uint16_t    wear[CY_OTA_FLASH_STATS_MEM_COUNT][OTA_FLASH_STATS_WEAR_SECTORS];  /**< Erases per sector, saturating */
+    uint32_t    wear_unmapped;      /**< Sector erases outside of the wear maps              */
+
+    uint32_t    cs_count;           /**< Critical sections entered by the driver             */
+    uint64_t    cs_total_us;        /**< Time spent with interrupts disabled                 */
+    uint32_t    cs_max_us;          /**< Longest critical section                            */
+} cy_ota_flash_stats_t;
+
+/**********************************************************************************************************************************
+ * Driver hooks
+ **********************************************************************************************************************************/
+#ifdef OTA_FLASH_STATS_ENABLE
+/* Start timing; declares the timestamp variable */
+#define OTA_FLASH_STATS_START(ts)                       uint32_t ts = cy_ota_flash_stats_cycles()
+#define OTA_FLASH_STATS_OP(ts, mem, op, addr, len, res) cy_ota_flash_stats_record_op((ts), (mem), (op), (addr), (len), (res))
+#define OTA_FLASH_STATS_CS(ts)                          cy_ota_flash_stats_record_cs(ts)
+#else
+#define OTA_FLASH_STATS_START(ts)
+#define OTA_FLASH_STATS_OP(ts, mem, op, addr, len, res)
+#define OTA_FLASH_STATS_CS(ts)
+#endif
+
+/**********************************************************************************************************************************
+ * Functions
+ **********************************************************************************************************************************/
+/**
+ * @brief Start the cycle counter used for timing. Called by cy_ota_mem_init().
+ */
+void cy_ota_flash_stats_init(void);
+
+/**
+ * @brief Current value of the cycle counter
+ *
+ * Inline so that it can be used while XIP is turned off.
+ */
+__STATIC_FORCEINLINE uint32_t cy_ota_flash_stats_cycles(void)
+{
+#if defined (DWT_CTRL_CYCCNTENA_Msk)
+    return DWT->CYCCNT;
+#else
+    return 0u;
+#endif
+}
+
+/**
+ * @brief Account a completed flash operation. Called by the driver with the flash lock held.
+ *
+ * @param[in]   start       cy_ota_flash_stats_cycles() at the start of the operation
+ * @param[in]   mem_type    Memory type @ref cy_ota_mem_type_t
+ * @param[in]   op          Operation @ref cy_ota_flash_op_t
+ * @param[in]   addr        Address passed to the driver
+ * @param[in]   len         Length passed to the driver
+ * @param[in]   result      Result of the operation
+ */
+void cy_ota_flash_stats_record_op(uint32_t start, cy_ota_mem_type_t mem_type, cy_ota_flash_op_t op,
+                                  uint32_t addr, size_t len, cy_rslt_t result);
+
+/**
+ * @brief Account a critical section that ended now. Called by the driver after re-enabling interrupts.
+ *
+ * @param[in]   start       cy_ota_flash_stats_cycles() right after interrupts were disabled
+ */
+void cy_ota_flash_stats_record_cs(uint32_t start);
+
+/**
+ * @brief Get a snapshot of the telemetry
+ *
+ * @param[out]  stats   Flash driver telemetry
+ */
+void cy_ota_flash_stats_get(cy_ota_flash_stats_t *stats);
+
+/**
+ * @brief Clear all counters, including the wear map
+ */
+void cy_ota_flash_stats_reset(void);
+
+/**
+ * @brief Latency below which the given percentage of the calls completed
+ *
+ * Resolved to the upper bound of the histogram bucket, capped at max_us.
+ *
+ * @param[in]   op_stats    Counters of one operation
+ * @param[in]   percent     Percentile, 1 to 100
+ *
+ * @return  Latency in microseconds, 0 if there were no calls
+ */
+uint32_t cy_ota_flash_stats_percentile(const cy_ota_flash_op_stats_t *op_stats, uint32_t percent);
+
+/**
+ * @brief Print the telemetry to the debug UART
+ */
+void cy_ota_flash_stats_print(void);
+
+/**
+ * @brief Format the telemetry as a compact JSON document, e.g. for an MQTT publish
+ *
+ * @param[out]  buf     Output buffer
+ * @param[in]   size    Size of the output buffer
+ *
+ * @return  Length of the document, 0 if it did not fit
+ */
+size_t cy_ota_flash_stats_to_json(char *buf, size_t size);
+
+#endif /* CY_OTA_FLASH_STATS_H_ */
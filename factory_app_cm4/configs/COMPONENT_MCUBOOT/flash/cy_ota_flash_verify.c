@@ -0,0 +1,348 @@
+/******************************************************************************
+* File Name:   cy_ota_flash_verify.c
+*
+* Description: This file contains the background read-back verification of external
+*              flash writes. Every page written is recorded with its CRC32, and a low
+*              priority task reads the pages back in large batched reads and compares
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifdef OTA_FLASH_VERIFY_ENABLE
+
+/* Header file includes */
+#include <stdio.h>
+#include <string.h>
+#include "cy_pdl.h"
+#include "cy_ota_flash.h"
+#include "cy_ota_flash_lock.h"
+#include "cy_ota_flash_verify.h"
+#include "cy_ota_crc32.h"
+
+/* FreeRTOS */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/**********************************************************************************************************************************
+ * local defines
+ **********************************************************************************************************************************/
+#define VERIFY_RING_INDEX(n)                ((ota_verify_head + (n)) % OTA_FLASH_VERIFY_QUEUE_LEN)
+
+/**********************************************************************************************************************************
+ * local variables & data
+ **********************************************************************************************************************************/
+/* One page write waiting for verification. len == 0 marks a discarded entry. */
+typedef struct ota_verify_entry_s
+{
+    uint32_t    addr;
+    uint32_t    len;
+    uint32_t    crc;
+} ota_verify_entry_t;
+
+/* Everything below is protected by the flash lock */
+static ota_verify_entry_t   ota_verify_ring[OTA_FLASH_VERIFY_QUEUE_LEN];
+static uint32_t             ota_verify_head;
+static uint32_t             ota_verify_count;
+static uint32_t             ota_verify_pending_bytes;
+static cy_ota_flash_verify_stats_t ota_verify_stats;
+
+/* Read-back buffer, shared by the verify task and inline drains */
+static uint8_t              ota_verify_buf[OTA_FLASH_VERIFY_READ_SIZE];
+
+static TaskHandle_t         ota_verify_task_handle;
+static StaticTask_t         ota_verify_task_tcb;
+static StackType_t          ota_verify_task_stack[OTA_FLASH_VERIFY_TASK_STACK_SIZE];
+
+/**********************************************************************************************************************************
+ * Internal Functions
+ **********************************************************************************************************************************/
+/*******************************************************************************
+* Function Name: ota_flash_verify_drain
+****************************************************************************//**
+*
+* Verifies every pending page. Contiguous pages are read back with a single
+* read of up to OTA_FLASH_VERIFY_READ_SIZE bytes. Must be called with the flash
+* lock held, which also keeps writes to the pages out while they are checked.
+*
+*******************************************************************************/
+static void ota_flash_verify_drain(void)
+{
+    while (ota_verify_count > 0u)
+    {
+        ota_verify_entry_t *first = &ota_verify_ring[ota_verify_head];
+        uint32_t span_len = 0u;
+        uint32_t num = 0u;
+        uint32_t idx;
+
+        if (first->len == 0u)
+        {
+            /* discarded by an erase */
+            ota_verify_head = VERIFY_RING_INDEX(1u);
+            ota_verify_count--;
+            continue;
+        }
+
+        /* Collect the contiguous run of pages starting at the head */
+        while (num < ota_verify_count)
+        {
+            ota_verify_entry_t *entry = &ota_verify_ring[VERIFY_RING_INDEX(num)];
+
+            if ((entry->len == 0u) ||
+                (entry->addr != (first->addr + span_len)) ||
+                ((span_len + entry->len) > sizeof(ota_verify_buf)))
+            {
+                break;
+            }
+            span_len += entry->len;
+            num++;
+        }
+
+        ota_verify_stats.reads++;
+        if (cy_ota_mem_read(CY_OTA_MEM_TYPE_EXTERNAL_FLASH, first->addr, ota_verify_buf, span_len) != CY_RSLT_SUCCESS)
+        {
+            ota_verify_stats.read_errors++;
+            printf("[Verify] Read-back failed at offset 0x%08lx (%lu bytes)\n",
+                    (unsigned long)first->addr, (unsigned long)span_len);
+        }
+        else
+        {
+            uint32_t buf_offset = 0u;
+
+            for (idx = 0u; idx < num; idx++)
+            {
+                ota_verify_entry_t *entry = &ota_verify_ring[VERIFY_RING_INDEX(idx)];
+
+                if (cy_ota_crc32(CY_OTA_CRC32_INIT, &ota_verify_buf[buf_offset], entry->len) != entry->crc)
+                {
+                    if (ota_verify_stats.mismatches == 0u)
+                    {
+                        ota_verify_stats.first_mismatch = entry->addr;
+                    }
+                    ota_verify_stats.last_mismatch = entry->addr;
+                    ota_verify_stats.mismatches++;
+                    printf("[Verify] Mismatch at offset 0x%08lx (%lu bytes)\n",
+                            (unsigned long)entry->addr, (unsigned long)entry->len);
+                }
+                ota_verify_stats.pages_verified++;
+                buf_offset += entry->len;
+            }
+            ota_verify_stats.bytes_verified += span_len;
+        }
+
+        ota_verify_head = VERIFY_RING_INDEX(num);
+        ota_verify_count -= num;
+        ota_verify_pending_bytes -= span_len;
+    }
+}
+
+/*******************************************************************************
+* Function Name: ota_flash_verify_task
+****************************************************************************//**
+*
+* Waits until a batch of pages is pending, or until the writer has been idle
+* for a while, and verifies everything pending.
+*
+* \param args
+* Task parameter defined during task creation (unused)
+*
+*******************************************************************************/
+static void ota_flash_verify_task(void *args)
+{
+    (void)args;
+
+    while (true)
+    {
+        (void)ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(OTA_FLASH_VERIFY_IDLE_MS));
+
+        cy_ota_mem_lock();
+        ota_flash_verify_drain();
+        cy_ota_mem_unlock();
+    }
+}
+
+/**********************************************************************************************************************************
+ * External Functions
+ **********************************************************************************************************************************/
+cy_rslt_t cy_ota_flash_verify_init(void)
+{
+    if (ota_verify_task_handle != NULL)
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    ota_verify_task_handle = xTaskCreateStatic(ota_flash_verify_task, "FLASH VERIFY", OTA_FLASH_VERIFY_TASK_STACK_SIZE,
+                                               NULL, OTA_FLASH_VERIFY_TASK_PRIORITY, ota_verify_task_stack,
+                                               &ota_verify_task_tcb);
+    if (ota_verify_task_handle == NULL)
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+void cy_ota_flash_verify_record(uint32_t addr, const uint8_t *data, size_t len)
+{
+    uint32_t crc;
+    uint32_t idx;
+
+    if (len == 0u)
+    {
+        return;
+    }
+
+    if (len > sizeof(ota_verify_buf))
+    {
+        /* Reported by cy_ota_flash_verify_flush() */
+        ota_verify_stats.skipped++;
+        return;
+    }
+
+    crc = cy_ota_crc32(CY_OTA_CRC32_INIT, data, len);
+
+    for (idx = 0u; idx < ota_verify_count; idx++)
+    {
+        ota_verify_entry_t *entry = &ota_verify_ring[VERIFY_RING_INDEX(idx)];
+
+        if ((entry->len == 0u) || ((addr + len) <= entry->addr) || ((entry->addr + entry->len) <= addr))
+        {
+            continue;
+        }
+
+        if ((entry->addr == addr) && (entry->len == len))
+        {
+            /* Same page rewritten (partial row update) before it was verified */
+            entry->crc = crc;
+            return;
+        }
+
+        /* Partially overlapping rewrite, check what is pending before it changes */
+        ota_verify_stats.inline_drains++;
+        ota_flash_verify_drain();
+        break;
+    }
+
+    if (ota_verify_count == OTA_FLASH_VERIFY_QUEUE_LEN)
+    {
+        ota_verify_stats.inline_drains++;
+        ota_flash_verify_drain();
+    }
+
+    ota_verify_ring[VERIFY_RING_INDEX(ota_verify_count)].addr = addr;
+    ota_verify_ring[VERIFY_RING_INDEX(ota_verify_count)].len  = len;
+    ota_verify_ring[VERIFY_RING_INDEX(ota_verify_count)].crc  = crc;
+    ota_verify_count++;
+    ota_verify_pending_bytes += len;
+    ota_verify_stats.pages_recorded++;
+
+    if ((ota_verify_pending_bytes >= OTA_FLASH_VERIFY_BATCH_BYTES) && (ota_verify_task_handle != NULL))
+    {
+        xTaskNotifyGive(ota_verify_task_handle);
+    }
+}
+
+void cy_ota_flash_verify_discard(uint32_t addr, size_t len)
+{
+    uint32_t idx;
+
+    for (idx = 0u; idx < ota_verify_count; idx++)
+    {
+        ota_verify_entry_t *entry = &ota_verify_ring[VERIFY_RING_INDEX(idx)];
+
+        if ((entry->len != 0u) && ((addr + len) > entry->addr) && ((entry->addr + entry->len) > addr))
+        {
+            ota_verify_pending_bytes -= entry->len;
+            entry->len = 0u;
+        }
+    }
+}
+
+cy_rslt_t cy_ota_flash_verify_flush(void)
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+
+    cy_ota_mem_lock();
+
+    ota_flash_verify_drain();
+
+    if (ota_verify_stats.skipped != 0u)
+    {
+        printf("[Verify] %lu writes larger than %u bytes were not checked\n",
+                (unsigned long)ota_verify_stats.skipped, (unsigned int)OTA_FLASH_VERIFY_READ_SIZE);
+    }
+
+    if ((ota_verify_stats.mismatches != 0u) || (ota_verify_stats.read_errors != 0u))
+    {
+        printf("[Verify] FAILED: %lu of %lu pages mismatched (first at 0x%08lx, last at 0x%08lx), %lu read errors\n",
+                (unsigned long)ota_verify_stats.mismatches,
+                (unsigned long)ota_verify_stats.pages_verified,
+                (unsigned long)ota_verify_stats.first_mismatch,
+                (unsigned long)ota_verify_stats.last_mismatch,
+                (unsigned long)ota_verify_stats.read_errors);
+        result = CY_RSLT_TYPE_ERROR;
+    }
+
+    cy_ota_mem_unlock();
+
+    return result;
+}
+
+void cy_ota_flash_verify_reset(void)
+{
+    cy_ota_mem_lock();
+
+    ota_verify_head = 0u;
+    ota_verify_count = 0u;
+    ota_verify_pending_bytes = 0u;
+    memset(&ota_verify_stats, 0, sizeof(ota_verify_stats));
+
+    cy_ota_mem_unlock();
+}
+
+void cy_ota_flash_verify_get_stats(cy_ota_flash_verify_stats_t *stats)
+{
+    if (stats == NULL)
+    {
+        return;
+    }
+
+    cy_ota_mem_lock();
+    *stats = ota_verify_stats;
+    cy_ota_mem_unlock();
+}
+
+#endif /* OTA_FLASH_VERIFY_ENABLE */
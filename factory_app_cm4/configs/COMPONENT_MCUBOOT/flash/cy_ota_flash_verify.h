@@ -0,0 +1,170 @@
+/******************************************************************************
+* File Name:   cy_ota_flash_verify.h
+*
+* Description: This file contains the configuration and API of the background
+*              read-back verification of external flash writes
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef CY_OTA_FLASH_VERIFY_H_
+#define CY_OTA_FLASH_VERIFY_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "cy_pdl.h"
+
+/**********************************************************************************************************************************
+ * Configuration
+ **********************************************************************************************************************************/
+/**
+ * Number of written pages that can wait for verification. When the queue is
+ * full, the writing task verifies the backlog itself before it continues.
+ */
+#ifndef OTA_FLASH_VERIFY_QUEUE_LEN
+#define OTA_FLASH_VERIFY_QUEUE_LEN                  (32u)
+#endif
+
+/**
+ * Size of a single read-back. Contiguous pages are read back together in one
+ * read of up to this many bytes.
+ */
+#ifndef OTA_FLASH_VERIFY_READ_SIZE
+#define OTA_FLASH_VERIFY_READ_SIZE                  (4096u)
+#endif
+
+/**
+ * The verify task waits for this many pending bytes before it reads back, so
+ * that reads are large. Pending pages are verified anyway once the writer has
+ * been idle for OTA_FLASH_VERIFY_IDLE_MS.
+ */
+#ifndef OTA_FLASH_VERIFY_BATCH_BYTES
+#define OTA_FLASH_VERIFY_BATCH_BYTES                (OTA_FLASH_VERIFY_READ_SIZE)
+#endif
+
+#ifndef OTA_FLASH_VERIFY_IDLE_MS
+#define OTA_FLASH_VERIFY_IDLE_MS                    (100u)
+#endif
+
+/* Verify task configuration. Runs below the OTA task so it only uses idle time. */
+#ifndef OTA_FLASH_VERIFY_TASK_STACK_SIZE
+#define OTA_FLASH_VERIFY_TASK_STACK_SIZE            (configMINIMAL_STACK_SIZE * 4)
+#endif
+
+#ifndef OTA_FLASH_VERIFY_TASK_PRIORITY
+#define OTA_FLASH_VERIFY_TASK_PRIORITY              (tskIDLE_PRIORITY + 1)
+#endif
+
+/**********************************************************************************************************************************
+ * Types
+ **********************************************************************************************************************************/
+/**
+ * @brief Read-back verification results since the last cy_ota_flash_verify_reset()
+ */
+typedef struct cy_ota_flash_verify_stats_s
+{
+    uint32_t    pages_recorded;     /**< Page writes queued for verification                 */
+    uint32_t    pages_verified;     /**< Page writes read back and checked                   */
+    uint32_t    bytes_verified;     /**< Bytes read back and checked                         */
+    uint32_t    reads;              /**< Number of read-back operations                      */
+    uint32_t    inline_drains;      /**< Times the writer had to verify a full queue itself  */
+    uint32_t    read_errors;        /**< Read-backs that failed                              */
+    uint32_t    mismatches;         /**< Pages whose read-back CRC did not match             */
+    uint32_t    first_mismatch;     /**< Flash offset of the first mismatching page          */
+    uint32_t    last_mismatch;      /**< Flash offset of the last mismatching page           */
+    uint32_t    skipped;            /**< Writes too large to be read back, not checked       */
+} cy_ota_flash_verify_stats_t;
+
+/**********************************************************************************************************************************
+ * Functions
+ **********************************************************************************************************************************/
+/**
+ * @brief Create the verify task. Called by cy_ota_mem_init().
+ *
+ * @return  CY_RSLT_SUCCESS on success
+ *          CY_RSLT_TYPE_ERROR on failure
+ */
+cy_rslt_t cy_ota_flash_verify_init(void);
+
+/**
+ * @brief Queue a completed external flash page write for verification
+ *
+ * Called by the flash driver with the flash lock held, right after a write.
+ * The CRC is computed over the bytes actually sent to the flash, i.e. the
+ * encrypted data when on-the-fly encryption is used, so the read-back never
+ * needs to be decrypted.
+ *
+ * A write larger than OTA_FLASH_VERIFY_READ_SIZE cannot be read back in one
+ * piece; it is counted in cy_ota_flash_verify_stats_t::skipped instead.
+ *
+ * @param[in]   addr    Flash offset of the write.
+ * @param[in]   data    Data written to the flash.
+ * @param[in]   len     Number of bytes written.
+ */
+void cy_ota_flash_verify_record(uint32_t addr, const uint8_t *data, size_t len);
+
+/**
+ * @brief Drop pending pages that overlap an erased range
+ *
+ * Called by the flash driver with the flash lock held, before an erase.
+ *
+ * @param[in]   addr    Flash offset of the erase.
+ * @param[in]   len     Number of bytes erased.
+ */
+void cy_ota_flash_verify_discard(uint32_t addr, size_t len);
+
+/**
+ * @brief Verify everything still pending in the calling task and report the result
+ *
+ * @return  CY_RSLT_SUCCESS if every page written since the last reset verified
+ *          CY_RSLT_TYPE_ERROR on mismatch or read error
+ */
+cy_rslt_t cy_ota_flash_verify_flush(void);
+
+/**
+ * @brief Discard pending pages and clear the statistics. Call at the start of a download.
+ */
+void cy_ota_flash_verify_reset(void);
+
+/**
+ * @brief Get a snapshot of the verification statistics
+ *
+ * @param[out]  stats   Verification statistics
+ */
+void cy_ota_flash_verify_get_stats(cy_ota_flash_verify_stats_t *stats);
+
+#endif /* CY_OTA_FLASH_VERIFY_H_ */
@@ -0,0 +1,276 @@
+/******************************************************************************
+* File Name:   cy_ota_range.c
+*
+* Description: This file contains the range tracker that records which units
+*              of the secondary slot have been written, for chunks arriving in any order
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/* Header file includes */
+#include <string.h>
+#include "cy_ota_range.h"
+
+/**********************************************************************************************************************************
+ * local functions
+ **********************************************************************************************************************************/
+static inline bool cy_ota_range_test(const cy_ota_range_t *range, uint32_t idx)
+{
+    return (range->bits[idx / 32u] & (1uL << (idx % 32u))) != 0u;
+}
+
+static inline uint32_t cy_ota_range_popcount(uint32_t word)
+{
+    word = word - ((word >> 1) & 0x55555555u);
+    word = (word & 0x33333333u) + ((word >> 2) & 0x33333333u);
+    return (((word + (word >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24;
+}
+
+/**********************************************************************************************************************************
+ * External Functions
+ **********************************************************************************************************************************/
+void cy_ota_range_init(cy_ota_range_t *range, uint32_t *bits, uint32_t max_units)
+{
+    memset(range, 0, sizeof(*range));
+    range->bits = bits;
+    range->max_units = max_units;
+    memset(bits, 0, CY_OTA_RANGE_WORDS(max_units) * sizeof(uint32_t));
+}
+
+bool cy_ota_range_reset(cy_ota_range_t *range, uint32_t unit, uint32_t total_size)
+{
+    uint32_t units = (unit != 0u) ? ((total_size + unit - 1u) / unit) : 0u;
+
+    memset(range->bits, 0, CY_OTA_RANGE_WORDS(range->max_units) * sizeof(uint32_t));
+    range->count = 0;
+    range->run_start = 0;
+    range->run_end = 0;
+
+    if ((unit == 0u) || (units > range->max_units))
+    {
+        range->unit = 0;
+        range->total_size = 0;
+        range->units = 0;
+        return false;
+    }
+
+    range->unit = unit;
+    range->total_size = total_size;
+    range->units = units;
+    return true;
+}
+
+void cy_ota_range_sync(cy_ota_range_t *range)
+{
+    uint32_t words = CY_OTA_RANGE_WORDS(range->max_units);
+    uint32_t i;
+
+    /* Clear everything beyond the last unit of the image */
+    for (i = range->units; (i % 32u) != 0u; i++)
+    {
+        range->bits[i / 32u] &= ~(1uL << (i % 32u));
+    }
+    for (i = CY_OTA_RANGE_WORDS(range->units); i < words; i++)
+    {
+        range->bits[i] = 0;
+    }
+
+    range->count = 0;
+    for (i = 0; i < CY_OTA_RANGE_WORDS(range->units); i++)
+    {
+        range->count += cy_ota_range_popcount(range->bits[i]);
+    }
+}
+
+bool cy_ota_range_copy(cy_ota_range_t *dst, const cy_ota_range_t *src)
+{
+    if (!cy_ota_range_reset(dst, src->unit, src->total_size))
+    {
+        return false;
+    }
+
+    memcpy(dst->bits, src->bits, CY_OTA_RANGE_WORDS(src->units) * sizeof(uint32_t));
+    dst->count = src->count;
+    return true;
+}
+
+uint32_t cy_ota_range_add(cy_ota_range_t *range, uint32_t offset, uint32_t len)
+{
+    uint32_t start = offset;
+    uint32_t end;
+    uint32_t first;
+    uint32_t last;
+    uint32_t added = 0;
+    uint32_t idx;
+
+    if ((range->total_size == 0u) || (len == 0u) || (offset >= range->total_size))
+    {
+        return 0;
+    }
+
+    end = ((len > (range->total_size - offset)) ? range->total_size : (offset + len));
+
+    /* Continue the previous range if this one follows it directly */
+    if ((offset != 0u) && (offset == range->run_end))
+    {
+        start = range->run_start;
+    }
+    range->run_start = start;
+    range->run_end = end;
+
+    first = (start + range->unit - 1u) / range->unit;
+    last = (end == range->total_size) ? range->units : (end / range->unit);
+
+    for (idx = first; idx < last; idx++)
+    {
+        if (!cy_ota_range_test(range, idx))
+        {
+            range->bits[idx / 32u] |= (1uL << (idx % 32u));
+            added++;
+        }
+    }
+
+    range->count += added;
+    return added;
+}
+
+void cy_ota_range_remove(cy_ota_range_t *range, uint32_t offset, uint32_t len)
+{
+    uint32_t first;
+    uint32_t last;
+    uint32_t idx;
+
+    if ((range->total_size == 0u) || (len == 0u) || (offset >= range->total_size))
+    {
+        return;
+    }
+
+    first = offset / range->unit;
+    last = ((len > (range->total_size - offset)) ? range->units : ((offset + len + range->unit - 1u) / range->unit));
+
+    /* A removed unit breaks the run of back to back ranges */
+    range->run_start = 0;
+    range->run_end = 0;
+
+    for (idx = first; idx < last; idx++)
+    {
+        if (cy_ota_range_test(range, idx))
+        {
+            range->bits[idx / 32u] &= ~(1uL << (idx % 32u));
+            range->count--;
+        }
+    }
+}
+
+bool cy_ota_range_contains(const cy_ota_range_t *range, uint32_t offset, uint32_t len)
+{
+    uint32_t first;
+    uint32_t last;
+    uint32_t idx;
+
+    if ((range->total_size == 0u) || (len == 0u) || (offset >= range->total_size) ||
+        (len > (range->total_size - offset)))
+    {
+        return false;
+    }
+
+    first = offset / range->unit;
+    last = (offset + len + range->unit - 1u) / range->unit;
+
+    for (idx = first; idx < last; idx++)
+    {
+        if (!cy_ota_range_test(range, idx))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool cy_ota_range_complete(const cy_ota_range_t *range)
+{
+    return (range->total_size != 0u) && (range->count == range->units);
+}
+
+bool cy_ota_range_next_gap(const cy_ota_range_t *range, uint32_t from, uint32_t *gap_offset, uint32_t *gap_len)
+{
+    uint32_t idx;
+    uint32_t end;
+
+    if ((range->total_size == 0u) || (from >= range->total_size))
+    {
+        return false;
+    }
+
+    /* First unit not written */
+    idx = from / range->unit;
+    while (idx < range->units)
+    {
+        if (((idx % 32u) == 0u) && (range->bits[idx / 32u] == 0xFFFFFFFFu))
+        {
+            idx += 32u;
+        }
+        else if (cy_ota_range_test(range, idx))
+        {
+            idx++;
+        }
+        else
+        {
+            break;
+        }
+    }
+    if (idx >= range->units)
+    {
+        return false;
+    }
+
+    /* First unit written after it */
+    end = idx + 1u;
+    while ((end < range->units) && !cy_ota_range_test(range, end))
+    {
+        end = (((end % 32u) == 0u) && (range->bits[end / 32u] == 0u)) ? (end + 32u) : (end + 1u);
+    }
+    if (end > range->units)
+    {
+        end = range->units;
+    }
+
+    *gap_offset = idx * range->unit;
+    *gap_len = ((end == range->units) ? range->total_size : (end * range->unit)) - *gap_offset;
+    return true;
+}
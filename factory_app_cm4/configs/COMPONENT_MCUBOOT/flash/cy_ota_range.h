@@ -0,0 +1,160 @@
+/******************************************************************************
+* File Name:   cy_ota_range.h
+*
+* Description: This file contains the range tracker that records which units
+*              of the secondary slot have been written, for chunks arriving in any order
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef CY_OTA_RANGE_H_
+#define CY_OTA_RANGE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/**********************************************************************************************************************************
+ * Configuration
+ **********************************************************************************************************************************/
+/**
+ * Number of uint32_t words of bitmap storage needed to track max_units units.
+ */
+#define CY_OTA_RANGE_WORDS(max_units)               (((max_units) + 31u) / 32u)
+
+/**********************************************************************************************************************************
+ * Types
+ **********************************************************************************************************************************/
+/**
+ * @brief Set of written ranges of an image
+ *
+ * The image is divided into units of a fixed, page aligned size, one bit per
+ * unit. The bitmap storage belongs to the caller, so a tracker can work
+ * directly on persisted data. A unit is marked only when it has been written
+ * completely, by one range or by ranges added back to back. The last unit of
+ * the image may be short.
+ */
+typedef struct cy_ota_range_s
+{
+    uint32_t    *bits;          /**< Bit n set - unit n has been written            */
+    uint32_t    max_units;      /**< Capacity of bits                               */
+    uint32_t    unit;           /**< Size of a unit in bytes                        */
+    uint32_t    total_size;     /**< Image size in bytes, 0 if not known yet        */
+    uint32_t    units;          /**< Units of the image                             */
+    uint32_t    count;          /**< Units written                                  */
+    uint32_t    run_start;      /**< Start of the ranges added back to back         */
+    uint32_t    run_end;        /**< End of the last range added                    */
+} cy_ota_range_t;
+
+/**********************************************************************************************************************************
+ * Functions
+ **********************************************************************************************************************************/
+/**
+ * @brief Attach bitmap storage to a tracker. The tracker is empty until
+ *        cy_ota_range_reset() sets the image size.
+ *
+ * @param[out]  range       Tracker
+ * @param[in]   bits        CY_OTA_RANGE_WORDS(max_units) words of storage
+ * @param[in]   max_units   Largest number of units to track
+ */
+void cy_ota_range_init(cy_ota_range_t *range, uint32_t *bits, uint32_t max_units);
+
+/**
+ * @brief Start tracking an image, nothing written
+ *
+ * @param[in]   range       Tracker
+ * @param[in]   unit        Unit size in bytes
+ * @param[in]   total_size  Image size in bytes
+ *
+ * @return  false if the image needs more units than the tracker has
+ */
+bool cy_ota_range_reset(cy_ota_range_t *range, uint32_t unit, uint32_t total_size);
+
+/**
+ * @brief Recount the written units after the bitmap storage was changed
+ *        directly, e.g. loaded from flash. Bits beyond the image are cleared.
+ */
+void cy_ota_range_sync(cy_ota_range_t *range);
+
+/**
+ * @brief Copy the written units of src to dst. Both must use the same unit.
+ *
+ * @return  false if dst cannot hold the image of src
+ */
+bool cy_ota_range_copy(cy_ota_range_t *dst, const cy_ota_range_t *src);
+
+/**
+ * @brief Mark the units completely covered by [offset, offset + len) as
+ *        written. A range that starts where the previous one ended continues
+ *        it, so units split across chunks are marked too. The last unit of the
+ *        image counts as covered when the range reaches the end of the image.
+ *
+ * @return  Number of units that were not marked before
+ */
+uint32_t cy_ota_range_add(cy_ota_range_t *range, uint32_t offset, uint32_t len);
+
+/**
+ * @brief Remove [offset, offset + len) from the written units, e.g. after the
+ *        flash has been erased. Every unit touched by the range is removed.
+ */
+void cy_ota_range_remove(cy_ota_range_t *range, uint32_t offset, uint32_t len);
+
+/**
+ * @brief Check whether every unit touched by [offset, offset + len) has been
+ *        written, so writing the range again would only repeat it.
+ */
+bool cy_ota_range_contains(const cy_ota_range_t *range, uint32_t offset, uint32_t len);
+
+/**
+ * @brief Check whether the whole image has been written. Constant time.
+ */
+bool cy_ota_range_complete(const cy_ota_range_t *range);
+
+/**
+ * @brief Find the first range at or after from that has not been written.
+ *        Written words of the bitmap are skipped 32 units at a time.
+ *
+ * @param[in]   range       Tracker
+ * @param[in]   from        Image offset to start at
+ * @param[out]  gap_offset  Start of the gap, unit aligned
+ * @param[out]  gap_len     Length of the gap, clipped to the image
+ *
+ * @return  false if there is no gap at or after from
+ */
+bool cy_ota_range_next_gap(const cy_ota_range_t *range, uint32_t from, uint32_t *gap_offset, uint32_t *gap_len);
+
+#endif /* CY_OTA_RANGE_H_ */
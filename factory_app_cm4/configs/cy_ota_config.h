@@ -55,21 +55,35 @@ extern "C" {
  *
  * This is used to start the timer for the initial OTA update check after calling cy_ota_agent_start().
  */
+#ifdef OTA_POLL_ENABLE
+/* The checks are started by the OTA poll scheduler of the factory app
+ * (source/ota_poll.c), the timers of the agent are only a daily fallback */
+#define CY_OTA_INITIAL_CHECK_SECS           (24 * 60 * 60)  /* 1 day */
+#else
 #define CY_OTA_INITIAL_CHECK_SECS           (10)            /* 10 seconds */
+#endif
 
 /**
  * @brief Next time for checking for OTA updates
  *
  * This is used to re-start the timer after an OTA update check in the OTA Agent.
  */
+#ifdef OTA_POLL_ENABLE
+#define CY_OTA_NEXT_CHECK_INTERVAL_SECS     (24 * 60 * 60)  /* 1 day */
+#else
 #define CY_OTA_NEXT_CHECK_INTERVAL_SECS     (10)            /* 10 seconds between checks */
+#endif
 
 /**
  * @brief Retry time which checking for OTA updates
  *
  * This is used to re-start the timer after failing to contact the server during an OTA update check.
  */
+#ifdef OTA_POLL_ENABLE
+#define CY_OTA_RETRY_INTERVAL_SECS          (24 * 60 * 60)  /* 1 day */
+#else
 #define CY_OTA_RETRY_INTERVAL_SECS          (5)             /* 5 seconds between retries after an error */
+#endif
 
 /**
  * @brief Length of time to check for downloads
@@ -242,6 +256,8 @@ extern "C" {
  *
  * An MQTT ping request will be sent periodically at this interval.
  * The maximum number of Topics for subscribing.
+ * With MQTT_SESSION_ENABLE this is the keep-alive of the first connection, the
+ * factory app adapts it for later ones (source/mqtt_session.c).
  */
 #define CY_OTA_MQTT_KEEP_ALIVE_SECONDS          (60)                /* 60 second keep-alive */
 
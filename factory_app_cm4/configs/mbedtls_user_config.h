@@ -179,6 +179,12 @@
 #undef MBEDTLS_ECP_DP_BP384R1_ENABLED
 #undef MBEDTLS_ECP_DP_BP512R1_ENABLED
 // #undef MBEDTLS_ECP_DP_CURVE25519_ENABLED
+#ifdef MBEDTLS_ACCEL_ECP_ENABLE
+/* The crypto block accelerates the NIST curves only, and any other curve
+ * disables MBEDTLS_ECP_ALT for all of them (see the end of this file). Without
+ * Curve25519 the ECDHE key exchange uses P-256 in hardware. */
+#undef MBEDTLS_ECP_DP_CURVE25519_ENABLED
+#endif
 #undef MBEDTLS_ECP_DP_CURVE448_ENABLED
 
 /**
@@ -879,9 +885,15 @@
  * callbacks are provided by MBEDTLS_SSL_TICKET_C.
  *
  * Comment this macro to disable support for SSL session tickets
+ *
+ * Kept with TLS_SESSION_RESUME_ENABLE, the factory app offers the ticket of
+ * the last session when it reconnects to the broker (see tls_session.c).
+ * Resumption by session ID needs no option on the client side.
  */
+#ifndef TLS_SESSION_RESUME_ENABLE
 #undef MBEDTLS_SSL_SESSION_TICKETS
 #endif
+#endif
 
 #ifdef MBEDTLS_SSL_PROTO_TLS1_3
 /**
@@ -1093,6 +1105,7 @@
 #define MBEDTLS_THREADING_C
 
 #endif
+
 /**
  * The cy-mbedtls-acceleration module supports only DP_SECP192R1,
  * SECP224R1, SECP256R1, SECP384R1 and SECP521R1 curves. If any
@@ -1143,4 +1156,16 @@
 
 #endif /* DISABLE_MBEDTLS_ACCELERATION */
 
+#ifdef ARENA_TLS_ENABLE
+/**
+ * \def MBEDTLS_PLATFORM_MEMORY
+ *
+ * With ARENA_TLS_ENABLE the factory app hands mbed TLS the calloc() and free()
+ * of its TLS arena through mbedtls_platform_set_calloc_free() (see arena.c).
+ */
+#ifndef MBEDTLS_PLATFORM_MEMORY
+#define MBEDTLS_PLATFORM_MEMORY
+#endif
+#endif
+
 #endif /* MBEDTLS_USER_CONFIG_HEADER */
@@ -0,0 +1,316 @@
+/******************************************************************************
+* File Name: app_log.c
+*
+* Description: This file implements the deferred log of the factory app. Messages
+* are formatted into a lock-free ring and printed to the debug UART by a
+* low-priority task, so the OTA download never waits for the UART.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/* Header file includes */
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include "cyhal.h"
+#include "cybsp.h"
+#include "cy_retarget_io.h"
+#include "app_log.h"
+/* FreeRTOS */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Below every other task of the app, the UART is drained when they wait */
+#define APP_LOG_TASK_STACK_SIZE             (configMINIMAL_STACK_SIZE * 4)
+#define APP_LOG_TASK_PRIORITY               (tskIDLE_PRIORITY + 1)
+
+/* Ends a truncated message */
+#define APP_LOG_TRUNCATED                   "...\n"
+
+/*******************************************************************************
+* Data Structures
+********************************************************************************/
+/* One message of the ring */
+typedef struct
+{
+    volatile uint32_t           ready;          /* Written, owned by the log task */
+    char                        text[APP_LOG_MSG_SIZE];
+} app_log_slot_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+#ifdef APP_LOG_DEFERRED_ENABLE
+static void app_log_task(void *args);
+#endif
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+#ifdef APP_LOG_DEFERRED_ENABLE
+static TaskHandle_t app_log_task_handle;
+static StaticTask_t app_log_task_tcb;
+static StackType_t app_log_task_stack[APP_LOG_TASK_STACK_SIZE];
+
+/* Producers reserve a slot by advancing head, the log task frees it by
+ * advancing tail. Both only grow, the slot is the index modulo the count. */
+static app_log_slot_t app_log_slots[APP_LOG_SLOT_COUNT];
+static uint32_t app_log_head;
+static uint32_t app_log_tail;
+static uint32_t app_log_dropped;
+#endif
+
+/*******************************************************************************
+ * Function Name: app_log_init
+ *******************************************************************************
+ * Summary:
+ *  Starts the log task. Does nothing if the log is not deferred.
+ *
+ * Return:
+ *  CY_RSLT_SUCCESS on success, CY_RSLT_TYPE_ERROR otherwise
+ *
+ *******************************************************************************/
+cy_rslt_t app_log_init(void)
+{
+#ifdef APP_LOG_DEFERRED_ENABLE
+    if (app_log_task_handle != NULL)
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    app_log_task_handle = xTaskCreateStatic(app_log_task, "APP LOG", APP_LOG_TASK_STACK_SIZE,
+                                            NULL, APP_LOG_TASK_PRIORITY, app_log_task_stack, &app_log_task_tcb);
+    if (app_log_task_handle == NULL)
+    {
+        printf("\n Creating the log task failed.\n");
+        return CY_RSLT_TYPE_ERROR;
+    }
+#endif
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: app_log_write
+ *******************************************************************************
+ * Summary:
+ *  Formats a message into the next free slot of the ring and wakes the log
+ *  task. Slots are reserved with a compare-and-swap on the head, so any task
+ *  can log without a lock. If the ring is full the message is dropped, the log
+ *  task reports the number of dropped messages with the next one it prints.
+ *
+ * Parameters:
+ *  const char *format : printf() format of the message
+ *
+ *******************************************************************************/
+void app_log_write(const char *format, ...)
+{
+    va_list args;
+
+#ifdef APP_LOG_DEFERRED_ENABLE
+    app_log_slot_t *slot;
+    uint32_t head;
+    int len;
+
+    /* Not started yet, nothing is time critical this early */
+    if ((app_log_task_handle == NULL) ||
+        (taskSCHEDULER_RUNNING != xTaskGetSchedulerState()))
+    {
+        va_start(args, format);
+        vprintf(format, args);
+        va_end(args);
+        return;
+    }
+
+    head = __atomic_load_n(&app_log_head, __ATOMIC_RELAXED);
+    do
+    {
+        if ((head - __atomic_load_n(&app_log_tail, __ATOMIC_ACQUIRE)) >= APP_LOG_SLOT_COUNT)
+        {
+            __atomic_fetch_add(&app_log_dropped, 1, __ATOMIC_RELAXED);
+            return;
+        }
+    } while (!__atomic_compare_exchange_n(&app_log_head, &head, head + 1, true,
+                                          __ATOMIC_ACQUIRE, __ATOMIC_RELAXED));
+
+    slot = &app_log_slots[head % APP_LOG_SLOT_COUNT];
+
+    va_start(args, format);
+    len = vsnprintf(slot->text, sizeof(slot->text), format, args);
+    va_end(args);
+
+    if (len >= (int)sizeof(slot->text))
+    {
+        memcpy(&slot->text[sizeof(slot->text) - sizeof(APP_LOG_TRUNCATED)],
+               APP_LOG_TRUNCATED, sizeof(APP_LOG_TRUNCATED));
+    }
+
+    __atomic_store_n(&slot->ready, 1, __ATOMIC_RELEASE);
+    xTaskNotifyGive(app_log_task_handle);
+#else
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+#endif
+}
+
+#ifdef APP_LOG_DEFERRED_ENABLE
+/*******************************************************************************
+ * Function Name: app_log_task
+ *******************************************************************************
+ * Summary:
+ *  Prints the messages of the ring in the order their slots were reserved.
+ *  A slot that is reserved but still being written ends the round, its writer
+ *  notifies the task again when it is done.
+ *
+ * Parameters:
+ *  void *args : Task parameter defined during task creation (unused)
+ *
+ *******************************************************************************/
+static void app_log_task(void *args)
+{
+    app_log_slot_t *slot;
+    uint32_t tail;
+    uint32_t dropped;
+
+    (void)args;
+
+    for (;;)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        tail = __atomic_load_n(&app_log_tail, __ATOMIC_RELAXED);
+        while (tail != __atomic_load_n(&app_log_head, __ATOMIC_ACQUIRE))
+        {
+            slot = &app_log_slots[tail % APP_LOG_SLOT_COUNT];
+            if (!__atomic_load_n(&slot->ready, __ATOMIC_ACQUIRE))
+            {
+                break;
+            }
+
+            fputs(slot->text, stdout);
+
+            slot->ready = 0;
+            tail++;
+            __atomic_store_n(&app_log_tail, tail, __ATOMIC_RELEASE);
+        }
+
+        dropped = __atomic_exchange_n(&app_log_dropped, 0, __ATOMIC_RELAXED);
+        if (dropped != 0)
+        {
+            printf("\n[%lu log messages dropped]\n", (unsigned long)dropped);
+        }
+        fflush(stdout);
+    }
+}
+#endif
+
+/*******************************************************************************
+ * Function Name: app_log_limit_reset
+ *******************************************************************************
+ * Summary:
+ *  Resets a rate limit, the next event is logged.
+ *
+ * Parameters:
+ *  app_log_limit_t *limit : Rate limit of the event
+ *
+ *******************************************************************************/
+void app_log_limit_reset(app_log_limit_t *limit)
+{
+    memset(limit, 0, sizeof(*limit));
+}
+
+/*******************************************************************************
+ * Function Name: app_log_limit_changed
+ *******************************************************************************
+ * Summary:
+ *  Limits an event to changes of its value, for example of the progress in
+ *  whole percent.
+ *
+ * Parameters:
+ *  app_log_limit_t *limit : Rate limit of the event
+ *  uint32_t value         : Value of the event
+ *
+ * Return:
+ *  true if the event is to be logged
+ *
+ *******************************************************************************/
+bool app_log_limit_changed(app_log_limit_t *limit, uint32_t value)
+{
+    if (limit->valid && (limit->last == value))
+    {
+        limit->suppressed++;
+        return false;
+    }
+
+    limit->valid = true;
+    limit->last = value;
+    limit->suppressed = 0;
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: app_log_limit_interval
+ *******************************************************************************
+ * Summary:
+ *  Limits an event to one per interval.
+ *
+ * Parameters:
+ *  app_log_limit_t *limit : Rate limit of the event
+ *  uint32_t interval_ms   : Minimum time between two logged events
+ *
+ * Return:
+ *  true if the event is to be logged
+ *
+ *******************************************************************************/
+bool app_log_limit_interval(app_log_limit_t *limit, uint32_t interval_ms)
+{
+    TickType_t now = xTaskGetTickCount();
+
+    if (limit->valid && ((now - (TickType_t)limit->last) < pdMS_TO_TICKS(interval_ms)))
+    {
+        limit->suppressed++;
+        return false;
+    }
+
+    limit->valid = true;
+    limit->last = (uint32_t)now;
+    limit->suppressed = 0;
+    return true;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,136 @@
+/******************************************************************************
+* File Name: app_log.h
+*
+* Description: This file contains the declarations of the deferred, rate-limited
+* log of the factory app.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef SOURCE_APP_LOG_H_
+#define SOURCE_APP_LOG_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "cy_result.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Log levels, messages above APP_LOG_LEVEL are removed at compile time */
+#define APP_LOG_LEVEL_NONE                  (0)
+#define APP_LOG_LEVEL_ERR                   (1)
+#define APP_LOG_LEVEL_WARN                  (2)
+#define APP_LOG_LEVEL_INFO                  (3)
+#define APP_LOG_LEVEL_DEBUG                 (4)
+
+#ifndef APP_LOG_LEVEL
+#define APP_LOG_LEVEL                       APP_LOG_LEVEL_INFO
+#endif
+
+/* Number and size of the messages queued for the log task. A longer message
+ * is truncated, a message that finds the ring full is dropped and counted. */
+#ifndef APP_LOG_SLOT_COUNT
+#define APP_LOG_SLOT_COUNT                  (16u)
+#endif
+#ifndef APP_LOG_MSG_SIZE
+#define APP_LOG_MSG_SIZE                    (192u)
+#endif
+
+#ifdef APP_LOG_DEFERRED_ENABLE
+#define APP_LOG_OUT(...)                    app_log_write(__VA_ARGS__)
+#else
+#define APP_LOG_OUT(...)                    printf(__VA_ARGS__)
+#endif
+
+/* A disabled message is still type checked but generates no code */
+#define APP_LOG_OFF(...)                    do { if (0) { printf(__VA_ARGS__); } } while (0)
+
+#if (APP_LOG_LEVEL >= APP_LOG_LEVEL_ERR)
+#define APP_LOG_ERR(...)                    APP_LOG_OUT(__VA_ARGS__)
+#else
+#define APP_LOG_ERR(...)                    APP_LOG_OFF(__VA_ARGS__)
+#endif
+
+#if (APP_LOG_LEVEL >= APP_LOG_LEVEL_WARN)
+#define APP_LOG_WARN(...)                   APP_LOG_OUT(__VA_ARGS__)
+#else
+#define APP_LOG_WARN(...)                   APP_LOG_OFF(__VA_ARGS__)
+#endif
+
+#if (APP_LOG_LEVEL >= APP_LOG_LEVEL_INFO)
+#define APP_LOG_INFO(...)                   APP_LOG_OUT(__VA_ARGS__)
+#else
+#define APP_LOG_INFO(...)                   APP_LOG_OFF(__VA_ARGS__)
+#endif
+
+#if (APP_LOG_LEVEL >= APP_LOG_LEVEL_DEBUG)
+#define APP_LOG_DEBUG(...)                  APP_LOG_OUT(__VA_ARGS__)
+#else
+#define APP_LOG_DEBUG(...)                  APP_LOG_OFF(__VA_ARGS__)
+#endif
+
+/*******************************************************************************
+* Data Structures
+********************************************************************************/
+/* Rate limit of one log event, see app_log_limit_changed() and
+ * app_log_limit_interval() */
+typedef struct
+{
+    bool                        valid;
+    uint32_t                    last;           /* Last logged value or tick */
+    uint32_t                    suppressed;     /* Events not logged since */
+} app_log_limit_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Starts the log task. Messages written before are printed directly. */
+cy_rslt_t app_log_init(void);
+
+/* Formats a message into the ring for the log task. Never blocks, must not be
+ * called from an interrupt. */
+void app_log_write(const char *format, ...) __attribute__((format(printf, 1, 2)));
+
+/* Logs the next event regardless of the limit */
+void app_log_limit_reset(app_log_limit_t *limit);
+
+/* True if value differs from the value of the last logged event */
+bool app_log_limit_changed(app_log_limit_t *limit, uint32_t value);
+
+/* True if at least interval_ms passed since the last logged event */
+bool app_log_limit_interval(app_log_limit_t *limit, uint32_t interval_ms);
+
+#endif /* SOURCE_APP_LOG_H_ */
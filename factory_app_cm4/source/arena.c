@@ -0,0 +1,413 @@
+/******************************************************************************
+* File Name: arena.c
+*
+* Description: This file implements the arena allocator. Each arena is a static
+* region split into classes of equal blocks, with a free list per class, so
+* allocating and freeing take constant time and one subsystem cannot fragment
+* the memory of another.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/* Header file includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include "cyhal.h"
+#include "cybsp.h"
+#include "cy_retarget_io.h"
+#include "arena.h"
+#include "app_log.h"
+#ifdef ARENA_TLS_ENABLE
+#include "mbedtls/platform.h"
+#endif
+/* FreeRTOS */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define ARENA_ALIGN                         (8u)
+
+/* Expand a class list into its byte count and its configuration */
+#define ARENA_CLASS_BYTES(size, count)      + ((size) * (count))
+#define ARENA_CLASS_CFG(size, count)        { (size), (count) },
+
+#define ARENA_TLS_BYTES                     (0u ARENA_TLS_CLASSES(ARENA_CLASS_BYTES))
+
+/*******************************************************************************
+* Data Structures
+********************************************************************************/
+typedef struct
+{
+    uint32_t                    size;
+    uint32_t                    count;
+} arena_class_cfg_t;
+
+/* Free blocks hold the link to the next one */
+typedef struct arena_block
+{
+    struct arena_block          *next;
+} arena_block_t;
+
+typedef struct
+{
+    uint8_t                     *start;
+    uint8_t                     *end;
+    arena_block_t               *free_list;
+} arena_class_t;
+
+typedef struct
+{
+    uint8_t                     *region;
+    const arena_class_cfg_t     *cfg;
+    arena_class_t               classes[ARENA_MAX_CLASSES];
+    arena_stats_t               stats;
+} arena_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void arena_setup(arena_t *arena, const char *name, uint8_t *region,
+                        const arena_class_cfg_t *cfg, uint32_t class_count);
+#ifdef ARENA_TLS_ENABLE
+static void *arena_tls_calloc(size_t n, size_t size);
+static void arena_tls_free(void *ptr);
+#endif
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static const arena_class_cfg_t arena_tls_cfg[] = { ARENA_TLS_CLASSES(ARENA_CLASS_CFG) };
+
+#ifdef ARENA_TLS_ENABLE
+static uint64_t arena_tls_region[ARENA_TLS_BYTES / sizeof(uint64_t)];
+#endif
+
+static arena_t arenas[ARENA_COUNT];
+
+/*******************************************************************************
+ * Function Name: arena_init
+ *******************************************************************************
+ * Summary:
+ *  Sets up the arenas enabled in the build. An arena that is not enabled
+ *  serves everything from the heap.
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS on success, error code otherwise
+ *
+ *******************************************************************************/
+cy_rslt_t arena_init(void)
+{
+    CY_ASSERT((sizeof(arena_tls_cfg) / sizeof(arena_tls_cfg[0])) <= ARENA_MAX_CLASSES);
+
+    arenas[ARENA_TLS].stats.name = "tls";
+#ifdef ARENA_TLS_ENABLE
+    arena_setup(&arenas[ARENA_TLS], "tls", (uint8_t *)arena_tls_region, arena_tls_cfg,
+                sizeof(arena_tls_cfg) / sizeof(arena_tls_cfg[0]));
+
+    if (0 != mbedtls_platform_set_calloc_free(arena_tls_calloc, arena_tls_free))
+    {
+        printf("\n Handing the TLS arena to mbed TLS failed.\n");
+        return CY_RSLT_TYPE_ERROR;
+    }
+#else
+    (void)arena_setup;
+#endif
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: arena_alloc
+ *******************************************************************************
+ * Summary:
+ *  Takes the first free block of the smallest class that fits. The number of
+ *  classes is fixed, so this takes constant time.
+ *
+ * Parameters:
+ *  arena_id_t id : Arena to allocate from
+ *  size_t size   : Bytes needed
+ *
+ * Return:
+ *  void * : The block, NULL if neither the arena nor the heap had memory
+ *
+ *******************************************************************************/
+void *arena_alloc(arena_id_t id, size_t size)
+{
+    arena_t *arena = &arenas[id];
+    arena_class_stats_t *cls;
+    arena_block_t *block = NULL;
+    uint32_t i;
+
+    taskENTER_CRITICAL();
+    arena->stats.allocs++;
+    for (i = 0; i < arena->stats.class_count; i++)
+    {
+        cls = &arena->stats.classes[i];
+        if ((size <= cls->size) && (arena->classes[i].free_list != NULL))
+        {
+            block = arena->classes[i].free_list;
+            arena->classes[i].free_list = block->next;
+
+            cls->used++;
+            cls->peak = CY_MAX(cls->peak, cls->used);
+            arena->stats.used += cls->size;
+            arena->stats.peak = CY_MAX(arena->stats.peak, arena->stats.used);
+            break;
+        }
+    }
+    if (block == NULL)
+    {
+        arena->stats.fallbacks++;
+    }
+    taskEXIT_CRITICAL();
+
+    if (block != NULL)
+    {
+        return block;
+    }
+
+    /* Too large or the arena is exhausted, the high-water marks tell which
+     * class to grow */
+    block = malloc(size);
+    if (block == NULL)
+    {
+        taskENTER_CRITICAL();
+        arena->stats.failures++;
+        taskEXIT_CRITICAL();
+    }
+
+    return block;
+}
+
+/*******************************************************************************
+ * Function Name: arena_calloc
+ *******************************************************************************
+ * Summary:
+ *  Allocates n zeroed elements of size bytes.
+ *
+ * Parameters:
+ *  arena_id_t id : Arena to allocate from
+ *  size_t n      : Number of elements
+ *  size_t size   : Bytes per element
+ *
+ * Return:
+ *  void * : The block, NULL on overflow or if there is no memory
+ *
+ *******************************************************************************/
+void *arena_calloc(arena_id_t id, size_t n, size_t size)
+{
+    void *ptr;
+
+    if ((size != 0) && (n > (SIZE_MAX / size)))
+    {
+        return NULL;
+    }
+
+    ptr = arena_alloc(id, n * size);
+    if (ptr != NULL)
+    {
+        memset(ptr, 0, n * size);
+    }
+
+    return ptr;
+}
+
+/*******************************************************************************
+ * Function Name: arena_free
+ *******************************************************************************
+ * Summary:
+ *  Puts a block back on the free list of its class. The class follows from
+ *  the address, so blocks need no header. Anything outside of the arena came
+ *  from the heap.
+ *
+ * Parameters:
+ *  arena_id_t id : Arena the block was allocated from
+ *  void *ptr     : Block, may be NULL
+ *
+ *******************************************************************************/
+void arena_free(arena_id_t id, void *ptr)
+{
+    arena_t *arena = &arenas[id];
+    arena_block_t *block = (arena_block_t *)ptr;
+    uint32_t i;
+
+    if (ptr == NULL)
+    {
+        return;
+    }
+
+    for (i = 0; i < arena->stats.class_count; i++)
+    {
+        if (((uint8_t *)ptr >= arena->classes[i].start) && ((uint8_t *)ptr < arena->classes[i].end))
+        {
+            taskENTER_CRITICAL();
+            block->next = arena->classes[i].free_list;
+            arena->classes[i].free_list = block;
+            arena->stats.classes[i].used--;
+            arena->stats.used -= arena->stats.classes[i].size;
+            taskEXIT_CRITICAL();
+            return;
+        }
+    }
+
+    free(ptr);
+}
+
+/*******************************************************************************
+ * Function Name: arena_get_stats
+ *******************************************************************************
+ * Summary:
+ *  Copies the usage of an arena.
+ *
+ * Parameters:
+ *  arena_id_t id         : Arena
+ *  arena_stats_t *stats  : Receives the usage
+ *
+ *******************************************************************************/
+void arena_get_stats(arena_id_t id, arena_stats_t *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = arenas[id].stats;
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: arena_report
+ *******************************************************************************
+ * Summary:
+ *  Prints the high-water marks of all arenas, one line per arena with the
+ *  peak and count of every class.
+ *
+ *******************************************************************************/
+void arena_report(void)
+{
+    arena_stats_t stats;
+    uint32_t id;
+    uint32_t i;
+
+    for (id = 0; id < ARENA_COUNT; id++)
+    {
+        arena_get_stats((arena_id_t)id, &stats);
+        if (stats.class_count == 0)
+        {
+            continue;
+        }
+
+        APP_LOG_INFO("Arena %s: peak %lu of %lu bytes, %lu allocs, %lu from heap, %lu failed\n",
+                     stats.name, (unsigned long)stats.peak, (unsigned long)stats.size,
+                     (unsigned long)stats.allocs, (unsigned long)stats.fallbacks,
+                     (unsigned long)stats.failures);
+        for (i = 0; i < stats.class_count; i++)
+        {
+            APP_LOG_INFO("  %5lu bytes: peak %lu of %lu\n", (unsigned long)stats.classes[i].size,
+                         (unsigned long)stats.classes[i].peak, (unsigned long)stats.classes[i].count);
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: arena_setup
+ *******************************************************************************
+ * Summary:
+ *  Splits the region of an arena into its classes and links the blocks of
+ *  every class into its free list.
+ *
+ *******************************************************************************/
+static void arena_setup(arena_t *arena, const char *name, uint8_t *region,
+                        const arena_class_cfg_t *cfg, uint32_t class_count)
+{
+    uint8_t *p = region;
+    arena_block_t *block;
+    uint32_t i;
+    uint32_t n;
+
+    memset(arena, 0, sizeof(*arena));
+    arena->region = region;
+    arena->cfg = cfg;
+    arena->stats.name = name;
+    arena->stats.class_count = class_count;
+
+    for (i = 0; i < class_count; i++)
+    {
+        CY_ASSERT((cfg[i].size % ARENA_ALIGN) == 0);
+
+        arena->classes[i].start = p;
+        arena->classes[i].free_list = NULL;
+        for (n = 0; n < cfg[i].count; n++)
+        {
+            /* Linked back to front, the first block is handed out first */
+            block = (arena_block_t *)(p + ((cfg[i].count - 1u - n) * cfg[i].size));
+            block->next = arena->classes[i].free_list;
+            arena->classes[i].free_list = block;
+        }
+        p += cfg[i].size * cfg[i].count;
+        arena->classes[i].end = p;
+
+        arena->stats.classes[i].size = cfg[i].size;
+        arena->stats.classes[i].count = cfg[i].count;
+        arena->stats.size += cfg[i].size * cfg[i].count;
+    }
+}
+
+#ifdef ARENA_TLS_ENABLE
+/*******************************************************************************
+ * Function Name: arena_tls_calloc
+ *******************************************************************************
+ * Summary:
+ *  calloc() of mbed TLS.
+ *
+ *******************************************************************************/
+static void *arena_tls_calloc(size_t n, size_t size)
+{
+    return arena_calloc(ARENA_TLS, n, size);
+}
+
+/*******************************************************************************
+ * Function Name: arena_tls_free
+ *******************************************************************************
+ * Summary:
+ *  free() of mbed TLS.
+ *
+ *******************************************************************************/
+static void arena_tls_free(void *ptr)
+{
+    arena_free(ARENA_TLS, ptr);
+}
+#endif
+
+/* [] END OF FILE */
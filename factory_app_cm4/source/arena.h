@@ -0,0 +1,124 @@
+/******************************************************************************
+* File Name: arena.h
+*
+* Description: This file contains the declarations of the arena allocator that keeps
+* the allocations of a subsystem in a region of their own.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef SOURCE_ARENA_H_
+#define SOURCE_ARENA_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "cy_result.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Block classes of the TLS arena as X(block size, block count), smallest
+ * first. Block sizes must be multiples of 8. The last class holds the record
+ * buffers of one connection, MBEDTLS_SSL_IN/OUT_BUFFER_LEN. */
+#ifndef ARENA_TLS_CLASSES
+#define ARENA_TLS_CLASSES(X)                \
+    X(32,    64)                            \
+    X(64,    64)                            \
+    X(128,   32)                            \
+    X(256,   16)                            \
+    X(512,   8)                             \
+    X(1024,  6)                             \
+    X(2048,  4)                             \
+    X(4096,  2)                             \
+    X(17408, 2)
+#endif
+
+/* Most block classes of one arena */
+#define ARENA_MAX_CLASSES                   (12u)
+
+/*******************************************************************************
+* Data Structures
+********************************************************************************/
+typedef enum
+{
+    ARENA_TLS,                          /* mbed TLS, see MBEDTLS_PLATFORM_MEMORY */
+    ARENA_COUNT
+} arena_id_t;
+
+/* Usage of one block class */
+typedef struct
+{
+    uint32_t                    size;           /* Block size */
+    uint32_t                    count;          /* Blocks in the class */
+    uint32_t                    used;           /* Blocks allocated now */
+    uint32_t                    peak;           /* Most blocks allocated at once */
+} arena_class_stats_t;
+
+typedef struct
+{
+    const char                  *name;
+    uint32_t                    size;           /* Bytes of all blocks */
+    uint32_t                    used;           /* Bytes of allocated blocks */
+    uint32_t                    peak;           /* High-water mark of used */
+    uint32_t                    allocs;
+    uint32_t                    fallbacks;      /* Served from the heap instead */
+    uint32_t                    failures;       /* Not served at all */
+    uint32_t                    class_count;
+    arena_class_stats_t         classes[ARENA_MAX_CLASSES];
+} arena_stats_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Carves the arenas into their blocks and hands the TLS arena to mbed TLS.
+ * Must be called before the first TLS connection. */
+cy_rslt_t arena_init(void);
+
+/* Allocates a block of the smallest class that fits size and has a free
+ * block. If there is none, the heap is used. Safe to call from any task. */
+void *arena_alloc(arena_id_t id, size_t size);
+
+/* Like arena_alloc(), for n zeroed elements */
+void *arena_calloc(arena_id_t id, size_t n, size_t size);
+
+/* Returns a block to its arena, or a heap fallback to the heap */
+void arena_free(arena_id_t id, void *ptr);
+
+/* Usage and high-water marks of an arena since the reset */
+void arena_get_stats(arena_id_t id, arena_stats_t *stats);
+
+/* Prints the high-water marks of all arenas */
+void arena_report(void);
+
+#endif /* SOURCE_ARENA_H_ */
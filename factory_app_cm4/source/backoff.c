@@ -0,0 +1,146 @@
+/******************************************************************************
+* File Name: backoff.c
+*
+* Description: This file implements the jittered exponential backoff used between
+* retries.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/* Header file includes */
+#include <stdio.h>
+#include <stdbool.h>
+#include "cyhal.h"
+#include "cybsp.h"
+#include "cy_retarget_io.h"
+#include "backoff.h"
+/* FreeRTOS */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* xorshift32 state, 0 until seeded */
+static uint32_t backoff_state;
+
+/*******************************************************************************
+ * Function Name: backoff_seed
+ *******************************************************************************
+ * Summary:
+ *  Seeds the generator from the TRNG, the tick count and a device specific
+ *  value, so devices that start together still draw different numbers if the
+ *  TRNG is not available.
+ *
+ * Parameters:
+ *  uint32_t seed : Device specific value, 0 if there is none
+ *
+ *******************************************************************************/
+void backoff_seed(uint32_t seed)
+{
+    cyhal_trng_t trng;
+
+    if (CY_RSLT_SUCCESS == cyhal_trng_init(&trng))
+    {
+        seed ^= cyhal_trng_generate(&trng);
+        cyhal_trng_free(&trng);
+    }
+    seed ^= (uint32_t)xTaskGetTickCount();
+
+    backoff_state = (seed != 0) ? seed : 0x9E3779B9u;
+}
+
+/*******************************************************************************
+ * Function Name: backoff_random
+ *******************************************************************************
+ * Summary:
+ *  Returns the next number of a xorshift32 generator, seeded on first use if
+ *  backoff_seed() was not called. Concurrent callers may get the same number,
+ *  which is fine for jitter.
+ *
+ * Return:
+ *  uint32_t : Pseudo-random number
+ *
+ *******************************************************************************/
+uint32_t backoff_random(void)
+{
+    uint32_t x;
+
+    if (backoff_state == 0)
+    {
+        backoff_seed(0);
+    }
+
+    x = backoff_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    backoff_state = x;
+
+    return x;
+}
+
+/*******************************************************************************
+ * Function Name: backoff_delay_ms
+ *******************************************************************************
+ * Summary:
+ *  Computes the delay before a retry.
+ *
+ * Parameters:
+ *  uint32_t attempt : Number of the retry, 0 for the first one
+ *  uint32_t base_ms : Delay before the first retry
+ *  uint32_t max_ms  : Upper limit of the delay
+ *
+ * Return:
+ *  uint32_t : Delay in milliseconds, between half and all of the exponential
+ *             delay
+ *
+ *******************************************************************************/
+uint32_t backoff_delay_ms(uint32_t attempt, uint32_t base_ms, uint32_t max_ms)
+{
+    uint32_t delay = base_ms;
+
+    while ((attempt-- > 0) && (delay < max_ms))
+    {
+        delay <<= 1;
+    }
+    if (delay > max_ms)
+    {
+        delay = max_ms;
+    }
+
+    return (delay / 2u) + (backoff_random() % ((delay / 2u) + 1u));
+}
+
+/* [] END OF FILE */
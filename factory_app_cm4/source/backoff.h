@@ -0,0 +1,63 @@
+/******************************************************************************
+* File Name: backoff.h
+*
+* Description: This file contains the declarations of the jittered exponential
+* backoff used between retries.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef SOURCE_BACKOFF_H_
+#define SOURCE_BACKOFF_H_
+
+#include <stdint.h>
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Delay before retry number attempt (0 for the first retry): base_ms doubled
+ * for every attempt up to max_ms. The result is randomized between half and
+ * all of that, so devices that start together do not retry in lockstep. */
+uint32_t backoff_delay_ms(uint32_t attempt, uint32_t base_ms, uint32_t max_ms);
+
+/* Pseudo-random number for jitter, seeded once from the TRNG. Not for
+ * anything security related. */
+uint32_t backoff_random(void);
+
+/* Seeds the generator from the TRNG mixed with a device specific value.
+ * Call before the network starts, while the crypto block is still idle;
+ * otherwise the first backoff_random() seeds it. */
+void backoff_seed(uint32_t seed);
+
+#endif /* SOURCE_BACKOFF_H_ */
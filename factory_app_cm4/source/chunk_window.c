@@ -0,0 +1,622 @@
+/******************************************************************************
+* File Name: chunk_window.c
+*
+* Description: This file contains the windowed chunk requester. Instead of
+* waiting for the publisher to push the image, it requests the image chunk by
+* chunk and keeps up to OTA_CHUNK_WINDOW_SIZE requests outstanding, so the
+* download is limited by the bandwidth rather than the round trip time.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include <stdio.h>
+#include <string.h>
+#include "cyhal.h"
+#include "cybsp.h"
+#include "cy_retarget_io.h"
+#include "chunk_window.h"
+/* FreeRTOS */
+#include <FreeRTOS.h>
+#include <task.h>
+#include <semphr.h>
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Chunk window task configurations */
+#define CHUNK_WINDOW_TASK_STACK_SIZE        (configMINIMAL_STACK_SIZE * 8)
+#define CHUNK_WINDOW_TASK_PRIORITY          (configMAX_PRIORITIES - 3)
+
+/* Interval of the check for timed out requests */
+#define CHUNK_WINDOW_POLL_MS                (500u)
+
+/* Topic the publisher listens on */
+#define CHUNK_WINDOW_REQUEST_TOPIC          COMPANY_TOPIC_PREPEND "/" CY_TARGET_BOARD_STRING "/" PUBLISHER_LISTEN_TOPIC
+
+/* Request for one chunk, answered on the unique topic. See "Request Data
+ * Chunk" in scripts/publisher.py. */
+#define CHUNK_WINDOW_REQUEST_JSON \
+"{\
+\"Message\":\"Request Data Chunk\", \
+\"UniqueTopicName\": \"%s\", \
+\"Offset\":\"%lu\", \
+\"Size\":\"%lu\"\
+}"
+
+#define CHUNK_WINDOW_TOPIC_MAX_LEN          (128u)
+#define CHUNK_WINDOW_DOC_MAX_LEN            (CHUNK_WINDOW_TOPIC_MAX_LEN + 128u)
+
+/*******************************************************************************
+* Data Structures
+********************************************************************************/
+/* Outstanding chunk request */
+typedef struct
+{
+    bool                        busy;
+    uint32_t                    offset;
+    TickType_t                  sent;
+    uint32_t                    tries;
+} chunk_window_slot_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void chunk_window_task(void *args);
+static uint32_t chunk_window_collect(uint32_t offsets[]);
+static bool chunk_window_is_pending(uint32_t offset);
+static bool chunk_window_next_prefetch(uint32_t *offset);
+static void chunk_window_request(cy_mqtt_t mqtt_handle, uint32_t offset);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Chunk window task handle */
+static TaskHandle_t chunk_window_task_handle;
+static StaticTask_t chunk_window_task_tcb;
+static StackType_t chunk_window_task_stack[CHUNK_WINDOW_TASK_STACK_SIZE];
+
+/* Protects the window state below */
+static SemaphoreHandle_t chunk_window_mutex;
+static StaticSemaphore_t chunk_window_mutex_buffer;
+
+static bool chunk_window_active;
+
+/* A windowed download was started, completion is tracked in
+ * chunk_window_received */
+static bool chunk_window_started;
+static cy_mqtt_t chunk_window_mqtt;
+static char chunk_window_topic[CHUNK_WINDOW_TOPIC_MAX_LEN];
+
+/* Lowest offset that has not been requested yet */
+static uint32_t chunk_window_next_offset;
+
+/* Requests sent again after a timeout */
+static uint32_t chunk_window_retry_count;
+
+/* Chunks to request out of order, none if end is 0 */
+static uint32_t chunk_window_prefetch_offset;
+static uint32_t chunk_window_prefetch_end;
+
+/* Chunks received, image size 0 until the first chunk has arrived */
+static uint32_t chunk_window_received_bits[CY_OTA_RANGE_WORDS(CHUNK_WINDOW_MAX_CHUNKS)];
+static cy_ota_range_t chunk_window_received;
+
+static chunk_window_slot_t chunk_window_slots[OTA_CHUNK_WINDOW_SIZE];
+
+/*******************************************************************************
+ * Function Name: chunk_window_init
+ *******************************************************************************
+ * Summary:
+ *  Creates the chunk window task. Does nothing if it is already running.
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS on success, error code otherwise
+ *
+ *******************************************************************************/
+cy_rslt_t chunk_window_init(void)
+{
+    if (chunk_window_task_handle != NULL)
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    cy_ota_range_init(&chunk_window_received, chunk_window_received_bits, CHUNK_WINDOW_MAX_CHUNKS);
+
+    chunk_window_mutex = xSemaphoreCreateMutexStatic(&chunk_window_mutex_buffer);
+    if (chunk_window_mutex == NULL)
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    chunk_window_task_handle = xTaskCreateStatic(chunk_window_task, "CHUNK WINDOW", CHUNK_WINDOW_TASK_STACK_SIZE,
+                                                 NULL, CHUNK_WINDOW_TASK_PRIORITY, chunk_window_task_stack,
+                                                 &chunk_window_task_tcb);
+    if (chunk_window_task_handle == NULL)
+    {
+        vSemaphoreDelete(chunk_window_mutex);
+        chunk_window_mutex = NULL;
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: chunk_window_start
+ *******************************************************************************
+ * Summary:
+ *  Starts a new download. The first chunk is requested alone to learn the
+ *  image size, after that the window is kept full. A resumed download knows
+ *  the size and requests only the missing chunks.
+ *
+ * Parameters:
+ *  cy_mqtt_t mqtt_handle        : Data connection of the OTA agent
+ *  const char *unique_topic     : Topic the OTA agent receives the chunks on
+ *  const cy_ota_range_t *resume : Chunks already written, NULL for a new
+ *                                 download
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS on success, error code otherwise
+ *
+ *******************************************************************************/
+cy_rslt_t chunk_window_start(cy_mqtt_t mqtt_handle, const char *unique_topic,
+                             const cy_ota_range_t *resume)
+{
+    if ((chunk_window_task_handle == NULL) || (mqtt_handle == NULL) || (unique_topic == NULL) ||
+        (strlen(unique_topic) >= sizeof(chunk_window_topic)))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    xSemaphoreTake(chunk_window_mutex, portMAX_DELAY);
+    chunk_window_mqtt = mqtt_handle;
+    strcpy(chunk_window_topic, unique_topic);
+    chunk_window_next_offset = 0;
+    chunk_window_prefetch_end = 0;
+    chunk_window_retry_count = 0;
+    (void)cy_ota_range_reset(&chunk_window_received, OTA_CHUNK_SIZE, 0);
+    memset(chunk_window_slots, 0, sizeof(chunk_window_slots));
+    if ((resume != NULL) && (resume->unit == OTA_CHUNK_SIZE) &&
+        cy_ota_range_copy(&chunk_window_received, resume))
+    {
+        printf("Resuming download, %lu of %lu chunks already written\n",
+                (unsigned long)chunk_window_received.count, (unsigned long)chunk_window_received.units);
+    }
+    chunk_window_active = true;
+    chunk_window_started = true;
+    xSemaphoreGive(chunk_window_mutex);
+
+    printf("Requesting %u byte chunks, %u outstanding\n",
+            (unsigned int)OTA_CHUNK_SIZE, (unsigned int)OTA_CHUNK_WINDOW_SIZE);
+
+    xTaskNotifyGive(chunk_window_task_handle);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: chunk_window_stop
+ *******************************************************************************
+ * Summary:
+ *  Stops requesting chunks. Chunks still in flight are accepted.
+ *
+ *******************************************************************************/
+void chunk_window_stop(void)
+{
+    if (chunk_window_mutex == NULL)
+    {
+        return;
+    }
+
+    xSemaphoreTake(chunk_window_mutex, portMAX_DELAY);
+    chunk_window_active = false;
+    xSemaphoreGive(chunk_window_mutex);
+}
+
+/*******************************************************************************
+ * Function Name: chunk_window_prefetch
+ *******************************************************************************
+ * Summary:
+ *  Requests the chunks covering a range of the image next, ahead of the ones
+ *  in order. Chunks already received or requested are skipped.
+ *
+ * Parameters:
+ *  uint32_t offset : Image offset of the range
+ *  uint32_t len    : Length of the range
+ *
+ *******************************************************************************/
+void chunk_window_prefetch(uint32_t offset, uint32_t len)
+{
+    if ((chunk_window_mutex == NULL) || (len == 0))
+    {
+        return;
+    }
+
+    xSemaphoreTake(chunk_window_mutex, portMAX_DELAY);
+    chunk_window_prefetch_offset = offset - (offset % OTA_CHUNK_SIZE);
+    chunk_window_prefetch_end = offset + len;
+    xSemaphoreGive(chunk_window_mutex);
+
+    xTaskNotifyGive(chunk_window_task_handle);
+}
+
+/*******************************************************************************
+ * Function Name: chunk_window_retries
+ *******************************************************************************
+ * Summary:
+ *  Returns the number of chunk requests sent again because the chunk did not
+ *  arrive in time.
+ *
+ *******************************************************************************/
+uint32_t chunk_window_retries(void)
+{
+    return chunk_window_retry_count;
+}
+
+/*******************************************************************************
+ * Function Name: chunk_window_on_chunk
+ *******************************************************************************
+ * Summary:
+ *  Accounts a chunk handed to the OTA storage, in any order, and lets the task
+ *  request the next one. Writes that do not start a chunk are not tracked.
+ *
+ * Parameters:
+ *  const cy_ota_storage_write_info_t *chunk_info : Chunk from the OTA agent
+ *
+ * Return:
+ *  bool : false if the chunk has already been received, true otherwise
+ *
+ *******************************************************************************/
+bool chunk_window_on_chunk(const cy_ota_storage_write_info_t *chunk_info)
+{
+    bool is_new = true;
+    uint32_t i;
+
+    if ((chunk_window_mutex == NULL) || (chunk_info == NULL) ||
+        ((chunk_info->offset % OTA_CHUNK_SIZE) != 0))
+    {
+        return true;
+    }
+
+    xSemaphoreTake(chunk_window_mutex, portMAX_DELAY);
+
+    if ((chunk_window_received.total_size == 0) &&
+        !cy_ota_range_reset(&chunk_window_received, OTA_CHUNK_SIZE, chunk_info->total_size))
+    {
+        (void)cy_ota_range_reset(&chunk_window_received, OTA_CHUNK_SIZE, 0);
+        if (chunk_window_active)
+        {
+            printf("\n Image of %lu bytes exceeds CHUNK_WINDOW_MAX_CHUNKS.\n",
+                    (unsigned long)chunk_info->total_size);
+            chunk_window_active = false;
+        }
+    }
+
+    if (cy_ota_range_contains(&chunk_window_received, chunk_info->offset, chunk_info->size))
+    {
+        is_new = false;
+    }
+    else
+    {
+        (void)cy_ota_range_add(&chunk_window_received, chunk_info->offset, chunk_info->size);
+    }
+
+    for (i = 0; i < OTA_CHUNK_WINDOW_SIZE; i++)
+    {
+        if (chunk_window_slots[i].busy && (chunk_window_slots[i].offset == chunk_info->offset))
+        {
+            chunk_window_slots[i].busy = false;
+        }
+    }
+
+    if (chunk_window_active && cy_ota_range_complete(&chunk_window_received))
+    {
+        /* All chunks are in, nothing left to request */
+        chunk_window_active = false;
+    }
+
+    xSemaphoreGive(chunk_window_mutex);
+
+    xTaskNotifyGive(chunk_window_task_handle);
+
+    return is_new;
+}
+
+/*******************************************************************************
+ * Function Name: chunk_window_complete
+ *******************************************************************************
+ * Summary:
+ *  Checks that every chunk of a windowed download has been received. Without
+ *  a windowed download the OTA agent pushes the image in order and its own
+ *  byte count holds.
+ *
+ * Return:
+ *  bool : false if a windowed download misses chunks
+ *
+ *******************************************************************************/
+bool chunk_window_complete(void)
+{
+    bool complete;
+
+    if (chunk_window_mutex == NULL)
+    {
+        return true;
+    }
+
+    xSemaphoreTake(chunk_window_mutex, portMAX_DELAY);
+    complete = !chunk_window_started || cy_ota_range_complete(&chunk_window_received);
+    xSemaphoreGive(chunk_window_mutex);
+
+    return complete;
+}
+
+/*******************************************************************************
+ * Function Name: chunk_window_task
+ *******************************************************************************
+ * Summary:
+ *  Keeps the window full. Woken up by every received chunk and periodically
+ *  to request timed out chunks again.
+ *
+ * Parameters:
+ *  void *args : Task parameter defined during task creation (unused)
+ *
+ *******************************************************************************/
+static void chunk_window_task(void *args)
+{
+    uint32_t offsets[OTA_CHUNK_WINDOW_SIZE];
+    uint32_t count;
+    uint32_t i;
+    cy_mqtt_t mqtt_handle;
+
+    (void)args;
+
+    for (;;)
+    {
+        (void)ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(CHUNK_WINDOW_POLL_MS));
+
+        count = 0;
+        xSemaphoreTake(chunk_window_mutex, portMAX_DELAY);
+        if (chunk_window_active)
+        {
+            count = chunk_window_collect(offsets);
+        }
+        mqtt_handle = chunk_window_mqtt;
+        xSemaphoreGive(chunk_window_mutex);
+
+        /* Publish without holding the lock, chunks keep arriving meanwhile */
+        for (i = 0; i < count; i++)
+        {
+            chunk_window_request(mqtt_handle, offsets[i]);
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: chunk_window_collect
+ *******************************************************************************
+ * Summary:
+ *  Picks the chunks to request now: timed out requests first, then new chunks
+ *  for the free slots. Until the image size is known only the first chunk is
+ *  requested. Called with the window lock held.
+ *
+ * Parameters:
+ *  uint32_t offsets[] : Receives up to OTA_CHUNK_WINDOW_SIZE chunk offsets
+ *
+ * Return:
+ *  uint32_t : Number of chunks to request
+ *
+ *******************************************************************************/
+static uint32_t chunk_window_collect(uint32_t offsets[])
+{
+    TickType_t now = xTaskGetTickCount();
+    uint32_t count = 0;
+    uint32_t gap_offset;
+    uint32_t gap_len;
+    uint32_t i;
+
+    for (i = 0; i < OTA_CHUNK_WINDOW_SIZE; i++)
+    {
+        chunk_window_slot_t *slot = &chunk_window_slots[i];
+
+        if (!slot->busy || ((now - slot->sent) < pdMS_TO_TICKS(CHUNK_WINDOW_TIMEOUT_MS)))
+        {
+            continue;
+        }
+
+        if (slot->tries >= CHUNK_WINDOW_MAX_RETRIES)
+        {
+            printf("\n Chunk at offset %lu not received, giving up.\n", (unsigned long)slot->offset);
+            chunk_window_active = false;
+            return 0;
+        }
+
+        slot->tries++;
+        chunk_window_retry_count++;
+        slot->sent = now;
+        offsets[count++] = slot->offset;
+    }
+
+    for (i = 0; i < OTA_CHUNK_WINDOW_SIZE; i++)
+    {
+        chunk_window_slot_t *slot = &chunk_window_slots[i];
+
+        if (slot->busy)
+        {
+            continue;
+        }
+
+        if (chunk_window_next_prefetch(&slot->offset))
+        {
+            /* Requested out of order, chunk_window_next_offset stays */
+        }
+        else if (chunk_window_received.total_size == 0)
+        {
+            if (chunk_window_next_offset != 0)
+            {
+                break;
+            }
+            slot->offset = chunk_window_next_offset;
+            chunk_window_next_offset += OTA_CHUNK_SIZE;
+        }
+        else
+        {
+            /* Skip chunks that arrived after a retry of an earlier request,
+             * and prefetched chunks that are still on their way */
+            while (cy_ota_range_next_gap(&chunk_window_received, chunk_window_next_offset, &gap_offset, &gap_len) &&
+                   chunk_window_is_pending(gap_offset))
+            {
+                chunk_window_next_offset = gap_offset + OTA_CHUNK_SIZE;
+            }
+
+            if (!cy_ota_range_next_gap(&chunk_window_received, chunk_window_next_offset, &gap_offset, &gap_len))
+            {
+                break;
+            }
+            slot->offset = gap_offset;
+            chunk_window_next_offset = gap_offset + OTA_CHUNK_SIZE;
+        }
+
+        slot->busy = true;
+        slot->sent = now;
+        slot->tries = 1;
+        offsets[count++] = slot->offset;
+    }
+
+    return count;
+}
+
+/*******************************************************************************
+ * Function Name: chunk_window_is_pending
+ *******************************************************************************
+ * Summary:
+ *  Checks whether a chunk has been requested and not received yet. Called
+ *  with the window lock held.
+ *
+ *******************************************************************************/
+static bool chunk_window_is_pending(uint32_t offset)
+{
+    uint32_t i;
+
+    for (i = 0; i < OTA_CHUNK_WINDOW_SIZE; i++)
+    {
+        if (chunk_window_slots[i].busy && (chunk_window_slots[i].offset == offset))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*******************************************************************************
+ * Function Name: chunk_window_next_prefetch
+ *******************************************************************************
+ * Summary:
+ *  Picks the next chunk of the prefetch range that is neither received nor
+ *  requested. The image size must be known. Called with the window lock held.
+ *
+ * Parameters:
+ *  uint32_t *offset : Receives the offset of the chunk
+ *
+ * Return:
+ *  bool : true if a chunk was picked
+ *
+ *******************************************************************************/
+static bool chunk_window_next_prefetch(uint32_t *offset)
+{
+    uint32_t next;
+
+    if (chunk_window_received.total_size == 0)
+    {
+        return false;
+    }
+
+    while ((chunk_window_prefetch_offset < chunk_window_prefetch_end) &&
+           (chunk_window_prefetch_offset < chunk_window_received.total_size))
+    {
+        next = chunk_window_prefetch_offset;
+        chunk_window_prefetch_offset += OTA_CHUNK_SIZE;
+
+        if (!cy_ota_range_contains(&chunk_window_received, next, 1u) && !chunk_window_is_pending(next))
+        {
+            *offset = next;
+            return true;
+        }
+    }
+
+    chunk_window_prefetch_end = 0;
+    return false;
+}
+
+/*******************************************************************************
+ * Function Name: chunk_window_request
+ *******************************************************************************
+ * Summary:
+ *  Publishes the request for one chunk with QoS 0. A lost request is sent
+ *  again when it times out.
+ *
+ * Parameters:
+ *  cy_mqtt_t mqtt_handle : Data connection of the OTA agent
+ *  uint32_t offset       : Image offset of the chunk
+ *
+ *******************************************************************************/
+static void chunk_window_request(cy_mqtt_t mqtt_handle, uint32_t offset)
+{
+    static char doc[CHUNK_WINDOW_DOC_MAX_LEN];
+    cy_mqtt_publish_info_t pub_info;
+    int doc_len;
+    cy_rslt_t result;
+
+    doc_len = snprintf(doc, sizeof(doc), CHUNK_WINDOW_REQUEST_JSON, chunk_window_topic,
+                       (unsigned long)offset, (unsigned long)OTA_CHUNK_SIZE);
+    if ((doc_len < 0) || ((size_t)doc_len >= sizeof(doc)))
+    {
+        return;
+    }
+
+    memset(&pub_info, 0, sizeof(pub_info));
+    pub_info.qos = CY_MQTT_QOS0;
+    pub_info.topic = CHUNK_WINDOW_REQUEST_TOPIC;
+    pub_info.topic_len = (uint16_t)(sizeof(CHUNK_WINDOW_REQUEST_TOPIC) - 1u);
+    pub_info.payload = doc;
+    pub_info.payload_len = (size_t)doc_len;
+
+    result = cy_mqtt_publish(mqtt_handle, &pub_info);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        printf("\n Requesting chunk at offset %lu failed: 0x%lx\n", (unsigned long)offset, (unsigned long)result);
+    }
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,111 @@
+/******************************************************************************
+* File Name: chunk_window.h
+*
+* Description: This file contains declaration of the windowed chunk requester
+* that keeps several OTA data chunk requests outstanding at once.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef SOURCE_CHUNK_WINDOW_H_
+#define SOURCE_CHUNK_WINDOW_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "cy_ota_api.h"
+#include "cy_ota_range.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Number of chunk requests kept outstanding. Set with OTA_CHUNK_WINDOW in the
+ * Makefile. */
+#ifndef OTA_CHUNK_WINDOW_SIZE
+#define OTA_CHUNK_WINDOW_SIZE               (4u)
+#endif
+
+/* Size of the OTA image data requested per chunk. The MQTT payload is the
+ * chunk plus a 32 byte header and must fit the OTA agent's receive buffer. */
+#ifndef OTA_CHUNK_SIZE
+#define OTA_CHUNK_SIZE                      (4096u)
+#endif
+
+/* Largest image that can be downloaded, in chunks */
+#ifndef CHUNK_WINDOW_MAX_CHUNKS
+#define CHUNK_WINDOW_MAX_CHUNKS             (1024u)
+#endif
+
+/* A chunk that has not arrived after this time is requested again. Keep it
+ * well above the round trip time, every chunk that arrives twice is sent
+ * twice by the publisher. */
+#ifndef CHUNK_WINDOW_TIMEOUT_MS
+#define CHUNK_WINDOW_TIMEOUT_MS             (10000u)
+#endif
+
+/* Requests of one chunk before the download is given up */
+#ifndef CHUNK_WINDOW_MAX_RETRIES
+#define CHUNK_WINDOW_MAX_RETRIES            (3u)
+#endif
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+cy_rslt_t chunk_window_init(void);
+
+/* Starts requesting the image on the data connection of the OTA agent. The
+ * chunks arrive on unique_topic. To resume a download, pass the chunks already
+ * written, tracked in units of OTA_CHUNK_SIZE, else NULL. */
+cy_rslt_t chunk_window_start(cy_mqtt_t mqtt_handle, const char *unique_topic,
+                             const cy_ota_range_t *resume);
+
+/* Stops requesting, e.g. when the data connection is closed */
+void chunk_window_stop(void);
+
+/* Requests the chunks covering len bytes at offset before continuing in
+ * order, e.g. the TLV area at the end of the image. */
+void chunk_window_prefetch(uint32_t offset, uint32_t len);
+
+/* Number of chunk requests sent again in the current download */
+uint32_t chunk_window_retries(void);
+
+/* Called for every chunk handed to the OTA storage. Returns false if the
+ * chunk was already received and must not be written again. */
+bool chunk_window_on_chunk(const cy_ota_storage_write_info_t *chunk_info);
+
+/* Returns false while a windowed download still misses chunks. The byte count
+ * of the OTA agent does not tell, the agent may reach the image size with the
+ * copy of a chunk that was requested again. */
+bool chunk_window_complete(void);
+
+#endif /* SOURCE_CHUNK_WINDOW_H_ */
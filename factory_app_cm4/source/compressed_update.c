@@ -0,0 +1,190 @@
+/******************************************************************************
+* File Name: compressed_update.c
+*
+* Description: This file contains the compressed image path of the OTA storage.
+* A download that starts with a compressed stream header is decoded frame by
+* frame while it arrives, and the decoded blocks are written to the secondary
+* slot at their image offset.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include <stdio.h>
+#include <string.h>
+#include "cyhal.h"
+#include "cybsp.h"
+#include "cy_retarget_io.h"
+#include "compressed_update.h"
+#include "ota_compress.h"
+#include "flash_service.h"
+/* FreeRTOS */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static cy_rslt_t compressed_update_write_image(void *arg, uint32_t offset, const void *data, size_t len);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Stream decoder. Holds the block buffer, so it is not on a task stack. */
+static ota_compress_t comp_decoder;
+
+/* The current download is compressed */
+static bool comp_active;
+
+/* Time the first chunk of the stream arrived */
+static TickType_t comp_start;
+
+/*******************************************************************************
+ * Function Name: compressed_update_reset
+ *******************************************************************************
+ * Summary:
+ *  Forgets the previous download.
+ *
+ *******************************************************************************/
+void compressed_update_reset(void)
+{
+    comp_active = false;
+}
+
+/*******************************************************************************
+ * Function Name: compressed_update_is_stream
+ *******************************************************************************
+ * Summary:
+ *  Decides on the first chunk whether the download is compressed and starts
+ *  the decoder if it is.
+ *
+ * Parameters:
+ *  const cy_ota_storage_write_info_t *chunk_info : Chunk from the OTA agent
+ *
+ * Return:
+ *  bool : true if the download is compressed
+ *
+ *******************************************************************************/
+bool compressed_update_is_stream(const cy_ota_storage_write_info_t *chunk_info)
+{
+    if ((chunk_info->offset == 0) && !comp_active &&
+        ota_compress_is_stream(chunk_info->buffer, chunk_info->size))
+    {
+        printf("\n Download is a compressed image of %lu bytes.\n", (unsigned long)chunk_info->total_size);
+        ota_compress_init(&comp_decoder, compressed_update_write_image, NULL);
+        comp_active = true;
+        comp_start = xTaskGetTickCount();
+    }
+
+    return comp_active;
+}
+
+/*******************************************************************************
+ * Function Name: compressed_update_write
+ *******************************************************************************
+ * Summary:
+ *  Decodes one chunk of the stream. Each chunk is a frame of whole blocks, so
+ *  it is decoded on its own.
+ *
+ * Parameters:
+ *  cy_ota_context_ptr ctx_ptr              : OTA context
+ *  cy_ota_storage_write_info_t *chunk_info : Chunk from the OTA agent
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS on success, error code otherwise
+ *
+ *******************************************************************************/
+cy_rslt_t compressed_update_write(cy_ota_context_ptr ctx_ptr, cy_ota_storage_write_info_t *chunk_info)
+{
+    comp_decoder.arg = ctx_ptr;
+    return ota_compress_frame(&comp_decoder, chunk_info->offset, chunk_info->buffer, chunk_info->size);
+}
+
+/*******************************************************************************
+ * Function Name: compressed_update_finish
+ *******************************************************************************
+ * Summary:
+ *  Checks the image is complete and prints the compression ratio.
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS on success, error code otherwise
+ *
+ *******************************************************************************/
+cy_rslt_t compressed_update_finish(void)
+{
+    cy_rslt_t result;
+    uint32_t elapsed_ms;
+
+    if (!comp_active)
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    comp_active = false;
+    result = ota_compress_finish(&comp_decoder);
+    if (CY_RSLT_SUCCESS == result)
+    {
+        elapsed_ms = (uint32_t)((xTaskGetTickCount() - comp_start) * portTICK_PERIOD_MS);
+        printf("\n Compressed update: %lu bytes downloaded for a %lu byte image (%lu%%) in %lu ms.\n",
+               (unsigned long)comp_decoder.stream_bytes, (unsigned long)comp_decoder.raw_size,
+               (unsigned long)((comp_decoder.stream_bytes * 100ull) / comp_decoder.raw_size),
+               (unsigned long)elapsed_ms);
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: compressed_update_write_image
+ *******************************************************************************
+ * Summary:
+ *  Writes a decoded block to the OTA storage, the same way the OTA agent
+ *  writes the chunks of an uncompressed image.
+ *
+ *******************************************************************************/
+static cy_rslt_t compressed_update_write_image(void *arg, uint32_t offset, const void *data, size_t len)
+{
+    cy_ota_storage_write_info_t info = { 0 };
+    uint32_t total_size = comp_decoder.raw_size;
+
+    info.total_size = total_size;
+    info.offset = offset;
+    info.buffer = (uint8_t *)data;
+    info.size = (uint32_t)len;
+    info.packet_number = (uint16_t)(offset / OTA_COMPRESS_BLOCK_SIZE);
+    info.total_packets = (uint16_t)((total_size + OTA_COMPRESS_BLOCK_SIZE - 1u) / OTA_COMPRESS_BLOCK_SIZE);
+
+    return flash_service_storage_write((cy_ota_context_ptr)arg, &info);
+}
+
+/* [] END OF FILE */
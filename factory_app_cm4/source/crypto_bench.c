@@ -0,0 +1,298 @@
+/******************************************************************************
+* File Name: crypto_bench.c
+*
+* Description: This file implements the benchmark of the mbed TLS primitives used by
+* the TLS connection to the broker, to compare the crypto block alternates
+* with the software implementation.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/* Header file includes */
+#include <stdio.h>
+#include <string.h>
+#include "cyhal.h"
+#include "cybsp.h"
+#include "cy_retarget_io.h"
+#include "crypto_bench.h"
+#include "mbedtls/gcm.h"
+#include "mbedtls/sha256.h"
+#include "mbedtls/ecdh.h"
+#include "mbedtls/ecdsa.h"
+#include "mbedtls/entropy.h"
+#include "mbedtls/ctr_drbg.h"
+/* FreeRTOS */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define CRYPTO_BENCH_TICKS_TO_MS(t)         ((uint32_t)((t) * portTICK_PERIOD_MS))
+
+/* Implementation of a primitive in the summary */
+#define CRYPTO_BENCH_IMPL(alt)              ((alt) ? "\"hw\"" : "\"sw\"")
+
+#ifdef MBEDTLS_AES_ALT
+#define CRYPTO_BENCH_AES_ALT                (1)
+#else
+#define CRYPTO_BENCH_AES_ALT                (0)
+#endif
+
+#ifdef MBEDTLS_SHA256_ALT
+#define CRYPTO_BENCH_SHA256_ALT             (1)
+#else
+#define CRYPTO_BENCH_SHA256_ALT             (0)
+#endif
+
+#ifdef MBEDTLS_ECP_ALT
+#define CRYPTO_BENCH_ECP_ALT                (1)
+#else
+#define CRYPTO_BENCH_ECP_ALT                (0)
+#endif
+
+/*******************************************************************************
+* Data Structures
+********************************************************************************/
+typedef struct
+{
+    uint32_t                    gcm_kib_s;      /* AES-128-GCM encryption */
+    uint32_t                    sha256_kib_s;
+    uint32_t                    ecdh_ms;        /* Key pair and shared secret */
+    uint32_t                    ecdsa_sign_ms;
+    uint32_t                    ecdsa_verify_ms;
+} crypto_bench_result_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static int crypto_bench_records(crypto_bench_result_t *result);
+static int crypto_bench_ecp(crypto_bench_result_t *result, mbedtls_ctr_drbg_context *drbg);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static uint8_t crypto_bench_in[CRYPTO_BENCH_RECORD_SIZE];
+static uint8_t crypto_bench_out[CRYPTO_BENCH_RECORD_SIZE];
+
+/*******************************************************************************
+ * Function Name: crypto_bench_run
+ *******************************************************************************
+ * Summary:
+ *  Runs the benchmark and prints the result. Which primitives use the crypto
+ *  block is reported with the numbers, so results of builds with and without
+ *  MBEDTLS_ACCEL can be compared with scripts/ota_bench.py.
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS on success, error code otherwise
+ *
+ *******************************************************************************/
+cy_rslt_t crypto_bench_run(void)
+{
+    mbedtls_entropy_context entropy;
+    mbedtls_ctr_drbg_context drbg;
+    crypto_bench_result_t result;
+    int ret;
+
+    memset(&result, 0, sizeof(result));
+    mbedtls_entropy_init(&entropy);
+    mbedtls_ctr_drbg_init(&drbg);
+
+    ret = mbedtls_ctr_drbg_seed(&drbg, mbedtls_entropy_func, &entropy, NULL, 0);
+    if (ret == 0)
+    {
+        ret = crypto_bench_records(&result);
+    }
+    if (ret == 0)
+    {
+        ret = crypto_bench_ecp(&result, &drbg);
+    }
+
+    mbedtls_ctr_drbg_free(&drbg);
+    mbedtls_entropy_free(&entropy);
+
+    if (ret != 0)
+    {
+        printf("\n Crypto benchmark failed: -0x%04x\n", (unsigned int)-ret);
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    printf("\n" CRYPTO_BENCH_LOG_PREFIX "{\"aes\":%s,\"sha256\":%s,\"ecp\":%s,\"record_size\":%u,"
+           "\"gcm_kib_s\":%lu,\"sha256_kib_s\":%lu,\"ecdh_ms\":%lu,\"ecdsa_sign_ms\":%lu,\"ecdsa_verify_ms\":%lu}\n",
+           CRYPTO_BENCH_IMPL(CRYPTO_BENCH_AES_ALT), CRYPTO_BENCH_IMPL(CRYPTO_BENCH_SHA256_ALT),
+           CRYPTO_BENCH_IMPL(CRYPTO_BENCH_ECP_ALT), (unsigned int)CRYPTO_BENCH_RECORD_SIZE,
+           (unsigned long)result.gcm_kib_s, (unsigned long)result.sha256_kib_s,
+           (unsigned long)result.ecdh_ms, (unsigned long)result.ecdsa_sign_ms,
+           (unsigned long)result.ecdsa_verify_ms);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: crypto_bench_records
+ *******************************************************************************
+ * Summary:
+ *  Encrypts records with AES-128-GCM and hashes them with SHA-256 for at least
+ *  CRYPTO_BENCH_MIN_MS each, and converts the counts to KiB/s.
+ *
+ *******************************************************************************/
+static int crypto_bench_records(crypto_bench_result_t *result)
+{
+    static const uint8_t key[16] = { 0 };
+    uint8_t iv[12] = { 0 };
+    uint8_t tag[16];
+    uint8_t hash[32];
+    mbedtls_gcm_context gcm;
+    TickType_t start;
+    uint32_t records;
+    uint32_t ms;
+    int ret;
+
+    memset(crypto_bench_in, 0xA5, sizeof(crypto_bench_in));
+
+    mbedtls_gcm_init(&gcm);
+    ret = mbedtls_gcm_setkey(&gcm, MBEDTLS_CIPHER_ID_AES, key, 128);
+    start = xTaskGetTickCount();
+    for (records = 0, ms = 0; (ret == 0) && (ms < CRYPTO_BENCH_MIN_MS); records++)
+    {
+        /* A new nonce per record, like the TLS record layer */
+        iv[11] = (uint8_t)records;
+        ret = mbedtls_gcm_crypt_and_tag(&gcm, MBEDTLS_GCM_ENCRYPT, sizeof(crypto_bench_in), iv, sizeof(iv),
+                                        NULL, 0, crypto_bench_in, crypto_bench_out, sizeof(tag), tag);
+        ms = CRYPTO_BENCH_TICKS_TO_MS(xTaskGetTickCount() - start);
+    }
+    mbedtls_gcm_free(&gcm);
+    if (ret != 0)
+    {
+        return ret;
+    }
+    result->gcm_kib_s = (uint32_t)(((uint64_t)records * sizeof(crypto_bench_in) * 1000u) / (ms * 1024u));
+
+    start = xTaskGetTickCount();
+    for (records = 0, ms = 0; (ret == 0) && (ms < CRYPTO_BENCH_MIN_MS); records++)
+    {
+        ret = mbedtls_sha256(crypto_bench_in, sizeof(crypto_bench_in), hash, 0);
+        ms = CRYPTO_BENCH_TICKS_TO_MS(xTaskGetTickCount() - start);
+    }
+    if (ret != 0)
+    {
+        return ret;
+    }
+    result->sha256_kib_s = (uint32_t)(((uint64_t)records * sizeof(crypto_bench_in) * 1000u) / (ms * 1024u));
+
+    return 0;
+}
+
+/*******************************************************************************
+ * Function Name: crypto_bench_ecp
+ *******************************************************************************
+ * Summary:
+ *  Times the P-256 operations of an ECDHE-ECDSA handshake: generating the
+ *  ephemeral key pair and the shared secret, signing and verifying. Each is
+ *  repeated for at least CRYPTO_BENCH_MIN_MS and the average is reported.
+ *
+ *******************************************************************************/
+static int crypto_bench_ecp(crypto_bench_result_t *result, mbedtls_ctr_drbg_context *drbg)
+{
+    mbedtls_ecp_group grp;
+    mbedtls_ecp_point q;
+    mbedtls_ecp_point peer_q;
+    mbedtls_mpi d;
+    mbedtls_mpi peer_d;
+    mbedtls_mpi z;
+    mbedtls_mpi r;
+    mbedtls_mpi s;
+    uint8_t hash[32];
+    TickType_t start;
+    uint32_t n;
+    uint32_t ms;
+    int ret;
+
+    mbedtls_ecp_group_init(&grp);
+    mbedtls_ecp_point_init(&q);
+    mbedtls_ecp_point_init(&peer_q);
+    mbedtls_mpi_init(&d);
+    mbedtls_mpi_init(&peer_d);
+    mbedtls_mpi_init(&z);
+    mbedtls_mpi_init(&r);
+    mbedtls_mpi_init(&s);
+    memset(hash, 0x5A, sizeof(hash));
+
+    ret = mbedtls_ecp_group_load(&grp, MBEDTLS_ECP_DP_SECP256R1);
+    if (ret == 0)
+    {
+        ret = mbedtls_ecdh_gen_public(&grp, &peer_d, &peer_q, mbedtls_ctr_drbg_random, drbg);
+    }
+
+    start = xTaskGetTickCount();
+    for (n = 0, ms = 0; (ret == 0) && (ms < CRYPTO_BENCH_MIN_MS); n++)
+    {
+        ret = mbedtls_ecdh_gen_public(&grp, &d, &q, mbedtls_ctr_drbg_random, drbg);
+        if (ret == 0)
+        {
+            ret = mbedtls_ecdh_compute_shared(&grp, &z, &peer_q, &d, mbedtls_ctr_drbg_random, drbg);
+        }
+        ms = CRYPTO_BENCH_TICKS_TO_MS(xTaskGetTickCount() - start);
+    }
+    result->ecdh_ms = (n != 0) ? (ms / n) : 0u;
+
+    start = xTaskGetTickCount();
+    for (n = 0, ms = 0; (ret == 0) && (ms < CRYPTO_BENCH_MIN_MS); n++)
+    {
+        ret = mbedtls_ecdsa_sign(&grp, &r, &s, &d, hash, sizeof(hash), mbedtls_ctr_drbg_random, drbg);
+        ms = CRYPTO_BENCH_TICKS_TO_MS(xTaskGetTickCount() - start);
+    }
+    result->ecdsa_sign_ms = (n != 0) ? (ms / n) : 0u;
+
+    start = xTaskGetTickCount();
+    for (n = 0, ms = 0; (ret == 0) && (ms < CRYPTO_BENCH_MIN_MS); n++)
+    {
+        ret = mbedtls_ecdsa_verify(&grp, hash, sizeof(hash), &q, &r, &s);
+        ms = CRYPTO_BENCH_TICKS_TO_MS(xTaskGetTickCount() - start);
+    }
+    result->ecdsa_verify_ms = (n != 0) ? (ms / n) : 0u;
+
+    mbedtls_mpi_free(&s);
+    mbedtls_mpi_free(&r);
+    mbedtls_mpi_free(&z);
+    mbedtls_mpi_free(&peer_d);
+    mbedtls_mpi_free(&d);
+    mbedtls_ecp_point_free(&peer_q);
+    mbedtls_ecp_point_free(&q);
+    mbedtls_ecp_group_free(&grp);
+
+    return ret;
+}
+
+/* [] END OF FILE */
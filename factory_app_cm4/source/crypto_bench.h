@@ -0,0 +1,69 @@
+/******************************************************************************
+* File Name: crypto_bench.h
+*
+* Description: This file contains the declarations of the benchmark of the mbed TLS
+* primitives used by the TLS connection to the broker.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef SOURCE_CRYPTO_BENCH_H_
+#define SOURCE_CRYPTO_BENCH_H_
+
+#include "cy_result.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Size of the records encrypted and hashed, the largest TLS record */
+#ifndef CRYPTO_BENCH_RECORD_SIZE
+#define CRYPTO_BENCH_RECORD_SIZE            (1024u)
+#endif
+
+/* Each primitive is repeated for at least this long */
+#ifndef CRYPTO_BENCH_MIN_MS
+#define CRYPTO_BENCH_MIN_MS                 (500u)
+#endif
+
+/* Prefix of the result line on the debug UART, see scripts/ota_bench.py */
+#define CRYPTO_BENCH_LOG_PREFIX             "CRYPTO_BENCH "
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Times AES-128-GCM and SHA-256 record processing and the P-256 operations of
+ * a handshake, and prints the result as one JSON line */
+cy_rslt_t crypto_bench_run(void);
+
+#endif /* SOURCE_CRYPTO_BENCH_H_ */
@@ -0,0 +1,233 @@
+/******************************************************************************
+* File Name: delta_update.c
+*
+* Description: This file contains the delta update path of the OTA storage. A
+* download that starts with a patch header is not written to the secondary slot
+* as is. The patch is applied against the image in the primary slot and the
+* resulting image is written instead, so only the changed parts of the image
+* have to be downloaded.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include <stdio.h>
+#include <string.h>
+#include "cyhal.h"
+#include "cybsp.h"
+#include "cy_retarget_io.h"
+#include "delta_update.h"
+#include "ota_delta.h"
+#include "flash_service.h"
+/* FreeRTOS */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Offset of the source image as used by the flash driver. The flash map may
+ * give the primary slot as an address or as an offset into the flash. */
+#define DELTA_UPDATE_SOURCE_OFFSET \
+    ((OTA_DELTA_SOURCE_ADDR >= CY_FLASH_BASE) ? (OTA_DELTA_SOURCE_ADDR - CY_FLASH_BASE) : OTA_DELTA_SOURCE_ADDR)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static cy_rslt_t delta_update_read_source(void *arg, uint32_t offset, void *data, size_t len);
+static cy_rslt_t delta_update_write_image(void *arg, uint32_t offset, const void *data, size_t len, bool last);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Patch decoder. Holds the output block, so it is not on a task stack. */
+static ota_delta_t delta_decoder;
+
+/* The current download is a patch */
+static bool delta_active;
+
+/* Patch offset of the next expected chunk */
+static uint32_t delta_next_offset;
+
+/* Time the first chunk of the patch arrived */
+static TickType_t delta_start;
+
+/*******************************************************************************
+ * Function Name: delta_update_reset
+ *******************************************************************************
+ * Summary:
+ *  Forgets the previous download.
+ *
+ *******************************************************************************/
+void delta_update_reset(void)
+{
+    delta_active = false;
+    delta_next_offset = 0;
+}
+
+/*******************************************************************************
+ * Function Name: delta_update_is_patch
+ *******************************************************************************
+ * Summary:
+ *  Decides on the first chunk whether the download is a patch and starts the
+ *  decoder if it is.
+ *
+ * Parameters:
+ *  const cy_ota_storage_write_info_t *chunk_info : Chunk from the OTA agent
+ *
+ * Return:
+ *  bool : true if the download is a patch
+ *
+ *******************************************************************************/
+bool delta_update_is_patch(const cy_ota_storage_write_info_t *chunk_info)
+{
+    if ((chunk_info->offset == 0) && !delta_active &&
+        ota_delta_is_patch(chunk_info->buffer, chunk_info->size))
+    {
+        printf("\n Download is a delta patch of %lu bytes, applying it to the primary slot.\n",
+               (unsigned long)chunk_info->total_size);
+        ota_delta_init(&delta_decoder, delta_update_read_source, delta_update_write_image, NULL);
+        delta_active = true;
+        delta_next_offset = 0;
+        delta_start = xTaskGetTickCount();
+    }
+
+    return delta_active;
+}
+
+/*******************************************************************************
+ * Function Name: delta_update_write
+ *******************************************************************************
+ * Summary:
+ *  Applies the next chunk of the patch. The decoder needs the patch in order,
+ *  a chunk at any other offset fails the update.
+ *
+ * Parameters:
+ *  cy_ota_context_ptr ctx_ptr              : OTA context
+ *  cy_ota_storage_write_info_t *chunk_info : Chunk from the OTA agent
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS on success, error code otherwise
+ *
+ *******************************************************************************/
+cy_rslt_t delta_update_write(cy_ota_context_ptr ctx_ptr, cy_ota_storage_write_info_t *chunk_info)
+{
+    if (chunk_info->offset != delta_next_offset)
+    {
+        printf("\n Delta update: chunk at offset %lu, expected %lu.\n",
+               (unsigned long)chunk_info->offset, (unsigned long)delta_next_offset);
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    delta_decoder.arg = ctx_ptr;
+    delta_next_offset += chunk_info->size;
+
+    return ota_delta_feed(&delta_decoder, chunk_info->buffer, chunk_info->size);
+}
+
+/*******************************************************************************
+ * Function Name: delta_update_finish
+ *******************************************************************************
+ * Summary:
+ *  Checks the new image and prints how long applying the patch took.
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS on success, error code otherwise
+ *
+ *******************************************************************************/
+cy_rslt_t delta_update_finish(void)
+{
+    cy_rslt_t result;
+    uint32_t elapsed_ms;
+
+    if (!delta_active)
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    delta_active = false;
+    result = ota_delta_finish(&delta_decoder);
+    if (CY_RSLT_SUCCESS == result)
+    {
+        elapsed_ms = (uint32_t)((xTaskGetTickCount() - delta_start) * portTICK_PERIOD_MS);
+        printf("\n Delta update: %lu byte patch produced a %lu byte image in %lu ms (%lu%% of the image downloaded).\n",
+               (unsigned long)delta_decoder.patch_bytes, (unsigned long)delta_decoder.written,
+               (unsigned long)elapsed_ms,
+               (unsigned long)((delta_decoder.patch_bytes * 100ull) / delta_decoder.written));
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: delta_update_read_source
+ *******************************************************************************
+ * Summary:
+ *  Reads the image in the primary slot.
+ *
+ *******************************************************************************/
+static cy_rslt_t delta_update_read_source(void *arg, uint32_t offset, void *data, size_t len)
+{
+    if ((offset > OTA_DELTA_SOURCE_SIZE) || (len > (OTA_DELTA_SOURCE_SIZE - offset)))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    return flash_service_read(CY_OTA_MEM_TYPE_INTERNAL_FLASH, DELTA_UPDATE_SOURCE_OFFSET + offset, data, len);
+}
+
+/*******************************************************************************
+ * Function Name: delta_update_write_image
+ *******************************************************************************
+ * Summary:
+ *  Writes a block of the new image to the OTA storage, the same way the OTA
+ *  agent writes the chunks of a full image.
+ *
+ *******************************************************************************/
+static cy_rslt_t delta_update_write_image(void *arg, uint32_t offset, const void *data, size_t len, bool last)
+{
+    cy_ota_storage_write_info_t info = { 0 };
+    uint32_t total_size = delta_decoder.header.target_size;
+
+    info.total_size = total_size;
+    info.offset = offset;
+    info.buffer = (uint8_t *)data;
+    info.size = (uint32_t)len;
+    info.packet_number = (uint16_t)(offset / OTA_DELTA_OUT_SIZE);
+    info.total_packets = (uint16_t)((total_size + OTA_DELTA_OUT_SIZE - 1u) / OTA_DELTA_OUT_SIZE);
+
+    (void)last;
+    return flash_service_storage_write((cy_ota_context_ptr)arg, &info);
+}
+
+/* [] END OF FILE */
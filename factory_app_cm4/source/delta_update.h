@@ -0,0 +1,78 @@
+/******************************************************************************
+* File Name: delta_update.h
+*
+* Description: This file contains the declarations of the delta update path of
+* the OTA storage.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef SOURCE_DELTA_UPDATE_H_
+#define SOURCE_DELTA_UPDATE_H_
+
+#include <stdbool.h>
+#include "cy_ota_api.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Primary slot holding the image a patch is applied to. Set from the flash map
+ * in the Makefile. */
+#ifndef OTA_DELTA_SOURCE_ADDR
+#define OTA_DELTA_SOURCE_ADDR               (0x10018000u)
+#endif
+
+#ifndef OTA_DELTA_SOURCE_SIZE
+#define OTA_DELTA_SOURCE_SIZE               (0x001C0000u)
+#endif
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Called when the OTA storage is opened for a new download */
+void delta_update_reset(void);
+
+/* Returns true if chunk_info belongs to a patch. The first chunk of the
+ * download decides whether it is a patch or a full image. */
+bool delta_update_is_patch(const cy_ota_storage_write_info_t *chunk_info);
+
+/* Applies the next chunk of the patch and writes the resulting part of the
+ * new image to the OTA storage. Chunks must arrive in order. */
+cy_rslt_t delta_update_write(cy_ota_context_ptr ctx_ptr, cy_ota_storage_write_info_t *chunk_info);
+
+/* Completes the patch. Returns an error if the new image is incomplete or
+ * corrupt. Does nothing for a full image. */
+cy_rslt_t delta_update_finish(void);
+
+#endif /* SOURCE_DELTA_UPDATE_H_ */
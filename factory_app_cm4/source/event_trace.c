@@ -0,0 +1,309 @@
+/******************************************************************************
+* File Name: event_trace.c
+*
+* Description: This file contains the event trace recorder. Events are kept in a
+* RAM ring buffer of fixed size records, the oldest are overwritten, and are
+* printed to the debug UART on request.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include <stdio.h>
+#include <stdbool.h>
+#include "cyhal.h"
+#include "cybsp.h"
+#include "cy_retarget_io.h"
+#include "event_trace.h"
+#include "cy_mqtt_api.h"
+#include "cy_ota_api.h"
+/* FreeRTOS */
+#include <FreeRTOS.h>
+#include <task.h>
+
+#ifdef EVENT_TRACE_ENABLE
+/*******************************************************************************
+* Data Structures
+********************************************************************************/
+typedef struct
+{
+    uint32_t                    time;       /* 2^EVENT_TRACE_TIME_SHIFT CPU cycles */
+    uint8_t                     type;       /* event_trace_type_t */
+    uint8_t                     id;
+    uint16_t                    arg16;
+    uint32_t                    arg;
+} event_trace_event_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static uint32_t event_trace_now(void);
+cy_rslt_t __real_cy_mqtt_publish(cy_mqtt_t mqtt_handle, cy_mqtt_publish_info_t *pub_msg);
+cy_rslt_t __wrap_cy_mqtt_publish(cy_mqtt_t mqtt_handle, cy_mqtt_publish_info_t *pub_msg);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Ring buffer, trace_count is the number of events recorded since the start */
+static event_trace_event_t trace_events[EVENT_TRACE_EVENTS];
+static uint32_t trace_count;
+static bool trace_running;
+static bool trace_dumping;
+
+/* Cycle counter extended to 64 bits on every event and every tick */
+static uint32_t trace_cycles_high;
+static uint32_t trace_cycles_last;
+
+/* Task names of the dump */
+static TaskStatus_t trace_task_status[EVENT_TRACE_MAX_TASKS];
+
+/*******************************************************************************
+ * Function Name: event_trace_init
+ *******************************************************************************
+ * Summary:
+ *  Starts the CPU cycle counter and the recording. Called before the
+ *  scheduler is started.
+ *
+ *******************************************************************************/
+void event_trace_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    trace_cycles_last = DWT->CYCCNT;
+    trace_running = true;
+}
+
+/*******************************************************************************
+ * Function Name: event_trace_now
+ *******************************************************************************
+ * Summary:
+ *  Returns the time stamp of an event. Called with interrupts masked.
+ *
+ * Return:
+ *  uint32_t : Time in 2^EVENT_TRACE_TIME_SHIFT CPU cycles
+ *
+ *******************************************************************************/
+static uint32_t event_trace_now(void)
+{
+    uint32_t now = DWT->CYCCNT;
+
+    if (now < trace_cycles_last)
+    {
+        trace_cycles_high++;
+    }
+    trace_cycles_last = now;
+
+    return (trace_cycles_high << (32u - EVENT_TRACE_TIME_SHIFT)) | (now >> EVENT_TRACE_TIME_SHIFT);
+}
+
+/*******************************************************************************
+ * Function Name: event_trace_record
+ *******************************************************************************
+ * Summary:
+ *  Records one event, overwriting the oldest one when the buffer is full.
+ *  Takes a few dozen cycles with the interrupts up to
+ *  configMAX_SYSCALL_INTERRUPT_PRIORITY masked, from tasks and interrupts.
+ *
+ * Parameters:
+ *  event_trace_type_t type : Event type
+ *  uint8_t id              : Event specific, see event_trace_type_t
+ *  uint16_t arg16          : Event specific, see event_trace_type_t
+ *  uint32_t arg            : Event specific, see event_trace_type_t
+ *
+ *******************************************************************************/
+void event_trace_record(event_trace_type_t type, uint8_t id, uint16_t arg16, uint32_t arg)
+{
+    UBaseType_t mask;
+    event_trace_event_t *event;
+
+    mask = portSET_INTERRUPT_MASK_FROM_ISR();
+    if (trace_running)
+    {
+        event = &trace_events[trace_count & (EVENT_TRACE_EVENTS - 1u)];
+        event->time = event_trace_now();
+        event->type = (uint8_t)type;
+        event->id = id;
+        event->arg16 = arg16;
+        event->arg = arg;
+        trace_count++;
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(mask);
+}
+
+/*******************************************************************************
+ * Function Name: event_trace_task_switch
+ *******************************************************************************
+ * Summary:
+ *  Called by the kernel through traceTASK_SWITCHED_IN().
+ *
+ * Parameters:
+ *  uint32_t task_number : Number of the task switched in, as reported in
+ *                         TaskStatus_t.xTaskNumber
+ *
+ *******************************************************************************/
+void event_trace_task_switch(uint32_t task_number)
+{
+    event_trace_record(EVENT_TRACE_TASK_SWITCH, 0u, 0u, task_number);
+}
+
+/*******************************************************************************
+ * Function Name: event_trace_isr
+ *******************************************************************************
+ * Summary:
+ *  Called by the kernel from interrupts through traceISR_ENTER(),
+ *  traceISR_EXIT() and the FROM_ISR hooks. Records the active exception.
+ *
+ * Parameters:
+ *  uint32_t type : EVENT_TRACE_ISR_ENTER, EVENT_TRACE_ISR_EXIT or
+ *                  EVENT_TRACE_ISR_SIGNAL
+ *
+ *******************************************************************************/
+void event_trace_isr(uint32_t type)
+{
+    event_trace_record((event_trace_type_t)type, 0u, 0u, __get_IPSR());
+}
+
+/*******************************************************************************
+ * Function Name: event_trace_tick
+ *******************************************************************************
+ * Summary:
+ *  Called by the kernel on every tick through traceTASK_INCREMENT_TICK(), so
+ *  no wrap of the cycle counter is missed when no event is recorded for a
+ *  while.
+ *
+ *******************************************************************************/
+void event_trace_tick(void)
+{
+    UBaseType_t mask;
+
+    mask = portSET_INTERRUPT_MASK_FROM_ISR();
+    (void)event_trace_now();
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(mask);
+}
+
+/*******************************************************************************
+ * Function Name: event_trace_dump
+ *******************************************************************************
+ * Summary:
+ *  Prints the recorded events, oldest first, as EVENT_TRACE_LOG_PREFIX lines
+ *  for scripts/event_trace.py, followed by the names of the tasks and the OTA
+ *  states. Recording is paused while the dump is printed.
+ *
+ *******************************************************************************/
+void event_trace_dump(void)
+{
+    const event_trace_event_t *event;
+    UBaseType_t task_count;
+    uint32_t count;
+    uint32_t i;
+
+    taskENTER_CRITICAL();
+    if (trace_dumping)
+    {
+        taskEXIT_CRITICAL();
+        return;
+    }
+    trace_dumping = true;
+    trace_running = false;
+    taskEXIT_CRITICAL();
+
+    count = CY_MIN(trace_count, EVENT_TRACE_EVENTS);
+    printf("\n" EVENT_TRACE_LOG_PREFIX "begin %lu %lu %lu\n",
+            (unsigned long)(SystemCoreClock >> EVENT_TRACE_TIME_SHIFT),
+            (unsigned long)count, (unsigned long)(trace_count - count));
+
+    for (i = trace_count - count; i != trace_count; i++)
+    {
+        event = &trace_events[i & (EVENT_TRACE_EVENTS - 1u)];
+        printf(EVENT_TRACE_LOG_PREFIX "e %lx %u %u %u %lx\n", (unsigned long)event->time,
+                (unsigned int)event->type, (unsigned int)event->id,
+                (unsigned int)event->arg16, (unsigned long)event->arg);
+    }
+
+    /* 0 if there are more tasks than EVENT_TRACE_MAX_TASKS */
+    task_count = uxTaskGetSystemState(trace_task_status, EVENT_TRACE_MAX_TASKS, NULL);
+    for (i = 0; i < task_count; i++)
+    {
+        printf(EVENT_TRACE_LOG_PREFIX "task %lu %s\n",
+                (unsigned long)trace_task_status[i].xTaskNumber, trace_task_status[i].pcTaskName);
+    }
+
+    for (i = 0; i < CY_OTA_NUM_STATES; i++)
+    {
+        printf(EVENT_TRACE_LOG_PREFIX "state %lu %s\n", (unsigned long)i,
+                cy_ota_get_state_string((cy_ota_agent_state_t)i));
+    }
+
+    printf(EVENT_TRACE_LOG_PREFIX "end\n");
+
+    taskENTER_CRITICAL();
+    trace_running = true;
+    trace_dumping = false;
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: __wrap_cy_mqtt_publish
+ *******************************************************************************
+ * Summary:
+ *  Replaces cy_mqtt_publish() for the whole application, so the publishes of
+ *  the OTA agent are recorded too. A QoS 1 publish returns once the broker
+ *  acknowledged it.
+ *
+ * Parameters:
+ *  cy_mqtt_t mqtt_handle               : MQTT connection
+ *  cy_mqtt_publish_info_t *pub_msg     : Message to publish
+ *
+ * Return:
+ *  cy_rslt_t : Result of cy_mqtt_publish()
+ *
+ *******************************************************************************/
+cy_rslt_t __wrap_cy_mqtt_publish(cy_mqtt_t mqtt_handle, cy_mqtt_publish_info_t *pub_msg)
+{
+    cy_rslt_t result;
+
+    if (pub_msg != NULL)
+    {
+        EVENT_TRACE(EVENT_TRACE_MQTT_PUBLISH, 0u, pub_msg->qos, pub_msg->payload_len);
+    }
+
+    result = __real_cy_mqtt_publish(mqtt_handle, pub_msg);
+
+    EVENT_TRACE(EVENT_TRACE_MQTT_PUBLISH, 1u, 0u, result);
+
+    return result;
+}
+#endif /* EVENT_TRACE_ENABLE */
+
+/* [] END OF FILE */
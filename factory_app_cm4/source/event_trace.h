@@ -0,0 +1,115 @@
+/******************************************************************************
+* File Name: event_trace.h
+*
+* Description: This file contains the declarations of the event trace recorder,
+* which keeps task switches, interrupts, flash operations, OTA state changes and
+* MQTT messages in a RAM ring buffer for scripts/event_trace.py.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+#ifndef SOURCE_EVENT_TRACE_H_
+#define SOURCE_EVENT_TRACE_H_
+
+#include <stdint.h>
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Events kept in the ring buffer, a power of 2. The oldest are overwritten,
+ * 12 bytes each. */
+#ifndef EVENT_TRACE_EVENTS
+#define EVENT_TRACE_EVENTS                  (1024u)
+#endif
+
+#if ((EVENT_TRACE_EVENTS & (EVENT_TRACE_EVENTS - 1u)) != 0u)
+#error "EVENT_TRACE_EVENTS must be a power of 2"
+#endif
+
+/* Time stamps count 2^EVENT_TRACE_TIME_SHIFT CPU cycles, so they wrap after
+ * 7.6 minutes at 150 MHz instead of 28 s */
+#define EVENT_TRACE_TIME_SHIFT              (4u)
+
+/* Most tasks whose names are dumped */
+#define EVENT_TRACE_MAX_TASKS               (16u)
+
+/* Prefix of the dump lines on the debug UART */
+#define EVENT_TRACE_LOG_PREFIX              "EVENT_TRACE "
+
+/* Records an event, compiled out without EVENT_TRACE_ENABLE */
+#ifdef EVENT_TRACE_ENABLE
+#define EVENT_TRACE(type, id, arg16, arg)   \
+    event_trace_record((type), (uint8_t)(id), (uint16_t)(arg16), (uint32_t)(arg))
+#else
+#define EVENT_TRACE(type, id, arg16, arg)
+#endif
+
+/*******************************************************************************
+* Data Structures
+********************************************************************************/
+/* Event types, the numbers are part of the dump format */
+typedef enum
+{
+    EVENT_TRACE_TASK_SWITCH = 0,    /* arg: number of the task switched in */
+    EVENT_TRACE_ISR_ENTER,          /* arg: exception number */
+    EVENT_TRACE_ISR_EXIT,           /* arg: exception number */
+    EVENT_TRACE_ISR_SIGNAL,         /* A task woken by an ISR, arg: exception number */
+    EVENT_TRACE_FLASH_BEGIN,        /* id: flash service op, arg16: length, arg: address or offset */
+    EVENT_TRACE_FLASH_END,          /* id: flash service op, arg: result */
+    EVENT_TRACE_OTA_STATE,          /* id: OTA agent state */
+    EVENT_TRACE_MQTT_PUBLISH,       /* id 0 on the call, arg16: QoS, arg: payload length,
+                                     * id 1 on the return, arg: result */
+    EVENT_TRACE_MQTT_RECEIVE,       /* OTA chunk, arg16: length, arg: offset */
+    EVENT_TRACE_TYPE_COUNT
+} event_trace_type_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Starts the cycle counter and the recording */
+void event_trace_init(void);
+
+/* Records one event, from tasks and from interrupts */
+void event_trace_record(event_trace_type_t type, uint8_t id, uint16_t arg16, uint32_t arg);
+
+/* Prints the recorded events, the task names and the OTA state names */
+void event_trace_dump(void);
+
+/* Kernel hooks, see FreeRTOSConfig.h */
+void event_trace_task_switch(uint32_t task_number);
+void event_trace_isr(uint32_t type);
+void event_trace_tick(void);
+
+#endif /* SOURCE_EVENT_TRACE_H_ */
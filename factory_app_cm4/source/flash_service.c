@@ -0,0 +1,800 @@
+/******************************************************************************
+* File Name: flash_service.c
+*
+* Description: This file contains the flash service task. It executes all flash
+* and OTA storage accesses of the application from a request queue, so that
+* the OTA agent does not wait for the flash while it downloads.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include <string.h>
+#include "cyhal.h"
+#include "cybsp.h"
+#include "cy_retarget_io.h"
+#include "flash_service.h"
+#include "event_trace.h"
+#ifdef OTA_IMAGE_VERIFY_ENABLE
+#include "image_verify.h"
+#endif
+#ifdef OTA_HEADER_CHECK_ENABLE
+#include "header_check.h"
+#endif
+#ifdef OTA_RESUME_ENABLE
+#include "resume_record.h"
+#endif
+/* OTA storage api */
+#include "cy_ota_storage_api.h"
+/* FreeRTOS */
+#include <FreeRTOS.h>
+#include <task.h>
+#include <queue.h>
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Flash service task configurations. It runs below the OTA task so that the
+ * network stack keeps receiving while the flash is busy. */
+#define FLASH_SERVICE_TASK_STACK_SIZE       (configMINIMAL_STACK_SIZE * 8)
+#define FLASH_SERVICE_TASK_PRIORITY         (configMAX_PRIORITIES - 4)
+
+/* Notification index a synchronous requester waits on. The default index 0
+ * stays free for the signals of the application. */
+#define FLASH_SERVICE_NOTIFY_INDEX          (1u)
+
+#if (configTASK_NOTIFICATION_ARRAY_ENTRIES <= FLASH_SERVICE_NOTIFY_INDEX)
+#error "The flash service needs configTASK_NOTIFICATION_ARRAY_ENTRIES of 2 or more"
+#endif
+
+/*******************************************************************************
+* Data Structures
+********************************************************************************/
+/* Recorded in the event trace, keep FLASH_OPS of scripts/event_trace.py in sync */
+typedef enum
+{
+    FLASH_SERVICE_OP_READ,
+    FLASH_SERVICE_OP_WRITE,
+    FLASH_SERVICE_OP_ERASE,
+    FLASH_SERVICE_OP_STORAGE_OPEN,
+    FLASH_SERVICE_OP_STORAGE_READ,
+    FLASH_SERVICE_OP_STORAGE_WRITE,
+    FLASH_SERVICE_OP_STORAGE_CLOSE,
+    FLASH_SERVICE_OP_STORAGE_VERIFY
+} flash_service_op_t;
+
+/* OTA data waiting to be written. info.buffer points to data. */
+typedef struct
+{
+    cy_ota_context_ptr          ctx_ptr;
+    cy_ota_storage_write_info_t info;
+    CY_ALIGN(4) uint8_t         data[FLASH_SERVICE_SLOT_SIZE];
+} flash_service_slot_t;
+
+typedef struct
+{
+    flash_service_op_t          op;
+    cy_ota_mem_type_t           mem_type;
+    uint32_t                    addr;
+    void                        *data;
+    size_t                      len;
+    cy_ota_context_ptr          ctx_ptr;
+    void                        *chunk_info;
+    /* Queued storage write, returned to the free list once written */
+    flash_service_slot_t        *slot;
+    /* Synchronous requests only: task to notify. The result is passed as the
+     * notification value, nothing on the stack of the requester is written. */
+    TaskHandle_t                requester;
+} flash_service_req_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void flash_service_task(void *args);
+static cy_rslt_t flash_service_submit(flash_service_req_t *req);
+static void flash_service_submit_open_slot(void);
+static cy_rslt_t flash_service_write_direct(cy_ota_context_ptr ctx_ptr, cy_ota_storage_write_info_t *chunk_info);
+static void flash_service_report_gaps(void);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Flash service task handle */
+static TaskHandle_t flash_service_task_handle;
+static StaticTask_t flash_service_task_tcb;
+static StackType_t flash_service_task_stack[FLASH_SERVICE_TASK_STACK_SIZE];
+
+/* Requests to the flash service task */
+static QueueHandle_t flash_service_queue;
+static StaticQueue_t flash_service_queue_buffer;
+static uint8_t flash_service_queue_storage[FLASH_SERVICE_QUEUE_LEN * sizeof(flash_service_req_t)];
+
+#ifndef OTA_ZERO_COPY_ENABLE
+/* Free write buffers */
+static QueueHandle_t flash_service_free_slots;
+static StaticQueue_t flash_service_free_slots_buffer;
+static uint8_t flash_service_free_slots_storage[FLASH_SERVICE_SLOT_COUNT * sizeof(flash_service_slot_t *)];
+
+static flash_service_slot_t flash_service_slots[FLASH_SERVICE_SLOT_COUNT];
+#endif
+
+/* Buffer being filled by the OTA agent, not yet queued. Only accessed by the
+ * task calling the storage callbacks. */
+static flash_service_slot_t *open_slot;
+
+/* First failure of a queued storage write, reported to the OTA agent on its
+ * next storage call */
+static volatile cy_rslt_t deferred_result = CY_RSLT_SUCCESS;
+
+/* Parts of the image queued for writing since the storage was opened, and
+ * chunks skipped because they were already written */
+static uint32_t storage_range_bits[CY_OTA_RANGE_WORDS(FLASH_SERVICE_RANGE_MAX_UNITS)];
+static cy_ota_range_t storage_range;
+static uint32_t storage_duplicates;
+
+/*******************************************************************************
+ * Function Name: flash_service_init
+ *******************************************************************************
+ * Summary:
+ *  Creates the request queue, the write buffer pool and the flash service
+ *  task. Does nothing if the service is already running.
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS on success, error code otherwise
+ *
+ *******************************************************************************/
+cy_rslt_t flash_service_init(void)
+{
+#ifndef OTA_ZERO_COPY_ENABLE
+    uint32_t i;
+#endif
+
+    if (flash_service_task_handle != NULL)
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    cy_ota_range_init(&storage_range, storage_range_bits, FLASH_SERVICE_RANGE_MAX_UNITS);
+
+    flash_service_queue = xQueueCreateStatic(FLASH_SERVICE_QUEUE_LEN, sizeof(flash_service_req_t),
+                                             flash_service_queue_storage, &flash_service_queue_buffer);
+    if (flash_service_queue == NULL)
+    {
+        printf("\n Creating the flash service queue failed.\n");
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+#ifndef OTA_ZERO_COPY_ENABLE
+    flash_service_free_slots = xQueueCreateStatic(FLASH_SERVICE_SLOT_COUNT, sizeof(flash_service_slot_t *),
+                                                  flash_service_free_slots_storage, &flash_service_free_slots_buffer);
+    if (flash_service_free_slots == NULL)
+    {
+        printf("\n Creating the flash service buffer pool failed.\n");
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    for (i = 0; i < FLASH_SERVICE_SLOT_COUNT; i++)
+    {
+        flash_service_slot_t *slot = &flash_service_slots[i];
+        xQueueSend(flash_service_free_slots, &slot, 0);
+    }
+#endif
+
+    flash_service_task_handle = xTaskCreateStatic(flash_service_task, "FLASH SERVICE", FLASH_SERVICE_TASK_STACK_SIZE,
+                                                  NULL, FLASH_SERVICE_TASK_PRIORITY, flash_service_task_stack,
+                                                  &flash_service_task_tcb);
+    if (flash_service_task_handle == NULL)
+    {
+        printf("\n Creating the flash service task failed.\n");
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: flash_service_task
+ *******************************************************************************
+ * Summary:
+ *  Executes the queued requests in order. Synchronous requesters are notified
+ *  on completion, queued storage writes return their buffer to the pool.
+ *
+ * Parameters:
+ *  void *args : Task parameter defined during task creation (unused)
+ *
+ *******************************************************************************/
+static void flash_service_task(void *args)
+{
+    flash_service_req_t req;
+    cy_rslt_t result;
+
+    (void)args;
+
+    while (true)
+    {
+        if (pdPASS != xQueueReceive(flash_service_queue, &req, portMAX_DELAY))
+        {
+            continue;
+        }
+
+#ifdef EVENT_TRACE_ENABLE
+        if (req.op == FLASH_SERVICE_OP_STORAGE_WRITE)
+        {
+            cy_ota_storage_write_info_t *info = (cy_ota_storage_write_info_t *)req.chunk_info;
+            EVENT_TRACE(EVENT_TRACE_FLASH_BEGIN, req.op, CY_MIN(info->size, 0xFFFFu), info->offset);
+        }
+        else
+        {
+            EVENT_TRACE(EVENT_TRACE_FLASH_BEGIN, req.op, CY_MIN(req.len, 0xFFFFu), req.addr);
+        }
+#endif
+
+        switch (req.op)
+        {
+            case FLASH_SERVICE_OP_READ:
+                result = cy_ota_mem_read(req.mem_type, req.addr, req.data, req.len);
+                break;
+
+            case FLASH_SERVICE_OP_WRITE:
+                result = cy_ota_mem_write(req.mem_type, req.addr, req.data, req.len);
+                break;
+
+            case FLASH_SERVICE_OP_ERASE:
+                result = cy_ota_mem_erase(req.mem_type, req.addr, req.len);
+                break;
+
+            case FLASH_SERVICE_OP_STORAGE_OPEN:
+                result = cy_ota_storage_open(req.ctx_ptr);
+                break;
+
+            case FLASH_SERVICE_OP_STORAGE_READ:
+                result = cy_ota_storage_read(req.ctx_ptr, (cy_ota_storage_read_info_t *)req.chunk_info);
+                break;
+
+            case FLASH_SERVICE_OP_STORAGE_WRITE:
+                result = cy_ota_storage_write(req.ctx_ptr, (cy_ota_storage_write_info_t *)req.chunk_info);
+                break;
+
+            case FLASH_SERVICE_OP_STORAGE_CLOSE:
+                result = cy_ota_storage_close(req.ctx_ptr);
+                break;
+
+            case FLASH_SERVICE_OP_STORAGE_VERIFY:
+                result = cy_ota_storage_verify(req.ctx_ptr);
+                break;
+
+            default:
+                result = CY_RSLT_TYPE_ERROR;
+                break;
+        }
+
+        EVENT_TRACE(EVENT_TRACE_FLASH_END, req.op, 0u, result);
+
+#ifdef OTA_RESUME_ENABLE
+        if ((req.op == FLASH_SERVICE_OP_STORAGE_WRITE) && (CY_RSLT_SUCCESS == result))
+        {
+            /* The resume record may claim the chunks now that they are in flash */
+            resume_record_commit((cy_ota_storage_write_info_t *)req.chunk_info);
+        }
+#endif
+
+        if (req.slot != NULL)
+        {
+            if ((CY_RSLT_SUCCESS != result) && (CY_RSLT_SUCCESS == deferred_result))
+            {
+                printf("\n Flash service: writing offset 0x%lx failed.\n",
+                        (unsigned long)req.slot->info.offset);
+                deferred_result = result;
+            }
+#ifndef OTA_ZERO_COPY_ENABLE
+            xQueueSend(flash_service_free_slots, &req.slot, 0);
+#endif
+        }
+        else
+        {
+            (void)xTaskNotifyIndexed(req.requester, FLASH_SERVICE_NOTIFY_INDEX, (uint32_t)result,
+                                     eSetValueWithOverwrite);
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: flash_service_submit
+ *******************************************************************************
+ * Summary:
+ *  Queues a request. Synchronous requests (no slot) wait for the flash service
+ *  to complete it; the buffer being filled is queued first so that the request
+ *  sees every write made before it.
+ *
+ * Parameters:
+ *  flash_service_req_t *req : Request to execute
+ *
+ * Return:
+ *  cy_rslt_t : Result of the request
+ *
+ *******************************************************************************/
+static cy_rslt_t flash_service_submit(flash_service_req_t *req)
+{
+    uint32_t result = CY_RSLT_SUCCESS;
+
+    if (flash_service_queue == NULL)
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    if (req->slot == NULL)
+    {
+        flash_service_submit_open_slot();
+        req->requester = xTaskGetCurrentTaskHandle();
+    }
+
+    xQueueSend(flash_service_queue, req, portMAX_DELAY);
+
+    if (req->slot == NULL)
+    {
+        /* Only the flash service notifies this index, once per request */
+        (void)xTaskNotifyWaitIndexed(FLASH_SERVICE_NOTIFY_INDEX, 0u, 0u, &result, portMAX_DELAY);
+    }
+
+    return (cy_rslt_t)result;
+}
+
+/*******************************************************************************
+ * Function Name: flash_service_submit_open_slot
+ *******************************************************************************
+ * Summary:
+ *  Queues the buffer being filled by the OTA agent, if any.
+ *
+ *******************************************************************************/
+static void flash_service_submit_open_slot(void)
+{
+    flash_service_req_t req = { 0 };
+
+    if (open_slot == NULL)
+    {
+        return;
+    }
+
+    req.op = FLASH_SERVICE_OP_STORAGE_WRITE;
+    req.ctx_ptr = open_slot->ctx_ptr;
+    req.chunk_info = &open_slot->info;
+    req.slot = open_slot;
+    open_slot = NULL;
+
+    flash_service_submit(&req);
+}
+
+/*******************************************************************************
+ * Function Name: flash_service_read
+ *******************************************************************************
+ * Summary:
+ *  Reads from the flash through the flash service.
+ *
+ * Parameters:
+ *  cy_ota_mem_type_t mem_type : Internal or external flash
+ *  uint32_t addr              : Address to read from
+ *  void *data                 : Destination buffer
+ *  size_t len                 : Number of bytes to read
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS on success, error code otherwise
+ *
+ *******************************************************************************/
+cy_rslt_t flash_service_read(cy_ota_mem_type_t mem_type, uint32_t addr, void *data, size_t len)
+{
+    flash_service_req_t req = { 0 };
+
+    req.op = FLASH_SERVICE_OP_READ;
+    req.mem_type = mem_type;
+    req.addr = addr;
+    req.data = data;
+    req.len = len;
+
+    return flash_service_submit(&req);
+}
+
+/*******************************************************************************
+ * Function Name: flash_service_write
+ *******************************************************************************
+ * Summary:
+ *  Writes to the flash through the flash service.
+ *
+ * Parameters:
+ *  cy_ota_mem_type_t mem_type : Internal or external flash
+ *  uint32_t addr              : Address to write to
+ *  const void *data           : Data to write
+ *  size_t len                 : Number of bytes to write
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS on success, error code otherwise
+ *
+ *******************************************************************************/
+cy_rslt_t flash_service_write(cy_ota_mem_type_t mem_type, uint32_t addr, const void *data, size_t len)
+{
+    flash_service_req_t req = { 0 };
+
+    req.op = FLASH_SERVICE_OP_WRITE;
+    req.mem_type = mem_type;
+    req.addr = addr;
+    req.data = (void *)data;
+    req.len = len;
+
+    return flash_service_submit(&req);
+}
+
+/*******************************************************************************
+ * Function Name: flash_service_erase
+ *******************************************************************************
+ * Summary:
+ *  Erases flash through the flash service.
+ *
+ * Parameters:
+ *  cy_ota_mem_type_t mem_type : Internal or external flash
+ *  uint32_t addr              : Start address of the erase
+ *  size_t len                 : Number of bytes to erase
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS on success, error code otherwise
+ *
+ *******************************************************************************/
+cy_rslt_t flash_service_erase(cy_ota_mem_type_t mem_type, uint32_t addr, size_t len)
+{
+    flash_service_req_t req = { 0 };
+
+    req.op = FLASH_SERVICE_OP_ERASE;
+    req.mem_type = mem_type;
+    req.addr = addr;
+    req.len = len;
+
+    return flash_service_submit(&req);
+}
+
+/*******************************************************************************
+ * Function Name: flash_service_storage_open
+ *******************************************************************************
+ * Summary:
+ *  Opens the OTA storage in the flash service and clears any error and written
+ *  range left over from a previous download.
+ *
+ * Parameters:
+ *  cy_ota_context_ptr ctx_ptr : OTA context
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS on success, error code otherwise
+ *
+ *******************************************************************************/
+cy_rslt_t flash_service_storage_open(cy_ota_context_ptr ctx_ptr)
+{
+    flash_service_req_t req = { 0 };
+    cy_rslt_t result;
+
+    req.op = FLASH_SERVICE_OP_STORAGE_OPEN;
+    req.ctx_ptr = ctx_ptr;
+
+    /* Writes of an aborted download complete before the open, so their
+     * errors can be cleared once it returns */
+    result = flash_service_submit(&req);
+    deferred_result = CY_RSLT_SUCCESS;
+
+    /* The image size is set by the first chunk */
+    (void)cy_ota_range_reset(&storage_range, FLASH_SERVICE_RANGE_UNIT, 0);
+    storage_duplicates = 0;
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: flash_service_storage_read
+ *******************************************************************************
+ * Summary:
+ *  Reads from the OTA storage in the flash service, after all queued writes.
+ *
+ * Parameters:
+ *  cy_ota_context_ptr ctx_ptr             : OTA context
+ *  cy_ota_storage_read_info_t *chunk_info : Read request
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS on success, error code otherwise
+ *
+ *******************************************************************************/
+cy_rslt_t flash_service_storage_read(cy_ota_context_ptr ctx_ptr, cy_ota_storage_read_info_t *chunk_info)
+{
+    flash_service_req_t req = { 0 };
+
+    req.op = FLASH_SERVICE_OP_STORAGE_READ;
+    req.ctx_ptr = ctx_ptr;
+    req.chunk_info = chunk_info;
+
+    return flash_service_submit(&req);
+}
+
+/*******************************************************************************
+ * Function Name: flash_service_storage_write
+ *******************************************************************************
+ * Summary:
+ *  Copies an OTA chunk into a write buffer and returns. A chunk that directly
+ *  follows the data in the buffer being filled is appended to it, so that the
+ *  flash service writes contiguous chunks with one storage write. The buffer
+ *  is queued once the next chunk would not fit or the last packet arrived.
+ *  Waits only when all buffers are queued. A chunk that was already written
+ *  completely, e.g. a retransmission, is skipped without touching the flash.
+ *  With OTA_ZERO_COPY_ENABLE the chunk is not copied but written from the
+ *  buffer of the OTA agent before this returns.
+ *
+ * Parameters:
+ *  cy_ota_context_ptr ctx_ptr              : OTA context
+ *  cy_ota_storage_write_info_t *chunk_info : Chunk to write
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS on success, error of an earlier queued write
+ *              or of this write otherwise
+ *
+ *******************************************************************************/
+cy_rslt_t flash_service_storage_write(cy_ota_context_ptr ctx_ptr, cy_ota_storage_write_info_t *chunk_info)
+{
+#ifdef OTA_HEADER_CHECK_ENABLE
+    cy_rslt_t result;
+#endif
+
+    if (CY_RSLT_SUCCESS != deferred_result)
+    {
+        return deferred_result;
+    }
+
+    /* Chunks can arrive in any order, the size of the image comes with each */
+    if ((storage_range.total_size == 0) &&
+        !cy_ota_range_reset(&storage_range, FLASH_SERVICE_RANGE_UNIT, chunk_info->total_size))
+    {
+        (void)cy_ota_range_reset(&storage_range, FLASH_SERVICE_RANGE_UNIT, 0);
+    }
+
+    if (cy_ota_range_contains(&storage_range, chunk_info->offset, chunk_info->size))
+    {
+        storage_duplicates++;
+        return CY_RSLT_SUCCESS;
+    }
+
+#ifdef OTA_HEADER_CHECK_ENABLE
+    /* An image the bootloader would refuse is rejected with its first chunk */
+    result = header_check_update(chunk_info->offset, chunk_info->buffer, chunk_info->size);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        return result;
+    }
+#endif
+#ifdef OTA_IMAGE_VERIFY_ENABLE
+    /* Every image byte passes here once, hash it while it is in RAM */
+    image_verify_update(chunk_info->offset, chunk_info->buffer, chunk_info->size);
+#endif
+
+#ifdef OTA_ZERO_COPY_ENABLE
+    return flash_service_write_direct(ctx_ptr, chunk_info);
+#else
+    /* Merge with the buffer being filled. The first chunk of the image is
+     * kept on its own so the storage layer sees the header unchanged. */
+    if ((open_slot != NULL) && (open_slot->ctx_ptr == ctx_ptr) && (open_slot->info.offset != 0) &&
+        (open_slot->info.offset + open_slot->info.size == chunk_info->offset) &&
+        (open_slot->info.size + chunk_info->size <= FLASH_SERVICE_SLOT_SIZE))
+    {
+        memcpy(&open_slot->data[open_slot->info.size], chunk_info->buffer, chunk_info->size);
+        open_slot->info.size += chunk_info->size;
+        open_slot->info.packet_number = chunk_info->packet_number;
+    }
+    else
+    {
+        flash_service_submit_open_slot();
+
+        if (chunk_info->size > FLASH_SERVICE_SLOT_SIZE)
+        {
+            return flash_service_write_direct(ctx_ptr, chunk_info);
+        }
+
+        xQueueReceive(flash_service_free_slots, &open_slot, portMAX_DELAY);
+
+        /* An earlier write may have failed while waiting for a buffer */
+        if (CY_RSLT_SUCCESS != deferred_result)
+        {
+            xQueueSend(flash_service_free_slots, &open_slot, 0);
+            open_slot = NULL;
+            return deferred_result;
+        }
+
+        memcpy(open_slot->data, chunk_info->buffer, chunk_info->size);
+        open_slot->ctx_ptr = ctx_ptr;
+        open_slot->info = *chunk_info;
+        open_slot->info.buffer = open_slot->data;
+    }
+
+    (void)cy_ota_range_add(&storage_range, chunk_info->offset, chunk_info->size);
+
+    if ((open_slot->info.offset == 0) ||
+        (open_slot->info.packet_number + 1u >= open_slot->info.total_packets) ||
+        (open_slot->info.size + chunk_info->size > FLASH_SERVICE_SLOT_SIZE))
+    {
+        flash_service_submit_open_slot();
+    }
+
+    return CY_RSLT_SUCCESS;
+#endif
+}
+
+/*******************************************************************************
+ * Function Name: flash_service_write_direct
+ *******************************************************************************
+ * Summary:
+ *  Writes an OTA chunk straight from the buffer of the caller. The caller gets
+ *  its buffer back, and with MQTT the agent its receive buffer, only once the
+ *  flash service has written the chunk.
+ *
+ * Parameters:
+ *  cy_ota_context_ptr ctx_ptr              : OTA context
+ *  cy_ota_storage_write_info_t *chunk_info : Chunk to write
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS on success, error code otherwise
+ *
+ *******************************************************************************/
+static cy_rslt_t flash_service_write_direct(cy_ota_context_ptr ctx_ptr, cy_ota_storage_write_info_t *chunk_info)
+{
+    flash_service_req_t req = { 0 };
+    cy_rslt_t result;
+
+    req.op = FLASH_SERVICE_OP_STORAGE_WRITE;
+    req.ctx_ptr = ctx_ptr;
+    req.chunk_info = chunk_info;
+    result = flash_service_submit(&req);
+
+    /* A chunk that failed is not skipped as a duplicate when it comes again */
+    if (CY_RSLT_SUCCESS == result)
+    {
+        (void)cy_ota_range_add(&storage_range, chunk_info->offset, chunk_info->size);
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: flash_service_storage_close
+ *******************************************************************************
+ * Summary:
+ *  Closes the OTA storage once all queued writes are done and reports the
+ *  parts of the image that were never written.
+ *
+ * Parameters:
+ *  cy_ota_context_ptr ctx_ptr : OTA context
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS on success, error of a queued write or of the
+ *              close otherwise
+ *
+ *******************************************************************************/
+cy_rslt_t flash_service_storage_close(cy_ota_context_ptr ctx_ptr)
+{
+    flash_service_req_t req = { 0 };
+    cy_rslt_t result;
+
+    req.op = FLASH_SERVICE_OP_STORAGE_CLOSE;
+    req.ctx_ptr = ctx_ptr;
+
+    result = flash_service_submit(&req);
+    flash_service_report_gaps();
+
+    return (CY_RSLT_SUCCESS != deferred_result) ? deferred_result : result;
+}
+
+/*******************************************************************************
+ * Function Name: flash_service_storage_verify
+ *******************************************************************************
+ * Summary:
+ *  Verifies the downloaded image once all queued writes are done.
+ *
+ * Parameters:
+ *  cy_ota_context_ptr ctx_ptr : OTA context
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS on success, error code otherwise
+ *
+ *******************************************************************************/
+cy_rslt_t flash_service_storage_verify(cy_ota_context_ptr ctx_ptr)
+{
+    flash_service_req_t req = { 0 };
+    cy_rslt_t result;
+
+    req.op = FLASH_SERVICE_OP_STORAGE_VERIFY;
+    req.ctx_ptr = ctx_ptr;
+
+    result = flash_service_submit(&req);
+
+    return (CY_RSLT_SUCCESS != deferred_result) ? deferred_result : result;
+}
+
+/*******************************************************************************
+ * Function Name: flash_service_storage_written
+ *******************************************************************************
+ * Summary:
+ *  Returns the parts of the OTA image queued for writing since the storage
+ *  was opened. Only valid in the task calling the storage callbacks.
+ *
+ * Return:
+ *  const cy_ota_range_t * : Written ranges, image size 0 before the first
+ *                           chunk
+ *
+ *******************************************************************************/
+const cy_ota_range_t *flash_service_storage_written(void)
+{
+    return &storage_range;
+}
+
+/*******************************************************************************
+ * Function Name: flash_service_report_gaps
+ *******************************************************************************
+ * Summary:
+ *  Prints the parts of the OTA image that were not written and the number of
+ *  chunks skipped as duplicates.
+ *
+ *******************************************************************************/
+static void flash_service_report_gaps(void)
+{
+    uint32_t offset = 0;
+    uint32_t gap_offset;
+    uint32_t gap_len;
+    uint32_t missing = 0;
+    uint32_t gaps = 0;
+
+    if (storage_duplicates != 0)
+    {
+        printf("\n Skipped %lu chunks that were already written.\n", (unsigned long)storage_duplicates);
+    }
+
+    if ((storage_range.total_size == 0) || cy_ota_range_complete(&storage_range))
+    {
+        return;
+    }
+
+    while (cy_ota_range_next_gap(&storage_range, offset, &gap_offset, &gap_len))
+    {
+        if (gaps == 0)
+        {
+            printf("\n Image incomplete, first gap at 0x%08lx (%lu bytes).\n",
+                   (unsigned long)gap_offset, (unsigned long)gap_len);
+        }
+        missing += gap_len;
+        gaps++;
+        offset = gap_offset + gap_len;
+    }
+
+    printf("\n %lu of %lu bytes missing in %lu gaps.\n",
+           (unsigned long)missing, (unsigned long)storage_range.total_size, (unsigned long)gaps);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,107 @@
+/******************************************************************************
+* File Name: flash_service.h
+*
+* Description: This file contains declaration of the flash service task that
+* owns all flash accesses of the application.
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef SOURCE_FLASH_SERVICE_H_
+#define SOURCE_FLASH_SERVICE_H_
+
+#include <stdint.h>
+#include "cy_ota_api.h"
+#include "cy_ota_flash.h"
+#include "cy_ota_range.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Number of requests that can be queued to the flash service */
+#ifndef FLASH_SERVICE_QUEUE_LEN
+#define FLASH_SERVICE_QUEUE_LEN             (8u)
+#endif
+
+/* Number of buffers holding OTA data that is waiting to be written. When all
+ * of them are in use, the OTA agent waits for the flash service to free one. */
+#ifndef FLASH_SERVICE_SLOT_COUNT
+#define FLASH_SERVICE_SLOT_COUNT            (4u)
+#endif
+
+/* Size of each buffer. Contiguous OTA chunks are merged into one buffer, and
+ * so into one storage write, as long as they fit. Chunks larger than this are
+ * written synchronously. */
+#ifndef FLASH_SERVICE_SLOT_SIZE
+#define FLASH_SERVICE_SLOT_SIZE             (8192u)
+#endif
+
+/* Granularity at which written parts of the OTA image are tracked. A multiple
+ * of the program size of the storage, chunks covering only units that were
+ * already written are not programmed again. */
+#ifndef FLASH_SERVICE_RANGE_UNIT
+#define FLASH_SERVICE_RANGE_UNIT            (512u)
+#endif
+
+/* Largest image, in units, that can be tracked. Larger images are written
+ * without duplicate detection. */
+#ifndef FLASH_SERVICE_RANGE_MAX_UNITS
+#define FLASH_SERVICE_RANGE_MAX_UNITS       (4096u)
+#endif
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+cy_rslt_t flash_service_init(void);
+
+/* Synchronous flash access. The calling task blocks until the flash service
+ * has completed the request and all requests queued before it. */
+cy_rslt_t flash_service_read(cy_ota_mem_type_t mem_type, uint32_t addr, void *data, size_t len);
+cy_rslt_t flash_service_write(cy_ota_mem_type_t mem_type, uint32_t addr, const void *data, size_t len);
+cy_rslt_t flash_service_erase(cy_ota_mem_type_t mem_type, uint32_t addr, size_t len);
+
+/* OTA storage interface callbacks executed by the flash service. Writes are
+ * queued and return without waiting for the flash. A failed write is reported
+ * by the next write, close or verify call. */
+cy_rslt_t flash_service_storage_open(cy_ota_context_ptr ctx_ptr);
+cy_rslt_t flash_service_storage_read(cy_ota_context_ptr ctx_ptr, cy_ota_storage_read_info_t *chunk_info);
+cy_rslt_t flash_service_storage_write(cy_ota_context_ptr ctx_ptr, cy_ota_storage_write_info_t *chunk_info);
+cy_rslt_t flash_service_storage_close(cy_ota_context_ptr ctx_ptr);
+cy_rslt_t flash_service_storage_verify(cy_ota_context_ptr ctx_ptr);
+
+/* Parts of the OTA image written since the storage was opened */
+const cy_ota_range_t *flash_service_storage_written(void);
+
+#endif /* SOURCE_FLASH_SERVICE_H_ */
@@ -0,0 +1,344 @@
+/******************************************************************************
+* File Name: header_check.c
+*
+* Description: This file contains the early check of the MCUboot header
+* of a downloaded image. The header arrives with the first chunk, so an image
+* that does not fit the slot, was not built for this board, would be refused as
+* a downgrade or is not signed with the bootloader key is rejected after a few
+* KB instead of after the whole download.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/* Header file includes */
+#include <stdio.h>
+#include <string.h>
+#include "cyhal.h"
+#include "cybsp.h"
+#include "cy_retarget_io.h"
+#include "header_check.h"
+#include "flash_service.h"
+#include "cy_ota_range.h"
+#include "ota_sign_key.h"
+#include "mcuboot_image.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Image flags the bootloader of this example does not support */
+#define IMAGE_F_UNSUPPORTED \
+    (IMAGE_F_ENCRYPTED_AES128 | IMAGE_F_ENCRYPTED_AES256 | IMAGE_F_RAM_LOAD)
+
+/* Primary slot in the address space of the CPU and in the flash service */
+#define HEADER_CHECK_PRIMARY_START \
+    ((OTA_HEADER_CHECK_PRIMARY_ADDR >= CY_FLASH_BASE) ? OTA_HEADER_CHECK_PRIMARY_ADDR : \
+     (OTA_HEADER_CHECK_PRIMARY_ADDR + CY_FLASH_BASE))
+#define HEADER_CHECK_PRIMARY_OFFSET         (HEADER_CHECK_PRIMARY_START - CY_FLASH_BASE)
+
+/*******************************************************************************
+* Data Structures
+********************************************************************************/
+typedef struct
+{
+    bool                        header_done;
+    bool                        key_done;
+    uint32_t                    tlv_offset;     /* 0 until the header is checked */
+    uint32_t                    tlv_bits[CY_OTA_RANGE_WORDS(HEADER_CHECK_TLV_MAX)];
+    cy_ota_range_t              tlv_received;   /* Bytes of tlv received */
+    uint8_t                     tlv[HEADER_CHECK_TLV_MAX];
+} header_check_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static cy_rslt_t header_check_header(const uint8_t *data, uint32_t len);
+static cy_rslt_t header_check_key(void);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static header_check_t header_check;
+
+/*******************************************************************************
+ * Function Name: header_check_reset
+ *******************************************************************************
+ * Summary:
+ *  Forgets the previous download.
+ *
+ *******************************************************************************/
+void header_check_reset(void)
+{
+    header_check.header_done = false;
+    header_check.key_done = false;
+    header_check.tlv_offset = 0;
+    cy_ota_range_init(&header_check.tlv_received, header_check.tlv_bits, HEADER_CHECK_TLV_MAX);
+    (void)cy_ota_range_reset(&header_check.tlv_received, 1u, HEADER_CHECK_TLV_MAX);
+}
+
+/*******************************************************************************
+ * Function Name: header_check_update
+ *******************************************************************************
+ * Summary:
+ *  Checks the header with the first chunk of the image, and collects the
+ *  start of the unprotected TLV area to check the key hash once it is in.
+ *  Data of the TLV area that arrives before the header is left to the checks
+ *  at the end of the download.
+ *
+ * Parameters:
+ *  uint32_t offset     : Image offset of the data
+ *  const uint8_t *data : Data to be written
+ *  uint32_t len        : Length of data
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS if the image can still be accepted, error code
+ *              otherwise
+ *
+ *******************************************************************************/
+cy_rslt_t header_check_update(uint32_t offset, const uint8_t *data, uint32_t len)
+{
+    cy_rslt_t result;
+    uint32_t end = offset + len;
+    uint32_t tlv_end;
+    uint32_t from;
+
+    if (!header_check.header_done && (offset == 0))
+    {
+        result = header_check_header(data, len);
+        if (CY_RSLT_SUCCESS != result)
+        {
+            return result;
+        }
+        header_check.header_done = true;
+    }
+
+    if ((header_check.tlv_offset == 0) || header_check.key_done)
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    tlv_end = header_check.tlv_offset + HEADER_CHECK_TLV_MAX;
+    if ((end <= header_check.tlv_offset) || (offset >= tlv_end))
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    from = CY_MAX(offset, header_check.tlv_offset);
+    end = CY_MIN(end, tlv_end);
+    memcpy(&header_check.tlv[from - header_check.tlv_offset], &data[from - offset], end - from);
+    (void)cy_ota_range_add(&header_check.tlv_received, from - header_check.tlv_offset, end - from);
+
+    return header_check_key();
+}
+
+/*******************************************************************************
+ * Function Name: header_check_tlv_offset
+ *******************************************************************************
+ * Summary:
+ *  Returns the image offset of the unprotected TLV area.
+ *
+ * Return:
+ *  uint32_t : Offset of the TLV area, 0 until the header has been checked
+ *
+ *******************************************************************************/
+uint32_t header_check_tlv_offset(void)
+{
+    return header_check.tlv_offset;
+}
+
+/*******************************************************************************
+ * Function Name: header_check_header
+ *******************************************************************************
+ * Summary:
+ *  Checks the header of the new image: the magic, that header, image and
+ *  TLVs fit the slot, the flags, that the reset vector lies in the primary
+ *  slot the image will run from, and the version against the image in the
+ *  primary slot.
+ *
+ * Parameters:
+ *  const uint8_t *data : First chunk of the image
+ *  uint32_t len        : Length of data
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS if the header is acceptable, error code
+ *              otherwise
+ *
+ *******************************************************************************/
+static cy_rslt_t header_check_header(const uint8_t *data, uint32_t len)
+{
+    mcuboot_image_header_t header;
+    mcuboot_image_header_t running;
+    uint8_t running_data[IMAGE_HEADER_SIZE];
+    uint32_t reset_vector;
+    uint64_t total;
+
+    if (len < IMAGE_HEADER_SIZE)
+    {
+        /* Left to the checks at the end of the download */
+        printf("\n Header check skipped, first chunk of %lu bytes.\n", (unsigned long)len);
+        return CY_RSLT_SUCCESS;
+    }
+
+    mcuboot_image_parse_header(data, &header);
+    if ((header.magic != IMAGE_MAGIC) || (header.hdr_size < IMAGE_HEADER_SIZE))
+    {
+        printf("\n Header check: not an MCUboot image.\n");
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    total = (uint64_t)header.hdr_size + header.img_size + header.prot_tlv_size + IMAGE_TLV_INFO_SIZE;
+    if ((total > OTA_HEADER_CHECK_SLOT_SIZE) || (total > OTA_HEADER_CHECK_PRIMARY_SIZE))
+    {
+        printf("\n Header check: image of %lu bytes does not fit the slot.\n", (unsigned long)header.img_size);
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    if ((header.flags & IMAGE_F_UNSUPPORTED) != 0)
+    {
+        printf("\n Header check: unsupported image flags 0x%lx.\n", (unsigned long)header.flags);
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    /* The vector table follows the header, an image linked for another
+     * board or flash map does not start in this primary slot */
+    if (len >= (header.hdr_size + 8u))
+    {
+        memcpy(&reset_vector, &data[header.hdr_size + 4u], sizeof(reset_vector));
+        reset_vector &= ~1u;
+        if ((reset_vector < (HEADER_CHECK_PRIMARY_START + header.hdr_size)) ||
+            (reset_vector >= (HEADER_CHECK_PRIMARY_START + header.hdr_size + header.img_size)))
+        {
+            printf("\n Header check: reset vector 0x%08lx is outside of the primary slot.\n",
+                   (unsigned long)reset_vector);
+            return CY_RSLT_TYPE_ERROR;
+        }
+    }
+
+    printf("\n Header check: image %u.%u.%u, %lu bytes.\n", (unsigned int)header.major,
+           (unsigned int)header.minor, (unsigned int)header.revision, (unsigned long)header.img_size);
+
+    /* Compared the way the bootloader does, without the build number */
+    if ((OTA_HEADER_CHECK_DOWNGRADE != 0) &&
+        (CY_RSLT_SUCCESS == flash_service_read(CY_OTA_MEM_TYPE_INTERNAL_FLASH, HEADER_CHECK_PRIMARY_OFFSET,
+                                               running_data, sizeof(running_data))))
+    {
+        mcuboot_image_parse_header(running_data, &running);
+        if ((running.magic == IMAGE_MAGIC) &&
+            ((header.major < running.major) ||
+             ((header.major == running.major) && (header.minor < running.minor)) ||
+             ((header.major == running.major) && (header.minor == running.minor) &&
+              (header.revision < running.revision))))
+        {
+            printf("\n Header check: downgrade from %u.%u.%u refused.\n", (unsigned int)running.major,
+                   (unsigned int)running.minor, (unsigned int)running.revision);
+            return CY_RSLT_TYPE_ERROR;
+        }
+    }
+
+    header_check.tlv_offset = (uint32_t)header.hdr_size + header.img_size + header.prot_tlv_size;
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: header_check_key
+ *******************************************************************************
+ * Summary:
+ *  Checks the key hash TLV against the key the bootloader trusts once the
+ *  TLVs up to it have been received.
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS if the key matches or the TLVs are not in yet,
+ *              error code otherwise
+ *
+ *******************************************************************************/
+static cy_rslt_t header_check_key(void)
+{
+    uint8_t key_hash[OTA_SIGN_KEY_DIGEST_SIZE];
+    uint32_t pos = IMAGE_TLV_INFO_SIZE;
+    uint32_t tlv_tot;
+    mcuboot_image_tlv_info_t info;
+    mcuboot_image_tlv_t it;
+
+    if (!cy_ota_range_contains(&header_check.tlv_received, 0, IMAGE_TLV_INFO_SIZE))
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    mcuboot_image_parse_tlv_info(header_check.tlv, &info);
+    tlv_tot = CY_MIN(info.tlv_tot, HEADER_CHECK_TLV_MAX);
+    if (info.magic != IMAGE_TLV_INFO_MAGIC)
+    {
+        printf("\n Header check: no TLV area after the image.\n");
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    /* Walk the TLVs received so far */
+    while (((pos + IMAGE_TLV_SIZE) <= tlv_tot) &&
+           cy_ota_range_contains(&header_check.tlv_received, pos, IMAGE_TLV_SIZE))
+    {
+        mcuboot_image_parse_tlv(&header_check.tlv[pos], &it);
+        pos += IMAGE_TLV_SIZE;
+        if (it.type != IMAGE_TLV_KEYHASH)
+        {
+            pos += it.len;
+            continue;
+        }
+
+        if (((pos + it.len) > tlv_tot) || !cy_ota_range_contains(&header_check.tlv_received, pos, it.len))
+        {
+            return CY_RSLT_SUCCESS;
+        }
+
+        header_check.key_done = true;
+        if ((it.len != OTA_SIGN_KEY_DIGEST_SIZE) || (CY_RSLT_SUCCESS != ota_sign_key_hash(key_hash)) ||
+            (memcmp(&header_check.tlv[pos], key_hash, OTA_SIGN_KEY_DIGEST_SIZE) != 0))
+        {
+            printf("\n Header check: image is not signed with the bootloader key.\n");
+            return CY_RSLT_TYPE_ERROR;
+        }
+        return CY_RSLT_SUCCESS;
+    }
+
+    if (((pos + IMAGE_TLV_SIZE) > tlv_tot) && (tlv_tot == info.tlv_tot))
+    {
+        /* All TLVs seen, MCUboot will refuse an image without a key hash */
+        header_check.key_done = true;
+        printf("\n Header check: image has no key hash.\n");
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+/* [] END OF FILE */
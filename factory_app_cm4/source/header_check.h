@@ -0,0 +1,89 @@
+/******************************************************************************
+* File Name: header_check.h
+*
+* Description: This file contains the declarations of the early check of
+* the MCUboot header of a downloaded image.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef SOURCE_HEADER_CHECK_H_
+#define SOURCE_HEADER_CHECK_H_
+
+#include <stdint.h>
+#include "cy_ota_api.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Primary slot the image runs from and secondary slot it is downloaded to.
+ * Set from the flash map in the Makefile. */
+#ifndef OTA_HEADER_CHECK_PRIMARY_ADDR
+#define OTA_HEADER_CHECK_PRIMARY_ADDR       (0x10018000u)
+#endif
+
+#ifndef OTA_HEADER_CHECK_PRIMARY_SIZE
+#define OTA_HEADER_CHECK_PRIMARY_SIZE       (0x001C0000u)
+#endif
+
+#ifndef OTA_HEADER_CHECK_SLOT_SIZE
+#define OTA_HEADER_CHECK_SLOT_SIZE          (0x001C0000u)
+#endif
+
+/* Set to 1 to reject images older than the one in the primary slot, as the
+ * bootloader does with MCUBOOT_DOWNGRADE_PREVENTION */
+#ifndef OTA_HEADER_CHECK_DOWNGRADE
+#define OTA_HEADER_CHECK_DOWNGRADE          (0)
+#endif
+
+/* Part of the unprotected TLV area searched for the key hash */
+#ifndef HEADER_CHECK_TLV_MAX
+#define HEADER_CHECK_TLV_MAX                (256u)
+#endif
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Called when the OTA storage is opened for a new download */
+void header_check_reset(void);
+
+/* Checks the MCUboot header when the first chunk of the image is written and
+ * the key hash when the TLV area is. Returns an error for an image the
+ * bootloader would not accept, which ends the download. */
+cy_rslt_t header_check_update(uint32_t offset, const uint8_t *data, uint32_t len);
+
+/* Image offset of the TLV area, 0 until the header has been checked */
+uint32_t header_check_tlv_offset(void);
+
+#endif /* SOURCE_HEADER_CHECK_H_ */
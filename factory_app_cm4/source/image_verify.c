@@ -0,0 +1,454 @@
+/******************************************************************************
+* File Name: image_verify.c
+*
+* Description: This file contains the incremental verification of the
+* downloaded MCUboot image. The SHA-256 of the image is computed while the chunks
+* are written and the TLVs are collected as they arrive, so the signature can be
+* checked at the end without reading the secondary slot back.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include <stdio.h>
+#include <string.h>
+#include "cyhal.h"
+#include "cybsp.h"
+#include "cy_retarget_io.h"
+#include "image_verify.h"
+#include "flash_service.h"
+#include "ota_sign_key.h"
+#include "mcuboot_image.h"
+#include "mbedtls/sha256.h"
+/* FreeRTOS */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define IMAGE_VERIFY_DIGEST_SIZE            OTA_SIGN_KEY_DIGEST_SIZE
+
+/* Block size of the read back */
+#define IMAGE_VERIFY_READ_SIZE              (512u)
+
+/*******************************************************************************
+* Data Structures
+********************************************************************************/
+typedef struct
+{
+    mbedtls_sha256_context      sha;
+    bool                        started;
+    uint32_t                    next_offset;    /* Image bytes seen so far */
+    bool                        in_order;
+    bool                        failed;
+    uint8_t                     header[IMAGE_HEADER_SIZE];
+    uint32_t                    hash_end;       /* 0 until the header is known */
+    uint32_t                    tlv_end;        /* 0 until the TLV info is known */
+    uint8_t                     tlv[IMAGE_VERIFY_TLV_MAX];
+} image_verify_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void image_verify_start(void);
+static void image_verify_feed(uint32_t offset, const uint8_t *data, uint32_t len);
+static bool image_verify_complete(void);
+static cy_rslt_t image_verify_read_back(void);
+static const uint8_t *image_verify_find_tlv(uint16_t type, uint16_t *len);
+static cy_rslt_t image_verify_signature(const uint8_t *digest);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static image_verify_t image_verify;
+
+/* Buffer of the read back */
+static uint8_t image_verify_buf[IMAGE_VERIFY_READ_SIZE];
+
+/*******************************************************************************
+ * Function Name: image_verify_reset
+ *******************************************************************************
+ * Summary:
+ *  Starts hashing a new download.
+ *
+ *******************************************************************************/
+void image_verify_reset(void)
+{
+    image_verify_start();
+}
+
+/*******************************************************************************
+ * Function Name: image_verify_update
+ *******************************************************************************
+ * Summary:
+ *  Feeds data written to the secondary slot to the hash. Only data that
+ *  continues the previous write can be hashed; after the first gap the image
+ *  is read back from the slot at the end instead.
+ *
+ * Parameters:
+ *  uint32_t offset     : Image offset of the data
+ *  const uint8_t *data : Data written
+ *  uint32_t len        : Length of data
+ *
+ *******************************************************************************/
+void image_verify_update(uint32_t offset, const uint8_t *data, uint32_t len)
+{
+    if (!image_verify.in_order)
+    {
+        return;
+    }
+
+    if (offset != image_verify.next_offset)
+    {
+        image_verify.in_order = false;
+        return;
+    }
+
+    image_verify_feed(offset, data, len);
+}
+
+/*******************************************************************************
+ * Function Name: image_verify_finish
+ *******************************************************************************
+ * Summary:
+ *  Completes the hash, reading the slot back if the image did not arrive in
+ *  order, and checks the SHA-256 TLV, the key hash TLV and the ECDSA
+ *  signature TLV. Called after all writes to the slot have been queued.
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS if the image is intact and signed with the
+ *              bootloader key, error code otherwise
+ *
+ *******************************************************************************/
+cy_rslt_t image_verify_finish(void)
+{
+    TickType_t start = xTaskGetTickCount();
+    uint8_t digest[IMAGE_VERIFY_DIGEST_SIZE];
+    const uint8_t *tlv;
+    uint16_t tlv_len;
+    bool streamed = image_verify.in_order && image_verify_complete();
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+
+    if (!streamed)
+    {
+        result = image_verify_read_back();
+    }
+
+    if ((CY_RSLT_SUCCESS == result) && (image_verify.failed || !image_verify_complete()))
+    {
+        printf("\n Image verification failed: not a complete MCUboot image.\n");
+        result = CY_RSLT_TYPE_ERROR;
+    }
+
+    if ((CY_RSLT_SUCCESS == result) && (0 != mbedtls_sha256_finish(&image_verify.sha, digest)))
+    {
+        result = CY_RSLT_TYPE_ERROR;
+    }
+
+    mbedtls_sha256_free(&image_verify.sha);
+    image_verify.started = false;
+    if (CY_RSLT_SUCCESS != result)
+    {
+        return result;
+    }
+
+    tlv = image_verify_find_tlv(IMAGE_TLV_SHA256, &tlv_len);
+    if ((tlv == NULL) || (tlv_len != IMAGE_VERIFY_DIGEST_SIZE) ||
+        (memcmp(tlv, digest, IMAGE_VERIFY_DIGEST_SIZE) != 0))
+    {
+        printf("\n Image verification failed: SHA-256 does not match.\n");
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    result = image_verify_signature(digest);
+    if (CY_RSLT_SUCCESS == result)
+    {
+        printf("Image signature verified in %lu ms (%s)\n",
+               (unsigned long)((xTaskGetTickCount() - start) * portTICK_PERIOD_MS),
+               streamed ? "hashed during download" : "slot read back");
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: image_verify_start
+ *******************************************************************************
+ * Summary:
+ *  Clears the state and starts a new hash.
+ *
+ *******************************************************************************/
+static void image_verify_start(void)
+{
+    if (image_verify.started)
+    {
+        mbedtls_sha256_free(&image_verify.sha);
+    }
+    memset(&image_verify, 0, sizeof(image_verify));
+    image_verify.in_order = true;
+
+    mbedtls_sha256_init(&image_verify.sha);
+    image_verify.started = true;
+    if (0 != mbedtls_sha256_starts(&image_verify.sha, 0))
+    {
+        image_verify.failed = true;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: image_verify_feed
+ *******************************************************************************
+ * Summary:
+ *  Consumes the next bytes of the image: the header is parsed, everything up
+ *  to the end of the protected TLVs is hashed and the unprotected TLV area is
+ *  kept for the checks at the end.
+ *
+ * Parameters:
+ *  uint32_t offset     : Image offset of data, equal to next_offset
+ *  const uint8_t *data : Image data
+ *  uint32_t len        : Length of data
+ *
+ *******************************************************************************/
+static void image_verify_feed(uint32_t offset, const uint8_t *data, uint32_t len)
+{
+    uint32_t end = offset + len;
+    uint32_t n;
+
+    image_verify.next_offset = end;
+    if (image_verify.failed)
+    {
+        return;
+    }
+
+    if (offset < IMAGE_HEADER_SIZE)
+    {
+        n = CY_MIN(end, IMAGE_HEADER_SIZE) - offset;
+        memcpy(&image_verify.header[offset], data, n);
+
+        if (end >= IMAGE_HEADER_SIZE)
+        {
+            mcuboot_image_header_t header;
+
+            mcuboot_image_parse_header(image_verify.header, &header);
+            if ((header.magic != IMAGE_MAGIC) || (header.hdr_size < IMAGE_HEADER_SIZE) ||
+                (header.img_size > OTA_IMAGE_VERIFY_SLOT_SIZE))
+            {
+                image_verify.failed = true;
+                return;
+            }
+            image_verify.hash_end = (uint32_t)header.hdr_size + header.img_size + header.prot_tlv_size;
+        }
+    }
+
+    /* The header, the image and the protected TLVs are hashed */
+    if ((image_verify.hash_end == 0) || (offset < image_verify.hash_end))
+    {
+        n = (image_verify.hash_end == 0) ? len : (CY_MIN(end, image_verify.hash_end) - offset);
+        if (0 != mbedtls_sha256_update(&image_verify.sha, data, n))
+        {
+            image_verify.failed = true;
+            return;
+        }
+    }
+
+    /* Unprotected TLV area */
+    if ((image_verify.hash_end != 0) && (end > image_verify.hash_end))
+    {
+        uint32_t from = CY_MAX(offset, image_verify.hash_end);
+        uint32_t pos = from - image_verify.hash_end;
+
+        if (pos < IMAGE_VERIFY_TLV_MAX)
+        {
+            n = CY_MIN(end - from, IMAGE_VERIFY_TLV_MAX - pos);
+            memcpy(&image_verify.tlv[pos], &data[from - offset], n);
+        }
+
+        if ((image_verify.tlv_end == 0) && ((end - image_verify.hash_end) >= IMAGE_TLV_INFO_SIZE))
+        {
+            mcuboot_image_tlv_info_t info;
+
+            mcuboot_image_parse_tlv_info(image_verify.tlv, &info);
+            if ((info.magic != IMAGE_TLV_INFO_MAGIC) || (info.tlv_tot < IMAGE_TLV_INFO_SIZE) ||
+                (info.tlv_tot > IMAGE_VERIFY_TLV_MAX))
+            {
+                image_verify.failed = true;
+                return;
+            }
+            image_verify.tlv_end = image_verify.hash_end + info.tlv_tot;
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: image_verify_complete
+ *******************************************************************************
+ * Summary:
+ *  Checks whether the whole image including its TLVs has been consumed.
+ *
+ *******************************************************************************/
+static bool image_verify_complete(void)
+{
+    return (image_verify.tlv_end != 0) && (image_verify.next_offset >= image_verify.tlv_end);
+}
+
+/*******************************************************************************
+ * Function Name: image_verify_read_back
+ *******************************************************************************
+ * Summary:
+ *  Hashes the image from the secondary slot, for downloads that did not
+ *  arrive in order. The flash service completes all queued writes first.
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS on success, error code otherwise
+ *
+ *******************************************************************************/
+static cy_rslt_t image_verify_read_back(void)
+{
+    uint32_t offset = 0;
+    uint32_t n;
+    cy_rslt_t result;
+
+    printf("Image not received in order, reading the slot back to verify it\n");
+    image_verify_start();
+
+    while (!image_verify.failed && !image_verify_complete() && (offset < OTA_IMAGE_VERIFY_SLOT_SIZE))
+    {
+        n = CY_MIN(sizeof(image_verify_buf), OTA_IMAGE_VERIFY_SLOT_SIZE - offset);
+        if (image_verify.tlv_end != 0)
+        {
+            n = CY_MIN(n, image_verify.tlv_end - offset);
+        }
+
+        result = flash_service_read(CY_OTA_MEM_TYPE_EXTERNAL_FLASH, OTA_IMAGE_VERIFY_SLOT_ADDR + offset,
+                                    image_verify_buf, n);
+        if (CY_RSLT_SUCCESS != result)
+        {
+            printf("\n Reading the secondary slot failed: 0x%lx\n", (unsigned long)result);
+            return result;
+        }
+
+        image_verify_feed(offset, image_verify_buf, n);
+        offset += n;
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: image_verify_find_tlv
+ *******************************************************************************
+ * Summary:
+ *  Finds a TLV in the unprotected TLV area.
+ *
+ * Parameters:
+ *  uint16_t type : TLV type
+ *  uint16_t *len : Receives the length of the value
+ *
+ * Return:
+ *  const uint8_t * : Value of the TLV, NULL if it is not present
+ *
+ *******************************************************************************/
+static const uint8_t *image_verify_find_tlv(uint16_t type, uint16_t *len)
+{
+    uint32_t tlv_tot = image_verify.tlv_end - image_verify.hash_end;
+    uint32_t pos = IMAGE_TLV_INFO_SIZE;
+    mcuboot_image_tlv_t it;
+
+    while ((pos + IMAGE_TLV_SIZE) <= tlv_tot)
+    {
+        mcuboot_image_parse_tlv(&image_verify.tlv[pos], &it);
+        pos += IMAGE_TLV_SIZE;
+        if ((pos + it.len) > tlv_tot)
+        {
+            break;
+        }
+
+        if (it.type == type)
+        {
+            *len = it.len;
+            return &image_verify.tlv[pos];
+        }
+        pos += it.len;
+    }
+
+    return NULL;
+}
+
+/*******************************************************************************
+ * Function Name: image_verify_signature
+ *******************************************************************************
+ * Summary:
+ *  Checks that the image was signed with the key built into the bootloader:
+ *  the key hash TLV must match the key, and the ECDSA signature must be valid
+ *  for the image digest.
+ *
+ * Parameters:
+ *  const uint8_t *digest : SHA-256 of the image
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS if the signature is valid, error code otherwise
+ *
+ *******************************************************************************/
+static cy_rslt_t image_verify_signature(const uint8_t *digest)
+{
+    uint8_t key_hash[IMAGE_VERIFY_DIGEST_SIZE];
+    const uint8_t *tlv;
+    uint16_t tlv_len;
+
+    tlv = image_verify_find_tlv(IMAGE_TLV_KEYHASH, &tlv_len);
+    if ((tlv == NULL) || (tlv_len != IMAGE_VERIFY_DIGEST_SIZE) ||
+        (CY_RSLT_SUCCESS != ota_sign_key_hash(key_hash)) ||
+        (memcmp(tlv, key_hash, IMAGE_VERIFY_DIGEST_SIZE) != 0))
+    {
+        printf("\n Image verification failed: image is not signed with the bootloader key.\n");
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    tlv = image_verify_find_tlv(IMAGE_TLV_ECDSA_SIG, &tlv_len);
+    if (tlv == NULL)
+    {
+        printf("\n Image verification failed: no ECDSA signature.\n");
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    if (CY_RSLT_SUCCESS != ota_sign_key_verify(digest, tlv, tlv_len))
+    {
+        printf("\n Image verification failed: invalid signature.\n");
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+/* [] END OF FILE */
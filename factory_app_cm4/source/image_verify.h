@@ -0,0 +1,81 @@
+/******************************************************************************
+* File Name: image_verify.h
+*
+* Description: This file contains the declarations of the incremental
+* verification of the downloaded MCUboot image.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef SOURCE_IMAGE_VERIFY_H_
+#define SOURCE_IMAGE_VERIFY_H_
+
+#include <stdint.h>
+#include "cy_ota_api.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Secondary slot the image is downloaded to, read back when the image did not
+ * arrive in order. Set from the flash map in the Makefile. */
+#ifndef OTA_IMAGE_VERIFY_SLOT_ADDR
+#define OTA_IMAGE_VERIFY_SLOT_ADDR          (0x18200200u)
+#endif
+
+#ifndef OTA_IMAGE_VERIFY_SLOT_SIZE
+#define OTA_IMAGE_VERIFY_SLOT_SIZE          (0x001C0000u)
+#endif
+
+/* Largest unprotected TLV area that can be checked */
+#ifndef IMAGE_VERIFY_TLV_MAX
+#define IMAGE_VERIFY_TLV_MAX                (256u)
+#endif
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Called when the OTA storage is opened for a new download */
+void image_verify_reset(void);
+
+/* Hashes image data written to the secondary slot. Data that does not follow
+ * the previous write switches to reading the slot back at the end. */
+void image_verify_update(uint32_t offset, const uint8_t *data, uint32_t len);
+
+/* Checks the SHA-256 and the ECDSA P-256 signature TLVs of the image against
+ * the digest computed during the download, after reading the slot back if
+ * needed. Returns CY_RSLT_SUCCESS if the image is signed with the key the
+ * bootloader trusts. */
+cy_rslt_t image_verify_finish(void);
+
+#endif /* SOURCE_IMAGE_VERIFY_H_ */
@@ -0,0 +1,93 @@
+/******************************************************************************
+* File Name: json_field.c
+*
+* Description: This file contains the reader of string values in flat JSON
+* documents, shared by the modules that parse the OTA job document.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/* Header file includes */
+#include <string.h>
+#include "json_field.h"
+
+/*******************************************************************************
+ * Function Name: json_field_get
+ *******************************************************************************
+ * Summary:
+ *  Copies the string value of "key" in a flat JSON document.
+ *
+ * Parameters:
+ *  const char *json_doc : NUL terminated JSON document
+ *  const char *key      : Name of the field
+ *  char *value          : Receives the value
+ *  size_t len           : Size of value
+ *
+ * Return:
+ *  bool : true if the value was copied
+ *
+ *******************************************************************************/
+bool json_field_get(const char *json_doc, const char *key, char *value, size_t len)
+{
+    size_t key_len = strlen(key);
+    const char *p = json_doc;
+    const char *end;
+
+    while ((p = strstr(p, key)) != NULL)
+    {
+        if ((p > json_doc) && (p[-1] == '"') && (p[key_len] == '"'))
+        {
+            p = strchr(p + key_len + 1u, '"');
+            if (p == NULL)
+            {
+                return false;
+            }
+            end = strchr(++p, '"');
+            if ((end == NULL) || ((size_t)(end - p) >= len))
+            {
+                return false;
+            }
+            memcpy(value, p, (size_t)(end - p));
+            value[end - p] = '\0';
+            return true;
+        }
+        p += key_len;
+    }
+
+    return false;
+}
+
+
+/* [] END OF FILE */
@@ -64,6 +64,8 @@
 ********************************************************************************/
 /* LED task handle */
 static TaskHandle_t led_task_handle;
+static StaticTask_t led_task_tcb;
+static StackType_t led_task_stack[LED_TASK_STACK_SIZE];
 
 /*******************************************************************************
 * Function Prototypes
@@ -80,8 +82,8 @@ static void led_task(void *args);
  *******************************************************************************/
 void led_task_init(void)
 {
-    xTaskCreate(led_task, "LED TASK", LED_TASK_STACK_SIZE, NULL,
-                LED_TASK_PRIORITY, &led_task_handle);
+    led_task_handle = xTaskCreateStatic(led_task, "LED TASK", LED_TASK_STACK_SIZE, NULL,
+                                        LED_TASK_PRIORITY, led_task_stack, &led_task_tcb);
 }
 
 /*******************************************************************************
@@ -55,6 +55,16 @@
 #include "cybsp.h"
 #include "cy_retarget_io.h"
 #include "state_mgr.h"
+#include "app_log.h"
+#include "arena.h"
+#ifdef RTOS_MONITOR_ENABLE
+/* CPU, stack and heap report */
+#include "rtos_monitor.h"
+#endif
+#ifdef EVENT_TRACE_ENABLE
+/* Task, interrupt, flash, OTA and MQTT timeline */
+#include "event_trace.h"
+#endif
 
 #ifdef DEBUG_PRINT
 #include "cy_log.h"
@@ -130,6 +140,30 @@ int main(void)
 
     printf("\nWatchdog timer started by the bootloader is now turned off!!!\n\n");
 
+    /* Start the log task, the OTA callback logs through it */
+    if (CY_RSLT_SUCCESS != app_log_init())
+    {
+        CY_ASSERT(0);
+    }
+
+    /* Carve the TLS arena before the first connection allocates from it */
+    if (CY_RSLT_SUCCESS != arena_init())
+    {
+        CY_ASSERT(0);
+    }
+
+#ifdef RTOS_MONITOR_ENABLE
+    if (CY_RSLT_SUCCESS != rtos_monitor_init())
+    {
+        CY_ASSERT(0);
+    }
+#endif
+
+#ifdef EVENT_TRACE_ENABLE
+    /* Record from the first task switch on */
+    event_trace_init();
+#endif
+
     /* initialize the state manager */
     state_mgr_task_init();
 
@@ -0,0 +1,293 @@
+/******************************************************************************
+* File Name: manifest_update.c
+*
+* Description: This file contains the manifest checked path of the OTA
+* storage. The download starts with the signed manifest of ota_manifest.h,
+* followed by the unchanged MCUboot image. Every chunk of the image is checked
+* against its hash before it is written, so a corrupt or forged chunk ends the
+* download right away instead of at the final image check.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/* Header file includes */
+#include <stdio.h>
+#include <string.h>
+#include "cyhal.h"
+#include "cybsp.h"
+#include "cy_retarget_io.h"
+#include "manifest_update.h"
+#include "ota_manifest.h"
+#include "flash_service.h"
+/* FreeRTOS */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static cy_rslt_t manifest_update_check_pending(void);
+static cy_rslt_t manifest_update_read_image(void *arg, uint32_t offset, void *data, size_t len);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Manifest of the current download. Holds the leaf hashes, so it is not on a
+ * task stack. */
+static ota_manifest_t mf_manifest;
+
+/* Image blocks written before the manifest was verified */
+static uint32_t mf_pending_bits[CY_OTA_RANGE_WORDS(OTA_MANIFEST_MAX_BLOCKS)];
+static cy_ota_range_t mf_pending;
+
+/* The current download has a manifest */
+static bool mf_active;
+
+/* Image blocks checked against the manifest */
+static uint32_t mf_checked_bits[CY_OTA_RANGE_WORDS(OTA_MANIFEST_MAX_BLOCKS)];
+static cy_ota_range_t mf_checked;
+
+/* Time the first chunk of the download arrived */
+static TickType_t mf_start;
+
+/*******************************************************************************
+ * Function Name: manifest_update_reset
+ *******************************************************************************
+ * Summary:
+ *  Forgets the previous download.
+ *
+ *******************************************************************************/
+void manifest_update_reset(void)
+{
+    mf_active = false;
+}
+
+/*******************************************************************************
+ * Function Name: manifest_update_is_stream
+ *******************************************************************************
+ * Summary:
+ *  Decides on the first chunk whether the download starts with a manifest and
+ *  starts collecting it if it does.
+ *
+ * Parameters:
+ *  const cy_ota_storage_write_info_t *chunk_info : Chunk from the OTA agent
+ *
+ * Return:
+ *  bool : true if the download has a manifest
+ *
+ *******************************************************************************/
+bool manifest_update_is_stream(const cy_ota_storage_write_info_t *chunk_info)
+{
+    if ((chunk_info->offset == 0) && !mf_active &&
+        ota_manifest_is_manifest(chunk_info->buffer, chunk_info->size))
+    {
+        printf("\n Download starts with a manifest, %lu bytes in total.\n", (unsigned long)chunk_info->total_size);
+        ota_manifest_init(&mf_manifest);
+        cy_ota_range_init(&mf_pending, mf_pending_bits, OTA_MANIFEST_MAX_BLOCKS);
+        cy_ota_range_init(&mf_checked, mf_checked_bits, OTA_MANIFEST_MAX_BLOCKS);
+        mf_active = true;
+        mf_start = xTaskGetTickCount();
+    }
+
+    return mf_active;
+}
+
+/*******************************************************************************
+ * Function Name: manifest_update_write
+ *******************************************************************************
+ * Summary:
+ *  Feeds a manifest chunk to the manifest, or checks an image chunk and writes
+ *  it to the OTA storage at its offset in the image. Image chunks that arrive
+ *  before the manifest is verified are written and checked from the flash
+ *  once it is.
+ *
+ * Parameters:
+ *  cy_ota_context_ptr ctx_ptr              : OTA context
+ *  cy_ota_storage_write_info_t *chunk_info : Chunk from the OTA agent
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS on success, error code otherwise
+ *
+ *******************************************************************************/
+cy_rslt_t manifest_update_write(cy_ota_context_ptr ctx_ptr, cy_ota_storage_write_info_t *chunk_info)
+{
+    const ota_manifest_header_t *header = &mf_manifest.header;
+    cy_ota_storage_write_info_t info;
+    cy_rslt_t result;
+    uint32_t offset;
+    uint32_t index;
+
+    if (!mf_manifest.header_valid || (chunk_info->offset < header->data_offset))
+    {
+        result = ota_manifest_feed(&mf_manifest, chunk_info->offset, chunk_info->buffer, chunk_info->size);
+        if ((CY_RSLT_SUCCESS == result) && (mf_checked.total_size == 0))
+        {
+            /* The header is parsed on the first chunk, size the trackers */
+            cy_ota_range_reset(&mf_pending, header->block_size, header->image_size);
+            cy_ota_range_reset(&mf_checked, header->block_size, header->image_size);
+        }
+        if ((CY_RSLT_SUCCESS == result) && ota_manifest_verified(&mf_manifest))
+        {
+            result = manifest_update_check_pending();
+        }
+        return result;
+    }
+
+    offset = chunk_info->offset - header->data_offset;
+    index = offset / header->block_size;
+    if (((offset % header->block_size) != 0) || (index >= header->block_count) ||
+        (chunk_info->size != CY_OTA_MANIFEST_MIN(header->block_size, header->image_size - offset)))
+    {
+        printf("\n Chunk at %lu does not match a block of the manifest.\n", (unsigned long)chunk_info->offset);
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    if (ota_manifest_verified(&mf_manifest))
+    {
+        result = ota_manifest_check_block(&mf_manifest, index, chunk_info->buffer, chunk_info->size);
+        if (CY_RSLT_SUCCESS != result)
+        {
+            printf("\n Block %lu does not match the manifest, download aborted.\n", (unsigned long)index);
+            return result;
+        }
+        cy_ota_range_add(&mf_checked, offset, chunk_info->size);
+    }
+
+    info = *chunk_info;
+    info.offset = offset;
+    info.total_size = header->image_size;
+    info.packet_number = (uint16_t)index;
+    info.total_packets = (uint16_t)header->block_count;
+
+    result = flash_service_storage_write(ctx_ptr, &info);
+    if ((CY_RSLT_SUCCESS == result) && !ota_manifest_verified(&mf_manifest))
+    {
+        cy_ota_range_add(&mf_pending, offset, chunk_info->size);
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: manifest_update_finish
+ *******************************************************************************
+ * Summary:
+ *  Checks the manifest was verified and every block of the image was checked
+ *  against it.
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS on success, error code otherwise
+ *
+ *******************************************************************************/
+cy_rslt_t manifest_update_finish(void)
+{
+    uint32_t elapsed_ms;
+
+    if (!mf_active)
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    mf_active = false;
+    if (!ota_manifest_verified(&mf_manifest) || !cy_ota_range_complete(&mf_checked))
+    {
+        printf("\n Manifest update: %lu of %lu blocks checked.\n",
+               (unsigned long)mf_checked.count, (unsigned long)mf_manifest.header.block_count);
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    elapsed_ms = (uint32_t)((xTaskGetTickCount() - mf_start) * portTICK_PERIOD_MS);
+    printf("\n Manifest update: %lu blocks of %lu bytes checked in %lu ms.\n",
+           (unsigned long)mf_checked.count, (unsigned long)mf_manifest.header.block_size, (unsigned long)elapsed_ms);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: manifest_update_check_pending
+ *******************************************************************************
+ * Summary:
+ *  Checks the blocks that were written before the manifest was verified,
+ *  reading them back from the secondary slot.
+ *
+ *******************************************************************************/
+static cy_rslt_t manifest_update_check_pending(void)
+{
+    const ota_manifest_header_t *header = &mf_manifest.header;
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+    uint32_t offset;
+    uint32_t index;
+
+    for (index = 0; index < header->block_count; index++)
+    {
+        offset = index * header->block_size;
+        if (!cy_ota_range_contains(&mf_pending, offset,
+                                   CY_OTA_MANIFEST_MIN(header->block_size, header->image_size - offset)))
+        {
+            continue;
+        }
+
+        result = ota_manifest_check_stored(&mf_manifest, index, manifest_update_read_image, NULL);
+        if (CY_RSLT_SUCCESS != result)
+        {
+            printf("\n Block %lu does not match the manifest, download aborted.\n", (unsigned long)index);
+            break;
+        }
+        cy_ota_range_add(&mf_checked, offset, CY_OTA_MANIFEST_MIN(header->block_size, header->image_size - offset));
+    }
+
+    cy_ota_range_reset(&mf_pending, header->block_size, header->image_size);
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: manifest_update_read_image
+ *******************************************************************************
+ * Summary:
+ *  Reads back part of the image from the secondary slot.
+ *
+ *******************************************************************************/
+static cy_rslt_t manifest_update_read_image(void *arg, uint32_t offset, void *data, size_t len)
+{
+    (void)arg;
+
+    if ((offset + len) > OTA_MANIFEST_SLOT_SIZE)
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    return flash_service_read(CY_OTA_MEM_TYPE_EXTERNAL_FLASH, OTA_MANIFEST_SLOT_ADDR + offset, data, len);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,79 @@
+/******************************************************************************
+* File Name: manifest_update.h
+*
+* Description: This file contains the declarations of the manifest checked
+* path of the OTA storage.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef SOURCE_MANIFEST_UPDATE_H_
+#define SOURCE_MANIFEST_UPDATE_H_
+
+#include <stdbool.h>
+#include "cy_ota_api.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Secondary slot the image is downloaded to, read back to check the blocks
+ * that arrived before the manifest. Set from the flash map in the Makefile. */
+#ifndef OTA_MANIFEST_SLOT_ADDR
+#define OTA_MANIFEST_SLOT_ADDR              (0x18200200u)
+#endif
+
+#ifndef OTA_MANIFEST_SLOT_SIZE
+#define OTA_MANIFEST_SLOT_SIZE              (0x001C0000u)
+#endif
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Called when the OTA storage is opened for a new download */
+void manifest_update_reset(void);
+
+/* Returns true if chunk_info belongs to a download with a manifest. The first
+ * chunk of the download decides whether it starts with a manifest. */
+bool manifest_update_is_stream(const cy_ota_storage_write_info_t *chunk_info);
+
+/* Feeds a chunk of the manifest, or checks a chunk of the image against the
+ * manifest and writes it to the OTA storage. Returns an error for a chunk that
+ * does not match, which ends the download. */
+cy_rslt_t manifest_update_write(cy_ota_context_ptr ctx_ptr, cy_ota_storage_write_info_t *chunk_info);
+
+/* Returns an error if the manifest was not verified or a block of the image
+ * was not checked. Does nothing for a download without a manifest. */
+cy_rslt_t manifest_update_finish(void);
+
+#endif /* SOURCE_MANIFEST_UPDATE_H_ */
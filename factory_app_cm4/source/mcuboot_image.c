@@ -0,0 +1,104 @@
+/******************************************************************************
+* File Name: mcuboot_image.c
+*
+* Description: This file contains the parsers of the MCUboot image header and
+* TLV area.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/* Header file includes */
+#include <string.h>
+#include "mcuboot_image.h"
+
+/*******************************************************************************
+ * Function Name: mcuboot_image_parse_header
+ *******************************************************************************
+ * Summary:
+ *  Extracts the fields of an image header.
+ *
+ * Parameters:
+ *  const uint8_t *data            : IMAGE_HEADER_SIZE bytes at the image start
+ *  mcuboot_image_header_t *header : Receives the fields
+ *
+ *******************************************************************************/
+void mcuboot_image_parse_header(const uint8_t *data, mcuboot_image_header_t *header)
+{
+    memcpy(&header->magic, &data[0], sizeof(header->magic));
+    memcpy(&header->hdr_size, &data[8], sizeof(header->hdr_size));
+    memcpy(&header->prot_tlv_size, &data[10], sizeof(header->prot_tlv_size));
+    memcpy(&header->img_size, &data[12], sizeof(header->img_size));
+    memcpy(&header->flags, &data[16], sizeof(header->flags));
+    header->major = data[20];
+    header->minor = data[21];
+    memcpy(&header->revision, &data[22], sizeof(header->revision));
+}
+
+/*******************************************************************************
+ * Function Name: mcuboot_image_parse_tlv_info
+ *******************************************************************************
+ * Summary:
+ *  Extracts the info at the start of the unprotected TLV area.
+ *
+ * Parameters:
+ *  const uint8_t *data            : IMAGE_TLV_INFO_SIZE bytes
+ *  mcuboot_image_tlv_info_t *info : Receives the fields
+ *
+ *******************************************************************************/
+void mcuboot_image_parse_tlv_info(const uint8_t *data, mcuboot_image_tlv_info_t *info)
+{
+    memcpy(&info->magic, &data[0], sizeof(info->magic));
+    memcpy(&info->tlv_tot, &data[2], sizeof(info->tlv_tot));
+}
+
+/*******************************************************************************
+ * Function Name: mcuboot_image_parse_tlv
+ *******************************************************************************
+ * Summary:
+ *  Extracts the type and length of a TLV, its value follows them.
+ *
+ * Parameters:
+ *  const uint8_t *data      : IMAGE_TLV_SIZE bytes
+ *  mcuboot_image_tlv_t *tlv : Receives the fields
+ *
+ *******************************************************************************/
+void mcuboot_image_parse_tlv(const uint8_t *data, mcuboot_image_tlv_t *tlv)
+{
+    memcpy(&tlv->type, &data[0], sizeof(tlv->type));
+    memcpy(&tlv->len, &data[2], sizeof(tlv->len));
+}
+
+
+/* [] END OF FILE */
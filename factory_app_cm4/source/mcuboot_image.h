@@ -0,0 +1,105 @@
+/******************************************************************************
+* File Name: mcuboot_image.h
+*
+* Description: This file contains the MCUboot image format shared by the
+* checks of downloaded images: the constants of bootutil/image.h and the
+* parsers of the header and the TLV area.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+#ifndef SOURCE_MCUBOOT_IMAGE_H_
+#define SOURCE_MCUBOOT_IMAGE_H_
+
+#include <stdint.h>
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* MCUboot image format, see bootutil/image.h */
+#define IMAGE_MAGIC                         (0x96f3b83du)
+#define IMAGE_HEADER_SIZE                   (32u)
+#define IMAGE_TLV_INFO_MAGIC                (0x6907u)
+#define IMAGE_TLV_INFO_SIZE                 (4u)
+/* Type and length in front of every TLV value */
+#define IMAGE_TLV_SIZE                      (4u)
+
+#define IMAGE_TLV_KEYHASH                   (0x01u)
+#define IMAGE_TLV_SHA256                    (0x10u)
+#define IMAGE_TLV_ECDSA_SIG                 (0x22u)
+
+#define IMAGE_F_ENCRYPTED_AES128            (0x04u)
+#define IMAGE_F_ENCRYPTED_AES256            (0x08u)
+#define IMAGE_F_RAM_LOAD                    (0x20u)
+
+/*******************************************************************************
+* Data Structures
+********************************************************************************/
+/* Fields of the image header used by the application */
+typedef struct
+{
+    uint32_t                    magic;
+    uint16_t                    hdr_size;
+    uint16_t                    prot_tlv_size;
+    uint32_t                    img_size;
+    uint32_t                    flags;
+    uint8_t                     major;
+    uint8_t                     minor;
+    uint16_t                    revision;
+} mcuboot_image_header_t;
+
+/* Info at the start of the unprotected TLV area, tlv_tot includes it */
+typedef struct
+{
+    uint16_t                    magic;
+    uint16_t                    tlv_tot;
+} mcuboot_image_tlv_info_t;
+
+typedef struct
+{
+    uint16_t                    type;
+    uint16_t                    len;
+} mcuboot_image_tlv_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Parse IMAGE_HEADER_SIZE, IMAGE_TLV_INFO_SIZE and IMAGE_TLV_SIZE bytes of
+ * image data. The data does not need to be aligned. */
+void mcuboot_image_parse_header(const uint8_t *data, mcuboot_image_header_t *header);
+void mcuboot_image_parse_tlv_info(const uint8_t *data, mcuboot_image_tlv_info_t *info);
+void mcuboot_image_parse_tlv(const uint8_t *data, mcuboot_image_tlv_t *tlv);
+
+#endif /* SOURCE_MCUBOOT_IMAGE_H_ */
@@ -0,0 +1,443 @@
+/******************************************************************************
+* File Name: mqtt_session.c
+*
+* Description: This file contains the MQTT session manager. The OTA agent connects to
+* the broker for the job check and again for the download. When the job
+* document offers a newer image on the same broker, the disconnect after the
+* job phase and the connect of the data phase are skipped, so the download
+* runs on the job connection and its subscription. cy_mqtt_connect() and
+* cy_mqtt_disconnect() are wrapped at link time to count the connects, to
+* adapt the keep-alive and to give persistent sessions a stable client ID.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/* Header file includes */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "cyhal.h"
+#include "cybsp.h"
+#include "cy_retarget_io.h"
+#include "mqtt_session.h"
+#include "json_field.h"
+#include "app_log.h"
+#include "cy_mqtt_api.h"
+/* FreeRTOS */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Longest broker host name of a job document that is compared */
+#define MQTT_SESSION_HOST_SIZE              (64u)
+
+/* Prefix of the agent and 12 hex digits of the silicon unique ID */
+#define MQTT_SESSION_CLIENT_ID_SIZE         (sizeof(CY_OTA_MQTT_CLIENT_ID_PREFIX) + 12u)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+cy_rslt_t __real_cy_mqtt_connect(cy_mqtt_t mqtt_handle, cy_mqtt_connect_info_t *connect_info);
+cy_rslt_t __wrap_cy_mqtt_connect(cy_mqtt_t mqtt_handle, cy_mqtt_connect_info_t *connect_info);
+cy_rslt_t __real_cy_mqtt_disconnect(cy_mqtt_t mqtt_handle);
+cy_rslt_t __wrap_cy_mqtt_disconnect(cy_mqtt_t mqtt_handle);
+static bool mqtt_session_keep(const char *json_doc);
+static bool mqtt_session_newer(const char *version);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Broker of the job connection */
+static char session_host[MQTT_SESSION_HOST_SIZE];
+static uint16_t session_port;
+
+/* The job connection was left open for the download */
+static bool session_kept;
+
+/* Between a successful connect and the disconnect */
+static bool session_connected;
+
+/* Keep-alive of the next connect */
+static uint16_t session_keep_alive_s = CY_OTA_MQTT_KEEP_ALIVE_SECONDS;
+
+#ifdef MQTT_SESSION_PERSISTENT_ENABLE
+/* Stable client ID, the agent appends a timestamp to its prefix */
+static char session_client_id[MQTT_SESSION_CLIENT_ID_SIZE];
+#endif
+
+/* Counters, only changed in critical sections */
+static mqtt_session_stats_t session_stats;
+
+/*******************************************************************************
+ * Function Name: mqtt_session_init
+ *******************************************************************************
+ * Summary:
+ *  Builds the client ID of the persistent session from the client ID prefix
+ *  of the agent and the silicon unique ID. The broker only keeps the session
+ *  of a client ID it has seen before, and every device of this example has
+ *  the same prefix.
+ *
+ *******************************************************************************/
+void mqtt_session_init(void)
+{
+#ifdef MQTT_SESSION_PERSISTENT_ENABLE
+    uint64_t unique_id = Cy_SysLib_GetUniqueId();
+
+    snprintf(session_client_id, sizeof(session_client_id), "%s%04lx%08lx", CY_OTA_MQTT_CLIENT_ID_PREFIX,
+             (unsigned long)((unique_id >> 32) & 0xFFFFu), (unsigned long)(unique_id & 0xFFFFFFFFu));
+    APP_LOG_INFO("MQTT session: persistent, client ID '%s'\n", session_client_id);
+#endif
+
+    session_stats.keep_alive_s = session_keep_alive_s;
+}
+
+/*******************************************************************************
+ * Function Name: mqtt_session_on_state
+ *******************************************************************************
+ * Summary:
+ *  Keeps the job connection open at CY_OTA_STATE_JOB_DISCONNECT if the job
+ *  document offers a newer image on the same broker, and hands it to the data
+ *  phase at CY_OTA_STATE_DATA_CONNECT. The agent then downloads on the
+ *  connection and the unique topic subscription of the job phase, and closes
+ *  it at CY_OTA_STATE_DATA_DISCONNECT as usual.
+ *
+ * Parameters:
+ *  cy_ota_cb_struct_t *cb_data : Callback data of the OTA agent
+ *
+ * Return:
+ *  cy_ota_callback_results_t : CY_OTA_CB_RSLT_APP_SUCCESS to skip the step
+ *                              of the agent, CY_OTA_CB_RSLT_OTA_CONTINUE
+ *                              otherwise
+ *
+ *******************************************************************************/
+cy_ota_callback_results_t mqtt_session_on_state(cy_ota_cb_struct_t *cb_data)
+{
+    cy_ota_callback_results_t cb_result = CY_OTA_CB_RSLT_OTA_CONTINUE;
+    size_t len;
+
+    switch (cb_data->ota_agt_state)
+    {
+        case CY_OTA_STATE_JOB_CONNECT:
+            taskENTER_CRITICAL();
+            session_stats.check_connects = 0;
+            session_stats.check_avoided = 0;
+            taskEXIT_CRITICAL();
+
+            /* An unknown broker is never reused */
+            session_host[0] = '\0';
+            len = (cb_data->broker_server.host_name != NULL) ? strlen(cb_data->broker_server.host_name) : 0u;
+            if (len < sizeof(session_host))
+            {
+                memcpy(session_host, cb_data->broker_server.host_name, len);
+                session_host[len] = '\0';
+            }
+            session_port = cb_data->broker_server.port;
+            session_kept = false;
+            break;
+
+        case CY_OTA_STATE_JOB_DISCONNECT:
+            if (session_connected && mqtt_session_keep(cb_data->json_doc))
+            {
+                APP_LOG_INFO("MQTT session: keeping the job connection for the download\n");
+                session_kept = true;
+                cb_result = CY_OTA_CB_RSLT_APP_SUCCESS;
+            }
+            break;
+
+        case CY_OTA_STATE_DATA_CONNECT:
+            if (!session_kept)
+            {
+                break;
+            }
+            if (session_connected && (cb_data->broker_server.host_name != NULL) &&
+                (0 == strcmp(cb_data->broker_server.host_name, session_host)) &&
+                (cb_data->broker_server.port == session_port))
+            {
+                taskENTER_CRITICAL();
+                session_stats.avoided++;
+                session_stats.check_avoided++;
+                taskEXIT_CRITICAL();
+                cb_result = CY_OTA_CB_RSLT_APP_SUCCESS;
+            }
+            else
+            {
+                /* Lost or redirected after all, the agent connects again */
+                APP_LOG_WARN("MQTT session: job connection not reusable, connecting again\n");
+                session_kept = false;
+            }
+            break;
+
+        case CY_OTA_STATE_DATA_DISCONNECT:
+            session_kept = false;
+            APP_LOG_INFO("MQTT session: %lu connects for this update, %lu avoided (%lu of %lu since reset), "
+                    "keep-alive %u s\n", (unsigned long)session_stats.check_connects,
+                    (unsigned long)session_stats.check_avoided, (unsigned long)session_stats.avoided,
+                    (unsigned long)(session_stats.connects + session_stats.avoided),
+                    (unsigned int)session_keep_alive_s);
+            break;
+
+        case CY_OTA_STATE_AGENT_WAITING:
+            /* The agent rejected the job after JOB_DISCONNECT, it ends the
+             * connection itself when the next check connects */
+            if (session_kept)
+            {
+                APP_LOG_WARN("MQTT session: job connection kept, but no download followed\n");
+                session_kept = false;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    return cb_result;
+}
+
+/*******************************************************************************
+ * Function Name: mqtt_session_on_failure
+ *******************************************************************************
+ * Summary:
+ *  A check or download that fails while connected most likely lost the
+ *  connection, often to a NAT or firewall that drops idle connections sooner
+ *  than the keep-alive. The keep-alive is halved for the next connect.
+ *
+ *******************************************************************************/
+void mqtt_session_on_failure(void)
+{
+    session_kept = false;
+    if (!session_connected)
+    {
+        return;
+    }
+
+    session_keep_alive_s /= 2u;
+    if (session_keep_alive_s < MQTT_SESSION_KEEP_ALIVE_MIN_S)
+    {
+        session_keep_alive_s = MQTT_SESSION_KEEP_ALIVE_MIN_S;
+    }
+
+    taskENTER_CRITICAL();
+    session_stats.drops++;
+    session_stats.keep_alive_s = session_keep_alive_s;
+    taskEXIT_CRITICAL();
+
+    APP_LOG_WARN("MQTT session: failed while connected, keep-alive %u s\n", (unsigned int)session_keep_alive_s);
+}
+
+/*******************************************************************************
+ * Function Name: mqtt_session_get_stats
+ *******************************************************************************
+ * Summary:
+ *  Copies the connect counters.
+ *
+ * Parameters:
+ *  mqtt_session_stats_t *stats : Receives the counters
+ *
+ *******************************************************************************/
+void mqtt_session_get_stats(mqtt_session_stats_t *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = session_stats;
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: __wrap_cy_mqtt_connect
+ *******************************************************************************
+ * Summary:
+ *  Replaces cy_mqtt_connect() for the whole application. Sets the adapted
+ *  keep-alive and, for a persistent session, the stable client ID, then
+ *  counts the connect. The OTA agent is the only MQTT client of the factory
+ *  app, so the client ID is never used twice at a time.
+ *
+ * Parameters:
+ *  cy_mqtt_t mqtt_handle                : Handle created by the OTA agent
+ *  cy_mqtt_connect_info_t *connect_info : Connect parameters of the OTA agent
+ *
+ * Return:
+ *  cy_rslt_t : Result of cy_mqtt_connect()
+ *
+ *******************************************************************************/
+cy_rslt_t __wrap_cy_mqtt_connect(cy_mqtt_t mqtt_handle, cy_mqtt_connect_info_t *connect_info)
+{
+    cy_rslt_t result;
+
+    if (connect_info != NULL)
+    {
+        connect_info->keep_alive_sec = session_keep_alive_s;
+#ifdef MQTT_SESSION_PERSISTENT_ENABLE
+        if (!connect_info->clean_session)
+        {
+            connect_info->client_id = session_client_id;
+            connect_info->client_id_len = (uint16_t)strlen(session_client_id);
+        }
+#endif
+    }
+
+    result = __real_cy_mqtt_connect(mqtt_handle, connect_info);
+
+    taskENTER_CRITICAL();
+    session_stats.connects++;
+    session_stats.check_connects++;
+    session_stats.failed += (result != CY_RSLT_SUCCESS) ? 1u : 0u;
+    taskEXIT_CRITICAL();
+    session_connected = (result == CY_RSLT_SUCCESS);
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: __wrap_cy_mqtt_disconnect
+ *******************************************************************************
+ * Summary:
+ *  Replaces cy_mqtt_disconnect() for the whole application. A connection the
+ *  agent ends itself lasted with the current keep-alive, so the next connect
+ *  tries a longer one, up to MQTT_SESSION_KEEP_ALIVE_MAX_S. Fewer pings keep
+ *  the radio idle longer.
+ *
+ * Parameters:
+ *  cy_mqtt_t mqtt_handle : Handle created by the OTA agent
+ *
+ * Return:
+ *  cy_rslt_t : Result of cy_mqtt_disconnect()
+ *
+ *******************************************************************************/
+cy_rslt_t __wrap_cy_mqtt_disconnect(cy_mqtt_t mqtt_handle)
+{
+    if (session_connected)
+    {
+        session_connected = false;
+        session_keep_alive_s += MQTT_SESSION_KEEP_ALIVE_STEP_S;
+        if (session_keep_alive_s > MQTT_SESSION_KEEP_ALIVE_MAX_S)
+        {
+            session_keep_alive_s = MQTT_SESSION_KEEP_ALIVE_MAX_S;
+        }
+
+        taskENTER_CRITICAL();
+        session_stats.keep_alive_s = session_keep_alive_s;
+        taskEXIT_CRITICAL();
+    }
+
+    return __real_cy_mqtt_disconnect(mqtt_handle);
+}
+
+/*******************************************************************************
+ * Function Name: mqtt_session_keep
+ *******************************************************************************
+ * Summary:
+ *  Checks that the job document offers an image newer than this app on the
+ *  broker of the job connection. The agent would reject an older image or
+ *  redirect to another broker, and the kept connection would stay open
+ *  without a download.
+ *
+ * Parameters:
+ *  const char *json_doc : Job document received by the agent
+ *
+ * Return:
+ *  bool : true to keep the connection for the download
+ *
+ *******************************************************************************/
+static bool mqtt_session_keep(const char *json_doc)
+{
+    char value[MQTT_SESSION_HOST_SIZE];
+
+    if ((json_doc == NULL) || (session_host[0] == '\0') ||
+        !json_field_get(json_doc, "Message", value, sizeof(value)) ||
+        (0 != strcmp(value, "Update Available")) ||
+        !json_field_get(json_doc, "Version", value, sizeof(value)) ||
+        !mqtt_session_newer(value))
+    {
+        return false;
+    }
+
+    /* Without a broker in the job, the data phase uses the job broker */
+    if (json_field_get(json_doc, "Broker", value, sizeof(value)) &&
+        (0 != strcmp(value, session_host)))
+    {
+        return false;
+    }
+    if (json_field_get(json_doc, "Port", value, sizeof(value)) &&
+        (strtoul(value, NULL, 10) != session_port))
+    {
+        return false;
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: mqtt_session_newer
+ *******************************************************************************
+ * Summary:
+ *  Compares a "major.minor.build" version with the version of this app.
+ *
+ * Parameters:
+ *  const char *version : Version of the job document
+ *
+ * Return:
+ *  bool : true if the version is newer
+ *
+ *******************************************************************************/
+static bool mqtt_session_newer(const char *version)
+{
+    const uint32_t current[] = { APP_VERSION_MAJOR, APP_VERSION_MINOR, APP_VERSION_BUILD };
+    uint32_t part;
+    char *end;
+    uint32_t i;
+
+    for (i = 0; i < (sizeof(current) / sizeof(current[0])); i++)
+    {
+        part = (uint32_t)strtoul(version, &end, 10);
+        if ((end == version) || ((*end != '.') && (*end != '\0')))
+        {
+            return false;
+        }
+        if (part != current[i])
+        {
+            return (part > current[i]);
+        }
+        if (*end == '\0')
+        {
+            break;
+        }
+        version = end + 1;
+    }
+
+    return false;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,103 @@
+/******************************************************************************
+* File Name: mqtt_session.h
+*
+* Description: This file contains the declarations of the MQTT session manager, which
+* keeps the broker connection of the OTA agent across the job and data phases
+* and adapts its keep-alive.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+#ifndef SOURCE_MQTT_SESSION_H_
+#define SOURCE_MQTT_SESSION_H_
+
+#include <stdint.h>
+#include "cy_ota_api.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Range of the keep-alive. The first connection uses
+ * CY_OTA_MQTT_KEEP_ALIVE_SECONDS. */
+#ifndef MQTT_SESSION_KEEP_ALIVE_MIN_S
+#define MQTT_SESSION_KEEP_ALIVE_MIN_S       (15u)
+#endif
+
+#ifndef MQTT_SESSION_KEEP_ALIVE_MAX_S
+#define MQTT_SESSION_KEEP_ALIVE_MAX_S       (300u)
+#endif
+
+/* Added to the keep-alive for every connection that ended without a failure */
+#define MQTT_SESSION_KEEP_ALIVE_STEP_S      (15u)
+
+#if ((MQTT_SESSION_KEEP_ALIVE_MIN_S > CY_OTA_MQTT_KEEP_ALIVE_SECONDS) || \
+     (MQTT_SESSION_KEEP_ALIVE_MAX_S < CY_OTA_MQTT_KEEP_ALIVE_SECONDS) || \
+     (MQTT_SESSION_KEEP_ALIVE_MAX_S > 65535u))
+#error "CY_OTA_MQTT_KEEP_ALIVE_SECONDS must be within MQTT_SESSION_KEEP_ALIVE_MIN_S and MQTT_SESSION_KEEP_ALIVE_MAX_S"
+#endif
+
+/*******************************************************************************
+* Data Structures
+********************************************************************************/
+typedef struct
+{
+    uint32_t                    connects;       /* Connects to the broker */
+    uint32_t                    failed;         /* Of those, failed */
+    uint32_t                    avoided;        /* Data connects served by the job connection */
+    uint32_t                    drops;          /* Checks that failed while connected */
+    uint32_t                    check_connects; /* Connects of the current or last check */
+    uint32_t                    check_avoided;  /* Connects that check avoided */
+    uint32_t                    keep_alive_s;   /* Keep-alive of the next connect */
+} mqtt_session_stats_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Builds the client ID of the persistent session. Call before the OTA agent
+ * starts. */
+void mqtt_session_init(void);
+
+/* Called from the OTA callback on every state change. Returns
+ * CY_OTA_CB_RSLT_APP_SUCCESS to skip the disconnect after the job phase and
+ * the connect of the data phase, CY_OTA_CB_RSLT_OTA_CONTINUE otherwise. */
+cy_ota_callback_results_t mqtt_session_on_state(cy_ota_cb_struct_t *cb_data);
+
+/* Called from the OTA callback on a failed check or download */
+void mqtt_session_on_failure(void);
+
+/* Copies the connect counters */
+void mqtt_session_get_stats(mqtt_session_stats_t *stats);
+
+#endif /* SOURCE_MQTT_SESSION_H_ */
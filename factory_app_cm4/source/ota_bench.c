@@ -0,0 +1,379 @@
+/******************************************************************************
+* File Name: ota_bench.c
+*
+* Description: This file contains the OTA throughput benchmark. It
+* timestamps every state of the OTA agent and accounts the time of a download
+* to network receive, storage write and verify. The summary is printed as a
+* single JSON line and published as telemetry, scripts/ota_bench.py collects it
+* and compares it against a baseline.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/* Header file includes */
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include "cyhal.h"
+#include "cybsp.h"
+#include "cy_retarget_io.h"
+#include "ota_bench.h"
+#include "telemetry.h"
+#ifdef OTA_CHUNK_WINDOW_ENABLE
+#include "chunk_window.h"
+#endif
+#ifdef TLS_SESSION_RESUME_ENABLE
+#include "tls_session.h"
+#endif
+#ifdef MQTT_SESSION_ENABLE
+#include "mqtt_session.h"
+#endif
+/* FreeRTOS */
+#include <task.h>
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define OTA_BENCH_TICKS_TO_MS(t)            ((uint32_t)((t) * portTICK_PERIOD_MS))
+
+/*******************************************************************************
+* Data Structures
+********************************************************************************/
+/* Time spent in one state of the OTA agent */
+typedef struct
+{
+    uint32_t                    count;          /* Times the state was entered */
+    uint32_t                    first_ms;       /* First entry, since the start */
+    uint32_t                    total_ms;
+} ota_bench_state_stats_t;
+
+typedef struct
+{
+    bool                        running;
+    TickType_t                  start;
+    cy_ota_agent_state_t        state;
+    TickType_t                  state_since;
+    ota_bench_state_stats_t     states[CY_OTA_NUM_STATES];
+
+    /* Download */
+    TickType_t                  last_write;     /* 0 until the data is requested */
+    uint32_t                    bytes;
+    uint32_t                    chunks;
+    uint32_t                    receive_ms;
+    uint32_t                    write_ms;
+    uint32_t                    verify_ms;
+    uint32_t                    stalls;
+    uint32_t                    max_gap_ms;
+} ota_bench_t;
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+static ota_bench_t ota_bench;
+
+/* Names in the summary, stable for the host script */
+static const char *const ota_bench_state_names[CY_OTA_NUM_STATES] =
+{
+    [CY_OTA_STATE_NOT_INITIALIZED]      = "NOT_INITIALIZED",
+    [CY_OTA_STATE_EXITING]              = "EXITING",
+    [CY_OTA_STATE_INITIALIZING]         = "INITIALIZING",
+    [CY_OTA_STATE_AGENT_STARTED]        = "AGENT_STARTED",
+    [CY_OTA_STATE_AGENT_WAITING]        = "AGENT_WAITING",
+    [CY_OTA_STATE_START_UPDATE]         = "START_UPDATE",
+    [CY_OTA_STATE_JOB_CONNECT]          = "JOB_CONNECT",
+    [CY_OTA_STATE_JOB_DOWNLOAD]         = "JOB_DOWNLOAD",
+    [CY_OTA_STATE_JOB_DISCONNECT]       = "JOB_DISCONNECT",
+    [CY_OTA_STATE_JOB_PARSE]            = "JOB_PARSE",
+    [CY_OTA_STATE_JOB_REDIRECT]         = "JOB_REDIRECT",
+    [CY_OTA_STATE_DATA_CONNECT]         = "DATA_CONNECT",
+    [CY_OTA_STATE_DATA_DOWNLOAD]        = "DATA_DOWNLOAD",
+    [CY_OTA_STATE_DATA_DISCONNECT]      = "DATA_DISCONNECT",
+    [CY_OTA_STATE_VERIFY]               = "VERIFY",
+    [CY_OTA_STATE_RESULT_REDIRECT]      = "RESULT_REDIRECT",
+    [CY_OTA_STATE_RESULT_CONNECT]       = "RESULT_CONNECT",
+    [CY_OTA_STATE_RESULT_SEND]          = "RESULT_SEND",
+    [CY_OTA_STATE_RESULT_RESPONSE]      = "RESULT_RESPONSE",
+    [CY_OTA_STATE_RESULT_DISCONNECT]    = "RESULT_DISCONNECT",
+    [CY_OTA_STATE_OTA_COMPLETE]         = "OTA_COMPLETE",
+    [CY_OTA_STATE_STORAGE_OPEN]         = "STORAGE_OPEN",
+    [CY_OTA_STATE_STORAGE_WRITE]        = "STORAGE_WRITE",
+    [CY_OTA_STATE_STORAGE_CLOSE]        = "STORAGE_CLOSE",
+};
+
+/*******************************************************************************
+ * Function Name: ota_bench_state
+ *******************************************************************************
+ * Summary:
+ *  Accounts the time spent in the previous state and timestamps the new one.
+ *  START_UPDATE starts a new measurement.
+ *
+ * Parameters:
+ *  const cy_ota_cb_struct_t *cb_data : Callback data of the state change
+ *
+ *******************************************************************************/
+void ota_bench_state(const cy_ota_cb_struct_t *cb_data)
+{
+    TickType_t now = xTaskGetTickCount();
+    cy_ota_agent_state_t state = cb_data->ota_agt_state;
+
+    if (state >= CY_OTA_NUM_STATES)
+    {
+        return;
+    }
+
+    if (state == CY_OTA_STATE_START_UPDATE)
+    {
+        memset(&ota_bench, 0, sizeof(ota_bench));
+        ota_bench.running = true;
+        ota_bench.start = now;
+    }
+    else if (!ota_bench.running)
+    {
+        return;
+    }
+    else
+    {
+        ota_bench.states[ota_bench.state].total_ms += OTA_BENCH_TICKS_TO_MS(now - ota_bench.state_since);
+    }
+
+    if (ota_bench.states[state].count == 0)
+    {
+        ota_bench.states[state].first_ms = OTA_BENCH_TICKS_TO_MS(now - ota_bench.start);
+    }
+    ota_bench.states[state].count++;
+    ota_bench.state = state;
+    ota_bench.state_since = now;
+
+    /* The first chunk is measured from the request of the data */
+    if ((state == CY_OTA_STATE_DATA_DOWNLOAD) && (ota_bench.last_write == 0))
+    {
+        ota_bench.last_write = now;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: ota_bench_start
+ *******************************************************************************
+ * Summary:
+ *  Returns the timestamp to pass to ota_bench_end().
+ *
+ *******************************************************************************/
+TickType_t ota_bench_start(void)
+{
+    return xTaskGetTickCount();
+}
+
+/*******************************************************************************
+ * Function Name: ota_bench_end
+ *******************************************************************************
+ * Summary:
+ *  Accounts a storage write or verify. The time between the end of a write
+ *  and the start of the next one is spent waiting for the network, a gap of
+ *  OTA_BENCH_STALL_MS or more is counted as a stall.
+ *
+ * Parameters:
+ *  ota_bench_stage_t stage : Stage that ended
+ *  TickType_t start        : ota_bench_start() at the start of the stage
+ *  uint32_t bytes          : Bytes written
+ *
+ *******************************************************************************/
+void ota_bench_end(ota_bench_stage_t stage, TickType_t start, uint32_t bytes)
+{
+    TickType_t now = xTaskGetTickCount();
+    uint32_t gap_ms;
+
+    if (!ota_bench.running)
+    {
+        return;
+    }
+
+    if (stage == OTA_BENCH_STAGE_VERIFY)
+    {
+        ota_bench.verify_ms += OTA_BENCH_TICKS_TO_MS(now - start);
+        return;
+    }
+
+    if (ota_bench.last_write == 0)
+    {
+        ota_bench.last_write = start;
+    }
+
+    gap_ms = OTA_BENCH_TICKS_TO_MS(start - ota_bench.last_write);
+    ota_bench.receive_ms += gap_ms;
+    if (gap_ms >= OTA_BENCH_STALL_MS)
+    {
+        ota_bench.stalls++;
+    }
+    if (gap_ms > ota_bench.max_gap_ms)
+    {
+        ota_bench.max_gap_ms = gap_ms;
+    }
+
+    ota_bench.write_ms += OTA_BENCH_TICKS_TO_MS(now - start);
+    ota_bench.bytes += bytes;
+    ota_bench.chunks++;
+    ota_bench.last_write = now;
+}
+
+/*******************************************************************************
+ * Function Name: ota_bench_report
+ *******************************************************************************
+ * Summary:
+ *  Prints the summary of the update as one JSON line prefixed with
+ *  OTA_BENCH_LOG_PREFIX and publishes it. The OTA agent verifies the image
+ *  after closing the data connection, so the summary is published when the
+ *  download ends and printed again with the verify time and the result.
+ *
+ * Parameters:
+ *  cy_mqtt_t mqtt_handle : MQTT connection to publish on, NULL to only print
+ *  const char *result    : "downloaded", or "success" or "failure" to end
+ *                          the measurement
+ *
+ *******************************************************************************/
+void ota_bench_report(cy_mqtt_t mqtt_handle, const char *result)
+{
+    static char doc[TELEMETRY_DOC_SIZE];
+    uint32_t total_ms;
+    uint32_t download_ms;
+    uint32_t retries = 0;
+#ifdef TLS_SESSION_RESUME_ENABLE
+    tls_session_stats_t tls_stats;
+#endif
+#ifdef MQTT_SESSION_ENABLE
+    mqtt_session_stats_t mqtt_stats;
+#endif
+    uint32_t i;
+    int len;
+    int n;
+
+    if (!ota_bench.running)
+    {
+        return;
+    }
+    if (strcmp(result, "downloaded") != 0)
+    {
+        ota_bench.running = false;
+    }
+
+    total_ms = OTA_BENCH_TICKS_TO_MS(xTaskGetTickCount() - ota_bench.start);
+    download_ms = ota_bench.receive_ms + ota_bench.write_ms;
+#ifdef OTA_CHUNK_WINDOW_ENABLE
+    retries = chunk_window_retries();
+#endif
+
+    len = snprintf(doc, sizeof(doc),
+                   "{\"result\":\"%s\",\"bytes\":%lu,\"chunks\":%lu,\"total_ms\":%lu,\"bytes_per_s\":%lu,"
+                   "\"receive_ms\":%lu,\"write_ms\":%lu,\"verify_ms\":%lu,"
+                   "\"retries\":%lu,\"stalls\":%lu,\"max_gap_ms\":%lu,\"states\":{",
+                   result, (unsigned long)ota_bench.bytes,
+                   (unsigned long)ota_bench.chunks, (unsigned long)total_ms,
+                   (unsigned long)((download_ms != 0) ? ((ota_bench.bytes * 1000ull) / download_ms) : 0u),
+                   (unsigned long)ota_bench.receive_ms, (unsigned long)ota_bench.write_ms,
+                   (unsigned long)ota_bench.verify_ms, (unsigned long)retries,
+                   (unsigned long)ota_bench.stalls, (unsigned long)ota_bench.max_gap_ms);
+
+    for (i = 0; (i < CY_OTA_NUM_STATES) && (len > 0) && ((size_t)len < sizeof(doc)); i++)
+    {
+        if ((ota_bench.states[i].count == 0) || (ota_bench_state_names[i] == NULL))
+        {
+            continue;
+        }
+
+        /* The current state is still running */
+        if (i == (uint32_t)ota_bench.state)
+        {
+            ota_bench.states[i].total_ms += OTA_BENCH_TICKS_TO_MS(xTaskGetTickCount() - ota_bench.state_since);
+            ota_bench.state_since = xTaskGetTickCount();
+        }
+
+        n = snprintf(&doc[len], sizeof(doc) - (size_t)len, "%s\"%s\":{\"n\":%lu,\"at_ms\":%lu,\"ms\":%lu}",
+                     (doc[len - 1] == '{') ? "" : ",", ota_bench_state_names[i],
+                     (unsigned long)ota_bench.states[i].count, (unsigned long)ota_bench.states[i].first_ms,
+                     (unsigned long)ota_bench.states[i].total_ms);
+        len = (n < 0) ? -1 : (len + n);
+    }
+
+    if ((len > 0) && ((size_t)len < sizeof(doc)))
+    {
+        n = snprintf(&doc[len], sizeof(doc) - (size_t)len, "}");
+        len = (n < 0) ? -1 : (len + n);
+    }
+
+#ifdef TLS_SESSION_RESUME_ENABLE
+    if ((len > 0) && ((size_t)len < sizeof(doc)))
+    {
+        /* Handshakes since the reset, not only of this update */
+        tls_session_get_stats(&tls_stats);
+        n = snprintf(&doc[len], sizeof(doc) - (size_t)len,
+                     ",\"tls\":{\"handshakes\":%lu,\"resumed\":%lu,\"full_ms\":%lu,\"resumed_ms\":%lu}",
+                     (unsigned long)tls_stats.handshakes, (unsigned long)tls_stats.resumed,
+                     (unsigned long)tls_stats.full_ms, (unsigned long)tls_stats.resumed_ms);
+        len = (n < 0) ? -1 : (len + n);
+    }
+#endif
+
+#ifdef MQTT_SESSION_ENABLE
+    if ((len > 0) && ((size_t)len < sizeof(doc)))
+    {
+        /* Connects of this update */
+        mqtt_session_get_stats(&mqtt_stats);
+        n = snprintf(&doc[len], sizeof(doc) - (size_t)len,
+                     ",\"mqtt\":{\"connects\":%lu,\"avoided\":%lu,\"keep_alive_s\":%lu}",
+                     (unsigned long)mqtt_stats.check_connects, (unsigned long)mqtt_stats.check_avoided,
+                     (unsigned long)mqtt_stats.keep_alive_s);
+        len = (n < 0) ? -1 : (len + n);
+    }
+#endif
+
+    if ((len > 0) && ((size_t)len < sizeof(doc)))
+    {
+        n = snprintf(&doc[len], sizeof(doc) - (size_t)len, "}");
+        len = (n < 0) ? -1 : (len + n);
+    }
+
+    if ((len <= 0) || ((size_t)len >= sizeof(doc)))
+    {
+        printf("\n OTA benchmark summary does not fit in %u bytes.\n", (unsigned int)sizeof(doc));
+        return;
+    }
+
+    printf("\n" OTA_BENCH_LOG_PREFIX "%s\n", doc);
+
+    if (mqtt_handle != NULL)
+    {
+        telemetry_publish(mqtt_handle, "bench", doc, (size_t)len);
+    }
+}
+
+/* [] END OF FILE */
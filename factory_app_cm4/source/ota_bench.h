@@ -0,0 +1,91 @@
+/******************************************************************************
+* File Name: ota_bench.h
+*
+* Description: This file contains the declarations of the OTA throughput
+* benchmark.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef SOURCE_OTA_BENCH_H_
+#define SOURCE_OTA_BENCH_H_
+
+#include <stdint.h>
+#include "cy_ota_api.h"
+#include "cy_mqtt_api.h"
+/* FreeRTOS */
+#include <FreeRTOS.h>
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* A gap of at least this long between two chunks counts as a stall */
+#ifndef OTA_BENCH_STALL_MS
+#define OTA_BENCH_STALL_MS                  (1000u)
+#endif
+
+/* Prefix of the summary line on the debug UART, see scripts/ota_bench.py */
+#define OTA_BENCH_LOG_PREFIX                "OTA_BENCH "
+
+/*******************************************************************************
+* Data Structures
+********************************************************************************/
+/* Stages timed by ota_bench_end() */
+typedef enum
+{
+    OTA_BENCH_STAGE_WRITE,              /* Storage write callback */
+    OTA_BENCH_STAGE_VERIFY              /* Storage verify callback */
+} ota_bench_stage_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Called from the OTA callback with every state change. A new update starts
+ * a new measurement. */
+void ota_bench_state(const cy_ota_cb_struct_t *cb_data);
+
+/* Timestamp for ota_bench_end() */
+TickType_t ota_bench_start(void);
+
+/* Accounts the time since start to a stage. For writes, the time since the
+ * previous write counts as network receive time. */
+void ota_bench_end(ota_bench_stage_t stage, TickType_t start, uint32_t bytes);
+
+/* Prints the summary as one JSON line and publishes it to
+ * TELEMETRY_TOPIC_PREFIX "bench" if mqtt_handle is not NULL. result is
+ * "downloaded" at the end of the download, "success" or "failure" at the end
+ * of the update, which ends the measurement. */
+void ota_bench_report(cy_mqtt_t mqtt_handle, const char *result);
+
+#endif /* SOURCE_OTA_BENCH_H_ */
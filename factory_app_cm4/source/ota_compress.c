@@ -0,0 +1,357 @@
+/******************************************************************************
+* File Name: ota_compress.c
+*
+* Description: This file contains the decoder of compressed OTA images. Each
+* frame of the stream is decoded on its own, block by block, into a single
+* block buffer, so chunks can arrive in any order and RAM use does not depend on
+* the image size. It has no RTOS or HAL dependencies, so it can also be built on
+* a host.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include <stdio.h>
+#include <string.h>
+#include "ota_compress.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Smallest LZ4 match */
+#define OTA_LZ4_MIN_MATCH                   (4u)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static uint32_t ota_compress_get_le32(const uint8_t *p);
+static uint16_t ota_compress_get_le16(const uint8_t *p);
+static cy_rslt_t ota_compress_fail(uint32_t offset, const char *reason);
+
+/*******************************************************************************
+ * Function Name: ota_compress_is_stream
+ *******************************************************************************
+ * Summary:
+ *  Checks for the stream magic at the start of an image.
+ *
+ * Parameters:
+ *  const void *data : First bytes of the image
+ *  size_t len       : Number of bytes available
+ *
+ * Return:
+ *  bool : true if data is the start of a compressed stream
+ *
+ *******************************************************************************/
+bool ota_compress_is_stream(const void *data, size_t len)
+{
+    return (data != NULL) && (len >= OTA_COMPRESS_MAGIC_LEN) &&
+           (memcmp(data, OTA_COMPRESS_MAGIC, OTA_COMPRESS_MAGIC_LEN) == 0);
+}
+
+/*******************************************************************************
+ * Function Name: ota_compress_init
+ *******************************************************************************
+ * Summary:
+ *  Prepares the decoder for a new stream.
+ *
+ * Parameters:
+ *  ota_compress_t *comp       : Decoder state
+ *  ota_compress_write_t write : Writes the image
+ *  void *arg                  : Passed to write
+ *
+ *******************************************************************************/
+void ota_compress_init(ota_compress_t *comp, ota_compress_write_t write, void *arg)
+{
+    memset(comp, 0, offsetof(ota_compress_t, out));
+    comp->write = write;
+    comp->arg = arg;
+}
+
+/*******************************************************************************
+ * Function Name: ota_compress_frame
+ *******************************************************************************
+ * Summary:
+ *  Decodes all blocks of one frame and writes them at their image offset.
+ *
+ * Parameters:
+ *  ota_compress_t *comp : Decoder state
+ *  uint32_t offset      : Offset of the frame in the stream
+ *  const void *data     : Frame data
+ *  size_t len           : Size of the frame, the last frame may be short
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS on success, error code otherwise
+ *
+ *******************************************************************************/
+cy_rslt_t ota_compress_frame(ota_compress_t *comp, uint32_t offset, const void *data, size_t len)
+{
+    const uint8_t *frame = (const uint8_t *)data;
+    uint32_t pos = 0;
+    uint32_t raw_offset;
+    uint16_t comp_len;
+    uint16_t raw_len;
+    int32_t decoded;
+
+    if (offset == 0)
+    {
+        if ((len < OTA_COMPRESS_HEADER_SIZE) || !ota_compress_is_stream(frame, len) ||
+            (ota_compress_get_le16(&frame[8]) != OTA_COMPRESS_VERSION))
+        {
+            return ota_compress_fail(offset, "unsupported stream header");
+        }
+        comp->frame_size = ota_compress_get_le16(&frame[10]);
+        comp->raw_size = ota_compress_get_le32(&frame[12]);
+        pos = OTA_COMPRESS_HEADER_SIZE;
+    }
+
+    if ((comp->frame_size == 0) || ((offset % comp->frame_size) != 0) || (len > comp->frame_size))
+    {
+        return ota_compress_fail(offset, "chunk is not a frame");
+    }
+
+    while ((pos + OTA_COMPRESS_BLOCK_HEADER_SIZE) <= len)
+    {
+        raw_offset = ota_compress_get_le32(&frame[pos]);
+        comp_len = ota_compress_get_le16(&frame[pos + 4]);
+        raw_len = ota_compress_get_le16(&frame[pos + 6]);
+        pos += OTA_COMPRESS_BLOCK_HEADER_SIZE;
+
+        /* Rest of the frame is padding */
+        if (comp_len == 0)
+        {
+            break;
+        }
+
+        if ((comp_len > (len - pos)) || (raw_offset > comp->raw_size))
+        {
+            return ota_compress_fail(offset, "block outside of the frame");
+        }
+
+        if ((raw_len & OTA_COMPRESS_STORED) != 0)
+        {
+            raw_len &= (uint16_t)~OTA_COMPRESS_STORED;
+            if ((comp_len != raw_len) || (raw_len > OTA_COMPRESS_BLOCK_SIZE))
+            {
+                return ota_compress_fail(offset, "corrupt stored block");
+            }
+            memcpy(comp->out, &frame[pos], raw_len);
+        }
+        else
+        {
+            decoded = ota_lz4_decode(&frame[pos], comp_len, comp->out, OTA_COMPRESS_BLOCK_SIZE);
+            if ((decoded < 0) || ((uint32_t)decoded != raw_len))
+            {
+                return ota_compress_fail(offset, "corrupt block");
+            }
+        }
+        pos += comp_len;
+
+        if (raw_len > (comp->raw_size - raw_offset))
+        {
+            return ota_compress_fail(offset, "block beyond the end of the image");
+        }
+
+        if (CY_RSLT_SUCCESS != comp->write(comp->arg, raw_offset, comp->out, raw_len))
+        {
+            return ota_compress_fail(offset, "writing the image failed");
+        }
+        comp->raw_written += raw_len;
+    }
+
+    comp->stream_bytes += (uint32_t)len;
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: ota_compress_finish
+ *******************************************************************************
+ * Summary:
+ *  Checks that the whole image has been decoded.
+ *
+ * Parameters:
+ *  ota_compress_t *comp : Decoder state
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS on success, error code otherwise
+ *
+ *******************************************************************************/
+cy_rslt_t ota_compress_finish(ota_compress_t *comp)
+{
+    if ((comp->raw_size == 0) || (comp->raw_written != comp->raw_size))
+    {
+        return ota_compress_fail(comp->stream_bytes, "image is incomplete");
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: ota_lz4_decode
+ *******************************************************************************
+ * Summary:
+ *  Decodes one block in the LZ4 block format. Every length is checked against
+ *  both buffers, a corrupt block cannot read or write outside of them.
+ *
+ * Parameters:
+ *  const uint8_t *src : Compressed block
+ *  size_t src_len     : Size of the compressed block
+ *  uint8_t *dst       : Output buffer
+ *  size_t dst_len     : Size of the output buffer
+ *
+ * Return:
+ *  int32_t : Decoded size, -1 on error
+ *
+ *******************************************************************************/
+int32_t ota_lz4_decode(const uint8_t *src, size_t src_len, uint8_t *dst, size_t dst_len)
+{
+    const uint8_t *ip = src;
+    const uint8_t *const ip_end = src + src_len;
+    uint8_t *op = dst;
+    uint8_t *const op_end = dst + dst_len;
+    size_t length;
+    size_t match_offset;
+    uint8_t token;
+    uint8_t extra;
+
+    while (ip < ip_end)
+    {
+        token = *ip++;
+
+        /* Literals */
+        length = token >> 4;
+        if (length == 15u)
+        {
+            do
+            {
+                if (ip >= ip_end)
+                {
+                    return -1;
+                }
+                extra = *ip++;
+                length += extra;
+            } while (extra == 255u);
+        }
+        if ((length > (size_t)(ip_end - ip)) || (length > (size_t)(op_end - op)))
+        {
+            return -1;
+        }
+        memcpy(op, ip, length);
+        ip += length;
+        op += length;
+
+        /* The last sequence has no match */
+        if (ip == ip_end)
+        {
+            break;
+        }
+
+        /* Match */
+        if ((ip_end - ip) < 2)
+        {
+            return -1;
+        }
+        match_offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+        ip += 2;
+        if ((match_offset == 0) || (match_offset > (size_t)(op - dst)))
+        {
+            return -1;
+        }
+
+        length = token & 0x0Fu;
+        if (length == 15u)
+        {
+            do
+            {
+                if (ip >= ip_end)
+                {
+                    return -1;
+                }
+                extra = *ip++;
+                length += extra;
+            } while (extra == 255u);
+        }
+        length += OTA_LZ4_MIN_MATCH;
+        if (length > (size_t)(op_end - op))
+        {
+            return -1;
+        }
+
+        /* Byte by byte, the match may overlap the output */
+        while (length-- > 0)
+        {
+            *op = *(op - match_offset);
+            op++;
+        }
+    }
+
+    return (int32_t)(op - dst);
+}
+
+/*******************************************************************************
+ * Function Name: ota_compress_get_le32
+ *******************************************************************************
+ * Summary:
+ *  Reads an unaligned little endian 32-bit value.
+ *
+ *******************************************************************************/
+static uint32_t ota_compress_get_le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/*******************************************************************************
+ * Function Name: ota_compress_get_le16
+ *******************************************************************************
+ * Summary:
+ *  Reads an unaligned little endian 16-bit value.
+ *
+ *******************************************************************************/
+static uint16_t ota_compress_get_le16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+/*******************************************************************************
+ * Function Name: ota_compress_fail
+ *******************************************************************************
+ * Summary:
+ *  Prints the reason the stream was rejected.
+ *
+ *******************************************************************************/
+static cy_rslt_t ota_compress_fail(uint32_t offset, const char *reason)
+{
+    printf("\n Compressed update failed at stream offset %lu: %s.\n", (unsigned long)offset, reason);
+    return CY_RSLT_TYPE_ERROR;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,122 @@
+/******************************************************************************
+* File Name: ota_compress.h
+*
+* Description: This file contains the format and the decoder of compressed OTA
+* images.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef SOURCE_OTA_COMPRESS_H_
+#define SOURCE_OTA_COMPRESS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "cy_result.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/*
+ * Stream format, all values little endian:
+ *
+ *  The stream is cut into frames of frame_size bytes, the size of the OTA
+ *  chunks, and every frame holds whole blocks only. A frame can therefore be
+ *  decoded on its own, in any order, once the header is known.
+ *
+ *  Header (OTA_COMPRESS_HEADER_SIZE bytes, start of the first frame)
+ *      char     magic[8]       "OTACOMPR"
+ *      uint16_t version        OTA_COMPRESS_VERSION
+ *      uint16_t frame_size     Size of a frame
+ *      uint32_t raw_size       Size of the image
+ *
+ *  Blocks, until the end of the frame or a block with comp_len 0
+ *      uint32_t raw_offset     Offset of the block in the image
+ *      uint16_t comp_len       Size of the block data
+ *      uint16_t raw_len        Size of the decoded block. OTA_COMPRESS_STORED
+ *                              is set if the data is not compressed.
+ *      uint8_t  data[comp_len] LZ4 block format
+ */
+#define OTA_COMPRESS_MAGIC                  "OTACOMPR"
+#define OTA_COMPRESS_MAGIC_LEN              (8u)
+#define OTA_COMPRESS_VERSION                (1u)
+#define OTA_COMPRESS_HEADER_SIZE            (16u)
+#define OTA_COMPRESS_BLOCK_HEADER_SIZE      (8u)
+#define OTA_COMPRESS_STORED                 (0x8000u)
+
+/* Largest decoded block, and so the only buffer the decoder needs */
+#ifndef OTA_COMPRESS_BLOCK_SIZE
+#define OTA_COMPRESS_BLOCK_SIZE             (4096u)
+#endif
+
+/*******************************************************************************
+* Data Structures
+********************************************************************************/
+/* Writes len bytes of the image at offset */
+typedef cy_rslt_t (*ota_compress_write_t)(void *arg, uint32_t offset, const void *data, size_t len);
+
+/* Decoder state, see ota_compress.c */
+typedef struct
+{
+    ota_compress_write_t        write;
+    void                        *arg;
+
+    uint32_t                    frame_size;
+    uint32_t                    raw_size;
+    uint32_t                    raw_written;
+    uint32_t                    stream_bytes;
+    uint8_t                     out[OTA_COMPRESS_BLOCK_SIZE];
+} ota_compress_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* True if data starts with a compressed stream header */
+bool ota_compress_is_stream(const void *data, size_t len);
+
+void ota_compress_init(ota_compress_t *comp, ota_compress_write_t write, void *arg);
+
+/* Decodes the frame at offset of the stream. The first frame must be decoded
+ * first, the others in any order. */
+cy_rslt_t ota_compress_frame(ota_compress_t *comp, uint32_t offset, const void *data, size_t len);
+
+/* Checks that every byte of the image has been written */
+cy_rslt_t ota_compress_finish(ota_compress_t *comp);
+
+/* Decodes an LZ4 block. Returns the decoded size, or -1 if the block is
+ * corrupt or does not fit dst. */
+int32_t ota_lz4_decode(const uint8_t *src, size_t src_len, uint8_t *dst, size_t dst_len);
+
+#endif /* SOURCE_OTA_COMPRESS_H_ */
@@ -0,0 +1,422 @@
+/******************************************************************************
+* File Name: ota_delta.c
+*
+* Description: This file contains the streaming decoder for delta OTA images.
+* It rebuilds the new image from the current one and a patch that arrives in
+* chunks, without holding either image in RAM. It has no RTOS or HAL
+* dependencies, so it can also be built on a host.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include <stdio.h>
+#include <string.h>
+#include "ota_delta.h"
+#include "cy_ota_crc32.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Decoder states */
+#define OTA_DELTA_STATE_HEADER              (0u)
+#define OTA_DELTA_STATE_OP                  (1u)
+#define OTA_DELTA_STATE_PARAMS              (2u)
+#define OTA_DELTA_STATE_DATA                (3u)
+#define OTA_DELTA_STATE_DONE                (4u)
+#define OTA_DELTA_STATE_ERROR               (5u)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static uint32_t ota_delta_get_le32(const uint8_t *p);
+static cy_rslt_t ota_delta_fail(ota_delta_t *delta, const char *reason);
+static cy_rslt_t ota_delta_flush(ota_delta_t *delta);
+static cy_rslt_t ota_delta_check_source(ota_delta_t *delta);
+static cy_rslt_t ota_delta_parse_header(ota_delta_t *delta);
+static cy_rslt_t ota_delta_copy(ota_delta_t *delta, uint32_t src_offset, uint32_t len);
+
+/*******************************************************************************
+ * Function Name: ota_delta_is_patch
+ *******************************************************************************
+ * Summary:
+ *  Checks for the patch magic at the start of an image.
+ *
+ * Parameters:
+ *  const void *data : First bytes of the image
+ *  size_t len       : Number of bytes available
+ *
+ * Return:
+ *  bool : true if data is the start of a patch
+ *
+ *******************************************************************************/
+bool ota_delta_is_patch(const void *data, size_t len)
+{
+    return (data != NULL) && (len >= OTA_DELTA_MAGIC_LEN) &&
+           (memcmp(data, OTA_DELTA_MAGIC, OTA_DELTA_MAGIC_LEN) == 0);
+}
+
+/*******************************************************************************
+ * Function Name: ota_delta_init
+ *******************************************************************************
+ * Summary:
+ *  Prepares the decoder for a new patch.
+ *
+ * Parameters:
+ *  ota_delta_t *delta      : Decoder state
+ *  ota_delta_read_t read   : Reads the source image
+ *  ota_delta_write_t write : Writes the new image
+ *  void *arg               : Passed to read and write
+ *
+ *******************************************************************************/
+void ota_delta_init(ota_delta_t *delta, ota_delta_read_t read, ota_delta_write_t write, void *arg)
+{
+    memset(delta, 0, offsetof(ota_delta_t, out));
+    delta->read = read;
+    delta->write = write;
+    delta->arg = arg;
+    delta->state = OTA_DELTA_STATE_HEADER;
+    delta->crc = CY_OTA_CRC32_INIT;
+}
+
+/*******************************************************************************
+ * Function Name: ota_delta_feed
+ *******************************************************************************
+ * Summary:
+ *  Decodes the next part of the patch. Copy operations are executed as soon
+ *  as their parameters are complete, so they may span any number of calls.
+ *
+ * Parameters:
+ *  ota_delta_t *delta : Decoder state
+ *  const void *data   : Patch bytes
+ *  size_t len         : Number of patch bytes
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS on success, error code otherwise
+ *
+ *******************************************************************************/
+cy_rslt_t ota_delta_feed(ota_delta_t *delta, const void *data, size_t len)
+{
+    const uint8_t *src = (const uint8_t *)data;
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+    uint32_t n;
+    uint32_t need;
+
+    while ((len > 0) && (result == CY_RSLT_SUCCESS))
+    {
+        switch (delta->state)
+        {
+            case OTA_DELTA_STATE_HEADER:
+                n = (uint32_t)CY_OTA_DELTA_MIN(len, OTA_DELTA_HEADER_SIZE - delta->field_len);
+                memcpy(&delta->field[delta->field_len], src, n);
+                delta->field_len += n;
+                if (delta->field_len == OTA_DELTA_HEADER_SIZE)
+                {
+                    result = ota_delta_parse_header(delta);
+                }
+                break;
+
+            case OTA_DELTA_STATE_OP:
+                delta->op = *src;
+                n = 1;
+                if ((delta->op != OTA_DELTA_OP_COPY) && (delta->op != OTA_DELTA_OP_DATA))
+                {
+                    result = ota_delta_fail(delta, "unknown operation");
+                    break;
+                }
+                delta->field_len = 0;
+                delta->state = OTA_DELTA_STATE_PARAMS;
+                break;
+
+            case OTA_DELTA_STATE_PARAMS:
+                need = (delta->op == OTA_DELTA_OP_COPY) ? 8u : 4u;
+                n = (uint32_t)CY_OTA_DELTA_MIN(len, need - delta->field_len);
+                memcpy(&delta->field[delta->field_len], src, n);
+                delta->field_len += n;
+                if (delta->field_len < need)
+                {
+                    break;
+                }
+
+                if (delta->op == OTA_DELTA_OP_COPY)
+                {
+                    result = ota_delta_copy(delta, ota_delta_get_le32(&delta->field[0]),
+                                            ota_delta_get_le32(&delta->field[4]));
+                }
+                else
+                {
+                    delta->data_remaining = ota_delta_get_le32(&delta->field[0]);
+                    if (delta->data_remaining > (delta->header.target_size - delta->written - delta->out_len))
+                    {
+                        result = ota_delta_fail(delta, "data beyond the end of the image");
+                    }
+                    else
+                    {
+                        delta->state = OTA_DELTA_STATE_DATA;
+                    }
+                }
+                break;
+
+            case OTA_DELTA_STATE_DATA:
+                n = (uint32_t)CY_OTA_DELTA_MIN(len, delta->data_remaining);
+                n = CY_OTA_DELTA_MIN(n, OTA_DELTA_OUT_SIZE - delta->out_len);
+                memcpy(&delta->out[delta->out_len], src, n);
+                delta->out_len += n;
+                delta->data_remaining -= n;
+                if (delta->out_len == OTA_DELTA_OUT_SIZE)
+                {
+                    result = ota_delta_flush(delta);
+                }
+                if (delta->data_remaining == 0)
+                {
+                    delta->state = OTA_DELTA_STATE_OP;
+                }
+                break;
+
+            default:
+                n = 0;
+                result = ota_delta_fail(delta, "data after the end of the patch");
+                break;
+        }
+
+        src += n;
+        len -= n;
+        delta->patch_bytes += n;
+
+        /* The image is complete when the last operation has produced its last byte */
+        if ((result == CY_RSLT_SUCCESS) && (delta->state == OTA_DELTA_STATE_OP) &&
+            ((delta->written + delta->out_len) == delta->header.target_size))
+        {
+            result = ota_delta_flush(delta);
+            delta->state = OTA_DELTA_STATE_DONE;
+        }
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: ota_delta_finish
+ *******************************************************************************
+ * Summary:
+ *  Checks that the whole patch has been applied and the new image has the
+ *  expected CRC.
+ *
+ * Parameters:
+ *  ota_delta_t *delta : Decoder state
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS on success, error code otherwise
+ *
+ *******************************************************************************/
+cy_rslt_t ota_delta_finish(ota_delta_t *delta)
+{
+    if (delta->state != OTA_DELTA_STATE_DONE)
+    {
+        return ota_delta_fail(delta, "patch is incomplete");
+    }
+
+    if (delta->crc != delta->header.target_crc)
+    {
+        return ota_delta_fail(delta, "CRC of the new image does not match");
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: ota_delta_get_le32
+ *******************************************************************************
+ * Summary:
+ *  Reads an unaligned little endian 32-bit value.
+ *
+ *******************************************************************************/
+static uint32_t ota_delta_get_le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/*******************************************************************************
+ * Function Name: ota_delta_fail
+ *******************************************************************************
+ * Summary:
+ *  Prints the reason and stops the decoder. Every later call fails.
+ *
+ *******************************************************************************/
+static cy_rslt_t ota_delta_fail(ota_delta_t *delta, const char *reason)
+{
+    printf("\n Delta update failed at patch offset %lu: %s.\n", (unsigned long)delta->patch_bytes, reason);
+    delta->state = OTA_DELTA_STATE_ERROR;
+    return CY_RSLT_TYPE_ERROR;
+}
+
+/*******************************************************************************
+ * Function Name: ota_delta_flush
+ *******************************************************************************
+ * Summary:
+ *  Writes the output buffer to the new image.
+ *
+ *******************************************************************************/
+static cy_rslt_t ota_delta_flush(ota_delta_t *delta)
+{
+    cy_rslt_t result;
+    bool last;
+
+    if (delta->out_len == 0)
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    last = ((delta->written + delta->out_len) == delta->header.target_size);
+    delta->crc = cy_ota_crc32(delta->crc, delta->out, delta->out_len);
+
+    result = delta->write(delta->arg, delta->written, delta->out, delta->out_len, last);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        return ota_delta_fail(delta, "writing the new image failed");
+    }
+
+    delta->written += delta->out_len;
+    delta->out_len = 0;
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: ota_delta_check_source
+ *******************************************************************************
+ * Summary:
+ *  Makes sure the image the patch was created for is the one in the source.
+ *  Uses the output buffer, which is still empty at this point.
+ *
+ *******************************************************************************/
+static cy_rslt_t ota_delta_check_source(ota_delta_t *delta)
+{
+    uint32_t crc = CY_OTA_CRC32_INIT;
+    uint32_t offset = 0;
+    uint32_t n;
+
+    while (offset < delta->header.source_size)
+    {
+        n = CY_OTA_DELTA_MIN(delta->header.source_size - offset, OTA_DELTA_OUT_SIZE);
+        if (delta->read(delta->arg, offset, delta->out, n) != CY_RSLT_SUCCESS)
+        {
+            return ota_delta_fail(delta, "reading the current image failed");
+        }
+        crc = cy_ota_crc32(crc, delta->out, n);
+        offset += n;
+    }
+
+    if (crc != delta->header.source_crc)
+    {
+        return ota_delta_fail(delta, "patch was not created for the current image");
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: ota_delta_parse_header
+ *******************************************************************************
+ * Summary:
+ *  Validates the patch header and the source image.
+ *
+ *******************************************************************************/
+static cy_rslt_t ota_delta_parse_header(ota_delta_t *delta)
+{
+    const uint8_t *hdr = delta->field;
+
+    if (!ota_delta_is_patch(hdr, OTA_DELTA_HEADER_SIZE) ||
+        ((hdr[8] | (hdr[9] << 8)) != OTA_DELTA_VERSION) ||
+        ((hdr[10] | (hdr[11] << 8)) != OTA_DELTA_HEADER_SIZE))
+    {
+        return ota_delta_fail(delta, "unsupported patch header");
+    }
+
+    delta->header.source_size = ota_delta_get_le32(&hdr[12]);
+    delta->header.source_crc  = ota_delta_get_le32(&hdr[16]);
+    delta->header.target_size = ota_delta_get_le32(&hdr[20]);
+    delta->header.target_crc  = ota_delta_get_le32(&hdr[24]);
+
+    if (delta->header.target_size == 0)
+    {
+        return ota_delta_fail(delta, "empty image");
+    }
+
+    if (ota_delta_check_source(delta) != CY_RSLT_SUCCESS)
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    delta->state = OTA_DELTA_STATE_OP;
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: ota_delta_copy
+ *******************************************************************************
+ * Summary:
+ *  Copies len bytes of the source image at src_offset to the new image.
+ *
+ *******************************************************************************/
+static cy_rslt_t ota_delta_copy(ota_delta_t *delta, uint32_t src_offset, uint32_t len)
+{
+    uint32_t n;
+
+    if ((src_offset > delta->header.source_size) || (len > (delta->header.source_size - src_offset)) ||
+        (len > (delta->header.target_size - delta->written - delta->out_len)))
+    {
+        return ota_delta_fail(delta, "copy outside of the images");
+    }
+
+    while (len > 0)
+    {
+        n = CY_OTA_DELTA_MIN(len, OTA_DELTA_OUT_SIZE - delta->out_len);
+        if (delta->read(delta->arg, src_offset, &delta->out[delta->out_len], n) != CY_RSLT_SUCCESS)
+        {
+            return ota_delta_fail(delta, "reading the current image failed");
+        }
+        delta->out_len += n;
+        src_offset += n;
+        len -= n;
+
+        if ((delta->out_len == OTA_DELTA_OUT_SIZE) && (ota_delta_flush(delta) != CY_RSLT_SUCCESS))
+        {
+            return CY_RSLT_TYPE_ERROR;
+        }
+    }
+
+    delta->state = OTA_DELTA_STATE_OP;
+    return CY_RSLT_SUCCESS;
+}
+
+/* [] END OF FILE */
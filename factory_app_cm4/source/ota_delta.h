@@ -0,0 +1,137 @@
+/******************************************************************************
+* File Name: ota_delta.h
+*
+* Description: This file contains declaration of the streaming decoder for
+* delta OTA images created with scripts/delta_patch.py.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef SOURCE_OTA_DELTA_H_
+#define SOURCE_OTA_DELTA_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "cy_result.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/*
+ * Patch format, all values little endian:
+ *
+ *  Header (OTA_DELTA_HEADER_SIZE bytes)
+ *      char     magic[8]       "OTADELTA"
+ *      uint16_t version        OTA_DELTA_VERSION
+ *      uint16_t header_size    OTA_DELTA_HEADER_SIZE
+ *      uint32_t source_size    Bytes of the primary slot the patch applies to
+ *      uint32_t source_crc     CRC-32 of those bytes
+ *      uint32_t target_size    Size of the new image
+ *      uint32_t target_crc     CRC-32 of the new image
+ *      uint32_t reserved
+ *
+ *  Operations, until target_size bytes have been produced
+ *      OTA_DELTA_OP_COPY       uint32_t src_offset, uint32_t length
+ *      OTA_DELTA_OP_DATA       uint32_t length, <length> bytes
+ */
+#define OTA_DELTA_MAGIC                     "OTADELTA"
+#define OTA_DELTA_MAGIC_LEN                 (8u)
+#define OTA_DELTA_VERSION                   (1u)
+#define OTA_DELTA_HEADER_SIZE               (32u)
+
+#define OTA_DELTA_OP_COPY                   (1u)
+#define OTA_DELTA_OP_DATA                   (2u)
+
+/* Size of the output buffer. The new image is written in blocks of this size,
+ * source data is read in blocks of at most this size. */
+#ifndef OTA_DELTA_OUT_SIZE
+#define OTA_DELTA_OUT_SIZE                  (4096u)
+#endif
+
+#define CY_OTA_DELTA_MIN(a, b)              (((a) < (b)) ? (a) : (b))
+
+/*******************************************************************************
+* Data Structures
+********************************************************************************/
+/* Reads len bytes of the source image at offset */
+typedef cy_rslt_t (*ota_delta_read_t)(void *arg, uint32_t offset, void *data, size_t len);
+
+/* Writes len bytes of the new image at offset. last is set for the final block. */
+typedef cy_rslt_t (*ota_delta_write_t)(void *arg, uint32_t offset, const void *data, size_t len, bool last);
+
+typedef struct
+{
+    uint32_t                    source_size;
+    uint32_t                    source_crc;
+    uint32_t                    target_size;
+    uint32_t                    target_crc;
+} ota_delta_header_t;
+
+/* Decoder state, see ota_delta.c */
+typedef struct
+{
+    ota_delta_read_t            read;
+    ota_delta_write_t           write;
+    void                        *arg;
+
+    ota_delta_header_t          header;
+    uint32_t                    state;
+    uint8_t                     field[OTA_DELTA_HEADER_SIZE];
+    uint32_t                    field_len;
+    uint8_t                     op;
+    uint32_t                    data_remaining;
+
+    uint32_t                    patch_bytes;
+    uint32_t                    written;
+    uint32_t                    crc;
+    uint32_t                    out_len;
+    uint8_t                     out[OTA_DELTA_OUT_SIZE];
+} ota_delta_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* True if data starts with a patch header */
+bool ota_delta_is_patch(const void *data, size_t len);
+
+void ota_delta_init(ota_delta_t *delta, ota_delta_read_t read, ota_delta_write_t write, void *arg);
+
+/* Feeds the next len bytes of the patch. Patch bytes must be fed in order. */
+cy_rslt_t ota_delta_feed(ota_delta_t *delta, const void *data, size_t len);
+
+/* Checks that the new image is complete and matches its CRC */
+cy_rslt_t ota_delta_finish(ota_delta_t *delta);
+
+#endif /* SOURCE_OTA_DELTA_H_ */
@@ -0,0 +1,454 @@
+/******************************************************************************
+* File Name: ota_manifest.c
+*
+* Description: This file contains the checks of the signed Merkle
+* manifest of OTA images. The manifest is verified once all of it has arrived,
+* after that every block of the image is checked against its hash as it arrives.
+* It has no RTOS or HAL dependencies.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include <stdio.h>
+#include <string.h>
+#include "ota_manifest.h"
+#include "ota_sign_key.h"
+#include "mbedtls/sha256.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Domain separation of leaves and nodes of the tree */
+#define OTA_MANIFEST_LEAF_PREFIX            (0x00u)
+#define OTA_MANIFEST_NODE_PREFIX            (0x01u)
+
+/* Piece size when checking a stored block */
+#define OTA_MANIFEST_READ_SIZE              (256u)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static uint32_t ota_manifest_get_le32(const uint8_t *p);
+static uint16_t ota_manifest_get_le16(const uint8_t *p);
+static cy_rslt_t ota_manifest_parse_header(ota_manifest_t *manifest, const uint8_t *p);
+static cy_rslt_t ota_manifest_verify(ota_manifest_t *manifest);
+static int ota_manifest_hash_node(const uint8_t *left, const uint8_t *right, uint8_t *out);
+
+/*******************************************************************************
+ * Function Name: ota_manifest_is_manifest
+ *******************************************************************************
+ * Summary:
+ *  Checks for the manifest magic at the start of a download.
+ *
+ * Parameters:
+ *  const void *data : First bytes of the download
+ *  size_t len       : Number of bytes available
+ *
+ * Return:
+ *  bool : true if data is the start of a manifest
+ *
+ *******************************************************************************/
+bool ota_manifest_is_manifest(const void *data, size_t len)
+{
+    return (len >= OTA_MANIFEST_HEADER_SIZE) &&
+           (memcmp(data, OTA_MANIFEST_MAGIC, OTA_MANIFEST_MAGIC_LEN) == 0);
+}
+
+/*******************************************************************************
+ * Function Name: ota_manifest_init
+ *******************************************************************************
+ * Summary:
+ *  Prepares the state for a new manifest.
+ *
+ * Parameters:
+ *  ota_manifest_t *manifest : Manifest state
+ *
+ *******************************************************************************/
+void ota_manifest_init(ota_manifest_t *manifest)
+{
+    memset(&manifest->header, 0, sizeof(manifest->header));
+    manifest->header_valid = false;
+    manifest->verified = false;
+    cy_ota_range_init(&manifest->received, manifest->received_bits, OTA_MANIFEST_MAX_CHUNKS);
+}
+
+/*******************************************************************************
+ * Function Name: ota_manifest_feed
+ *******************************************************************************
+ * Summary:
+ *  Stores a chunk of the manifest. The first chunk carries the header, which
+ *  gives the size of the manifest. When the last missing chunk arrives, the
+ *  manifest is verified.
+ *
+ * Parameters:
+ *  ota_manifest_t *manifest : Manifest state
+ *  uint32_t offset          : Offset of the chunk in the download
+ *  const void *data         : Chunk data
+ *  size_t len               : Length of data
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS on success, error code if the manifest is
+ *              invalid
+ *
+ *******************************************************************************/
+cy_rslt_t ota_manifest_feed(ota_manifest_t *manifest, uint32_t offset, const void *data, size_t len)
+{
+    uint32_t manifest_size;
+    uint32_t n;
+
+    if (!manifest->header_valid)
+    {
+        if ((offset != 0) || !ota_manifest_is_manifest(data, len) ||
+            (CY_RSLT_SUCCESS != ota_manifest_parse_header(manifest, data)))
+        {
+            printf("\n Manifest: invalid header.\n");
+            return CY_RSLT_TYPE_ERROR;
+        }
+    }
+
+    if (manifest->verified || (offset >= manifest->header.data_offset))
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    /* Keep the part holding the manifest, the rest is padding */
+    manifest_size = OTA_MANIFEST_HEADER_SIZE + OTA_MANIFEST_SIG_SIZE +
+                    (manifest->header.block_count * OTA_MANIFEST_HASH_SIZE);
+    if (offset < manifest_size)
+    {
+        n = CY_OTA_MANIFEST_MIN((uint32_t)len, manifest_size - offset);
+        memcpy(&manifest->buf[offset], data, n);
+    }
+
+    (void)cy_ota_range_add(&manifest->received, offset, (uint32_t)len);
+    if (!cy_ota_range_complete(&manifest->received))
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    return ota_manifest_verify(manifest);
+}
+
+/*******************************************************************************
+ * Function Name: ota_manifest_verified
+ *******************************************************************************
+ * Summary:
+ *  Returns whether the manifest is complete and authentic.
+ *
+ *******************************************************************************/
+bool ota_manifest_verified(const ota_manifest_t *manifest)
+{
+    return manifest->verified;
+}
+
+/*******************************************************************************
+ * Function Name: ota_manifest_check_block
+ *******************************************************************************
+ * Summary:
+ *  Checks a block of the image against its hash in the verified manifest.
+ *
+ * Parameters:
+ *  const ota_manifest_t *manifest : Verified manifest
+ *  uint32_t index                 : Block number
+ *  const void *data               : Block data
+ *  size_t len                     : Length of the block
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS if the block matches, error code otherwise
+ *
+ *******************************************************************************/
+cy_rslt_t ota_manifest_check_block(const ota_manifest_t *manifest, uint32_t index, const void *data, size_t len)
+{
+    mbedtls_sha256_context sha;
+    uint8_t prefix = OTA_MANIFEST_LEAF_PREFIX;
+    uint8_t hash[OTA_MANIFEST_HASH_SIZE];
+    uint32_t expected_len;
+    int ret;
+
+    if (!manifest->verified || (index >= manifest->header.block_count))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    expected_len = CY_OTA_MANIFEST_MIN(manifest->header.block_size,
+                                    manifest->header.image_size - (index * manifest->header.block_size));
+    if (len != expected_len)
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    mbedtls_sha256_init(&sha);
+    ret = mbedtls_sha256_starts(&sha, 0);
+    ret = (ret != 0) ? ret : mbedtls_sha256_update(&sha, &prefix, 1);
+    ret = (ret != 0) ? ret : mbedtls_sha256_update(&sha, data, len);
+    ret = (ret != 0) ? ret : mbedtls_sha256_finish(&sha, hash);
+    mbedtls_sha256_free(&sha);
+
+    if ((ret != 0) ||
+        (memcmp(hash, &manifest->buf[OTA_MANIFEST_HEADER_SIZE + OTA_MANIFEST_SIG_SIZE +
+                                     (index * OTA_MANIFEST_HASH_SIZE)], OTA_MANIFEST_HASH_SIZE) != 0))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: ota_manifest_check_stored
+ *******************************************************************************
+ * Summary:
+ *  Checks a block that was stored before the manifest was complete. The block
+ *  is read and hashed in OTA_MANIFEST_READ_SIZE pieces.
+ *
+ * Parameters:
+ *  const ota_manifest_t *manifest : Verified manifest
+ *  uint32_t index                 : Block number
+ *  ota_manifest_read_t read       : Reads the stored image
+ *  void *arg                      : Argument of read
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS if the block matches, error code otherwise
+ *
+ *******************************************************************************/
+cy_rslt_t ota_manifest_check_stored(const ota_manifest_t *manifest, uint32_t index,
+                                    ota_manifest_read_t read, void *arg)
+{
+    mbedtls_sha256_context sha;
+    uint8_t piece[OTA_MANIFEST_READ_SIZE];
+    uint8_t hash[OTA_MANIFEST_HASH_SIZE];
+    uint32_t offset;
+    uint32_t end;
+    uint32_t n;
+    int ret;
+
+    if (!manifest->verified || (index >= manifest->header.block_count))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    offset = index * manifest->header.block_size;
+    end = offset + CY_OTA_MANIFEST_MIN(manifest->header.block_size, manifest->header.image_size - offset);
+
+    piece[0] = OTA_MANIFEST_LEAF_PREFIX;
+    mbedtls_sha256_init(&sha);
+    ret = mbedtls_sha256_starts(&sha, 0);
+    ret = (ret != 0) ? ret : mbedtls_sha256_update(&sha, piece, 1);
+    while ((ret == 0) && (offset < end))
+    {
+        n = CY_OTA_MANIFEST_MIN(sizeof(piece), end - offset);
+        if (CY_RSLT_SUCCESS != read(arg, offset, piece, n))
+        {
+            ret = -1;
+            break;
+        }
+        ret = mbedtls_sha256_update(&sha, piece, n);
+        offset += n;
+    }
+    ret = (ret != 0) ? ret : mbedtls_sha256_finish(&sha, hash);
+    mbedtls_sha256_free(&sha);
+
+    if ((ret != 0) ||
+        (memcmp(hash, &manifest->buf[OTA_MANIFEST_HEADER_SIZE + OTA_MANIFEST_SIG_SIZE +
+                                     (index * OTA_MANIFEST_HASH_SIZE)], OTA_MANIFEST_HASH_SIZE) != 0))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: ota_manifest_parse_header
+ *******************************************************************************
+ * Summary:
+ *  Reads and checks the header. The signature is checked later, with the
+ *  rest of the manifest.
+ *
+ *******************************************************************************/
+static cy_rslt_t ota_manifest_parse_header(ota_manifest_t *manifest, const uint8_t *p)
+{
+    ota_manifest_header_t *hdr = &manifest->header;
+    uint32_t manifest_size;
+
+    if ((ota_manifest_get_le16(&p[8]) != OTA_MANIFEST_VERSION) ||
+        (ota_manifest_get_le16(&p[10]) != OTA_MANIFEST_HEADER_SIZE))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    hdr->block_size = ota_manifest_get_le32(&p[12]);
+    hdr->image_size = ota_manifest_get_le32(&p[16]);
+    hdr->block_count = ota_manifest_get_le32(&p[20]);
+    hdr->data_offset = ota_manifest_get_le32(&p[24]);
+    hdr->sig_len = ota_manifest_get_le16(&p[28]);
+    memcpy(hdr->root, &p[32], OTA_MANIFEST_HASH_SIZE);
+
+    /* Power of two block size, one hash per block, image right after the
+     * manifest at a block boundary */
+    if ((hdr->block_size < OTA_MANIFEST_MIN_BLOCK_SIZE) || ((hdr->block_size & (hdr->block_size - 1u)) != 0) ||
+        (hdr->image_size == 0) || (hdr->block_count > OTA_MANIFEST_MAX_BLOCKS) ||
+        (hdr->block_count != ((hdr->image_size + hdr->block_size - 1u) / hdr->block_size)) ||
+        (hdr->sig_len == 0) || (hdr->sig_len > OTA_MANIFEST_SIG_SIZE))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    manifest_size = OTA_MANIFEST_HEADER_SIZE + OTA_MANIFEST_SIG_SIZE + (hdr->block_count * OTA_MANIFEST_HASH_SIZE);
+    if (hdr->data_offset != (((manifest_size + hdr->block_size - 1u) / hdr->block_size) * hdr->block_size))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    if (!cy_ota_range_reset(&manifest->received, hdr->block_size, hdr->data_offset))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    manifest->header_valid = true;
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: ota_manifest_verify
+ *******************************************************************************
+ * Summary:
+ *  Computes the Merkle root of the block hashes and compares it with the
+ *  root in the header, then checks the signature of the header. The subtrees
+ *  not yet paired are kept on a stack, one per set bit of the number of
+ *  blocks processed, and joined from the right at the end.
+ *
+ *******************************************************************************/
+static cy_rslt_t ota_manifest_verify(ota_manifest_t *manifest)
+{
+    const uint8_t *leaves = &manifest->buf[OTA_MANIFEST_HEADER_SIZE + OTA_MANIFEST_SIG_SIZE];
+    uint8_t digest[OTA_MANIFEST_HASH_SIZE];
+    uint32_t depth = 0;
+    uint32_t count;
+    uint32_t i;
+
+    for (i = 0; i < manifest->header.block_count; i++)
+    {
+        memcpy(manifest->stack[depth], &leaves[i * OTA_MANIFEST_HASH_SIZE], OTA_MANIFEST_HASH_SIZE);
+        depth++;
+
+        /* Join complete subtrees of equal size */
+        for (count = i + 1u; (count % 2u) == 0; count /= 2u)
+        {
+            if (0 != ota_manifest_hash_node(manifest->stack[depth - 2u], manifest->stack[depth - 1u],
+                                            manifest->stack[depth - 2u]))
+            {
+                return CY_RSLT_TYPE_ERROR;
+            }
+            depth--;
+        }
+    }
+
+    while (depth > 1u)
+    {
+        if (0 != ota_manifest_hash_node(manifest->stack[depth - 2u], manifest->stack[depth - 1u],
+                                        manifest->stack[depth - 2u]))
+        {
+            return CY_RSLT_TYPE_ERROR;
+        }
+        depth--;
+    }
+
+    if ((depth != 1u) || (memcmp(manifest->stack[0], manifest->header.root, OTA_MANIFEST_HASH_SIZE) != 0))
+    {
+        printf("\n Manifest: block hashes do not match the root.\n");
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    if ((0 != mbedtls_sha256(manifest->buf, OTA_MANIFEST_HEADER_SIZE, digest, 0)) ||
+        (CY_RSLT_SUCCESS != ota_sign_key_verify(digest, &manifest->buf[OTA_MANIFEST_HEADER_SIZE],
+                                                manifest->header.sig_len)))
+    {
+        printf("\n Manifest: invalid signature.\n");
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    manifest->verified = true;
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: ota_manifest_hash_node
+ *******************************************************************************
+ * Summary:
+ *  Computes an inner node of the tree. out may be the same as left.
+ *
+ *******************************************************************************/
+static int ota_manifest_hash_node(const uint8_t *left, const uint8_t *right, uint8_t *out)
+{
+    mbedtls_sha256_context sha;
+    uint8_t prefix = OTA_MANIFEST_NODE_PREFIX;
+    int ret;
+
+    mbedtls_sha256_init(&sha);
+    ret = mbedtls_sha256_starts(&sha, 0);
+    ret = (ret != 0) ? ret : mbedtls_sha256_update(&sha, &prefix, 1);
+    ret = (ret != 0) ? ret : mbedtls_sha256_update(&sha, left, OTA_MANIFEST_HASH_SIZE);
+    ret = (ret != 0) ? ret : mbedtls_sha256_update(&sha, right, OTA_MANIFEST_HASH_SIZE);
+    ret = (ret != 0) ? ret : mbedtls_sha256_finish(&sha, out);
+    mbedtls_sha256_free(&sha);
+
+    return ret;
+}
+
+/*******************************************************************************
+ * Function Name: ota_manifest_get_le32
+ *******************************************************************************
+ * Summary:
+ *  Reads a little endian 32-bit value.
+ *
+ *******************************************************************************/
+static uint32_t ota_manifest_get_le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/*******************************************************************************
+ * Function Name: ota_manifest_get_le16
+ *******************************************************************************
+ * Summary:
+ *  Reads a little endian 16-bit value.
+ *
+ *******************************************************************************/
+static uint16_t ota_manifest_get_le16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+/* [] END OF FILE */
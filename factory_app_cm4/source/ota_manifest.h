@@ -0,0 +1,160 @@
+/******************************************************************************
+* File Name: ota_manifest.h
+*
+* Description: This file contains the format and the declarations of the
+* signed Merkle manifest of OTA images.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef SOURCE_OTA_MANIFEST_H_
+#define SOURCE_OTA_MANIFEST_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "cy_result.h"
+#include "cy_ota_range.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/*
+ * Manifest format, all values little endian. The manifest is sent in front of
+ * the image, the image starts at data_offset of the download.
+ *
+ *  Header (OTA_MANIFEST_HEADER_SIZE bytes)
+ *      char     magic[8]       "OTAMANIF"
+ *      uint16_t version        OTA_MANIFEST_VERSION
+ *      uint16_t header_size    OTA_MANIFEST_HEADER_SIZE
+ *      uint32_t block_size     Size of a hashed block, the chunk size
+ *      uint32_t image_size     Size of the MCUboot image
+ *      uint32_t block_count    Number of blocks of the image
+ *      uint32_t data_offset    Manifest size rounded up to block_size
+ *      uint16_t sig_len        Length of the signature
+ *      uint16_t reserved
+ *      uint8_t  root[32]       Merkle root of the block hashes
+ *
+ *  Signature (OTA_MANIFEST_SIG_SIZE bytes)
+ *      ECDSA P-256 signature in ASN.1 DER format of the SHA-256 of the
+ *      header, with the image signing key, padded with zeros
+ *
+ *  Block hashes (block_count * OTA_MANIFEST_HASH_SIZE bytes)
+ *      SHA-256 of 0x00 followed by the block
+ *
+ * The root is computed as in RFC 6962: a node is the SHA-256 of 0x01 followed
+ * by its two children, the tree is split at the largest power of two below
+ * the number of blocks.
+ */
+#define OTA_MANIFEST_MAGIC                  "OTAMANIF"
+#define OTA_MANIFEST_MAGIC_LEN              (8u)
+#define OTA_MANIFEST_VERSION                (1u)
+#define OTA_MANIFEST_HEADER_SIZE            (64u)
+#define OTA_MANIFEST_SIG_SIZE               (72u)
+#define OTA_MANIFEST_HASH_SIZE              (32u)
+
+/* Smallest supported block size */
+#define OTA_MANIFEST_MIN_BLOCK_SIZE         (512u)
+
+/* Largest image, in blocks. The block hashes are kept in RAM. */
+#ifndef OTA_MANIFEST_MAX_BLOCKS
+#define OTA_MANIFEST_MAX_BLOCKS             (512u)
+#endif
+
+/* Levels of the Merkle tree of OTA_MANIFEST_MAX_BLOCKS blocks, plus one */
+#define OTA_MANIFEST_TREE_DEPTH             (16u)
+
+#define OTA_MANIFEST_BUF_SIZE               (OTA_MANIFEST_HEADER_SIZE + OTA_MANIFEST_SIG_SIZE + \
+                                             (OTA_MANIFEST_MAX_BLOCKS * OTA_MANIFEST_HASH_SIZE))
+#define OTA_MANIFEST_MAX_CHUNKS             ((OTA_MANIFEST_BUF_SIZE / OTA_MANIFEST_MIN_BLOCK_SIZE) + 1u)
+
+#define CY_OTA_MANIFEST_MIN(a, b)           (((a) < (b)) ? (a) : (b))
+
+/*******************************************************************************
+* Data Structures
+********************************************************************************/
+/* Reads len bytes of the stored image at offset */
+typedef cy_rslt_t (*ota_manifest_read_t)(void *arg, uint32_t offset, void *data, size_t len);
+
+typedef struct
+{
+    uint32_t                    block_size;
+    uint32_t                    image_size;
+    uint32_t                    block_count;
+    uint32_t                    data_offset;
+    uint16_t                    sig_len;
+    uint8_t                     root[OTA_MANIFEST_HASH_SIZE];
+} ota_manifest_header_t;
+
+/* Manifest state, see ota_manifest.c */
+typedef struct
+{
+    ota_manifest_header_t       header;
+    bool                        header_valid;
+    bool                        verified;
+
+    /* Manifest chunks received, in units of block_size */
+    cy_ota_range_t              received;
+    uint32_t                    received_bits[CY_OTA_RANGE_WORDS(OTA_MANIFEST_MAX_CHUNKS)];
+
+    /* Pending subtrees while the root is computed */
+    uint8_t                     stack[OTA_MANIFEST_TREE_DEPTH][OTA_MANIFEST_HASH_SIZE];
+
+    uint8_t                     buf[OTA_MANIFEST_BUF_SIZE];
+} ota_manifest_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* True if data starts with a manifest header */
+bool ota_manifest_is_manifest(const void *data, size_t len);
+
+void ota_manifest_init(ota_manifest_t *manifest);
+
+/* Feeds a chunk of the manifest at its offset in the download. The chunk at
+ * offset 0 must come first, the others may arrive in any order. Once all are
+ * in, the root and the signature are checked. */
+cy_rslt_t ota_manifest_feed(ota_manifest_t *manifest, uint32_t offset, const void *data, size_t len);
+
+/* True once the manifest is complete and its signature is valid */
+bool ota_manifest_verified(const ota_manifest_t *manifest);
+
+/* Checks a block of the image against its hash */
+cy_rslt_t ota_manifest_check_block(const ota_manifest_t *manifest, uint32_t index, const void *data, size_t len);
+
+/* Checks a block that is already stored, reading it in small pieces */
+cy_rslt_t ota_manifest_check_stored(const ota_manifest_t *manifest, uint32_t index,
+                                    ota_manifest_read_t read, void *arg);
+
+#endif /* SOURCE_OTA_MANIFEST_H_ */
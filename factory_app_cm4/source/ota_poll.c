@@ -0,0 +1,416 @@
+/******************************************************************************
+* File Name: ota_poll.c
+*
+* Description: This file contains the OTA poll scheduler. Instead of the fixed check
+* timers of the OTA agent, every device checks at its own phase within
+* OTA_POLL_SPREAD_S, derived from its client ID and silicon ID, backs off
+* exponentially after failures and honours a "RetryAfter" hint of the job
+* document, so a fleet that powers up together does not poll in lockstep.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "cyhal.h"
+#include "cybsp.h"
+#include "cy_retarget_io.h"
+#include "ota_poll.h"
+#include "backoff.h"
+#include "json_field.h"
+#include "app_log.h"
+/* FreeRTOS */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define OTA_POLL_TASK_STACK_SIZE            (configMINIMAL_STACK_SIZE * 4)
+#define OTA_POLL_TASK_PRIORITY              (tskIDLE_PRIORITY + 1)
+
+/* Long enough for any delay, unlike pdMS_TO_TICKS() */
+#define OTA_POLL_MS_TO_TICKS(ms)            ((TickType_t)((ms) / portTICK_PERIOD_MS))
+#define OTA_POLL_TICKS_TO_MS(t)             ((uint32_t)((t) * portTICK_PERIOD_MS))
+
+/* A check the agent has not ended by then is started again */
+#define OTA_POLL_CHECK_TIMEOUT_MS           (OTA_POLL_BACKOFF_MAX_S * 1000u)
+
+/*******************************************************************************
+* Data Structures
+********************************************************************************/
+typedef enum
+{
+    OTA_POLL_OUTCOME_NONE,
+    OTA_POLL_OUTCOME_UPDATE,
+    OTA_POLL_OUTCOME_NO_UPDATE,
+    OTA_POLL_OUTCOME_FAILED
+} ota_poll_outcome_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void ota_poll_task(void *args);
+static uint32_t ota_poll_slot_delay_ms(void);
+static uint32_t ota_poll_next_ms(void);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Scheduler task control block and stack */
+static TaskHandle_t poll_task_handle;
+static StaticTask_t poll_task_tcb;
+static StackType_t poll_task_stack[OTA_POLL_TASK_STACK_SIZE];
+
+static cy_ota_context_ptr poll_context;
+static TickType_t poll_start;
+
+/* Outcome of the running check, set from the OTA callback */
+static ota_poll_outcome_t poll_outcome;
+static uint32_t poll_retry_after_s;
+
+/* Counters, only changed in critical sections */
+static ota_poll_stats_t poll_stats;
+
+/*******************************************************************************
+ * Function Name: ota_poll_init
+ *******************************************************************************
+ * Summary:
+ *  Derives the phase of this device from a FNV-1a hash of the MQTT client ID
+ *  and the silicon unique ID. The client ID is the same on every device of
+ *  this example, the silicon ID makes the phase unique. The hash also seeds
+ *  the backoff jitter while the crypto block is still idle.
+ *
+ * Parameters:
+ *  const char *client_id : MQTT client ID of the OTA agent
+ *
+ *******************************************************************************/
+void ota_poll_init(const char *client_id)
+{
+    uint32_t hash = 2166136261u;
+    uint64_t unique_id = Cy_SysLib_GetUniqueId();
+    uint32_t i;
+
+    while ((client_id != NULL) && (*client_id != '\0'))
+    {
+        hash = (hash ^ (uint8_t)*client_id++) * 16777619u;
+    }
+    for (i = 0; i < sizeof(unique_id); i++)
+    {
+        hash = (hash ^ (uint8_t)(unique_id >> (8u * i))) * 16777619u;
+    }
+
+    poll_stats.phase_ms = hash % (OTA_POLL_SPREAD_S * 1000u);
+    backoff_seed(hash);
+}
+
+/*******************************************************************************
+ * Function Name: ota_poll_start
+ *******************************************************************************
+ * Summary:
+ *  Creates the scheduler task. The first check is due OTA_POLL_INITIAL_S
+ *  plus the phase of this device from now.
+ *
+ * Parameters:
+ *  cy_ota_context_ptr ota_context : Context of the running OTA agent
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS on success, error code otherwise
+ *
+ *******************************************************************************/
+cy_rslt_t ota_poll_start(cy_ota_context_ptr ota_context)
+{
+    poll_context = ota_context;
+    poll_start = xTaskGetTickCount();
+
+    APP_LOG_INFO("OTA poll: first check in %lu ms, then every %lu s\n",
+            (unsigned long)ota_poll_slot_delay_ms(), (unsigned long)OTA_POLL_INTERVAL_S);
+
+    poll_task_handle = xTaskCreateStatic(ota_poll_task, "OTA Poll", OTA_POLL_TASK_STACK_SIZE, NULL,
+                                         OTA_POLL_TASK_PRIORITY, poll_task_stack, &poll_task_tcb);
+    if (poll_task_handle == NULL)
+    {
+        printf("\n Creating the OTA poll task failed.\n");
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: ota_poll_task
+ *******************************************************************************
+ * Summary:
+ *  Starts a check when it is due and waits for the agent to report the end of
+ *  it, then schedules the next one from its outcome.
+ *
+ * Parameters:
+ *  void *args : Task parameter defined during task creation (unused)
+ *
+ *******************************************************************************/
+static void ota_poll_task(void *args)
+{
+    TickType_t deadline;
+    TickType_t wait;
+    bool checking = false;
+    cy_rslt_t result;
+
+    (void)args;
+
+    deadline = poll_start + OTA_POLL_MS_TO_TICKS(ota_poll_slot_delay_ms());
+
+    while (true)
+    {
+        wait = deadline - xTaskGetTickCount();
+        if ((int32_t)wait < 0)
+        {
+            wait = 0;
+        }
+
+        if (0u != ulTaskNotifyTake(pdTRUE, wait))
+        {
+            /* The agent waits again. Only the end of a check moves the
+             * deadline, not the start of the agent. */
+            if (checking)
+            {
+                checking = false;
+                deadline = xTaskGetTickCount() + OTA_POLL_MS_TO_TICKS(ota_poll_next_ms());
+            }
+            continue;
+        }
+
+        taskENTER_CRITICAL();
+        poll_outcome = OTA_POLL_OUTCOME_NONE;
+        poll_retry_after_s = 0;
+        taskEXIT_CRITICAL();
+
+        /* Fails while the agent is busy, e.g. with a long download; its end is
+         * still reported and treated like the end of this check */
+        result = cy_ota_get_update_now(poll_context);
+        if (CY_RSLT_SUCCESS == result)
+        {
+            taskENTER_CRITICAL();
+            poll_stats.checks++;
+            taskEXIT_CRITICAL();
+        }
+        checking = true;
+        deadline = xTaskGetTickCount() + OTA_POLL_MS_TO_TICKS(OTA_POLL_CHECK_TIMEOUT_MS);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: ota_poll_slot_delay_ms
+ *******************************************************************************
+ * Summary:
+ *  Returns the time to the next check slot of this device. Slots are
+ *  OTA_POLL_INTERVAL_S apart, starting OTA_POLL_INITIAL_S plus the phase after
+ *  the start, so the devices keep their place in the spread however long
+ *  their checks take.
+ *
+ * Return:
+ *  uint32_t : Delay in milliseconds
+ *
+ *******************************************************************************/
+static uint32_t ota_poll_slot_delay_ms(void)
+{
+    uint32_t elapsed = OTA_POLL_TICKS_TO_MS(xTaskGetTickCount() - poll_start);
+    uint32_t first = (OTA_POLL_INITIAL_S * 1000u) + poll_stats.phase_ms;
+
+    if (elapsed < first)
+    {
+        return first - elapsed;
+    }
+
+    return (OTA_POLL_INTERVAL_S * 1000u) - ((elapsed - first) % (OTA_POLL_INTERVAL_S * 1000u));
+}
+
+/*******************************************************************************
+ * Function Name: ota_poll_next_ms
+ *******************************************************************************
+ * Summary:
+ *  Schedules the check after the one that just ended: the next slot, or after
+ *  a failure the exponential backoff with jitter. A "RetryAfter" hint is a
+ *  lower bound, the phase spreads the devices that got the same hint over
+ *  half of it.
+ *
+ * Return:
+ *  uint32_t : Delay in milliseconds
+ *
+ *******************************************************************************/
+static uint32_t ota_poll_next_ms(void)
+{
+    ota_poll_outcome_t outcome;
+    uint32_t retry_after_s;
+    uint32_t hint_ms;
+    uint32_t delay_ms;
+    ota_poll_stats_t stats;
+
+    taskENTER_CRITICAL();
+    outcome = poll_outcome;
+    retry_after_s = poll_retry_after_s;
+    taskEXIT_CRITICAL();
+
+    if (OTA_POLL_OUTCOME_FAILED == outcome)
+    {
+        delay_ms = backoff_delay_ms(poll_stats.backoff_level, OTA_POLL_RETRY_S * 1000u,
+                                    OTA_POLL_BACKOFF_MAX_S * 1000u);
+    }
+    else
+    {
+        delay_ms = ota_poll_slot_delay_ms();
+    }
+
+    if (retry_after_s != 0u)
+    {
+        hint_ms = CY_MIN(retry_after_s, OTA_POLL_RETRY_AFTER_MAX_S) * 1000u;
+        delay_ms = CY_MAX(delay_ms, hint_ms + (poll_stats.phase_ms % ((hint_ms / 2u) + 1u)));
+    }
+
+    taskENTER_CRITICAL();
+    poll_stats.backoff_level = (OTA_POLL_OUTCOME_FAILED == outcome) ? (poll_stats.backoff_level + 1u) : 0u;
+    poll_stats.retry_hints += (retry_after_s != 0u) ? 1u : 0u;
+    poll_stats.next_ms = delay_ms;
+    stats = poll_stats;
+    taskEXIT_CRITICAL();
+
+    APP_LOG_INFO("OTA poll: %lu checks, %lu updates, %lu without, %lu failures, next in %lu ms\n",
+            (unsigned long)stats.checks, (unsigned long)stats.updates, (unsigned long)stats.no_updates,
+            (unsigned long)stats.failures, (unsigned long)delay_ms);
+
+    return delay_ms;
+}
+
+/*******************************************************************************
+ * Function Name: ota_poll_on_job
+ *******************************************************************************
+ * Summary:
+ *  Takes the outcome and the "RetryAfter" hint (in seconds) of a check from
+ *  its job document.
+ *
+ * Parameters:
+ *  const char *json_doc : Job document
+ *
+ *******************************************************************************/
+void ota_poll_on_job(const char *json_doc)
+{
+    char value[24];
+    ota_poll_outcome_t outcome = OTA_POLL_OUTCOME_NONE;
+    uint32_t retry_after_s = 0;
+
+    if (json_doc == NULL)
+    {
+        return;
+    }
+
+    if (json_field_get(json_doc, "Message", value, sizeof(value)))
+    {
+        if (0 == strcmp(value, "No Update Available"))
+        {
+            outcome = OTA_POLL_OUTCOME_NO_UPDATE;
+        }
+        else if (0 == strcmp(value, "Update Available"))
+        {
+            outcome = OTA_POLL_OUTCOME_UPDATE;
+        }
+    }
+    if (json_field_get(json_doc, "RetryAfter", value, sizeof(value)))
+    {
+        retry_after_s = (uint32_t)strtoul(value, NULL, 10);
+    }
+
+    taskENTER_CRITICAL();
+    if (outcome != OTA_POLL_OUTCOME_NONE)
+    {
+        poll_outcome = outcome;
+        poll_stats.updates += (outcome == OTA_POLL_OUTCOME_UPDATE) ? 1u : 0u;
+        poll_stats.no_updates += (outcome == OTA_POLL_OUTCOME_NO_UPDATE) ? 1u : 0u;
+    }
+    poll_retry_after_s = retry_after_s;
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: ota_poll_on_failure
+ *******************************************************************************
+ * Summary:
+ *  Marks the running check as failed. A check that was told there is no
+ *  update is not a failure, whatever the agent reports for it.
+ *
+ *******************************************************************************/
+void ota_poll_on_failure(void)
+{
+    taskENTER_CRITICAL();
+    if (poll_outcome != OTA_POLL_OUTCOME_NO_UPDATE)
+    {
+        poll_outcome = OTA_POLL_OUTCOME_FAILED;
+        poll_stats.failures++;
+    }
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: ota_poll_on_waiting
+ *******************************************************************************
+ * Summary:
+ *  Tells the scheduler that the agent waits for the next check.
+ *
+ *******************************************************************************/
+void ota_poll_on_waiting(void)
+{
+    if (poll_task_handle != NULL)
+    {
+        xTaskNotifyGive(poll_task_handle);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: ota_poll_get_stats
+ *******************************************************************************
+ * Summary:
+ *  Copies the check counters.
+ *
+ * Parameters:
+ *  ota_poll_stats_t *stats : Receives the counters
+ *
+ *******************************************************************************/
+void ota_poll_get_stats(ota_poll_stats_t *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = poll_stats;
+    taskEXIT_CRITICAL();
+}
+
+/* [] END OF FILE */
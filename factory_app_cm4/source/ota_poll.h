@@ -0,0 +1,119 @@
+/******************************************************************************
+* File Name: ota_poll.h
+*
+* Description: This file contains the declarations of the OTA poll scheduler, which
+* starts the update checks of the OTA agent at a device specific phase and
+* backs off after failed checks.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+#ifndef SOURCE_OTA_POLL_H_
+#define SOURCE_OTA_POLL_H_
+
+#include <stdint.h>
+#include "cy_result.h"
+#include "cy_ota_api.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Earliest first check after the agent started */
+#ifndef OTA_POLL_INITIAL_S
+#define OTA_POLL_INITIAL_S                  (10u)
+#endif
+
+/* Time between the checks of one device */
+#ifndef OTA_POLL_INTERVAL_S
+#define OTA_POLL_INTERVAL_S                 (10u)
+#endif
+
+/* Window the phases of all devices are spread over, from the client ID */
+#ifndef OTA_POLL_SPREAD_S
+#define OTA_POLL_SPREAD_S                   OTA_POLL_INTERVAL_S
+#endif
+
+/* Delay before the first retry of a failed check, doubled for every further
+ * failure up to OTA_POLL_BACKOFF_MAX_S */
+#ifndef OTA_POLL_RETRY_S
+#define OTA_POLL_RETRY_S                    (5u)
+#endif
+
+#ifndef OTA_POLL_BACKOFF_MAX_S
+#define OTA_POLL_BACKOFF_MAX_S              (600u)
+#endif
+
+/* Longest "RetryAfter" of a job document that is honoured */
+#define OTA_POLL_RETRY_AFTER_MAX_S          (24u * 60u * 60u)
+
+#if ((OTA_POLL_INTERVAL_S == 0u) || (OTA_POLL_SPREAD_S == 0u) || (OTA_POLL_RETRY_S == 0u))
+#error "OTA_POLL_INTERVAL_S, OTA_POLL_SPREAD_S and OTA_POLL_RETRY_S must not be 0"
+#endif
+
+/*******************************************************************************
+* Data Structures
+********************************************************************************/
+typedef struct
+{
+    uint32_t                    checks;         /* Checks started */
+    uint32_t                    updates;        /* Job documents with an update */
+    uint32_t                    no_updates;     /* Job documents without an update */
+    uint32_t                    failures;       /* Failed checks and downloads */
+    uint32_t                    retry_hints;    /* "RetryAfter" hints honoured */
+    uint32_t                    backoff_level;  /* Failures since the last good check */
+    uint32_t                    phase_ms;       /* Place of this device in the spread */
+    uint32_t                    next_ms;        /* Delay before the next check */
+} ota_poll_stats_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Derives the phase of this device and seeds the backoff jitter. Call before
+ * the network starts. */
+void ota_poll_init(const char *client_id);
+
+/* Starts the scheduler task once the agent is running */
+cy_rslt_t ota_poll_start(cy_ota_context_ptr ota_context);
+
+/* Called from the OTA callback: job document, failure, and the agent waiting
+ * again at the end of a check */
+void ota_poll_on_job(const char *json_doc);
+void ota_poll_on_failure(void);
+void ota_poll_on_waiting(void);
+
+/* Copies the check counters */
+void ota_poll_get_stats(ota_poll_stats_t *stats);
+
+#endif /* SOURCE_OTA_POLL_H_ */
@@ -0,0 +1,105 @@
+/******************************************************************************
+* File Name: ota_sign_key.c
+*
+* Description: This file contains the checks against the public key the
+* bootloader trusts. The key is the one the bootloader is built with, set by
+* SIGN_KEY_FILE in user_config.mk. Only built when a feature that needs it is
+* enabled in the Makefile.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include "ota_sign_key.h"
+
+#ifdef OTA_SIGN_KEY_FILE
+
+#include "mbedtls/sha256.h"
+#include "mbedtls/pk.h"
+
+/* Public key of the bootloader, ecdsa_pub_key[] in DER format */
+#include OTA_SIGN_KEY_FILE
+
+/*******************************************************************************
+ * Function Name: ota_sign_key_verify
+ *******************************************************************************
+ * Summary:
+ *  Checks an ECDSA P-256 signature of a SHA-256 digest against the public key
+ *  of the bootloader.
+ *
+ * Parameters:
+ *  const uint8_t *digest : SHA-256 digest, OTA_SIGN_KEY_DIGEST_SIZE bytes
+ *  const uint8_t *sig    : Signature in ASN.1 DER format
+ *  size_t sig_len        : Length of sig
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS if the signature is valid, error code otherwise
+ *
+ *******************************************************************************/
+cy_rslt_t ota_sign_key_verify(const uint8_t *digest, const uint8_t *sig, size_t sig_len)
+{
+    mbedtls_pk_context pk;
+    int ret;
+
+    mbedtls_pk_init(&pk);
+    ret = mbedtls_pk_parse_public_key(&pk, ecdsa_pub_key, ecdsa_pub_key_len);
+    if (ret == 0)
+    {
+        ret = mbedtls_pk_verify(&pk, MBEDTLS_MD_SHA256, digest, OTA_SIGN_KEY_DIGEST_SIZE, sig, sig_len);
+    }
+    mbedtls_pk_free(&pk);
+
+    return (ret == 0) ? CY_RSLT_SUCCESS : CY_RSLT_TYPE_ERROR;
+}
+
+/*******************************************************************************
+ * Function Name: ota_sign_key_hash
+ *******************************************************************************
+ * Summary:
+ *  Computes the SHA-256 of the public key in DER format.
+ *
+ * Parameters:
+ *  uint8_t *hash : Receives OTA_SIGN_KEY_DIGEST_SIZE bytes
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS on success, error code otherwise
+ *
+ *******************************************************************************/
+cy_rslt_t ota_sign_key_hash(uint8_t *hash)
+{
+    return (0 == mbedtls_sha256(ecdsa_pub_key, ecdsa_pub_key_len, hash, 0)) ? CY_RSLT_SUCCESS : CY_RSLT_TYPE_ERROR;
+}
+
+#endif /* OTA_SIGN_KEY_FILE */
+
+/* [] END OF FILE */
@@ -0,0 +1,63 @@
+/******************************************************************************
+* File Name: ota_sign_key.h
+*
+* Description: This file contains the declarations of the checks against
+* the public key the bootloader trusts.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef SOURCE_OTA_SIGN_KEY_H_
+#define SOURCE_OTA_SIGN_KEY_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "cy_result.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Size of a SHA-256 digest */
+#define OTA_SIGN_KEY_DIGEST_SIZE            (32u)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Checks an ECDSA P-256 signature in ASN.1 DER format of a SHA-256 digest */
+cy_rslt_t ota_sign_key_verify(const uint8_t *digest, const uint8_t *sig, size_t sig_len);
+
+/* SHA-256 of the public key, as in the key hash TLV of an MCUboot image */
+cy_rslt_t ota_sign_key_hash(uint8_t *hash);
+
+#endif /* SOURCE_OTA_SIGN_KEY_H_ */
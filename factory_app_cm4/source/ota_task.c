@@ -53,6 +53,84 @@
 #include "cy_ota_api.h"
 /* OTA storage api */
 #include "cy_ota_storage_api.h"
+/* Flash service task */
+#include "flash_service.h"
+/* Deferred log */
+#include "app_log.h"
+/* Retry delays */
+#include "backoff.h"
+/* Telemetry documents published over MQTT */
+#include "telemetry.h"
+/* Event trace, recorded with EVENT_TRACE_ENABLE only */
+#include "event_trace.h"
+#ifdef WIFI_FAST_CONNECT_ENABLE
+/* Cached AP profile for a directed connect */
+#include "wifi_profile.h"
+#endif
+#ifdef TLS_SESSION_RESUME_ENABLE
+/* TLS session resumption */
+#include "tls_session.h"
+#endif
+#ifdef CRYPTO_BENCH_ENABLE
+/* mbed TLS primitive benchmark */
+#include "crypto_bench.h"
+#endif
+#ifdef OTA_FLASH_VERIFY_ENABLE
+/* Read-back verification of flash writes */
+#include "cy_ota_flash_verify.h"
+#endif
+#ifdef OTA_FLASH_STATS_ENABLE
+/* Flash driver telemetry */
+#include "cy_ota_flash_stats.h"
+#endif
+#ifdef OTA_CHUNK_WINDOW_ENABLE
+/* Windowed chunk requests */
+#include "chunk_window.h"
+#endif
+#ifdef OTA_DELTA_ENABLE
+/* Delta updates against the primary slot */
+#include "delta_update.h"
+#endif
+#ifdef OTA_COMPRESS_ENABLE
+/* Compressed images */
+#include "compressed_update.h"
+#endif
+#ifdef OTA_RESUME_ENABLE
+/* Resumable downloads */
+#include "resume_record.h"
+#endif
+#ifdef OTA_IMAGE_VERIFY_ENABLE
+/* Signature check on the digest computed during the download */
+#include "image_verify.h"
+#endif
+#ifdef OTA_MANIFEST_ENABLE
+/* Per-chunk check against a signed manifest */
+#include "manifest_update.h"
+#endif
+#ifdef OTA_HEADER_CHECK_ENABLE
+/* Early check of the MCUboot header */
+#include "header_check.h"
+#endif
+#ifdef OTA_BENCH_ENABLE
+/* Throughput benchmark */
+#include "ota_bench.h"
+#endif
+#ifdef ARENA_TLS_ENABLE
+/* High-water marks of the TLS arena */
+#include "arena.h"
+#endif
+#ifdef RTOS_MONITOR_ENABLE
+/* CPU, stack and heap report */
+#include "rtos_monitor.h"
+#endif
+#ifdef OTA_POLL_ENABLE
+/* Update checks with per-device jitter and backoff */
+#include "ota_poll.h"
+#endif
+#ifdef MQTT_SESSION_ENABLE
+/* One broker connection for the job and data phases */
+#include "mqtt_session.h"
+#endif
 
 /*******************************************************************************
 * Macros
@@ -64,15 +142,49 @@
 /* MAX connection retries to join WI-FI AP */
 #define MAX_CONNECTION_RETRIES              (10)
 
-/* Wait between connection retries */
+/* Wait between connection retries, doubled for every retry up to the maximum */
 #define WIFI_CONN_RETRY_DELAY_MS            (500)
+#define WIFI_CONN_RETRY_MAX_DELAY_MS        (8000)
+
+/* Connection attempts to the cached AP before scanning for any AP of the SSID */
+#define WIFI_FAST_CONNECT_ATTEMPTS          (2)
+
+#define OTA_TICKS_TO_MS(t)                  ((uint32_t)((t) * portTICK_PERIOD_MS))
+
+/*******************************************************************************
+* Data Structures
+********************************************************************************/
+/* Timing of the Wi-Fi connect, printed once connected */
+typedef struct
+{
+    bool                        fast;           /* Connected to the cached AP */
+    uint32_t                    attempts;
+    uint32_t                    total_ms;       /* First attempt to IP address */
+    uint32_t                    backoff_ms;     /* Waiting between attempts */
+    uint32_t                    join_ms;        /* Last attempt to link up */
+    uint32_t                    dhcp_ms;        /* Link up to IP address */
+} wifi_conn_stats_t;
 
 /*******************************************************************************
 * Forward declaration
 ********************************************************************************/
 cy_rslt_t connect_to_wifi_ap(void);
+static void wifi_event_callback(cy_wcm_event_t event, cy_wcm_event_data_t *event_data);
 cy_ota_callback_results_t ota_callback(cy_ota_cb_struct_t *cb_data);
 static void ota_task(void *args);
+static cy_rslt_t ota_storage_open(cy_ota_context_ptr ctx_ptr);
+static cy_rslt_t ota_storage_write(cy_ota_context_ptr ctx_ptr, cy_ota_storage_write_info_t *chunk_info);
+static cy_rslt_t ota_storage_verify(cy_ota_context_ptr ctx_ptr);
+#ifdef OTA_FLASH_STATS_ENABLE
+static void ota_report_flash_stats(cy_mqtt_t mqtt_handle);
+#endif
+#ifdef OTA_RESUME_ENABLE
+static void ota_resume_finish(void);
+#endif
+#ifdef OTA_BENCH_ENABLE
+static cy_rslt_t ota_storage_write_timed(cy_ota_context_ptr ctx_ptr, cy_ota_storage_write_info_t *chunk_info);
+static cy_rslt_t ota_storage_verify_timed(cy_ota_context_ptr ctx_ptr);
+#endif
 
 /*******************************************************************************
 * Global Variables
@@ -82,6 +194,22 @@ cy_ota_context_ptr ota_context;
 
 /* OTA task handle */
 static TaskHandle_t ota_task_handle;
+static StaticTask_t ota_task_tcb;
+static StackType_t ota_task_stack[OTA_TASK_STACK_SIZE];
+
+#ifdef OTA_RESUME_ENABLE
+/* The current download continues an interrupted one */
+static bool ota_resuming;
+
+/* Data connection of the resumed download, the result is reported on it */
+static cy_mqtt_t ota_resume_mqtt;
+#endif
+
+/* Time the link of the current connection attempt came up, 0 before */
+static volatile TickType_t wifi_link_up;
+
+/* The download progress is logged on whole-percent changes only */
+static app_log_limit_t ota_progress_limit;
 
 /* Network parameters for OTA */
 cy_ota_network_params_t ota_network_params =
@@ -94,7 +222,11 @@ cy_ota_network_params_t ota_network_params =
             .port = MQTT_SERVER_PORT
         },
         .pTopicFilters = my_topics,
+#ifdef MQTT_SESSION_PERSISTENT_ENABLE
+        .session_type = CY_OTA_MQTT_SESSION_PERSISTENT,
+#else
         .session_type = CY_OTA_MQTT_SESSION_CLEAN,
+#endif
         .numTopicFilters = MQTT_TOPIC_FILTER_NUM,
         .pIdentifier = OTA_MQTT_ID,
     #if (ENABLE_TLS == true)
@@ -131,11 +263,17 @@ cy_ota_agent_params_t ota_agent_params =
 /* OTA storage interface callbacks */
 cy_ota_storage_interface_t ota_interfaces =
 {
-   .ota_file_open            = cy_ota_storage_open,
-   .ota_file_read            = cy_ota_storage_read,
-   .ota_file_write           = cy_ota_storage_write,
-   .ota_file_close           = cy_ota_storage_close,
-   .ota_file_verify          = cy_ota_storage_verify,
+   .ota_file_open            = ota_storage_open,
+   .ota_file_read            = flash_service_storage_read,
+#ifdef OTA_BENCH_ENABLE
+   .ota_file_write           = ota_storage_write_timed,
+   .ota_file_close           = flash_service_storage_close,
+   .ota_file_verify          = ota_storage_verify_timed,
+#else
+   .ota_file_write           = ota_storage_write,
+   .ota_file_close           = flash_service_storage_close,
+   .ota_file_verify          = ota_storage_verify,
+#endif
    .ota_file_validate        = cy_ota_storage_image_validate,
    .ota_file_get_app_info    = cy_ota_storage_get_app_info
 };
@@ -155,6 +293,37 @@ cy_ota_storage_interface_t ota_interfaces =
  *******************************************************************************/
 static void ota_task(void *args)
 {
+    /* Start the flash service before anything queues requests to it */
+    if (CY_RSLT_SUCCESS != flash_service_init())
+    {
+        printf("\n Starting the flash service failed.\n");
+        CY_ASSERT(0);
+    }
+
+#ifdef OTA_CHUNK_WINDOW_ENABLE
+    if (CY_RSLT_SUCCESS != chunk_window_init())
+    {
+        printf("\n Starting the chunk window failed.\n");
+        CY_ASSERT(0);
+    }
+#endif
+
+#ifdef OTA_RESUME_ENABLE
+    /* Downloads still work without the record, they just start over */
+    if (CY_RSLT_SUCCESS != resume_record_init())
+    {
+        printf("\n Reading the resume record failed, downloads will not be resumed.\n");
+    }
+#endif
+
+#ifdef TLS_SESSION_RESUME_ENABLE
+    /* Reconnects to the broker only do a full handshake without it */
+    if (CY_RSLT_SUCCESS != tls_session_init())
+    {
+        printf("\n Creating the TLS session cache failed.\n");
+    }
+#endif
+
     /* initialize OTA storage */
     if (CY_RSLT_SUCCESS != cy_ota_storage_init())
     {
@@ -162,6 +331,19 @@ static void ota_task(void *args)
         CY_ASSERT(0);
     }
 
+#ifdef CRYPTO_BENCH_ENABLE
+    /* Before the network starts, so nothing else uses the crypto block */
+    (void)crypto_bench_run();
+#endif
+
+#ifdef OTA_POLL_ENABLE
+    /* Also seeds the retry jitter from the TRNG, before TLS uses the crypto block */
+    ota_poll_init(OTA_MQTT_ID);
+#endif
+#ifdef MQTT_SESSION_ENABLE
+    mqtt_session_init();
+#endif
+
     /* Connect to Wi-Fi AP */
     if(CY_RSLT_SUCCESS != connect_to_wifi_ap())
     {
@@ -190,15 +372,249 @@ static void ota_task(void *args)
         CY_ASSERT(0);
     }
 
+#ifdef OTA_POLL_ENABLE
+    /* Without it the agent only checks once a day, see cy_ota_config.h */
+    if (CY_RSLT_SUCCESS != ota_poll_start(ota_context))
+    {
+        printf("\n Starting the OTA poll scheduler failed.\n");
+        CY_ASSERT(0);
+    }
+#endif
+
+#ifdef OTA_RESUME_ENABLE
+    /* The OTA agent does not know about chunks written before the download
+     * was resumed, so a resumed download is completed here */
+    for (;;)
+    {
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        ota_resume_finish();
+    }
+#else
     vTaskSuspend( NULL );
+#endif
  }
 
+/*******************************************************************************
+ * Function Name: ota_storage_open
+ *******************************************************************************
+ * Summary:
+ *  Storage open callback of the OTA agent. Prepares the application's write
+ *  path for a new download and opens the OTA storage.
+ *
+ * Parameters:
+ *  cy_ota_context_ptr ctx_ptr : OTA context
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS on success, error code otherwise
+ *
+ *******************************************************************************/
+static cy_rslt_t ota_storage_open(cy_ota_context_ptr ctx_ptr)
+{
+#ifdef OTA_FLASH_VERIFY_ENABLE
+    cy_ota_flash_verify_reset();
+#endif
+#ifdef OTA_DELTA_ENABLE
+    delta_update_reset();
+#endif
+#ifdef OTA_COMPRESS_ENABLE
+    compressed_update_reset();
+#endif
+#ifdef OTA_IMAGE_VERIFY_ENABLE
+    image_verify_reset();
+#endif
+#ifdef OTA_MANIFEST_ENABLE
+    manifest_update_reset();
+#endif
+#ifdef OTA_HEADER_CHECK_ENABLE
+    header_check_reset();
+#endif
+#ifdef OTA_RESUME_ENABLE
+    /* The secondary slot already holds part of the image, opening the
+     * storage would erase it */
+    ota_resuming = resume_record_open();
+    if (ota_resuming)
+    {
+        return CY_RSLT_SUCCESS;
+    }
+#endif
+
+    return flash_service_storage_open(ctx_ptr);
+}
+
+/*******************************************************************************
+ * Function Name: ota_storage_write
+ *******************************************************************************
+ * Summary:
+ *  Storage write callback of the OTA agent. With windowed chunk requests the
+ *  chunks can arrive out of order, they are written at their image offset and
+ *  a chunk that arrives a second time is dropped. The chunks of a delta patch
+ *  are applied to the primary slot and the chunks of a compressed image are
+ *  decoded, instead of being written as they are. Written chunks are recorded
+ *  so an interrupted download can be resumed.
+ *
+ * Parameters:
+ *  cy_ota_context_ptr ctx_ptr              : OTA context
+ *  cy_ota_storage_write_info_t *chunk_info : Chunk to write
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS on success, error code otherwise
+ *
+ *******************************************************************************/
+static cy_rslt_t ota_storage_write(cy_ota_context_ptr ctx_ptr, cy_ota_storage_write_info_t *chunk_info)
+{
+    cy_rslt_t result;
+
+    EVENT_TRACE(EVENT_TRACE_MQTT_RECEIVE, 0u, chunk_info->size, chunk_info->offset);
+
+#ifdef OTA_CHUNK_WINDOW_ENABLE
+    if (!chunk_window_on_chunk(chunk_info))
+    {
+        /* The OTA agent adds the size of every written chunk to its byte
+         * count, a copy must not bring the count closer to the image size */
+        chunk_info->size = 0;
+        return CY_RSLT_SUCCESS;
+    }
+#endif
+#ifdef OTA_DELTA_ENABLE
+    if (delta_update_is_patch(chunk_info))
+    {
+        return delta_update_write(ctx_ptr, chunk_info);
+    }
+#endif
+#ifdef OTA_COMPRESS_ENABLE
+    if (compressed_update_is_stream(chunk_info))
+    {
+        return compressed_update_write(ctx_ptr, chunk_info);
+    }
+#endif
+#ifdef OTA_MANIFEST_ENABLE
+    if (manifest_update_is_stream(chunk_info))
+    {
+        return manifest_update_write(ctx_ptr, chunk_info);
+    }
+#endif
+#ifdef OTA_RESUME_ENABLE
+    if (ota_resuming)
+    {
+        /* The storage was not opened, write to the secondary slot directly */
+        result = flash_service_write(CY_OTA_MEM_TYPE_EXTERNAL_FLASH, OTA_RESUME_SLOT_ADDR + chunk_info->offset,
+                                     chunk_info->buffer, chunk_info->size);
+    }
+    else
+    {
+        result = flash_service_storage_write(ctx_ptr, chunk_info);
+    }
+
+    if (CY_RSLT_SUCCESS != result)
+    {
+        /* May report an earlier chunk that is already in the record */
+        resume_record_clear();
+        return result;
+    }
+
+    if (ota_resuming)
+    {
+        /* Written synchronously, queued writes are committed by the flash
+         * service once they are done */
+        resume_record_commit(chunk_info);
+        if (resume_record_complete())
+        {
+            xTaskNotifyGive(ota_task_handle);
+        }
+    }
+    resume_record_checkpoint();
+#else
+    result = flash_service_storage_write(ctx_ptr, chunk_info);
+#endif
+#if defined(OTA_HEADER_CHECK_ENABLE) && defined(OTA_CHUNK_WINDOW_ENABLE)
+    if ((CY_RSLT_SUCCESS == result) && (chunk_info->offset == 0) && (header_check_tlv_offset() != 0))
+    {
+        /* Request the TLV area next, so the key hash is checked early too */
+        chunk_window_prefetch(header_check_tlv_offset(), HEADER_CHECK_TLV_MAX);
+    }
+#endif
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: ota_storage_verify
+ *******************************************************************************
+ * Summary:
+ *  Storage verify callback of the OTA agent. Fails the update if requested
+ *  chunks are missing, if a delta patch or a compressed image did not produce
+ *  the complete image, if any page did not read back as written or if the
+ *  image is not signed with the bootloader key, then runs the regular image
+ *  verification.
+ *
+ * Parameters:
+ *  cy_ota_context_ptr ctx_ptr : OTA context
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS on success, error code otherwise
+ *
+ *******************************************************************************/
+static cy_rslt_t ota_storage_verify(cy_ota_context_ptr ctx_ptr)
+{
+#ifdef OTA_CHUNK_WINDOW_ENABLE
+    /* Before the record is cleared, a resumed session fetches the rest */
+    if (!chunk_window_complete())
+    {
+        printf("\n Image incomplete, chunks are missing.\n");
+        return CY_RSLT_TYPE_ERROR;
+    }
+#endif
+#ifdef OTA_RESUME_ENABLE
+    /* Whatever the result, this download is not continued */
+    resume_record_clear();
+#endif
+#ifdef OTA_DELTA_ENABLE
+    if (CY_RSLT_SUCCESS != delta_update_finish())
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+#endif
+#ifdef OTA_COMPRESS_ENABLE
+    if (CY_RSLT_SUCCESS != compressed_update_finish())
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+#endif
+#ifdef OTA_MANIFEST_ENABLE
+    if (CY_RSLT_SUCCESS != manifest_update_finish())
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+#endif
+#ifdef OTA_FLASH_VERIFY_ENABLE
+    if (CY_RSLT_SUCCESS != cy_ota_flash_verify_flush())
+    {
+        printf("\n Flash read-back verification failed.\n");
+        return CY_RSLT_TYPE_ERROR;
+    }
+#endif
+#ifdef OTA_IMAGE_VERIFY_ENABLE
+    if (CY_RSLT_SUCCESS != image_verify_finish())
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+#endif
+
+    return flash_service_storage_verify(ctx_ptr);
+}
+
 /*******************************************************************************
  * Function Name: connect_to_wifi_ap()
  *******************************************************************************
  * Summary:
  *  Connects to Wi-Fi AP using the user-configured credentials, retries up to a
- *  configured number of times until the connection succeeds.
+ *  configured number of times until the connection succeeds. Retries back off
+ *  exponentially with jitter.
+ *
+ *  With WIFI_FAST_CONNECT_ENABLE, the first attempts go to the BSSID and band
+ *  of the AP of the last connection, which spares the scan of all channels.
+ *  If they fail, any AP of the SSID is accepted. The profile of the AP is
+ *  stored again whenever it changes.
  *
  *******************************************************************************/
 cy_rslt_t connect_to_wifi_ap(void)
@@ -207,6 +623,16 @@ cy_rslt_t connect_to_wifi_ap(void)
     cy_wcm_connect_params_t wifi_conn_param;
     cy_wcm_ip_address_t ip_address;
     cy_rslt_t result = CY_RSLT_TYPE_ERROR;
+    wifi_conn_stats_t stats;
+    TickType_t start;
+    TickType_t attempt_start;
+    TickType_t link_up;
+    uint32_t delay_ms;
+    bool fast = false;
+#ifdef WIFI_FAST_CONNECT_ENABLE
+    wifi_profile_t profile;
+    bool profile_valid;
+#endif
 
     /* Variable to track the number of connection retries to the Wi-Fi AP specified
      * by WIFI_SSID macro. */
@@ -229,28 +655,109 @@ cy_rslt_t connect_to_wifi_ap(void)
     memcpy(wifi_conn_param.ap_credentials.password, WIFI_PASSWORD, sizeof(WIFI_PASSWORD));
     wifi_conn_param.ap_credentials.security = WIFI_SECURITY;
 
+#ifdef WIFI_FAST_CONNECT_ENABLE
+    profile_valid = wifi_profile_load(wifi_conn_param.ap_credentials.SSID, &profile);
+#endif
+
+    /* Only used to time the join, connecting works without it */
+    (void)cy_wcm_register_event_callback(wifi_event_callback);
+
+    memset(&stats, 0, sizeof(stats));
+    start = xTaskGetTickCount();
+
     /* Connect to the Wi-Fi AP */
     for(conn_retries = 0; conn_retries < MAX_CONNECTION_RETRIES; conn_retries++)
     {
+#ifdef WIFI_FAST_CONNECT_ENABLE
+        fast = profile_valid && (conn_retries < WIFI_FAST_CONNECT_ATTEMPTS);
+        if (fast)
+        {
+            memcpy(wifi_conn_param.BSSID, profile.bssid, sizeof(wifi_conn_param.BSSID));
+            wifi_conn_param.band = profile.band;
+            printf("Connecting to %02X:%02X:%02X:%02X:%02X:%02X on channel %u\n",
+                    profile.bssid[0], profile.bssid[1], profile.bssid[2],
+                    profile.bssid[3], profile.bssid[4], profile.bssid[5],
+                    (unsigned int)profile.channel);
+        }
+        else
+        {
+            memset(wifi_conn_param.BSSID, 0, sizeof(wifi_conn_param.BSSID));
+            wifi_conn_param.band = CY_WCM_WIFI_BAND_ANY;
+        }
+#endif
+
+        wifi_link_up = 0;
+        attempt_start = xTaskGetTickCount();
         result = cy_wcm_connect_ap( &wifi_conn_param, &ip_address );
 
         if (CY_RSLT_SUCCESS == result)
         {
+            link_up = wifi_link_up;
+            stats.fast = fast;
+            stats.attempts = conn_retries + 1;
+            stats.total_ms = OTA_TICKS_TO_MS(xTaskGetTickCount() - start);
+            if (link_up != 0)
+            {
+                stats.join_ms = OTA_TICKS_TO_MS(link_up - attempt_start);
+                stats.dhcp_ms = OTA_TICKS_TO_MS(xTaskGetTickCount() - link_up);
+            }
+            (void)cy_wcm_deregister_event_callback(wifi_event_callback);
+
             printf( "Successfully connected to Wi-Fi network '%s'.\n",
                     wifi_conn_param.ap_credentials.SSID);
+            printf("Wi-Fi connect: %s, %lu attempts, %lu ms (join %lu ms, DHCP %lu ms, backoff %lu ms)\n",
+                    stats.fast ? "cached AP" : "scan", (unsigned long)stats.attempts,
+                    (unsigned long)stats.total_ms, (unsigned long)stats.join_ms,
+                    (unsigned long)stats.dhcp_ms, (unsigned long)stats.backoff_ms);
+#ifdef WIFI_FAST_CONNECT_ENABLE
+            if (CY_RSLT_SUCCESS != wifi_profile_save(wifi_conn_param.ap_credentials.SSID))
+            {
+                printf("Storing the Wi-Fi profile failed, the next connect scans all channels.\n");
+            }
+#endif
             return result;
         }
 
+#ifdef WIFI_FAST_CONNECT_ENABLE
+        /* The AP has moved or is gone, scan right away */
+        if (fast && ((conn_retries + 1) == WIFI_FAST_CONNECT_ATTEMPTS))
+        {
+            printf("Connection to the cached AP failed with error code %d. Scanning...\n", (int) result);
+            continue;
+        }
+#endif
+
+        delay_ms = backoff_delay_ms(conn_retries, WIFI_CONN_RETRY_DELAY_MS, WIFI_CONN_RETRY_MAX_DELAY_MS);
         printf( "Connection to Wi-Fi network failed with error code %d."
-                "Retrying in %d ms...\n", (int) result, WIFI_CONN_RETRY_DELAY_MS );
-        vTaskDelay(pdMS_TO_TICKS(WIFI_CONN_RETRY_DELAY_MS));
+                "Retrying in %lu ms...\n", (int) result, (unsigned long)delay_ms );
+        vTaskDelay(pdMS_TO_TICKS(delay_ms));
+        stats.backoff_ms += delay_ms;
     }
 
+    (void)cy_wcm_deregister_event_callback(wifi_event_callback);
     printf( "Exceeded maximum Wi-Fi connection attempts\n" );
 
     return result;
 }
 
+/*******************************************************************************
+ * Function Name: wifi_event_callback
+ *******************************************************************************
+ * Summary:
+ *  Timestamps the link coming up, to split the connect time into join and
+ *  DHCP.
+ *
+ *******************************************************************************/
+static void wifi_event_callback(cy_wcm_event_t event, cy_wcm_event_data_t *event_data)
+{
+    (void)event_data;
+
+    if ((CY_WCM_EVENT_CONNECTED == event) && (wifi_link_up == 0))
+    {
+        wifi_link_up = xTaskGetTickCount();
+    }
+}
+
 /*******************************************************************************
  * Function Name: ota_callback()
  *******************************************************************************
@@ -287,32 +794,64 @@ cy_ota_callback_results_t ota_callback(cy_ota_cb_struct_t *cb_data)
             break;
 
         case CY_OTA_REASON_SUCCESS:
-            printf(">> APP CB OTA SUCCESS state:%d %s last_error:%s\n\n",
+            APP_LOG_INFO(">> APP CB OTA SUCCESS state:%d %s last_error:%s\n\n",
                     cb_data->ota_agt_state,
                     state_string, error_string);
             break;
 
         case CY_OTA_REASON_FAILURE:
-            printf(">> APP CB OTA FAILURE state:%d %s last_error:%s\n\n",
+            APP_LOG_ERR(">> APP CB OTA FAILURE state:%d %s last_error:%s\n\n",
                     cb_data->ota_agt_state, state_string, error_string);
+#ifdef OTA_CHUNK_WINDOW_ENABLE
+            chunk_window_stop();
+#endif
+#ifdef OTA_RESUME_ENABLE
+            resume_record_save();
+#endif
+#ifdef OTA_BENCH_ENABLE
+            ota_bench_report(NULL, "failure");
+#endif
+#ifdef EVENT_TRACE_ENABLE
+            /* The events that led to the failure */
+            event_trace_dump();
+#endif
+#ifdef OTA_POLL_ENABLE
+            ota_poll_on_failure();
+#endif
+#ifdef MQTT_SESSION_ENABLE
+            mqtt_session_on_failure();
+#endif
             break;
 
         case CY_OTA_REASON_STATE_CHANGE:
+            EVENT_TRACE(EVENT_TRACE_OTA_STATE, cb_data->ota_agt_state, 0u, 0u);
+#ifdef OTA_BENCH_ENABLE
+            ota_bench_state(cb_data);
+#endif
+#ifdef MQTT_SESSION_ENABLE
+            /* Skips the job disconnect and the data connect of the agent */
+            cb_result = mqtt_session_on_state(cb_data);
+#endif
             switch (cb_data->ota_agt_state)
             {
                 case CY_OTA_STATE_NOT_INITIALIZED:
                 case CY_OTA_STATE_EXITING:
                 case CY_OTA_STATE_INITIALIZING:
                 case CY_OTA_STATE_AGENT_STARTED:
+                    break;
+
                 case CY_OTA_STATE_AGENT_WAITING:
+#ifdef OTA_POLL_ENABLE
+                    /* A check ended, schedule the next one */
+                    ota_poll_on_waiting();
+#endif
                     break;
 
                 case CY_OTA_STATE_START_UPDATE:
-                    printf("APP CB OTA STATE CHANGE CY_OTA_STATE_START_UPDATE\n");
+                    APP_LOG_INFO("APP CB OTA STATE CHANGE CY_OTA_STATE_START_UPDATE\n");
                     break;
 
                 case CY_OTA_STATE_JOB_CONNECT:
-                    printf("APP CB OTA CONNECT FOR JOB using ");
                     /* NOTE:
                      *  HTTP - json_doc holds the MQTT JSON request doc
                      */
@@ -320,13 +859,13 @@ cy_ota_callback_results_t ota_callback(cy_ota_cb_struct_t *cb_data)
                         ( cb_data->broker_server.port == 0)         ||
                         ( strlen(cb_data->unique_topic) == 0))
                     {
-                        printf("ERROR in callback data: MQTT: server: %p port: %d topic: '%p'\n",
+                        APP_LOG_ERR("ERROR in callback data: MQTT: server: %p port: %d topic: '%p'\n",
                                 cb_data->broker_server.host_name,
                                 cb_data->broker_server.port,
                                 cb_data->unique_topic);
                         cb_result = CY_OTA_CB_RSLT_OTA_STOP;
                     }
-                    printf("MQTT: server:%s port: %d topic: '%s'\n",
+                    APP_LOG_INFO("APP CB OTA CONNECT FOR JOB using MQTT: server:%s port: %d topic: '%s'\n",
                             cb_data->broker_server.host_name,
                             cb_data->broker_server.port,
                             cb_data->unique_topic);
@@ -334,102 +873,150 @@ cy_ota_callback_results_t ota_callback(cy_ota_cb_struct_t *cb_data)
                     break;
 
                 case CY_OTA_STATE_JOB_DOWNLOAD:
-                    printf("APP CB OTA JOB DOWNLOAD using ");
                     /* NOTE:
                      *  HTTP - json_doc holds the MQTT JSON request doc
                      */
-                    printf("MQTT: '%s'\n", cb_data->json_doc);
-                    printf("topic: '%s' \n", cb_data->unique_topic);
+                    APP_LOG_INFO("APP CB OTA JOB DOWNLOAD using MQTT: '%s'\ntopic: '%s' \n",
+                            cb_data->json_doc, cb_data->unique_topic);
                     break;
 
                 case CY_OTA_STATE_JOB_DISCONNECT:
-                    printf("APP CB OTA JOB DISCONNECT\n");
+                    APP_LOG_INFO("APP CB OTA JOB DISCONNECT\n");
                     break;
 
                 case CY_OTA_STATE_JOB_PARSE:
-                    printf("APP CB OTA PARSE JOB: '%.*s' \n",
-                    strlen(cb_data->json_doc),
-                    cb_data->json_doc);
+                    APP_LOG_INFO("APP CB OTA PARSE JOB: '%s' \n", cb_data->json_doc);
+#ifdef OTA_RESUME_ENABLE
+                    resume_record_set_job(cb_data->json_doc);
+#endif
+#ifdef OTA_POLL_ENABLE
+                    ota_poll_on_job(cb_data->json_doc);
+#endif
                     break;
 
                 case CY_OTA_STATE_JOB_REDIRECT:
-                    printf("APP CB OTA JOB REDIRECT\n");
+                    APP_LOG_INFO("APP CB OTA JOB REDIRECT\n");
                     break;
 
                 case CY_OTA_STATE_DATA_CONNECT:
-                    printf("APP CB OTA CONNECT FOR DATA using ");
-                    printf("MQTT: %s:%d \n", cb_data->broker_server.host_name,
-                    cb_data->broker_server.port);
+                    APP_LOG_INFO("APP CB OTA CONNECT FOR DATA using MQTT: %s:%d \n",
+                            cb_data->broker_server.host_name, cb_data->broker_server.port);
                     break;
 
                 case CY_OTA_STATE_DATA_DOWNLOAD:
-                    printf("APP CB OTA DATA DOWNLOAD using ");
                     /* NOTE:
                      *  MQTT - json_doc holds the MQTT JSON request doc
                      */
-                    printf("MQTT: '%.*s' \n", strlen(cb_data->json_doc), cb_data->json_doc);
-                    printf("topic: '%s'\n\n", cb_data->unique_topic);
+                    APP_LOG_INFO("APP CB OTA DATA DOWNLOAD using MQTT: '%s' \ntopic: '%s'\n\n",
+                            cb_data->json_doc, cb_data->unique_topic);
+#ifdef OTA_CHUNK_WINDOW_ENABLE
+                    /* Request the chunks ourselves instead of the OTA agent
+                     * asking the publisher to push the whole image */
+#ifdef OTA_RESUME_ENABLE
+                    if (ota_resuming)
+                    {
+                        ota_resume_mqtt = cb_data->mqtt_connection;
+                        if (CY_RSLT_SUCCESS == chunk_window_start(cb_data->mqtt_connection, cb_data->unique_topic,
+                                                                  resume_record_range()))
+                        {
+                            cb_result = CY_OTA_CB_RSLT_APP_SUCCESS;
+                        }
+                        /* Nothing left to request */
+                        if (resume_record_complete())
+                        {
+                            xTaskNotifyGive(ota_task_handle);
+                        }
+                        break;
+                    }
+#endif
+                    if (CY_RSLT_SUCCESS == chunk_window_start(cb_data->mqtt_connection, cb_data->unique_topic, NULL))
+                    {
+                        cb_result = CY_OTA_CB_RSLT_APP_SUCCESS;
+                    }
+#endif
                     break;
 
                 case CY_OTA_STATE_DATA_DISCONNECT:
-                    printf("APP CB OTA DATA DISCONNECT\n");
+                    APP_LOG_INFO("APP CB OTA DATA DISCONNECT\n");
+#ifdef OTA_CHUNK_WINDOW_ENABLE
+                    chunk_window_stop();
+#endif
+#ifdef OTA_RESUME_ENABLE
+                    resume_record_save();
+#endif
+#ifdef OTA_FLASH_STATS_ENABLE
+                    /* Still connected, report the flash cost of the download */
+                    ota_report_flash_stats(cb_data->mqtt_connection);
+#endif
+#ifdef OTA_BENCH_ENABLE
+                    ota_bench_report(cb_data->mqtt_connection, "downloaded");
+#endif
+#ifdef RTOS_MONITOR_ENABLE
+                    /* Last report, taken while the download was running */
+                    (void)rtos_monitor_publish(cb_data->mqtt_connection);
+#endif
                     break;
 
                 case CY_OTA_STATE_RESULT_CONNECT:
-                    printf("APP CB OTA SEND RESULT CONNECT using ");
                     /* NOTE:
                      *  MQTT - json_doc holds the MQTT JSON request doc
                      */
-                    printf("MQTT: Broker:%s port: %d\n",
+                    APP_LOG_INFO("APP CB OTA SEND RESULT CONNECT using MQTT: Broker:%s port: %d\ntopic: '%s' \n",
                             cb_data->broker_server.host_name,
-                            cb_data->broker_server.port);
-                    printf("topic: '%s' \n", cb_data->unique_topic);
+                            cb_data->broker_server.port,
+                            cb_data->unique_topic);
                     break;
 
                 case CY_OTA_STATE_RESULT_SEND:
-                    printf("APP CB OTA SENDING RESULT using ");
                     /* NOTE:
                      *  MQTT - json_doc holds the MQTT JSON request doc
                      */
-                    printf("MQTT: '%s' \n", cb_data->json_doc);
+                    APP_LOG_INFO("APP CB OTA SENDING RESULT using MQTT: '%s' \n", cb_data->json_doc);
                     break;
 
                 case CY_OTA_STATE_RESULT_RESPONSE:
-                    printf("APP CB OTA Got Result response\n");
+                    APP_LOG_INFO("APP CB OTA Got Result response\n");
                     break;
 
                 case CY_OTA_STATE_RESULT_DISCONNECT:
-                    printf("APP CB OTA Result Disconnect\n");
+                    APP_LOG_INFO("APP CB OTA Result Disconnect\n");
                     break;
 
                 case CY_OTA_STATE_OTA_COMPLETE:
-                    printf("APP CB OTA Session Complete\n");
+                    APP_LOG_INFO("APP CB OTA Session Complete\n");
+#ifdef ARENA_TLS_ENABLE
+                    arena_report();
+#endif
                     break;
 
                 case CY_OTA_STATE_STORAGE_OPEN:
-                    printf("APP CB OTA STORAGE OPEN\n");
+                    APP_LOG_INFO("APP CB OTA STORAGE OPEN\n");
+                    app_log_limit_reset(&ota_progress_limit);
                     break;
 
                 case CY_OTA_STATE_STORAGE_WRITE:
-                    printf("APP CB OTA STORAGE WRITE %ld%% (%ld of %ld)\n",
-                            (unsigned long)cb_data->percentage,
-                            (unsigned long)cb_data->bytes_written,
-                            (unsigned long)cb_data->total_size);
-
-                    /* Move cursor to previous line */
-                    printf("\x1b[1F");
+                    /* Called for every chunk, only log whole-percent steps.
+                     * The escape sequence moves the cursor to the previous
+                     * line so the next step overwrites this one. */
+                    if (app_log_limit_changed(&ota_progress_limit, (uint32_t)cb_data->percentage))
+                    {
+                        APP_LOG_INFO("APP CB OTA STORAGE WRITE %lu%% (%lu of %lu)\n\x1b[1F",
+                                (unsigned long)cb_data->percentage,
+                                (unsigned long)cb_data->bytes_written,
+                                (unsigned long)cb_data->total_size);
+                    }
                     break;
 
                 case CY_OTA_STATE_STORAGE_CLOSE:
-                    printf("APP CB OTA STORAGE CLOSE\n");
+                    APP_LOG_INFO("APP CB OTA STORAGE CLOSE\n");
                     break;
 
                 case CY_OTA_STATE_VERIFY:
-                    printf("APP CB OTA VERIFY\n");
+                    APP_LOG_INFO("APP CB OTA VERIFY\n");
                     break;
 
                 case CY_OTA_STATE_RESULT_REDIRECT:
-                    printf("APP CB OTA RESULT REDIRECT\n");
+                    APP_LOG_INFO("APP CB OTA RESULT REDIRECT\n");
                     break;
 
                 case CY_OTA_NUM_STATES:
@@ -441,6 +1028,147 @@ cy_ota_callback_results_t ota_callback(cy_ota_cb_struct_t *cb_data)
     return cb_result;
 }
 
+#ifdef OTA_FLASH_STATS_ENABLE
+/*******************************************************************************
+ * Function Name: ota_report_flash_stats
+ *******************************************************************************
+ * Summary:
+ *  Prints the flash driver telemetry to the debug UART and publishes it as a
+ *  JSON document to TELEMETRY_TOPIC_PREFIX "flash".
+ *
+ * Parameters:
+ *  cy_mqtt_t mqtt_handle : MQTT connection to publish on, NULL to only print
+ *
+ *******************************************************************************/
+static void ota_report_flash_stats(cy_mqtt_t mqtt_handle)
+{
+    static char doc[TELEMETRY_DOC_SIZE];
+    size_t doc_len;
+
+    cy_ota_flash_stats_print();
+
+    if (mqtt_handle == NULL)
+    {
+        return;
+    }
+
+    doc_len = cy_ota_flash_stats_to_json(doc, sizeof(doc));
+    if (doc_len == 0)
+    {
+        printf("\n Flash telemetry does not fit in %u bytes.\n", (unsigned int)sizeof(doc));
+        return;
+    }
+
+    telemetry_publish(mqtt_handle, "flash", doc, doc_len);
+}
+#endif
+
+#ifdef OTA_BENCH_ENABLE
+/*******************************************************************************
+ * Function Name: ota_storage_write_timed
+ *******************************************************************************
+ * Summary:
+ *  Storage write callback of the benchmark, times ota_storage_write().
+ *
+ *******************************************************************************/
+static cy_rslt_t ota_storage_write_timed(cy_ota_context_ptr ctx_ptr, cy_ota_storage_write_info_t *chunk_info)
+{
+    TickType_t start = ota_bench_start();
+    cy_rslt_t result;
+
+    result = ota_storage_write(ctx_ptr, chunk_info);
+    ota_bench_end(OTA_BENCH_STAGE_WRITE, start, chunk_info->size);
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: ota_storage_verify_timed
+ *******************************************************************************
+ * Summary:
+ *  Storage verify callback of the benchmark, times ota_storage_verify() and
+ *  prints the summary of the update.
+ *
+ *******************************************************************************/
+static cy_rslt_t ota_storage_verify_timed(cy_ota_context_ptr ctx_ptr)
+{
+    TickType_t start = ota_bench_start();
+    cy_rslt_t result;
+
+    result = ota_storage_verify(ctx_ptr);
+    ota_bench_end(OTA_BENCH_STAGE_VERIFY, start, 0);
+    ota_bench_report(NULL, (CY_RSLT_SUCCESS == result) ? "success" : "failure");
+
+    return result;
+}
+#endif
+
+#ifdef OTA_RESUME_ENABLE
+/*******************************************************************************
+ * Function Name: ota_resume_finish
+ *******************************************************************************
+ * Summary:
+ *  Completes a resumed download once every chunk is in the secondary slot.
+ *  The OTA agent only counts the chunks of the current session and would wait
+ *  for the rest, so the image is verified here and the agent is stopped. Its
+ *  result phase is skipped; the result is logged and published as telemetry
+ *  instead, then the device is reset for MCUboot to install the image if
+ *  reboot_upon_completion is set.
+ *
+ *******************************************************************************/
+static void ota_resume_finish(void)
+{
+    const char *result_string;
+    char doc[64];
+    int doc_len;
+    cy_rslt_t result;
+
+    chunk_window_stop();
+
+    printf("\n Resumed download complete, verifying the image.\n");
+    result = ota_storage_verify(ota_context);
+    result_string = (CY_RSLT_SUCCESS == result) ? "Success" : "Failure";
+    if (CY_RSLT_SUCCESS == result)
+    {
+        APP_LOG_INFO(">> APP RESUMED OTA SUCCESS\n\n");
+    }
+    else
+    {
+        APP_LOG_ERR(">> APP RESUMED OTA FAILURE verify:0x%lx\n\n", (unsigned long)result);
+    }
+
+#ifdef OTA_FLASH_STATS_ENABLE
+    ota_report_flash_stats(ota_resume_mqtt);
+#endif
+#ifdef OTA_BENCH_ENABLE
+    ota_bench_report(ota_resume_mqtt, (CY_RSLT_SUCCESS == result) ? "success" : "failure");
+#endif
+    doc_len = snprintf(doc, sizeof(doc), "{\"Result\":\"%s\",\"Resumed\":1}", result_string);
+    if (ota_resume_mqtt != NULL)
+    {
+        (void)telemetry_publish(ota_resume_mqtt, "result", doc, (size_t)doc_len);
+    }
+    ota_resume_mqtt = NULL;
+
+    if (CY_RSLT_SUCCESS != result)
+    {
+        /* The record is gone, the OTA agent retries with a full download */
+        return;
+    }
+
+    (void)cy_ota_agent_stop(&ota_context);
+
+    if (!ota_agent_params.reboot_upon_completion)
+    {
+        printf("\n The new image is installed at the next reset.\n");
+        return;
+    }
+
+    printf("\n Resetting to install the new image.\n");
+    vTaskDelay(pdMS_TO_TICKS(100));
+    NVIC_SystemReset();
+}
+#endif
 
 /*******************************************************************************
  * Function Name: ota_task_init
@@ -451,8 +1179,8 @@ cy_ota_callback_results_t ota_callback(cy_ota_cb_struct_t *cb_data)
  *******************************************************************************/
 void ota_task_init(void)
 {
-    xTaskCreate(ota_task, "OTA TASK", OTA_TASK_STACK_SIZE, NULL,
-                OTA_TASK_PRIORITY, &ota_task_handle);
+    ota_task_handle = xTaskCreateStatic(ota_task, "OTA TASK", OTA_TASK_STACK_SIZE, NULL,
+                                        OTA_TASK_PRIORITY, ota_task_stack, &ota_task_tcb);
 }
 
 
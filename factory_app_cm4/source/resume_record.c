@@ -0,0 +1,649 @@
+/******************************************************************************
+* File Name: resume_record.c
+*
+* Description: This file contains the persisted download progress record. The
+* record identifies the image being downloaded and holds a bitmap of the chunks
+* already written to the secondary slot, so an interrupted download continues
+* where it stopped, also after a reset. Records are appended to a log in two
+* sectors of external flash and protected by a CRC, so a record that was being
+* written during a reset is ignored and the previous one is used.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cyhal.h"
+#include "cybsp.h"
+#include "cy_retarget_io.h"
+#include "resume_record.h"
+#include "flash_service.h"
+#include "cy_ota_flash.h"
+#include "cy_ota_crc32.h"
+#include "json_field.h"
+/* FreeRTOS */
+#include <FreeRTOS.h>
+#include <task.h>
+#include <semphr.h>
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define RESUME_RECORD_MAGIC                 (0x5345524Fu)   /* "ORES" */
+#define RESUME_RECORD_VERSION_LEN           (16u)
+#define RESUME_RECORD_WORDS                 CY_OTA_RANGE_WORDS(CHUNK_WINDOW_MAX_CHUNKS)
+
+/* Largest flash space one record may take, a multiple of the program size */
+#define RESUME_RECORD_BUF_SIZE              (512u)
+
+#define RESUME_RECORD_SECTORS               (2u)
+
+/*******************************************************************************
+* Data Structures
+********************************************************************************/
+typedef struct
+{
+    uint32_t                    magic;
+    uint32_t                    seq;
+    char                        version[RESUME_RECORD_VERSION_LEN];
+    uint32_t                    image_crc;
+    uint32_t                    total_size;     /* 0 - nothing to resume */
+    uint32_t                    chunk_size;
+    uint32_t                    received[RESUME_RECORD_WORDS];
+    uint32_t                    crc;            /* CRC32 of everything above */
+} resume_record_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static bool resume_record_load(uint32_t addr, resume_record_t *rec);
+static bool resume_record_is_blank(uint32_t addr, uint32_t len);
+static cy_rslt_t resume_record_write(void);
+static void resume_record_set_size(uint32_t total_size);
+static bool resume_record_drop_dirty(void);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Protects the state below, storage and callback calls of the OTA agent may
+ * come from different tasks. The chunk bitmap, resume_pending and
+ * resume_dirty are also updated by the flash service task, in critical
+ * sections. */
+static SemaphoreHandle_t resume_mutex;
+static StaticSemaphore_t resume_mutex_buffer;
+
+/* Latest record, and the tracker of its chunk bitmap. The tracker works
+ * directly on resume_rec.received. */
+static resume_record_t resume_rec;
+static cy_ota_range_t resume_range;
+
+/* Chunks committed since the record was last written */
+static volatile uint32_t resume_pending;
+static volatile bool resume_dirty;
+
+/* Record log geometry, 0 if the log is not usable */
+static uint32_t resume_sector_size;
+static uint32_t resume_slot_size;
+
+/* Sector and slot the next record is written to */
+static uint32_t resume_sector;
+static uint32_t resume_slot;
+
+/* Identity of the image offered by the job document */
+static bool resume_job_valid;
+static char resume_job_version[RESUME_RECORD_VERSION_LEN];
+static uint32_t resume_job_size;
+static uint32_t resume_job_crc;
+
+/* Flash slot of one record, also used to read back flash */
+static CY_ALIGN(4) uint8_t resume_buf[RESUME_RECORD_BUF_SIZE];
+
+/*******************************************************************************
+ * Function Name: resume_record_init
+ *******************************************************************************
+ * Summary:
+ *  Finds the latest valid record in the log. Must be called after the flash
+ *  service has been started.
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS on success, error code otherwise
+ *
+ *******************************************************************************/
+cy_rslt_t resume_record_init(void)
+{
+    resume_record_t rec;
+    uint32_t prog_size;
+    uint32_t addr;
+    uint32_t sector;
+    uint32_t slot;
+    bool found = false;
+
+    resume_mutex = xSemaphoreCreateMutexStatic(&resume_mutex_buffer);
+    if (resume_mutex == NULL)
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    resume_sector_size = (uint32_t)cy_ota_mem_get_erase_size(CY_OTA_MEM_TYPE_EXTERNAL_FLASH, OTA_RESUME_RECORD_ADDR);
+    prog_size = (uint32_t)cy_ota_mem_get_prog_size(CY_OTA_MEM_TYPE_EXTERNAL_FLASH, OTA_RESUME_RECORD_ADDR);
+    if ((resume_sector_size == 0) || (prog_size == 0))
+    {
+        resume_sector_size = 0;
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    resume_slot_size = ((sizeof(resume_record_t) + prog_size - 1u) / prog_size) * prog_size;
+    if (resume_slot_size > sizeof(resume_buf))
+    {
+        printf("\n Resume record does not fit a %lu byte program page.\n", (unsigned long)prog_size);
+        resume_sector_size = 0;
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    memset(&resume_rec, 0, sizeof(resume_rec));
+    cy_ota_range_init(&resume_range, resume_rec.received, CHUNK_WINDOW_MAX_CHUNKS);
+
+    for (sector = 0; sector < RESUME_RECORD_SECTORS; sector++)
+    {
+        for (slot = 0; slot < (resume_sector_size / resume_slot_size); slot++)
+        {
+            addr = OTA_RESUME_RECORD_ADDR + (sector * resume_sector_size) + (slot * resume_slot_size);
+            if (!resume_record_load(addr, &rec))
+            {
+                /* Records are appended, the rest of the sector is unused */
+                break;
+            }
+
+            if (!found || ((int32_t)(rec.seq - resume_rec.seq) > 0))
+            {
+                resume_rec = rec;
+                resume_sector = sector;
+                resume_slot = slot + 1u;
+                found = true;
+            }
+        }
+    }
+
+    /* Resetting the tracker clears the bitmap, put the loaded one back and
+     * count it. A record that does not fit the tracker cannot be resumed. */
+    memcpy(rec.received, resume_rec.received, sizeof(rec.received));
+    if ((resume_rec.chunk_size == OTA_CHUNK_SIZE) &&
+        cy_ota_range_reset(&resume_range, OTA_CHUNK_SIZE, resume_rec.total_size))
+    {
+        memcpy(resume_rec.received, rec.received, sizeof(resume_rec.received));
+        cy_ota_range_sync(&resume_range);
+    }
+    else
+    {
+        resume_record_set_size(0);
+    }
+
+    if (found && (resume_rec.total_size != 0))
+    {
+        printf("Resume record: version %s, %lu bytes, sequence %lu\n", resume_rec.version,
+               (unsigned long)resume_rec.total_size, (unsigned long)resume_rec.seq);
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: resume_record_set_job
+ *******************************************************************************
+ * Summary:
+ *  Takes the identity of the offered image from the job document.
+ *
+ * Parameters:
+ *  const char *json_doc : Job document
+ *
+ *******************************************************************************/
+void resume_record_set_job(const char *json_doc)
+{
+    char value[16];
+
+    resume_job_valid = false;
+    if ((json_doc == NULL) ||
+        !json_field_get(json_doc, "Version", resume_job_version, sizeof(resume_job_version)))
+    {
+        return;
+    }
+
+    if (!json_field_get(json_doc, "ImageSize", value, sizeof(value)))
+    {
+        return;
+    }
+    resume_job_size = (uint32_t)strtoul(value, NULL, 10);
+
+    if (!json_field_get(json_doc, "ImageCRC", value, sizeof(value)))
+    {
+        return;
+    }
+    resume_job_crc = (uint32_t)strtoul(value, NULL, 16);
+
+    resume_job_valid = (resume_job_size != 0) &&
+                       (((resume_job_size + OTA_CHUNK_SIZE - 1u) / OTA_CHUNK_SIZE) <= CHUNK_WINDOW_MAX_CHUNKS);
+}
+
+/*******************************************************************************
+ * Function Name: resume_record_open
+ *******************************************************************************
+ * Summary:
+ *  Called when the OTA storage is opened. Continues the recorded download if
+ *  the job offers the same image, otherwise starts a new record. The new
+ *  record is written before the caller erases the slot, so a record never
+ *  describes chunks of another image.
+ *
+ * Return:
+ *  bool : true if the download is resumed
+ *
+ *******************************************************************************/
+bool resume_record_open(void)
+{
+    bool resumed = false;
+
+    if (resume_sector_size == 0)
+    {
+        return false;
+    }
+
+    xSemaphoreTake(resume_mutex, portMAX_DELAY);
+
+    if (resume_job_valid && (resume_rec.total_size == resume_job_size) &&
+        (resume_rec.image_crc == resume_job_crc) && (resume_rec.chunk_size == OTA_CHUNK_SIZE) &&
+        (strncmp(resume_rec.version, resume_job_version, RESUME_RECORD_VERSION_LEN) == 0))
+    {
+        resumed = resume_record_drop_dirty();
+    }
+
+    if (!resumed)
+    {
+        memcpy(resume_rec.version, resume_job_version, RESUME_RECORD_VERSION_LEN);
+        resume_rec.image_crc = resume_job_crc;
+        resume_record_set_size(resume_job_valid ? resume_job_size : 0u);
+        resume_rec.chunk_size = OTA_CHUNK_SIZE;
+        resume_dirty = true;
+    }
+
+    resume_pending = 0;
+    if (resume_dirty && (CY_RSLT_SUCCESS != resume_record_write()))
+    {
+        /* Without a persisted record, resuming later would be unsafe */
+        resume_record_set_size(0);
+        resumed = false;
+    }
+
+    xSemaphoreGive(resume_mutex);
+
+    return resumed;
+}
+
+/*******************************************************************************
+ * Function Name: resume_record_range
+ *******************************************************************************
+ * Summary:
+ *  Returns the chunks in the secondary slot, image size 0 if there is no
+ *  recorded image.
+ *
+ *******************************************************************************/
+const cy_ota_range_t *resume_record_range(void)
+{
+    return &resume_range;
+}
+
+/*******************************************************************************
+ * Function Name: resume_record_commit
+ *******************************************************************************
+ * Summary:
+ *  Marks chunks as written. Does not access the flash: queued writes are
+ *  committed by the flash service task, which a task holding the lock may be
+ *  waiting for. The record is written by resume_record_checkpoint().
+ *
+ * Parameters:
+ *  const cy_ota_storage_write_info_t *chunk_info : Chunks that were written
+ *
+ *******************************************************************************/
+void resume_record_commit(const cy_ota_storage_write_info_t *chunk_info)
+{
+    bool matches;
+
+    if ((resume_rec.total_size == 0) || ((chunk_info->offset % OTA_CHUNK_SIZE) != 0))
+    {
+        return;
+    }
+
+    taskENTER_CRITICAL();
+    matches = (chunk_info->total_size == resume_rec.total_size);
+    if (!matches)
+    {
+        /* Not the image the job document announced, nothing to resume */
+        (void)cy_ota_range_reset(&resume_range, OTA_CHUNK_SIZE, 0);
+        resume_rec.total_size = 0;
+        resume_pending = OTA_RESUME_SAVE_CHUNKS;
+        resume_dirty = true;
+    }
+    else if (cy_ota_range_add(&resume_range, chunk_info->offset, chunk_info->size) != 0)
+    {
+        resume_pending++;
+        resume_dirty = true;
+    }
+    taskEXIT_CRITICAL();
+
+    if (!matches)
+    {
+        printf("\n Image size %lu does not match the job, download will not be resumable.\n",
+               (unsigned long)chunk_info->total_size);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: resume_record_checkpoint
+ *******************************************************************************
+ * Summary:
+ *  Writes the record once OTA_RESUME_SAVE_CHUNKS chunks have been committed
+ *  since it was last written.
+ *
+ *******************************************************************************/
+void resume_record_checkpoint(void)
+{
+    if ((resume_mutex == NULL) || (resume_pending < OTA_RESUME_SAVE_CHUNKS))
+    {
+        return;
+    }
+
+    xSemaphoreTake(resume_mutex, portMAX_DELAY);
+    if (resume_pending >= OTA_RESUME_SAVE_CHUNKS)
+    {
+        (void)resume_record_write();
+    }
+    xSemaphoreGive(resume_mutex);
+}
+
+/*******************************************************************************
+ * Function Name: resume_record_complete
+ *******************************************************************************
+ * Summary:
+ *  Checks whether every chunk of the recorded image has been written.
+ *
+ *******************************************************************************/
+bool resume_record_complete(void)
+{
+    return cy_ota_range_complete(&resume_range);
+}
+
+/*******************************************************************************
+ * Function Name: resume_record_save
+ *******************************************************************************
+ * Summary:
+ *  Writes the record if chunks have been committed since the last write.
+ *
+ *******************************************************************************/
+void resume_record_save(void)
+{
+    if (resume_mutex == NULL)
+    {
+        return;
+    }
+
+    xSemaphoreTake(resume_mutex, portMAX_DELAY);
+    if (resume_dirty)
+    {
+        (void)resume_record_write();
+    }
+    xSemaphoreGive(resume_mutex);
+}
+
+/*******************************************************************************
+ * Function Name: resume_record_clear
+ *******************************************************************************
+ * Summary:
+ *  Writes a record without an image, the next download starts from the
+ *  beginning.
+ *
+ *******************************************************************************/
+void resume_record_clear(void)
+{
+    if (resume_mutex == NULL)
+    {
+        return;
+    }
+
+    xSemaphoreTake(resume_mutex, portMAX_DELAY);
+    if (resume_rec.total_size != 0)
+    {
+        resume_record_set_size(0);
+        resume_dirty = true;
+        (void)resume_record_write();
+    }
+    xSemaphoreGive(resume_mutex);
+}
+
+/*******************************************************************************
+ * Function Name: resume_record_load
+ *******************************************************************************
+ * Summary:
+ *  Reads the record at addr. Returns false if the slot does not hold a
+ *  complete record.
+ *
+ *******************************************************************************/
+static bool resume_record_load(uint32_t addr, resume_record_t *rec)
+{
+    if (CY_RSLT_SUCCESS != flash_service_read(CY_OTA_MEM_TYPE_EXTERNAL_FLASH, addr, rec, sizeof(*rec)))
+    {
+        return false;
+    }
+
+    return (rec->magic == RESUME_RECORD_MAGIC) &&
+           (rec->crc == cy_ota_crc32(CY_OTA_CRC32_INIT, rec, offsetof(resume_record_t, crc)));
+}
+
+/*******************************************************************************
+ * Function Name: resume_record_is_blank
+ *******************************************************************************
+ * Summary:
+ *  Checks that len bytes of external flash at addr are erased.
+ *
+ *******************************************************************************/
+static bool resume_record_is_blank(uint32_t addr, uint32_t len)
+{
+    uint32_t n;
+    uint32_t i;
+
+    while (len > 0)
+    {
+        n = CY_MIN(len, sizeof(resume_buf));
+        if (CY_RSLT_SUCCESS != flash_service_read(CY_OTA_MEM_TYPE_EXTERNAL_FLASH, addr, resume_buf, n))
+        {
+            return false;
+        }
+
+        for (i = 0; i < n; i++)
+        {
+            if (resume_buf[i] != 0xFFu)
+            {
+                return false;
+            }
+        }
+        addr += n;
+        len -= n;
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: resume_record_write
+ *******************************************************************************
+ * Summary:
+ *  Appends the record to the log. When the current sector is full, the other
+ *  sector is erased and the log continues there; the previous record stays
+ *  valid until the new one has been written. Called with the lock held.
+ *
+ *******************************************************************************/
+static cy_rslt_t resume_record_write(void)
+{
+    resume_record_t *rec = (resume_record_t *)resume_buf;
+    uint32_t pending;
+    uint32_t addr;
+    cy_rslt_t result;
+
+    if (resume_sector_size == 0)
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    resume_rec.magic = RESUME_RECORD_MAGIC;
+    resume_rec.seq++;
+
+    addr = OTA_RESUME_RECORD_ADDR + (resume_sector * resume_sector_size) + (resume_slot * resume_slot_size);
+    if ((resume_slot >= (resume_sector_size / resume_slot_size)) || !resume_record_is_blank(addr, resume_slot_size))
+    {
+        resume_sector = (resume_sector + 1u) % RESUME_RECORD_SECTORS;
+        resume_slot = 0;
+        addr = OTA_RESUME_RECORD_ADDR + (resume_sector * resume_sector_size);
+
+        result = flash_service_erase(CY_OTA_MEM_TYPE_EXTERNAL_FLASH, addr, resume_sector_size);
+        if (CY_RSLT_SUCCESS != result)
+        {
+            printf("\n Erasing the resume record sector failed: 0x%lx\n", (unsigned long)result);
+            return result;
+        }
+    }
+
+    /* Chunks are only committed once the flash service has written them, so
+     * the copy never claims data that is not in flash */
+    memset(resume_buf, 0xFF, resume_slot_size);
+    taskENTER_CRITICAL();
+    memcpy(rec, &resume_rec, sizeof(resume_rec));
+    pending = resume_pending;
+    taskEXIT_CRITICAL();
+    rec->crc = cy_ota_crc32(CY_OTA_CRC32_INIT, rec, offsetof(resume_record_t, crc));
+
+    result = flash_service_write(CY_OTA_MEM_TYPE_EXTERNAL_FLASH, addr, resume_buf, resume_slot_size);
+    resume_slot++;
+    if (CY_RSLT_SUCCESS != result)
+    {
+        printf("\n Writing the resume record failed: 0x%lx\n", (unsigned long)result);
+        return result;
+    }
+
+    /* Chunks committed during the write go into the next record */
+    taskENTER_CRITICAL();
+    resume_pending -= pending;
+    resume_dirty = (resume_pending != 0);
+    taskEXIT_CRITICAL();
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: resume_record_set_size
+ *******************************************************************************
+ * Summary:
+ *  Sets the image size of the record and clears its chunks. Size 0 means
+ *  there is nothing to resume.
+ *
+ *******************************************************************************/
+static void resume_record_set_size(uint32_t total_size)
+{
+    taskENTER_CRITICAL();
+    if (!cy_ota_range_reset(&resume_range, OTA_CHUNK_SIZE, total_size))
+    {
+        (void)cy_ota_range_reset(&resume_range, OTA_CHUNK_SIZE, 0);
+    }
+    resume_rec.total_size = resume_range.total_size;
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: resume_record_drop_dirty
+ *******************************************************************************
+ * Summary:
+ *  A chunk that was being written during a reset may be partially programmed
+ *  and cannot be written again without an erase. Every gap in the record is
+ *  checked; if a chunk in it is not blank, its sectors are erased and all
+ *  chunks in them are downloaded again. Called with the lock held.
+ *
+ * Return:
+ *  bool : false if the slot cannot be repaired, the download starts over
+ *
+ *******************************************************************************/
+static bool resume_record_drop_dirty(void)
+{
+    uint32_t offset = 0;
+    uint32_t gap_offset;
+    uint32_t gap_len;
+    uint32_t erase_size;
+    uint32_t start;
+    uint32_t end;
+
+    while (cy_ota_range_next_gap(&resume_range, offset, &gap_offset, &gap_len))
+    {
+        /* Chunks of a gap are checked one at a time, a dirty one is erased
+         * together with its neighbours in the same sectors */
+        offset = gap_offset + OTA_CHUNK_SIZE;
+        if (resume_record_is_blank(OTA_RESUME_SLOT_ADDR + gap_offset, CY_MIN(gap_len, OTA_CHUNK_SIZE)))
+        {
+            continue;
+        }
+
+        erase_size = (uint32_t)cy_ota_mem_get_erase_size(CY_OTA_MEM_TYPE_EXTERNAL_FLASH,
+                                                          OTA_RESUME_SLOT_ADDR + gap_offset);
+        if (erase_size == 0)
+        {
+            return false;
+        }
+
+        start = (OTA_RESUME_SLOT_ADDR + gap_offset) & ~(erase_size - 1u);
+        end = (OTA_RESUME_SLOT_ADDR + gap_offset + OTA_CHUNK_SIZE + erase_size - 1u) & ~(erase_size - 1u);
+
+        /* Never erase outside of the secondary slot */
+        if ((start < OTA_RESUME_SLOT_ADDR) || (end > (OTA_RESUME_SLOT_ADDR + OTA_RESUME_SLOT_SIZE)))
+        {
+            return false;
+        }
+
+        if (CY_RSLT_SUCCESS != flash_service_erase(CY_OTA_MEM_TYPE_EXTERNAL_FLASH, start, end - start))
+        {
+            return false;
+        }
+
+        cy_ota_range_remove(&resume_range, start - OTA_RESUME_SLOT_ADDR, end - start);
+        offset = end - OTA_RESUME_SLOT_ADDR;
+        resume_dirty = true;
+    }
+
+    return true;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,112 @@
+/******************************************************************************
+* File Name: resume_record.h
+*
+* Description: This file contains the declarations of the persisted download
+* progress record used to resume OTA downloads.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef SOURCE_RESUME_RECORD_H_
+#define SOURCE_RESUME_RECORD_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "cy_ota_api.h"
+#include "chunk_window.h"
+#include "cy_ota_range.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Secondary slot the image is downloaded to. Set from the flash map in the
+ * Makefile. */
+#ifndef OTA_RESUME_SLOT_ADDR
+#define OTA_RESUME_SLOT_ADDR                (0x18200200u)
+#endif
+
+#ifndef OTA_RESUME_SLOT_SIZE
+#define OTA_RESUME_SLOT_SIZE                (0x001C0000u)
+#endif
+
+/* Two erase sectors of external flash outside of all flash map areas that
+ * hold the record log */
+#ifndef OTA_RESUME_RECORD_ADDR
+#define OTA_RESUME_RECORD_ADDR              (0x184C0000u)
+#endif
+
+/* The record is written after this many new chunks and when the download is
+ * interrupted */
+#ifndef OTA_RESUME_SAVE_CHUNKS
+#define OTA_RESUME_SAVE_CHUNKS              (16u)
+#endif
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Loads the latest record from external flash */
+cy_rslt_t resume_record_init(void);
+
+/* Takes the image identity from the job document: "Version", "ImageSize" and
+ * "ImageCRC". Without them the download cannot be resumed. */
+void resume_record_set_job(const char *json_doc);
+
+/* Decides at storage open whether the download continues the recorded one.
+ * If it does, chunks whose flash is not blank any more are dropped from the
+ * record, and true is returned. Otherwise the record is restarted for the new
+ * image and false is returned. */
+bool resume_record_open(void);
+
+/* Chunks already in the secondary slot, for the chunk window */
+const cy_ota_range_t *resume_record_range(void);
+
+/* Marks chunks as written. Must only be called once the chunks are in flash,
+ * so the record never gets ahead of the data. The flash service calls it for
+ * every completed storage write. */
+void resume_record_commit(const cy_ota_storage_write_info_t *chunk_info);
+
+/* Writes the record every OTA_RESUME_SAVE_CHUNKS committed chunks. Must not be
+ * called from the flash service task. */
+void resume_record_checkpoint(void);
+
+/* True once every chunk of the image has been written */
+bool resume_record_complete(void);
+
+/* Writes the record if it has changed */
+void resume_record_save(void);
+
+/* Forgets the download, e.g. after the image has been verified */
+void resume_record_clear(void);
+
+#endif /* SOURCE_RESUME_RECORD_H_ */
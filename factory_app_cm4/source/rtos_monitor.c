@@ -0,0 +1,430 @@
+/******************************************************************************
+* File Name: rtos_monitor.c
+*
+* Description: This file contains the RTOS monitor task. It times the tasks with
+* the CPU cycle counter and prints their CPU use and stack margin, the heap
+* and the context switch rate at a fixed interval.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/* Header file includes */
+#include <stdio.h>
+#include <string.h>
+#if defined(__GNUC__) && !defined(__ARMCC_VERSION)
+#include <malloc.h>
+#endif
+#include "cyhal.h"
+#include "cybsp.h"
+#include "cy_retarget_io.h"
+#include "rtos_monitor.h"
+#include "telemetry.h"
+/* FreeRTOS */
+#include <FreeRTOS.h>
+#include <task.h>
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Above the idle task only, the report is not time critical */
+#define RTOS_MONITOR_TASK_STACK_SIZE        (configMINIMAL_STACK_SIZE * 4)
+#define RTOS_MONITOR_TASK_PRIORITY          (tskIDLE_PRIORITY + 1)
+
+#ifndef configIDLE_TASK_NAME
+#define configIDLE_TASK_NAME                "IDLE"
+#endif
+
+#define RTOS_MONITOR_JSON_APPEND(...)                                       \
+    do {                                                                    \
+        int n = snprintf(&buf[used], size - used, __VA_ARGS__);             \
+        if ((n < 0) || ((size_t)n >= (size - used))) { return 0u; }         \
+        used += (size_t)n;                                                  \
+    } while (0)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static void rtos_monitor_task(void *args);
+static void rtos_monitor_sample(void);
+static void rtos_monitor_heap(rtos_monitor_stats_t *stats);
+static void rtos_monitor_print(const rtos_monitor_stats_t *stats);
+static size_t rtos_monitor_to_json(const rtos_monitor_stats_t *stats, char *buf, size_t size);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Monitor task control block and stack */
+static StaticTask_t rtos_monitor_task_tcb;
+static StackType_t rtos_monitor_task_stack[RTOS_MONITOR_TASK_STACK_SIZE];
+
+/* Counted by traceTASK_SWITCHED_IN() */
+volatile uint32_t rtos_monitor_switches;
+
+/* Run time in us, extended from the cycle counter on every read */
+static uint32_t run_time_us;
+static uint32_t run_time_last_cycles;
+static uint32_t run_time_rest_cycles;
+static uint32_t run_time_cycles_per_us = 1u;
+
+/* Task states of the current and run times of the previous sample */
+static TaskStatus_t task_status[RTOS_MONITOR_MAX_TASKS];
+static UBaseType_t prev_numbers[RTOS_MONITOR_MAX_TASKS];
+static uint32_t prev_run_times[RTOS_MONITOR_MAX_TASKS];
+static UBaseType_t prev_count;
+static uint32_t prev_total;
+static uint32_t prev_switches;
+
+/* Last report, only changed with the scheduler suspended */
+static rtos_monitor_stats_t monitor_stats;
+
+/*******************************************************************************
+ * Function Name: rtos_monitor_init
+ *******************************************************************************
+ * Summary:
+ *  Creates the monitor task.
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS on success, error code otherwise
+ *
+ *******************************************************************************/
+cy_rslt_t rtos_monitor_init(void)
+{
+    if (NULL == xTaskCreateStatic(rtos_monitor_task, "RTOS MONITOR", RTOS_MONITOR_TASK_STACK_SIZE,
+                                  NULL, RTOS_MONITOR_TASK_PRIORITY, rtos_monitor_task_stack,
+                                  &rtos_monitor_task_tcb))
+    {
+        printf("\n Creating the RTOS monitor task failed.\n");
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: rtos_monitor_timer_init
+ *******************************************************************************
+ * Summary:
+ *  Starts the CPU cycle counter. Called by vTaskStartScheduler() through
+ *  portCONFIGURE_TIMER_FOR_RUN_TIME_STATS().
+ *
+ *******************************************************************************/
+void rtos_monitor_timer_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    run_time_cycles_per_us = CY_MAX(SystemCoreClock / 1000000u, 1u);
+    run_time_last_cycles = DWT->CYCCNT;
+}
+
+/*******************************************************************************
+ * Function Name: rtos_monitor_run_time
+ *******************************************************************************
+ * Summary:
+ *  Returns the run time in us. Called by the kernel on every context switch
+ *  through portGET_RUN_TIME_COUNTER_VALUE(), from tasks and from PendSV.
+ *
+ * Return:
+ *  uint32_t : us since the scheduler started, wraps after 71 minutes
+ *
+ *******************************************************************************/
+uint32_t rtos_monitor_run_time(void)
+{
+    UBaseType_t mask;
+    uint32_t now;
+    uint32_t cycles;
+    uint32_t result;
+
+    mask = portSET_INTERRUPT_MASK_FROM_ISR();
+    now = DWT->CYCCNT;
+    cycles = (now - run_time_last_cycles) + run_time_rest_cycles;
+    run_time_last_cycles = now;
+    run_time_us += cycles / run_time_cycles_per_us;
+    run_time_rest_cycles = cycles % run_time_cycles_per_us;
+    result = run_time_us;
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(mask);
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: rtos_monitor_get_stats
+ *******************************************************************************
+ * Summary:
+ *  Copies the last report.
+ *
+ * Parameters:
+ *  rtos_monitor_stats_t *stats : Receives the report
+ *
+ *******************************************************************************/
+void rtos_monitor_get_stats(rtos_monitor_stats_t *stats)
+{
+    vTaskSuspendAll();
+    *stats = monitor_stats;
+    (void)xTaskResumeAll();
+}
+
+/*******************************************************************************
+ * Function Name: rtos_monitor_publish
+ *******************************************************************************
+ * Summary:
+ *  Publishes the last report as a JSON document to TELEMETRY_TOPIC_PREFIX
+ *  "rtos".
+ *
+ * Parameters:
+ *  cy_mqtt_t mqtt_handle : Connected MQTT handle
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS on success, error code otherwise
+ *
+ *******************************************************************************/
+cy_rslt_t rtos_monitor_publish(cy_mqtt_t mqtt_handle)
+{
+    static rtos_monitor_stats_t stats;
+    static char doc[TELEMETRY_DOC_SIZE];
+    size_t doc_len;
+
+    rtos_monitor_get_stats(&stats);
+    if (stats.period_ms == 0)
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    doc_len = rtos_monitor_to_json(&stats, doc, sizeof(doc));
+    if (doc_len == 0)
+    {
+        printf("\n RTOS telemetry does not fit in %u bytes.\n", (unsigned int)sizeof(doc));
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    return telemetry_publish(mqtt_handle, "rtos", doc, doc_len);
+}
+
+/*******************************************************************************
+ * Function Name: rtos_monitor_task
+ *******************************************************************************
+ * Summary:
+ *  Samples and prints the task states every RTOS_MONITOR_PERIOD_MS.
+ *
+ * Parameters:
+ *  void *args : Task parameter defined during task creation (unused)
+ *
+ *******************************************************************************/
+static void rtos_monitor_task(void *args)
+{
+    static rtos_monitor_stats_t stats;
+    TickType_t wake = xTaskGetTickCount();
+
+    (void)args;
+
+    /* The first sample only sets the start of the first period */
+    rtos_monitor_sample();
+
+    while (true)
+    {
+        vTaskDelayUntil(&wake, pdMS_TO_TICKS(RTOS_MONITOR_PERIOD_MS));
+
+        rtos_monitor_sample();
+        rtos_monitor_get_stats(&stats);
+        rtos_monitor_print(&stats);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: rtos_monitor_sample
+ *******************************************************************************
+ * Summary:
+ *  Reads the state of all tasks and updates the report with the CPU use of
+ *  every task since the previous sample.
+ *
+ *******************************************************************************/
+static void rtos_monitor_sample(void)
+{
+    static rtos_monitor_stats_t stats;
+    configRUN_TIME_COUNTER_TYPE total;
+    UBaseType_t count;
+    uint32_t period;
+    uint32_t delta;
+    uint32_t switches;
+    uint32_t idle = 0;
+    UBaseType_t i;
+    UBaseType_t j;
+
+    count = uxTaskGetSystemState(task_status, RTOS_MONITOR_MAX_TASKS, &total);
+    switches = rtos_monitor_switches;
+    if (count == 0)
+    {
+        printf("\n RTOS monitor: more than %u tasks.\n", (unsigned int)RTOS_MONITOR_MAX_TASKS);
+        return;
+    }
+
+    rtos_monitor_get_stats(&stats);
+    period = (uint32_t)total - prev_total;
+
+    for (i = 0; i < count; i++)
+    {
+        rtos_monitor_task_t *task = &stats.tasks[i];
+
+        /* A task that did not exist at the previous sample ran since its start */
+        delta = (uint32_t)task_status[i].ulRunTimeCounter;
+        for (j = 0; j < prev_count; j++)
+        {
+            if (prev_numbers[j] == task_status[i].xTaskNumber)
+            {
+                delta -= prev_run_times[j];
+                break;
+            }
+        }
+
+        strncpy(task->name, task_status[i].pcTaskName, sizeof(task->name) - 1u);
+        task->name[sizeof(task->name) - 1u] = '\0';
+        task->priority = (uint32_t)task_status[i].uxCurrentPriority;
+        task->cpu_permille = (period != 0) ? (uint32_t)(((uint64_t)delta * 1000u) / period) : 0u;
+        task->stack_free = (uint32_t)task_status[i].usStackHighWaterMark * sizeof(StackType_t);
+
+        if (0 == strcmp(task_status[i].pcTaskName, configIDLE_TASK_NAME))
+        {
+            idle = task->cpu_permille;
+        }
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        prev_numbers[i] = task_status[i].xTaskNumber;
+        prev_run_times[i] = (uint32_t)task_status[i].ulRunTimeCounter;
+    }
+    prev_count = count;
+
+    stats.period_ms = (prev_total != 0) ? (period / 1000u) : 0u;
+    stats.cpu_permille = (idle < 1000u) ? (1000u - idle) : 0u;
+    stats.switches = switches - prev_switches;
+    stats.task_count = (uint32_t)count;
+    rtos_monitor_heap(&stats);
+
+    prev_total = (uint32_t)total;
+    prev_switches = switches;
+
+    vTaskSuspendAll();
+    monitor_stats = stats;
+    (void)xTaskResumeAll();
+}
+
+/*******************************************************************************
+ * Function Name: rtos_monitor_heap
+ *******************************************************************************
+ * Summary:
+ *  Fills in the heap use. With heap_3 FreeRTOS allocates from the newlib
+ *  heap, which takes what it needs from the heap section of the linker script
+ *  and keeps its own list of freed blocks.
+ *
+ *******************************************************************************/
+static void rtos_monitor_heap(rtos_monitor_stats_t *stats)
+{
+#if defined(__GNUC__) && !defined(__ARMCC_VERSION)
+    extern uint8_t __HeapBase[];
+    extern uint8_t __HeapLimit[];
+    struct mallinfo info = mallinfo();
+
+    stats->heap_size = (uint32_t)(__HeapLimit - __HeapBase);
+    stats->heap_free = stats->heap_size - (uint32_t)info.arena + (uint32_t)info.fordblks;
+    if ((stats->heap_min_free == 0) || (stats->heap_free < stats->heap_min_free))
+    {
+        stats->heap_min_free = stats->heap_free;
+    }
+#else
+    (void)stats;
+#endif
+}
+
+/*******************************************************************************
+ * Function Name: rtos_monitor_print
+ *******************************************************************************
+ * Summary:
+ *  Prints a report to the debug UART.
+ *
+ *******************************************************************************/
+static void rtos_monitor_print(const rtos_monitor_stats_t *stats)
+{
+    uint32_t i;
+
+    printf("\nRTOS monitor: CPU %lu.%lu%% in %lu ms, %lu context switches, heap %lu of %lu bytes free (min %lu)\n",
+           (unsigned long)(stats->cpu_permille / 10u), (unsigned long)(stats->cpu_permille % 10u),
+           (unsigned long)stats->period_ms, (unsigned long)stats->switches,
+           (unsigned long)stats->heap_free, (unsigned long)stats->heap_size,
+           (unsigned long)stats->heap_min_free);
+    printf("  %-16s %4s %7s %10s\n", "task", "prio", "cpu %", "stack free");
+    for (i = 0; i < stats->task_count; i++)
+    {
+        printf("  %-16s %4lu %5lu.%lu %10lu\n", stats->tasks[i].name,
+               (unsigned long)stats->tasks[i].priority,
+               (unsigned long)(stats->tasks[i].cpu_permille / 10u),
+               (unsigned long)(stats->tasks[i].cpu_permille % 10u),
+               (unsigned long)stats->tasks[i].stack_free);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: rtos_monitor_to_json
+ *******************************************************************************
+ * Summary:
+ *  Formats a report as a JSON document.
+ *
+ * Return:
+ *  size_t : Length of the document, 0 if it does not fit
+ *
+ *******************************************************************************/
+static size_t rtos_monitor_to_json(const rtos_monitor_stats_t *stats, char *buf, size_t size)
+{
+    size_t used = 0;
+    uint32_t i;
+
+    RTOS_MONITOR_JSON_APPEND("{\"period_ms\":%lu,\"cpu_permille\":%lu,\"switches\":%lu,"
+                             "\"heap\":{\"size\":%lu,\"free\":%lu,\"min_free\":%lu},\"tasks\":{",
+                             (unsigned long)stats->period_ms, (unsigned long)stats->cpu_permille,
+                             (unsigned long)stats->switches, (unsigned long)stats->heap_size,
+                             (unsigned long)stats->heap_free, (unsigned long)stats->heap_min_free);
+    for (i = 0; i < stats->task_count; i++)
+    {
+        RTOS_MONITOR_JSON_APPEND("%s\"%s\":{\"prio\":%lu,\"cpu_permille\":%lu,\"stack_free\":%lu}",
+                                 (i == 0) ? "" : ",", stats->tasks[i].name,
+                                 (unsigned long)stats->tasks[i].priority,
+                                 (unsigned long)stats->tasks[i].cpu_permille,
+                                 (unsigned long)stats->tasks[i].stack_free);
+    }
+    RTOS_MONITOR_JSON_APPEND("}}");
+
+    return used;
+}
+
+/* [] END OF FILE */
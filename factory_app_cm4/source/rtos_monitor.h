@@ -0,0 +1,108 @@
+/******************************************************************************
+* File Name: rtos_monitor.h
+*
+* Description: This file contains the declarations of the RTOS monitor, which
+* reports the CPU use and stack margin of every task, the heap and the
+* context switch rate.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef SOURCE_RTOS_MONITOR_H_
+#define SOURCE_RTOS_MONITOR_H_
+
+#include <stdint.h>
+#include "cy_result.h"
+#include "cy_mqtt_api.h"
+#include <FreeRTOS.h>
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Interval of the report. The cycle counter behind the run time wraps after
+ * 2^32 CPU cycles (28 s at 150 MHz) and is extended on every read, so the
+ * monitor must read it more often than that. */
+#ifndef RTOS_MONITOR_PERIOD_MS
+#define RTOS_MONITOR_PERIOD_MS              (10000u)
+#endif
+
+#if (RTOS_MONITOR_PERIOD_MS > 20000u)
+#error "RTOS_MONITOR_PERIOD_MS must not exceed 20000"
+#endif
+
+/* Most tasks that are reported */
+#ifndef RTOS_MONITOR_MAX_TASKS
+#define RTOS_MONITOR_MAX_TASKS              (16u)
+#endif
+
+/*******************************************************************************
+* Data Structures
+********************************************************************************/
+typedef struct
+{
+    char                        name[configMAX_TASK_NAME_LEN];
+    uint32_t                    priority;
+    uint32_t                    cpu_permille;   /* Share of the last period */
+    uint32_t                    stack_free;     /* Bytes never used since the start */
+} rtos_monitor_task_t;
+
+typedef struct
+{
+    uint32_t                    period_ms;      /* 0 before the first report */
+    uint32_t                    cpu_permille;   /* All tasks but the idle task */
+    uint32_t                    switches;       /* Context switches in the period */
+    uint32_t                    heap_size;
+    uint32_t                    heap_free;
+    uint32_t                    heap_min_free;  /* Lowest heap_free of all reports */
+    uint32_t                    task_count;
+    rtos_monitor_task_t         tasks[RTOS_MONITOR_MAX_TASKS];
+} rtos_monitor_stats_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Starts the monitor task, which prints a report every RTOS_MONITOR_PERIOD_MS */
+cy_rslt_t rtos_monitor_init(void);
+
+/* Copies the last report */
+void rtos_monitor_get_stats(rtos_monitor_stats_t *stats);
+
+/* Publishes the last report as a JSON document to TELEMETRY_TOPIC_PREFIX "rtos" */
+cy_rslt_t rtos_monitor_publish(cy_mqtt_t mqtt_handle);
+
+/* Run time counter of FreeRTOS, see FreeRTOSConfig.h */
+void rtos_monitor_timer_init(void);
+uint32_t rtos_monitor_run_time(void);
+
+#endif /* SOURCE_RTOS_MONITOR_H_ */
@@ -44,6 +44,10 @@
 #include "ota_task.h"
 #include "led_task.h"
 #include "cycfg_pins.h"
+#ifdef EVENT_TRACE_ENABLE
+/* Dumped on further button presses */
+#include "event_trace.h"
+#endif
 
 /* FreeRTOS header file */
 #include <FreeRTOS.h>
@@ -68,6 +72,8 @@
 ********************************************************************************/
 /* State Mgr handle */
 static TaskHandle_t state_mgr_task_handle;
+static StaticTask_t state_mgr_task_tcb;
+static StackType_t state_mgr_task_stack[STATE_MGR_TASK_STACK_SIZE];
 
 /*******************************************************************************
 * Function Prototypes
@@ -90,8 +96,9 @@ cyhal_gpio_callback_data_t cb_data =
 void state_mgr_task_init(void)
 {
     /* Create the tasks */
-    xTaskCreate(state_mgr, "STATE MGR", STATE_MGR_TASK_STACK_SIZE, NULL,
-                STATE_MGR_TASK_PRIORITY, &state_mgr_task_handle);
+    state_mgr_task_handle = xTaskCreateStatic(state_mgr, "STATE MGR", STATE_MGR_TASK_STACK_SIZE, NULL,
+                                              STATE_MGR_TASK_PRIORITY, state_mgr_task_stack,
+                                              &state_mgr_task_tcb);
 }
 
 /*******************************************************************************
@@ -124,7 +131,8 @@ static void user_button_callback(void *handler_arg, cyhal_gpio_event_t event)
  * Summary:
  *  It starts the LED task immediately on start.
  *  Waits for the user button events and starts the OTA task, when the
- *  user button event is detected and then suspends itself.
+ *  user button event is detected and then suspends itself. With
+ *  EVENT_TRACE_ENABLE it dumps the event trace on every further press instead.
  *
  * Parameters:
  *  *args : Task parameter defined during task creation (unused)
@@ -180,10 +188,26 @@ static void state_mgr(void *args)
     /* start the OTA task */
     ota_task_init();
 
+#ifdef EVENT_TRACE_ENABLE
+    printf("\n****Press the user button to dump the event trace****\n");
+
+    while (true)
+    {
+        event_result = xTaskNotifyWait(pdFALSE, ULONG_MAX, &notified_value, portMAX_DELAY);
+        if ((event_result == pdPASS) && (notified_value & USER_EVENT_DETECT_FLAG))
+        {
+            event_trace_dump();
+
+            /* Drop the presses and bounces seen during the dump */
+            (void)xTaskNotifyWait(pdFALSE, ULONG_MAX, &notified_value, 0);
+        }
+    }
+#else
     printf("%s task entering IDLE state...\n\n",__func__);
 
     /* suspend the task */
     vTaskSuspend( NULL );
+#endif
 }
 
 /* [] END OF FILE */
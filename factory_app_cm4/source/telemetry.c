@@ -0,0 +1,105 @@
+/******************************************************************************
+* File Name: telemetry.c
+*
+* Description: This file contains the helper that publishes telemetry documents
+* over MQTT.
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Header file includes */
+#include <stdio.h>
+#include <string.h>
+#include "cyhal.h"
+#include "cybsp.h"
+#include "cy_retarget_io.h"
+#include "telemetry.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define TELEMETRY_TOPIC_MAX_LEN             (128u)
+
+/*******************************************************************************
+ * Function Name: telemetry_publish
+ *******************************************************************************
+ * Summary:
+ *  Publishes a telemetry document with QoS 0 on the given MQTT connection,
+ *  under the topic TELEMETRY_TOPIC_PREFIX<name>.
+ *
+ * Parameters:
+ *  cy_mqtt_t mqtt_handle : Connected MQTT handle, e.g. the one of the OTA agent
+ *  const char *name      : Last topic level
+ *  const char *doc       : Document to publish
+ *  size_t doc_len        : Length of the document
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS on success, error code otherwise
+ *
+ *******************************************************************************/
+cy_rslt_t telemetry_publish(cy_mqtt_t mqtt_handle, const char *name, const char *doc, size_t doc_len)
+{
+    char topic[TELEMETRY_TOPIC_MAX_LEN];
+    cy_mqtt_publish_info_t pub_info;
+    int topic_len;
+    cy_rslt_t result;
+
+    if ((mqtt_handle == NULL) || (name == NULL) || (doc == NULL) || (doc_len == 0))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    topic_len = snprintf(topic, sizeof(topic), "%s%s", TELEMETRY_TOPIC_PREFIX, name);
+    if ((topic_len < 0) || ((size_t)topic_len >= sizeof(topic)))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    memset(&pub_info, 0, sizeof(pub_info));
+    pub_info.qos = CY_MQTT_QOS0;
+    pub_info.topic = topic;
+    pub_info.topic_len = (uint16_t)topic_len;
+    pub_info.payload = doc;
+    pub_info.payload_len = doc_len;
+
+    result = cy_mqtt_publish(mqtt_handle, &pub_info);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        printf("\n Publishing telemetry to '%s' failed: 0x%lx\n", topic, (unsigned long)result);
+    }
+
+    return result;
+}
+
+/* [] END OF FILE */
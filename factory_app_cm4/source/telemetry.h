@@ -0,0 +1,64 @@
+/******************************************************************************
+* File Name: telemetry.h
+*
+* Description: This file contains declaration of the helper that publishes
+* telemetry documents over MQTT.
+*
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef SOURCE_TELEMETRY_H_
+#define SOURCE_TELEMETRY_H_
+
+#include <stddef.h>
+#include "cy_ota_api.h"
+#include "cy_ota_config.h"
+#include "cy_mqtt_api.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* Telemetry documents are published to TELEMETRY_TOPIC_PREFIX<name> */
+#define TELEMETRY_TOPIC_PREFIX              COMPANY_TOPIC_PREPEND "/" CY_TARGET_BOARD_STRING "/telemetry/"
+
+/* Size of the buffers used to format telemetry documents */
+#define TELEMETRY_DOC_SIZE                  (2048u)
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+cy_rslt_t telemetry_publish(cy_mqtt_t mqtt_handle, const char *name, const char *doc, size_t doc_len);
+
+#endif /* SOURCE_TELEMETRY_H_ */
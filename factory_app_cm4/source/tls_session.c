@@ -0,0 +1,420 @@
+/******************************************************************************
+* File Name: tls_session.c
+*
+* Description: This file implements the TLS session cache. The handshakes of the
+* secure sockets library are wrapped at link time (--wrap=mbedtls_ssl_handshake),
+* so every connection to the broker offers the session of the previous one.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/* Header file includes */
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include "cyhal.h"
+#include "cybsp.h"
+#include "cy_retarget_io.h"
+#include "tls_session.h"
+#include "app_log.h"
+#include "mbedtls/ssl.h"
+#include "mbedtls/platform_util.h"
+#ifdef TLS_SESSION_PERSIST_ENABLE
+#include "flash_service.h"
+#include "cy_ota_flash.h"
+#include "cy_ota_crc32.h"
+#endif
+/* FreeRTOS */
+#include <FreeRTOS.h>
+#include <task.h>
+#include <semphr.h>
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define TLS_SESSION_MAGIC                   (0x53534C54u)   /* "TLSS" */
+
+#define TLS_SESSION_TICKS_TO_MS(t)          ((uint32_t)((t) * portTICK_PERIOD_MS))
+
+/*******************************************************************************
+* Data Structures
+********************************************************************************/
+#ifdef TLS_SESSION_PERSIST_ENABLE
+/* Header of the session in flash, followed by the mbedtls_ssl_session_save()
+ * output */
+typedef struct
+{
+    uint32_t                    magic;
+    uint32_t                    len;
+    uint32_t                    crc;            /* CRC32 of the session data */
+} tls_session_record_t;
+#endif
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+#ifdef TLS_SESSION_RESUME_ENABLE
+int __real_mbedtls_ssl_handshake(mbedtls_ssl_context *ssl);
+int __wrap_mbedtls_ssl_handshake(mbedtls_ssl_context *ssl);
+static void tls_session_finish(mbedtls_ssl_context *ssl, int ret, uint32_t ms, bool offered);
+#endif
+#ifdef TLS_SESSION_PERSIST_ENABLE
+static void tls_session_load(void);
+static void tls_session_store(void);
+#endif
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Protects the state below */
+static SemaphoreHandle_t tls_session_mutex;
+static StaticSemaphore_t tls_session_mutex_buffer;
+
+/* Session of the last handshake with the broker */
+static mbedtls_ssl_session tls_session_cache;
+static bool tls_session_valid;
+
+#ifdef TLS_SESSION_RESUME_ENABLE
+/* Handshake in progress, started at tls_session_start. The OTA agent makes
+ * one connection at a time. */
+static mbedtls_ssl_context *tls_session_pending;
+static TickType_t tls_session_start;
+static bool tls_session_offered;
+#endif
+
+static tls_session_stats_t tls_session_stats;
+
+#ifdef TLS_SESSION_PERSIST_ENABLE
+/* Flash slot of the stored session */
+static uint8_t tls_session_buf[TLS_SESSION_BUF_SIZE];
+#endif
+
+/*******************************************************************************
+ * Function Name: tls_session_init
+ *******************************************************************************
+ * Summary:
+ *  Creates the session cache.
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS on success, error code otherwise
+ *
+ *******************************************************************************/
+cy_rslt_t tls_session_init(void)
+{
+    if (tls_session_mutex != NULL)
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    tls_session_mutex = xSemaphoreCreateMutexStatic(&tls_session_mutex_buffer);
+    if (tls_session_mutex == NULL)
+    {
+        printf("\n Creating the TLS session mutex failed.\n");
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    mbedtls_ssl_session_init(&tls_session_cache);
+    tls_session_valid = false;
+
+#ifdef TLS_SESSION_PERSIST_ENABLE
+    tls_session_load();
+#endif
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: tls_session_clear
+ *******************************************************************************
+ * Summary:
+ *  Forgets the cached session, the next handshake is a full one.
+ *
+ *******************************************************************************/
+void tls_session_clear(void)
+{
+    if (tls_session_mutex == NULL)
+    {
+        return;
+    }
+
+    xSemaphoreTake(tls_session_mutex, portMAX_DELAY);
+    mbedtls_ssl_session_free(&tls_session_cache);
+    mbedtls_ssl_session_init(&tls_session_cache);
+    tls_session_valid = false;
+#ifdef TLS_SESSION_PERSIST_ENABLE
+    tls_session_store();
+#endif
+    xSemaphoreGive(tls_session_mutex);
+}
+
+/*******************************************************************************
+ * Function Name: tls_session_get_stats
+ *******************************************************************************
+ * Summary:
+ *  Copies the handshake statistics.
+ *
+ * Parameters:
+ *  tls_session_stats_t *stats : Receives the statistics
+ *
+ *******************************************************************************/
+void tls_session_get_stats(tls_session_stats_t *stats)
+{
+    if (tls_session_mutex == NULL)
+    {
+        memset(stats, 0, sizeof(*stats));
+        return;
+    }
+
+    xSemaphoreTake(tls_session_mutex, portMAX_DELAY);
+    *stats = tls_session_stats;
+    xSemaphoreGive(tls_session_mutex);
+}
+
+#ifdef TLS_SESSION_RESUME_ENABLE
+/*******************************************************************************
+ * Function Name: __wrap_mbedtls_ssl_handshake
+ *******************************************************************************
+ * Summary:
+ *  Replaces mbedtls_ssl_handshake() for the whole application. A client
+ *  handshake that has not started yet is offered the cached session. The
+ *  server resumes it with an abbreviated handshake if it still knows the
+ *  session ID or accepts the session ticket, otherwise mbed TLS falls back to
+ *  a full handshake. The completed handshake is timed and its session cached.
+ *
+ * Parameters:
+ *  mbedtls_ssl_context *ssl : SSL context set up by the secure sockets library
+ *
+ * Return:
+ *  int : Result of mbedtls_ssl_handshake()
+ *
+ *******************************************************************************/
+int __wrap_mbedtls_ssl_handshake(mbedtls_ssl_context *ssl)
+{
+    int ret;
+
+    if ((tls_session_mutex == NULL) || (ssl == NULL) ||
+        (MBEDTLS_SSL_IS_CLIENT != mbedtls_ssl_conf_get_endpoint(mbedtls_ssl_context_get_config(ssl))))
+    {
+        return __real_mbedtls_ssl_handshake(ssl);
+    }
+
+    if (ssl->MBEDTLS_PRIVATE(state) == MBEDTLS_SSL_HELLO_REQUEST)
+    {
+        xSemaphoreTake(tls_session_mutex, portMAX_DELAY);
+        tls_session_offered = tls_session_valid &&
+                              (0 == mbedtls_ssl_set_session(ssl, &tls_session_cache));
+        tls_session_pending = ssl;
+        tls_session_start = xTaskGetTickCount();
+        xSemaphoreGive(tls_session_mutex);
+    }
+
+    ret = __real_mbedtls_ssl_handshake(ssl);
+
+    /* Not finished yet with non-blocking I/O, or not ours to time */
+    if ((ssl != tls_session_pending) ||
+        (ret == MBEDTLS_ERR_SSL_WANT_READ) || (ret == MBEDTLS_ERR_SSL_WANT_WRITE) ||
+        (ret == MBEDTLS_ERR_SSL_ASYNC_IN_PROGRESS) || (ret == MBEDTLS_ERR_SSL_CRYPTO_IN_PROGRESS))
+    {
+        return ret;
+    }
+
+    tls_session_finish(ssl, ret, TLS_SESSION_TICKS_TO_MS(xTaskGetTickCount() - tls_session_start),
+                       tls_session_offered);
+
+    return ret;
+}
+
+/*******************************************************************************
+ * Function Name: tls_session_finish
+ *******************************************************************************
+ * Summary:
+ *  Accounts a finished handshake and caches its session. A resumed session
+ *  keeps the master secret of the offered one, a full handshake derives a new
+ *  one. A failed handshake drops the cached session, in case the server chokes
+ *  on it.
+ *
+ *******************************************************************************/
+static void tls_session_finish(mbedtls_ssl_context *ssl, int ret, uint32_t ms, bool offered)
+{
+    mbedtls_ssl_session session;
+    bool resumed = false;
+
+    mbedtls_ssl_session_init(&session);
+
+    xSemaphoreTake(tls_session_mutex, portMAX_DELAY);
+    tls_session_pending = NULL;
+
+    if (ret != 0)
+    {
+        tls_session_stats.failed++;
+        if (offered)
+        {
+            mbedtls_ssl_session_free(&tls_session_cache);
+            mbedtls_ssl_session_init(&tls_session_cache);
+            tls_session_valid = false;
+        }
+        xSemaphoreGive(tls_session_mutex);
+
+        APP_LOG_WARN("TLS handshake failed after %lu ms: -0x%04x\n", (unsigned long)ms, (unsigned int)-ret);
+        return;
+    }
+
+    if (0 == mbedtls_ssl_get_session(ssl, &session))
+    {
+        resumed = offered &&
+                  (0 == memcmp(session.MBEDTLS_PRIVATE(master), tls_session_cache.MBEDTLS_PRIVATE(master),
+                               sizeof(session.MBEDTLS_PRIVATE(master))));
+
+        /* Keep the latest session, the server may have issued a new ticket */
+        mbedtls_ssl_session_free(&tls_session_cache);
+        tls_session_cache = session;
+        tls_session_valid = true;
+
+#ifdef TLS_SESSION_PERSIST_ENABLE
+        /* Only new sessions are stored, a reconnect every check interval
+         * would wear the sector out otherwise */
+        if (!resumed)
+        {
+            tls_session_store();
+        }
+#endif
+    }
+    else
+    {
+        mbedtls_ssl_session_free(&session);
+    }
+
+    tls_session_stats.handshakes++;
+    tls_session_stats.last_ms = ms;
+    if (resumed)
+    {
+        tls_session_stats.resumed++;
+        tls_session_stats.resumed_ms += ms;
+    }
+    else
+    {
+        tls_session_stats.full_ms += ms;
+    }
+    xSemaphoreGive(tls_session_mutex);
+
+    APP_LOG_INFO("TLS handshake: %s in %lu ms (%lu of %lu resumed)\n", resumed ? "resumed" : "full",
+                 (unsigned long)ms, (unsigned long)tls_session_stats.resumed,
+                 (unsigned long)tls_session_stats.handshakes);
+}
+#endif
+
+#ifdef TLS_SESSION_PERSIST_ENABLE
+/*******************************************************************************
+ * Function Name: tls_session_load
+ *******************************************************************************
+ * Summary:
+ *  Loads the session stored before the reset into the cache.
+ *
+ *******************************************************************************/
+static void tls_session_load(void)
+{
+    tls_session_record_t *rec = (tls_session_record_t *)tls_session_buf;
+
+    if (CY_RSLT_SUCCESS != flash_service_read(CY_OTA_MEM_TYPE_EXTERNAL_FLASH, TLS_SESSION_ADDR,
+                                              tls_session_buf, sizeof(tls_session_buf)))
+    {
+        return;
+    }
+
+    if ((rec->magic == TLS_SESSION_MAGIC) &&
+        (rec->len <= (sizeof(tls_session_buf) - sizeof(*rec))) &&
+        (rec->crc == cy_ota_crc32(CY_OTA_CRC32_INIT, &tls_session_buf[sizeof(*rec)], rec->len)) &&
+        (0 == mbedtls_ssl_session_load(&tls_session_cache, &tls_session_buf[sizeof(*rec)], rec->len)))
+    {
+        tls_session_valid = true;
+        printf("Loaded the TLS session of the last connection\n");
+    }
+
+    mbedtls_platform_zeroize(tls_session_buf, sizeof(tls_session_buf));
+}
+
+/*******************************************************************************
+ * Function Name: tls_session_store
+ *******************************************************************************
+ * Summary:
+ *  Writes the cached session to flash, or erases the stored one if there is
+ *  no valid session. Called with the lock held. A session that does not fit
+ *  TLS_SESSION_BUF_SIZE is only kept in RAM.
+ *
+ *******************************************************************************/
+static void tls_session_store(void)
+{
+    tls_session_record_t *rec = (tls_session_record_t *)tls_session_buf;
+    uint32_t sector_size;
+    uint32_t prog_size;
+    size_t len = 0;
+    cy_rslt_t result;
+
+    sector_size = (uint32_t)cy_ota_mem_get_erase_size(CY_OTA_MEM_TYPE_EXTERNAL_FLASH, TLS_SESSION_ADDR);
+    prog_size = (uint32_t)cy_ota_mem_get_prog_size(CY_OTA_MEM_TYPE_EXTERNAL_FLASH, TLS_SESSION_ADDR);
+    if ((sector_size == 0) || (prog_size == 0) || (sizeof(tls_session_buf) % prog_size != 0))
+    {
+        return;
+    }
+
+    memset(tls_session_buf, 0xFF, sizeof(tls_session_buf));
+    if (tls_session_valid)
+    {
+        if (0 != mbedtls_ssl_session_save(&tls_session_cache, &tls_session_buf[sizeof(*rec)],
+                                          sizeof(tls_session_buf) - sizeof(*rec), &len))
+        {
+            printf("\n TLS session does not fit %u bytes, not stored.\n", (unsigned int)sizeof(tls_session_buf));
+            len = 0;
+        }
+    }
+
+    result = flash_service_erase(CY_OTA_MEM_TYPE_EXTERNAL_FLASH, TLS_SESSION_ADDR, sector_size);
+    if ((CY_RSLT_SUCCESS == result) && (len != 0))
+    {
+        rec->magic = TLS_SESSION_MAGIC;
+        rec->len = (uint32_t)len;
+        rec->crc = cy_ota_crc32(CY_OTA_CRC32_INIT, &tls_session_buf[sizeof(*rec)], len);
+        len = ((sizeof(*rec) + len + prog_size - 1u) / prog_size) * prog_size;
+        result = flash_service_write(CY_OTA_MEM_TYPE_EXTERNAL_FLASH, TLS_SESSION_ADDR, tls_session_buf, len);
+    }
+    if (CY_RSLT_SUCCESS != result)
+    {
+        printf("\n Storing the TLS session failed: 0x%lx\n", (unsigned long)result);
+    }
+
+    mbedtls_platform_zeroize(tls_session_buf, sizeof(tls_session_buf));
+}
+#endif
+
+/* [] END OF FILE */
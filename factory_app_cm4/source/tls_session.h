@@ -0,0 +1,91 @@
+/******************************************************************************
+* File Name: tls_session.h
+*
+* Description: This file contains the declarations of the TLS session cache that
+* lets reconnects to the MQTT broker resume the previous session.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef SOURCE_TLS_SESSION_H_
+#define SOURCE_TLS_SESSION_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "cy_result.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* One erase sector of external flash outside of all flash map areas that
+ * holds the session with TLS_SESSION_PERSIST_ENABLE, after the Wi-Fi profile
+ * by default */
+#ifndef TLS_SESSION_ADDR
+#define TLS_SESSION_ADDR                    (0x18580000u)
+#endif
+
+/* Largest serialized session that is kept in flash, a multiple of the
+ * program size */
+#ifndef TLS_SESSION_BUF_SIZE
+#define TLS_SESSION_BUF_SIZE                (1024u)
+#endif
+
+/*******************************************************************************
+* Data Structures
+********************************************************************************/
+typedef struct
+{
+    uint32_t                    handshakes;     /* Completed handshakes */
+    uint32_t                    resumed;        /* Of those, resumed sessions */
+    uint32_t                    failed;
+    uint32_t                    full_ms;        /* Total time of full handshakes */
+    uint32_t                    resumed_ms;     /* Total time of resumed ones */
+    uint32_t                    last_ms;
+} tls_session_stats_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Creates the cache and, with TLS_SESSION_PERSIST_ENABLE, loads the session
+ * stored before the reset. Must be called after the flash service has been
+ * started and before the first TLS connection. */
+cy_rslt_t tls_session_init(void);
+
+/* Forgets the cached session, in RAM and in flash */
+void tls_session_clear(void);
+
+/* Handshake counts and times since the reset */
+void tls_session_get_stats(tls_session_stats_t *stats);
+
+#endif /* SOURCE_TLS_SESSION_H_ */
@@ -0,0 +1,204 @@
+/******************************************************************************
+* File Name: wifi_profile.c
+*
+* Description: This file implements the cached profile of the last Wi-Fi AP the
+* device connected to, kept in external flash for a directed connect after
+* the next reset.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/* Header file includes */
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include "cyhal.h"
+#include "cybsp.h"
+#include "cy_retarget_io.h"
+#include "wifi_profile.h"
+#include "flash_service.h"
+#include "cy_ota_flash.h"
+#include "cy_ota_crc32.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define WIFI_PROFILE_MAGIC                  (0x50494657u)   /* "WFIP" */
+
+/* Largest flash space the record may take, a multiple of the program size */
+#define WIFI_PROFILE_BUF_SIZE               (512u)
+
+/* Channels above this one are in the 5 GHz band */
+#define WIFI_PROFILE_MAX_2G4_CHANNEL        (14u)
+
+/*******************************************************************************
+* Data Structures
+********************************************************************************/
+typedef struct
+{
+    uint32_t                    magic;
+    uint8_t                     ssid[CY_WCM_MAX_SSID_LEN + 1];
+    cy_wcm_mac_t                bssid;
+    uint8_t                     channel;
+    uint8_t                     band;
+    uint32_t                    crc;            /* CRC32 of everything above */
+} wifi_profile_record_t;
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Record in flash, magic 0 if there is none */
+static wifi_profile_record_t wifi_profile_rec;
+
+/* Flash slot of the record */
+static uint8_t wifi_profile_buf[WIFI_PROFILE_BUF_SIZE];
+
+/*******************************************************************************
+ * Function Name: wifi_profile_load
+ *******************************************************************************
+ * Summary:
+ *  Reads the profile from external flash.
+ *
+ * Parameters:
+ *  const uint8_t *ssid     : SSID the profile must have been stored for
+ *  wifi_profile_t *profile : Receives the profile
+ *
+ * Return:
+ *  true if a profile for ssid was found
+ *
+ *******************************************************************************/
+bool wifi_profile_load(const uint8_t *ssid, wifi_profile_t *profile)
+{
+    wifi_profile_record_t *rec = &wifi_profile_rec;
+
+    if ((CY_RSLT_SUCCESS != flash_service_read(CY_OTA_MEM_TYPE_EXTERNAL_FLASH, WIFI_PROFILE_ADDR,
+                                               rec, sizeof(*rec))) ||
+        (rec->magic != WIFI_PROFILE_MAGIC) ||
+        (rec->crc != cy_ota_crc32(CY_OTA_CRC32_INIT, rec, offsetof(wifi_profile_record_t, crc))))
+    {
+        rec->magic = 0;
+        return false;
+    }
+
+    if (0 != strncmp((const char *)rec->ssid, (const char *)ssid, sizeof(rec->ssid)))
+    {
+        return false;
+    }
+
+    memcpy(profile->bssid, rec->bssid, sizeof(profile->bssid));
+    profile->channel = rec->channel;
+    profile->band = (cy_wcm_wifi_band_t)rec->band;
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: wifi_profile_save
+ *******************************************************************************
+ * Summary:
+ *  Reads the BSSID and channel of the associated AP and stores them with ssid
+ *  if they differ from the stored profile. If the write is interrupted the
+ *  profile is lost and the next connect scans all channels.
+ *
+ * Parameters:
+ *  const uint8_t *ssid : SSID of the associated AP
+ *
+ * Return:
+ *  cy_rslt_t : CY_RSLT_SUCCESS on success, error code otherwise
+ *
+ *******************************************************************************/
+cy_rslt_t wifi_profile_save(const uint8_t *ssid)
+{
+    cy_wcm_associated_ap_info_t ap_info;
+    wifi_profile_record_t rec;
+    uint32_t sector_size;
+    uint32_t prog_size;
+    uint32_t len;
+    cy_rslt_t result;
+
+    result = cy_wcm_get_associated_ap_info(&ap_info);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        return result;
+    }
+
+    memset(&rec, 0, sizeof(rec));
+    rec.magic = WIFI_PROFILE_MAGIC;
+    strncpy((char *)rec.ssid, (const char *)ssid, sizeof(rec.ssid) - 1u);
+    memcpy(rec.bssid, ap_info.BSSID, sizeof(rec.bssid));
+    rec.channel = ap_info.channel;
+    rec.band = (uint8_t)((ap_info.channel > WIFI_PROFILE_MAX_2G4_CHANNEL) ?
+                         CY_WCM_WIFI_BAND_5GHZ : CY_WCM_WIFI_BAND_2_4GHZ);
+    rec.crc = cy_ota_crc32(CY_OTA_CRC32_INIT, &rec, offsetof(wifi_profile_record_t, crc));
+
+    if (0 == memcmp(&rec, &wifi_profile_rec, sizeof(rec)))
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    sector_size = (uint32_t)cy_ota_mem_get_erase_size(CY_OTA_MEM_TYPE_EXTERNAL_FLASH, WIFI_PROFILE_ADDR);
+    prog_size = (uint32_t)cy_ota_mem_get_prog_size(CY_OTA_MEM_TYPE_EXTERNAL_FLASH, WIFI_PROFILE_ADDR);
+    if ((sector_size == 0) || (prog_size == 0))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    len = ((sizeof(rec) + prog_size - 1u) / prog_size) * prog_size;
+    if (len > sizeof(wifi_profile_buf))
+    {
+        printf("\n Wi-Fi profile does not fit a %lu byte program page.\n", (unsigned long)prog_size);
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    result = flash_service_erase(CY_OTA_MEM_TYPE_EXTERNAL_FLASH, WIFI_PROFILE_ADDR, sector_size);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        printf("\n Erasing the Wi-Fi profile failed: 0x%lx\n", (unsigned long)result);
+        return result;
+    }
+
+    memset(wifi_profile_buf, 0xFF, len);
+    memcpy(wifi_profile_buf, &rec, sizeof(rec));
+    result = flash_service_write(CY_OTA_MEM_TYPE_EXTERNAL_FLASH, WIFI_PROFILE_ADDR, wifi_profile_buf, len);
+    if (CY_RSLT_SUCCESS != result)
+    {
+        printf("\n Writing the Wi-Fi profile failed: 0x%lx\n", (unsigned long)result);
+        return result;
+    }
+
+    wifi_profile_rec = rec;
+    return CY_RSLT_SUCCESS;
+}
+
+/* [] END OF FILE */
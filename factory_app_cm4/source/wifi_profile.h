@@ -0,0 +1,79 @@
+/******************************************************************************
+* File Name: wifi_profile.h
+*
+* Description: This file contains the declarations of the cached profile of the
+* last Wi-Fi AP the device connected to.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#ifndef SOURCE_WIFI_PROFILE_H_
+#define SOURCE_WIFI_PROFILE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "cy_wcm.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+/* One erase sector of external flash outside of all flash map areas that
+ * holds the profile, after the resume record log by default */
+#ifndef WIFI_PROFILE_ADDR
+#define WIFI_PROFILE_ADDR                   (0x18540000u)
+#endif
+
+/*******************************************************************************
+* Data Structures
+********************************************************************************/
+typedef struct
+{
+    cy_wcm_mac_t                bssid;
+    uint8_t                     channel;
+    cy_wcm_wifi_band_t          band;
+} wifi_profile_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+/* Loads the profile stored for ssid. Returns false if there is none or it was
+ * stored for another SSID. Must be called after the flash service has been
+ * started. */
+bool wifi_profile_load(const uint8_t *ssid, wifi_profile_t *profile);
+
+/* Stores the profile of the AP the device is associated with. Flash is only
+ * written if the profile has changed. */
+cy_rslt_t wifi_profile_save(const uint8_t *ssid);
+
+#endif /* SOURCE_WIFI_PROFILE_H_ */
@@ -0,0 +1,286 @@
+"""Delta OTA patch tool
+Copyright (c) 2025 Infineon Technologies AG
+
+Creates patches for delta OTA updates, applies them, and measures how much
+smaller they are than the full image. The patch format is described in
+factory_app_cm4/source/ota_delta.h.
+
+Usage:
+    python delta_patch.py create <old image> <new image> <patch>
+    python delta_patch.py apply  <old image> <patch> <new image>
+    python delta_patch.py bench  <old image> <new image>
+    python delta_patch.py check  [<old image> <new image>]
+
+<old image> is the signed image currently in the primary slot of the device,
+<new image> the signed image to update to.
+
+check builds the decoder of the device (factory_app_cm4/source/ota_delta.c)
+for the host with delta_patch_host.c and the C compiler in $CC (default cc).
+It applies a patch of this script in chunks of several sizes and checks the
+result, and checks that a patch for another image and a corrupt patch are
+rejected. Without images, generated ones are used.
+"""
+
+import os
+import random
+import shutil
+import struct
+import subprocess
+import sys
+import tempfile
+import time
+import zlib
+
+MAGIC = b"OTADELTA"
+VERSION = 1
+HEADER_SIZE = 32
+HEADER_FORMAT = "<8sHHIIIII"
+
+OP_COPY = 1
+OP_DATA = 2
+
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+APP_DIR = os.path.join(SCRIPT_DIR, "..", "factory_app_cm4")
+
+# Chunk sizes the host decoder is fed with, each list used in turn. Small and
+# odd sizes split the header and the operation fields.
+CHECK_CHUNK_SIZES = [["4096"], ["1"], ["3", "32", "4000", "7"]]
+
+# Stand-in for cy_result.h of the ModusToolbox core library
+CY_RESULT_H = """#ifndef CY_RESULT_H
+#define CY_RESULT_H
+#include <stdint.h>
+typedef uint32_t cy_rslt_t;
+#define CY_RSLT_SUCCESS ((cy_rslt_t)0x00000000U)
+#define CY_RSLT_TYPE_ERROR (2U)
+#endif
+"""
+
+# Blocks of the old image are indexed every INDEX_STEP bytes. A match needs
+# BLOCK_SIZE equal bytes to be found and MIN_COPY bytes to be used.
+BLOCK_SIZE = 32
+INDEX_STEP = 16
+MIN_COPY = 24
+
+
+def crc32(data):
+    return zlib.crc32(data) & 0xFFFFFFFF
+
+
+def build_index(old):
+    index = {}
+    for offset in range(0, len(old) - BLOCK_SIZE + 1, INDEX_STEP):
+        index.setdefault(old[offset:offset + BLOCK_SIZE], offset)
+    return index
+
+
+def create_patch(old, new):
+    index = build_index(old)
+    ops = []
+    literal = bytearray()
+    pos = 0
+    # Old image offset at which the previous copy ended. Trying it first keeps
+    # long runs of unchanged code in a single copy.
+    expected = 0
+
+    def add_data():
+        if literal:
+            ops.append(struct.pack("<BI", OP_DATA, len(literal)) + bytes(literal))
+            literal.clear()
+
+    while pos < len(new):
+        src = None
+        if expected + BLOCK_SIZE <= len(old) and old[expected:expected + BLOCK_SIZE] == new[pos:pos + BLOCK_SIZE]:
+            src = expected
+        else:
+            src = index.get(new[pos:pos + BLOCK_SIZE])
+
+        if src is None:
+            literal.append(new[pos])
+            pos += 1
+            continue
+
+        # Extend the match backwards into the pending literal data
+        back = 0
+        while back < len(literal) and back < src and old[src - back - 1] == literal[-back - 1]:
+            back += 1
+
+        length = BLOCK_SIZE
+        while pos + length < len(new) and src + length < len(old) and old[src + length] == new[pos + length]:
+            length += 1
+
+        if length + back < MIN_COPY:
+            literal.append(new[pos])
+            pos += 1
+            continue
+
+        if back:
+            del literal[-back:]
+        add_data()
+        ops.append(struct.pack("<BII", OP_COPY, src - back, length + back))
+        pos += length
+        expected = src + length
+
+    add_data()
+
+    header = struct.pack(HEADER_FORMAT, MAGIC, VERSION, HEADER_SIZE,
+                         len(old), crc32(old), len(new), crc32(new), 0)
+    return header + b"".join(ops)
+
+
+def apply_patch(old, patch):
+    magic, version, header_size, source_size, source_crc, target_size, target_crc, _ = \
+        struct.unpack_from(HEADER_FORMAT, patch)
+    if magic != MAGIC or version != VERSION or header_size != HEADER_SIZE:
+        raise ValueError("unsupported patch header")
+    if source_size > len(old) or crc32(old[:source_size]) != source_crc:
+        raise ValueError("patch was not created for this image")
+
+    new = bytearray()
+    pos = HEADER_SIZE
+    while len(new) < target_size:
+        op = patch[pos]
+        if op == OP_COPY:
+            src, length = struct.unpack_from("<II", patch, pos + 1)
+            if src + length > source_size:
+                raise ValueError("copy outside of the old image")
+            new += old[src:src + length]
+            pos += 9
+        elif op == OP_DATA:
+            (length,) = struct.unpack_from("<I", patch, pos + 1)
+            new += patch[pos + 5:pos + 5 + length]
+            pos += 5 + length
+        else:
+            raise ValueError("unknown operation %d at patch offset %d" % (op, pos))
+
+    if len(new) != target_size or pos != len(patch) or crc32(new) != target_crc:
+        raise ValueError("patch did not produce the expected image")
+    return bytes(new)
+
+
+def read_file(name):
+    with open(name, "rb") as f:
+        return f.read()
+
+
+def write_file(name, data):
+    with open(name, "wb") as f:
+        f.write(data)
+
+
+def bench(old, new):
+    start = time.perf_counter()
+    patch = create_patch(old, new)
+    create_time = time.perf_counter() - start
+
+    start = time.perf_counter()
+    result = apply_patch(old, patch)
+    apply_time = time.perf_counter() - start
+
+    print("Old image   : %d bytes" % len(old))
+    print("New image   : %d bytes" % len(new))
+    print("Patch       : %d bytes (%.1f%% of the new image)" % (len(patch), 100.0 * len(patch) / len(new)))
+    print("Compressed  : %d bytes patch, %d bytes new image (zlib, for comparison)" %
+          (len(zlib.compress(patch, 9)), len(zlib.compress(new, 9))))
+    print("Create time : %.3f s" % create_time)
+    print("Apply time  : %.3f s" % apply_time)
+    print("Round trip  : %s" % ("OK" if result == new else "FAILED"))
+    return result == new
+
+
+def build_host_decoder(work_dir):
+    with open(os.path.join(work_dir, "cy_result.h"), "w") as f:
+        f.write(CY_RESULT_H)
+    exe = os.path.join(work_dir, "delta_patch_host")
+    flash_dir = os.path.join(APP_DIR, "configs", "COMPONENT_MCUBOOT", "flash")
+    subprocess.check_call([os.environ.get("CC", "cc"), "-std=c99", "-O2", "-Wall", "-Wextra",
+                           "-I" + work_dir, "-I" + os.path.join(APP_DIR, "source"), "-I" + flash_dir,
+                           os.path.join(SCRIPT_DIR, "delta_patch_host.c"),
+                           os.path.join(APP_DIR, "source", "ota_delta.c"),
+                           os.path.join(flash_dir, "cy_ota_crc32.c"), "-o", exe])
+    return exe
+
+
+def run_host_decoder(exe, work_dir, old, patch, chunk_sizes):
+    old_name = os.path.join(work_dir, "old.bin")
+    patch_name = os.path.join(work_dir, "patch.bin")
+    new_name = os.path.join(work_dir, "new.bin")
+    write_file(old_name, old)
+    write_file(patch_name, patch)
+    if os.path.exists(new_name):
+        os.remove(new_name)
+    result = subprocess.run([exe, old_name, patch_name, new_name] + chunk_sizes,
+                            stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+    if result.returncode != 0:
+        return None
+    return read_file(new_name)
+
+
+def generated_images():
+    rng = random.Random(1)
+    old = bytes(rng.getrandbits(8) for _ in range(64 * 1024))
+    new = bytearray(old)
+    # Changed bytes, an insertion, a removal and a moved block
+    for _ in range(20):
+        pos = rng.randrange(len(new))
+        new[pos] ^= 0x5A
+    new[1000:1000] = bytes(rng.getrandbits(8) for _ in range(300))
+    del new[20000:20500]
+    new += old[4096:8192]
+    return old, bytes(new)
+
+
+def check(old, new):
+    patch = create_patch(old, new)
+    ok = True
+    work_dir = tempfile.mkdtemp(prefix="delta_patch_")
+    try:
+        exe = build_host_decoder(work_dir)
+
+        for sizes in CHECK_CHUNK_SIZES:
+            passed = run_host_decoder(exe, work_dir, old, patch, sizes) == new
+            print("%-21s: %s" % ("Chunks of " + ",".join(sizes), "OK" if passed else "FAILED"))
+            ok = ok and passed
+
+        other = bytearray(old)
+        other[len(other) // 2] ^= 0xFF
+        passed = run_host_decoder(exe, work_dir, bytes(other), patch, CHECK_CHUNK_SIZES[0]) is None
+        print("Other image          : %s" % ("rejected" if passed else "FAILED, not rejected"))
+        ok = ok and passed
+
+        corrupt = bytearray(patch)
+        corrupt[-1] ^= 0xFF
+        passed = run_host_decoder(exe, work_dir, old, bytes(corrupt), CHECK_CHUNK_SIZES[0]) is None
+        print("Corrupt patch        : %s" % ("rejected" if passed else "FAILED, not rejected"))
+        ok = ok and passed
+    finally:
+        shutil.rmtree(work_dir)
+
+    print("Host decoder         : %s (patch of %d bytes)" % ("OK" if ok else "FAILED", len(patch)))
+    return ok
+
+
+def main(argv):
+    if len(argv) == 5 and argv[1] == "create":
+        patch = create_patch(read_file(argv[2]), read_file(argv[3]))
+        write_file(argv[4], patch)
+        print("Created %s: %d bytes" % (argv[4], len(patch)))
+    elif len(argv) == 5 and argv[1] == "apply":
+        new = apply_patch(read_file(argv[2]), read_file(argv[3]))
+        write_file(argv[4], new)
+        print("Created %s: %d bytes" % (argv[4], len(new)))
+    elif len(argv) == 4 and argv[1] == "bench":
+        if not bench(read_file(argv[2]), read_file(argv[3])):
+            return 1
+    elif len(argv) in (2, 4) and argv[1] == "check":
+        old, new = (read_file(argv[2]), read_file(argv[3])) if len(argv) == 4 else generated_images()
+        if not check(old, new):
+            return 1
+    else:
+        print(__doc__)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
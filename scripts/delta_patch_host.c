@@ -0,0 +1,259 @@
+/******************************************************************************
+* File Name: delta_patch_host.c
+*
+* Description: Host driver of the delta OTA decoder. delta_patch.py check builds it
+* with factory_app_cm4/source/ota_delta.c and feeds it the patches of
+* delta_patch.py, so the decoder of the device is tested against the patch
+* generator.
+*
+*******************************************************************************
+* Copyright 2025, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+/* Header file includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ota_delta.h"
+
+/*******************************************************************************
+* Macros
+********************************************************************************/
+#define HOST_MAX_CHUNK_SIZES                (16)
+
+/*******************************************************************************
+* Data Structures
+********************************************************************************/
+typedef struct
+{
+    const uint8_t               *source;
+    size_t                      source_len;
+    uint8_t                     *target;
+    size_t                      target_len;
+    uint32_t                    last_blocks;    /* Writes flagged as the last one */
+} host_images_t;
+
+/*******************************************************************************
+* Function Prototypes
+********************************************************************************/
+static cy_rslt_t host_read(void *arg, uint32_t offset, void *data, size_t len);
+static cy_rslt_t host_write(void *arg, uint32_t offset, const void *data, size_t len, bool last);
+static uint8_t *host_read_file(const char *name, size_t *len);
+
+/*******************************************************************************
+* Global Variables
+********************************************************************************/
+/* Too large for the stack with a big OTA_DELTA_OUT_SIZE */
+static ota_delta_t host_delta;
+
+/*******************************************************************************
+ * Function Name: main
+ *******************************************************************************
+ * Summary:
+ *  Applies a patch to the old image, feeding it in chunks of the given sizes
+ *  in turn, and writes the new image.
+ *
+ *  Usage: delta_patch_host <old image> <patch> <new image> <chunk size> ...
+ *
+ * Return:
+ *  int : 0 if the patch was applied, 1 if the decoder failed, 2 on a usage
+ *        or file error
+ *
+ *******************************************************************************/
+int main(int argc, char *argv[])
+{
+    host_images_t images = { 0 };
+    size_t chunk_sizes[HOST_MAX_CHUNK_SIZES];
+    size_t num_sizes = 0;
+    uint8_t *patch;
+    size_t patch_len;
+    size_t pos = 0;
+    size_t n;
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+    FILE *f;
+    int i;
+
+    if ((argc < 5) || ((argc - 4) > HOST_MAX_CHUNK_SIZES))
+    {
+        fprintf(stderr, "Usage: %s <old image> <patch> <new image> <chunk size> ...\n", argv[0]);
+        return 2;
+    }
+    for (i = 4; i < argc; i++)
+    {
+        chunk_sizes[num_sizes] = (size_t)strtoul(argv[i], NULL, 0);
+        if (chunk_sizes[num_sizes++] == 0)
+        {
+            fprintf(stderr, "Invalid chunk size '%s'\n", argv[i]);
+            return 2;
+        }
+    }
+
+    images.source = host_read_file(argv[1], &images.source_len);
+    patch = host_read_file(argv[2], &patch_len);
+    if ((images.source == NULL) || (patch == NULL))
+    {
+        return 2;
+    }
+
+    ota_delta_init(&host_delta, host_read, host_write, &images);
+    for (i = 0; (pos < patch_len) && (result == CY_RSLT_SUCCESS); i++)
+    {
+        n = chunk_sizes[(size_t)i % num_sizes];
+        if (n > (patch_len - pos))
+        {
+            n = patch_len - pos;
+        }
+        result = ota_delta_feed(&host_delta, &patch[pos], n);
+        pos += n;
+    }
+    if (result == CY_RSLT_SUCCESS)
+    {
+        result = ota_delta_finish(&host_delta);
+    }
+    if ((result == CY_RSLT_SUCCESS) && (images.target_len != 0) && (images.last_blocks != 1u))
+    {
+        fprintf(stderr, "The last block was flagged %u times\n", (unsigned int)images.last_blocks);
+        result = CY_RSLT_TYPE_ERROR;
+    }
+
+    if (result == CY_RSLT_SUCCESS)
+    {
+        f = fopen(argv[3], "wb");
+        if ((f == NULL) || (fwrite(images.target, 1, images.target_len, f) != images.target_len))
+        {
+            fprintf(stderr, "Cannot write %s\n", argv[3]);
+            return 2;
+        }
+        fclose(f);
+    }
+
+    free((void *)images.source);
+    free(images.target);
+    free(patch);
+
+    return (result == CY_RSLT_SUCCESS) ? 0 : 1;
+}
+
+/*******************************************************************************
+ * Function Name: host_read
+ *******************************************************************************
+ * Summary:
+ *  Source read callback, reads the old image. Reads beyond it fail like reads
+ *  beyond the primary slot.
+ *
+ *******************************************************************************/
+static cy_rslt_t host_read(void *arg, uint32_t offset, void *data, size_t len)
+{
+    host_images_t *images = (host_images_t *)arg;
+
+    if ((offset > images->source_len) || (len > (images->source_len - offset)))
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    memcpy(data, &images->source[offset], len);
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: host_write
+ *******************************************************************************
+ * Summary:
+ *  Target write callback. The decoder must write the new image in order and
+ *  without gaps, as the flash service expects on the device.
+ *
+ *******************************************************************************/
+static cy_rslt_t host_write(void *arg, uint32_t offset, const void *data, size_t len, bool last)
+{
+    host_images_t *images = (host_images_t *)arg;
+    uint8_t *target;
+
+    if (offset != images->target_len)
+    {
+        fprintf(stderr, "Write at %lu, expected %lu\n", (unsigned long)offset, (unsigned long)images->target_len);
+        return CY_RSLT_TYPE_ERROR;
+    }
+
+    target = realloc(images->target, images->target_len + len);
+    if (target == NULL)
+    {
+        return CY_RSLT_TYPE_ERROR;
+    }
+    memcpy(&target[images->target_len], data, len);
+    images->target = target;
+    images->target_len += len;
+    images->last_blocks += last ? 1u : 0u;
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: host_read_file
+ *******************************************************************************
+ * Summary:
+ *  Reads a whole file into a buffer allocated with malloc().
+ *
+ *******************************************************************************/
+static uint8_t *host_read_file(const char *name, size_t *len)
+{
+    uint8_t *data = NULL;
+    FILE *f;
+    long size;
+
+    f = fopen(name, "rb");
+    if ((f != NULL) && (fseek(f, 0, SEEK_END) == 0) && ((size = ftell(f)) >= 0) && (fseek(f, 0, SEEK_SET) == 0))
+    {
+        data = malloc((size_t)size + 1u);
+        if ((data != NULL) && (fread(data, 1, (size_t)size, f) == (size_t)size))
+        {
+            *len = (size_t)size;
+        }
+        else
+        {
+            free(data);
+            data = NULL;
+        }
+    }
+    if (f != NULL)
+    {
+        fclose(f);
+    }
+    if (data == NULL)
+    {
+        fprintf(stderr, "Cannot read %s\n", name);
+    }
+
+    return data;
+}
+
+/* [] END OF FILE */
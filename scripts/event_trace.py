@@ -0,0 +1,210 @@
+"""Event trace converter
+Copyright (c) 2025 Infineon Technologies AG
+
+Converts the event trace dump of the factory app (built with EVENT_TRACE=1)
+from a captured debug UART log into a Chrome trace JSON file, which opens in
+https://ui.perfetto.dev or chrome://tracing. The timeline has one track each
+for the running task, interrupts, flash service operations, OTA agent states
+and MQTT messages.
+
+The factory app prints the dump when the update fails and on every user
+button press once the OTA task runs. Only the last complete dump of the log
+is converted.
+
+Usage:
+    python event_trace.py <uart log> [<trace json>]
+
+The trace is written to event_trace.json by default. The longest gaps between
+two received OTA chunks are printed, the first places to look for a stall.
+"""
+
+import json
+import sys
+
+LOG_PREFIX = "EVENT_TRACE "
+TRACE_FILE = "event_trace.json"
+GAPS = 5
+
+# event_trace_type_t of factory_app_cm4/source/event_trace.h
+TASK_SWITCH = 0
+ISR_ENTER = 1
+ISR_EXIT = 2
+ISR_SIGNAL = 3
+FLASH_BEGIN = 4
+FLASH_END = 5
+OTA_STATE = 6
+MQTT_PUBLISH = 7
+MQTT_RECEIVE = 8
+
+# flash_service_op_t of factory_app_cm4/source/flash_service.c
+FLASH_OPS = ["read", "write", "erase", "storage_open", "storage_read",
+             "storage_write", "storage_close", "storage_verify"]
+
+PID = 1
+CPU_TID = 1
+ISR_TID = 2
+FLASH_TID = 3
+OTA_TID = 4
+MQTT_TID = 5
+TRACKS = {CPU_TID: "CPU", ISR_TID: "Interrupts", FLASH_TID: "Flash service",
+          OTA_TID: "OTA agent state", MQTT_TID: "MQTT"}
+
+
+def read_dumps(name):
+    dumps = []
+    dump = None
+    with open(name, "r", errors="replace") as f:
+        for line in f:
+            pos = line.find(LOG_PREFIX)
+            if pos < 0:
+                continue
+            words = line[pos + len(LOG_PREFIX):].split()
+            try:
+                if words[0] == "begin":
+                    dump = {"hz": int(words[1]), "lost": int(words[3]), "events": [],
+                            "tasks": {}, "states": {}}
+                elif dump is None:
+                    continue
+                elif words[0] == "e":
+                    dump["events"].append((int(words[1], 16), int(words[2]), int(words[3]),
+                                           int(words[4]), int(words[5], 16)))
+                elif words[0] == "task":
+                    dump["tasks"][int(words[1])] = " ".join(words[2:])
+                elif words[0] == "state":
+                    dump["states"][int(words[1])] = " ".join(words[2:])
+                elif words[0] == "end":
+                    dumps.append(dump)
+                    dump = None
+            except (IndexError, ValueError):
+                # Garbled by output of another task, drop the line
+                continue
+    return dumps
+
+
+def exception_name(number):
+    if number >= 16:
+        return "IRQ %d" % (number - 16)
+    return {11: "SVCall", 14: "PendSV", 15: "SysTick"}.get(number, "exception %d" % number)
+
+
+def unwrap(events, hz):
+    """Returns the events with time stamps in us since the first event"""
+    result = []
+    time = 0
+    last = None
+    for raw, kind, ident, arg16, arg in events:
+        if last is not None:
+            time += (raw - last) & 0xFFFFFFFF
+        last = raw
+        result.append((time * 1000000.0 / hz, kind, ident, arg16, arg))
+    return result
+
+
+class Timeline:
+    def __init__(self):
+        self.events = []
+        self.open = {}
+
+    def begin(self, tid, key, name, ts, args=None):
+        self.open[(tid, key)] = (name, ts, args or {})
+
+    def end(self, tid, key, ts, args=None):
+        # The begin of the oldest slices may have been overwritten
+        if (tid, key) not in self.open:
+            return
+        name, start, begin_args = self.open.pop((tid, key))
+        begin_args.update(args or {})
+        self.events.append({"name": name, "ph": "X", "pid": PID, "tid": tid, "ts": start,
+                            "dur": ts - start, "args": begin_args})
+
+    def switch(self, tid, name, ts, args=None):
+        self.end(tid, None, ts)
+        self.begin(tid, None, name, ts, args)
+
+    def instant(self, tid, name, ts, args=None):
+        self.events.append({"name": name, "ph": "i", "s": "t", "pid": PID, "tid": tid, "ts": ts,
+                            "args": args or {}})
+
+    def close(self, ts):
+        for tid, key in list(self.open):
+            self.end(tid, key, ts)
+
+
+def convert(dump):
+    timeline = Timeline()
+    events = unwrap(dump["events"], dump["hz"])
+    receives = []
+
+    for ts, kind, ident, arg16, arg in events:
+        if kind == TASK_SWITCH:
+            timeline.switch(CPU_TID, dump["tasks"].get(arg, "task %d" % arg), ts, {"task": arg})
+        elif kind == ISR_ENTER:
+            timeline.begin(ISR_TID, arg, exception_name(arg), ts)
+        elif kind == ISR_EXIT:
+            timeline.end(ISR_TID, arg, ts)
+        elif kind == ISR_SIGNAL:
+            timeline.instant(ISR_TID, "wake from " + exception_name(arg), ts)
+        elif kind == FLASH_BEGIN:
+            name = FLASH_OPS[ident] if ident < len(FLASH_OPS) else "op %d" % ident
+            timeline.begin(FLASH_TID, None, name, ts, {"address": "0x%x" % arg, "length": arg16})
+        elif kind == FLASH_END:
+            timeline.end(FLASH_TID, None, ts, {"result": "0x%x" % arg})
+        elif kind == OTA_STATE:
+            timeline.switch(OTA_TID, dump["states"].get(ident, "state %d" % ident), ts)
+        elif kind == MQTT_PUBLISH and ident == 0:
+            timeline.begin(MQTT_TID, None, "publish", ts, {"qos": arg16, "length": arg})
+        elif kind == MQTT_PUBLISH:
+            timeline.end(MQTT_TID, None, ts, {"result": "0x%x" % arg})
+        elif kind == MQTT_RECEIVE:
+            timeline.instant(MQTT_TID, "chunk", ts, {"offset": arg, "length": arg16})
+            receives.append((ts, arg))
+
+    if events:
+        timeline.close(events[-1][0])
+
+    metadata = [{"name": "process_name", "ph": "M", "pid": PID, "args": {"name": "factory_app_cm4"}}]
+    for tid, name in sorted(TRACKS.items()):
+        metadata.append({"name": "thread_name", "ph": "M", "pid": PID, "tid": tid, "args": {"name": name}})
+        metadata.append({"name": "thread_sort_index", "ph": "M", "pid": PID, "tid": tid,
+                         "args": {"sort_index": tid}})
+
+    trace = {"traceEvents": metadata + timeline.events, "displayTimeUnit": "ms",
+             "otherData": {"lost_events": dump["lost"]}}
+    return trace, events, receives
+
+
+def print_summary(dump, events, receives):
+    duration = events[-1][0] if events else 0.0
+    print("Events       : %d over %.1f ms, %d older ones overwritten" % (len(events), duration / 1000.0,
+                                                                       dump["lost"]))
+    print("Tasks        : %s" % ", ".join(name for _, name in sorted(dump["tasks"].items())))
+    print("Chunks       : %d received" % len(receives))
+    gaps = sorted(((receives[i][0] - receives[i - 1][0], receives[i - 1]) for i in range(1, len(receives))),
+                  reverse=True)
+    for gap, (ts, offset) in gaps[:GAPS]:
+        print("  gap %8.1f ms after the chunk at offset 0x%x, %.1f ms into the trace" %
+              (gap / 1000.0, offset, ts / 1000.0))
+
+
+def main(argv):
+    if len(argv) not in (2, 3):
+        print(__doc__)
+        return 1
+
+    dumps = read_dumps(argv[1])
+    if not dumps:
+        print("No complete " + LOG_PREFIX.strip() + " dump in " + argv[1])
+        return 1
+
+    trace, events, receives = convert(dumps[-1])
+    print_summary(dumps[-1], events, receives)
+
+    name = argv[2] if len(argv) == 3 else TRACE_FILE
+    with open(name, "w") as f:
+        json.dump(trace, f)
+    print("Saved " + name)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
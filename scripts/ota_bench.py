@@ -0,0 +1,214 @@
+"""OTA throughput benchmark
+Copyright (c) 2025 Infineon Technologies AG
+
+Runs an OTA update against the local Mosquitto broker and collects the
+benchmark summary of the factory app (built with OTA_BENCH=1), or extracts it
+from a captured debug UART log, and compares results against a baseline so
+throughput regressions are caught before a release.
+
+The factory app publishes the summary of the download to
+<COMPANY_TOPIC_PREPEND>/APP_<kit>/telemetry/bench when it closes the data
+connection. The image is verified after that, so the verify time and the final
+result are only in the "OTA_BENCH {...}" line on the debug UART.
+
+Usage:
+    python ota_bench.py run     <kit> [<publisher args> ...]
+    python ota_bench.py log     <uart log> [<result>]
+    python ota_bench.py compare <baseline> <result> [<tolerance %>]
+    python ota_bench.py crypto  <baseline uart log> <uart log>
+
+run starts "mosquitto -c mosquitto.conf" and "publisher.py tls -b ml -k <kit>"
+with the extra publisher arguments, waits for one summary and writes it to
+ota_bench_result.json. Reset the device to start the update. Set
+OTA_BENCH_NO_BROKER=1 if the broker is already running.
+
+crypto compares the "CRYPTO_BENCH {...}" lines of two builds with CRYPTO_BENCH=1,
+e.g. MBEDTLS_ACCEL=0 against MBEDTLS_ACCEL=1.
+"""
+
+import json
+import os
+import ssl
+import subprocess
+import sys
+import time
+
+# Must match COMPANY_TOPIC_PREPEND in factory_app_cm4/configs/cy_ota_config.h
+COMPANY_TOPIC_PREPEND = "MyUniqueTopic"
+
+# TLS listener of mosquitto.conf and the client certificates publisher.py uses
+BROKER_ADDRESS = "localhost"
+BROKER_PORT = 8884
+CA_CERTS = "mosquitto_ca.crt"
+CERT_FILE = "mosquitto_client.crt"
+KEY_FILE = "mosquitto_client.key"
+
+LOG_PREFIX = "OTA_BENCH "
+CRYPTO_LOG_PREFIX = "CRYPTO_BENCH "
+RESULT_FILE = "ota_bench_result.json"
+TIMEOUT_S = 600
+TOLERANCE = 10.0
+
+# Compared against the baseline: higher is better for throughput, lower for times
+HIGHER_IS_BETTER = ["bytes_per_s"]
+LOWER_IS_BETTER = ["total_ms", "receive_ms", "write_ms", "verify_ms"]
+MUST_NOT_GROW = ["retries", "stalls"]
+
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+
+
+# Crypto benchmark rates are better higher, operation times lower
+CRYPTO_RATES = ["gcm_kib_s", "sha256_kib_s"]
+CRYPTO_TIMES = ["ecdh_ms", "ecdsa_sign_ms", "ecdsa_verify_ms"]
+
+
+def read_log(name, prefix=LOG_PREFIX):
+    summaries = []
+    with open(name, "r", errors="replace") as f:
+        for line in f:
+            pos = line.find(prefix)
+            if pos >= 0:
+                summaries.append(json.loads(line[pos + len(prefix):].strip()))
+    return summaries
+
+
+def compare_crypto(baseline, result):
+    print("%-16s %10s %10s %8s" % ("", "baseline", "result", "speedup"))
+    for key in ["aes", "sha256", "ecp"]:
+        print("%-16s %10s %10s" % (key, baseline[key], result[key]))
+    for key in CRYPTO_RATES:
+        speedup = float(result[key]) / baseline[key] if baseline[key] else 0.0
+        print("%-16s %10d %10d %7.2fx" % (key, baseline[key], result[key], speedup))
+    for key in CRYPTO_TIMES:
+        speedup = float(baseline[key]) / result[key] if result[key] else 0.0
+        print("%-16s %10d %10d %7.2fx" % (key, baseline[key], result[key], speedup))
+
+
+def print_summary(summary):
+    print("Result       : %s" % summary["result"])
+    print("Bytes        : %d in %d chunks" % (summary["bytes"], summary["chunks"]))
+    print("Throughput   : %d bytes/s" % summary["bytes_per_s"])
+    print("Total        : %d ms" % summary["total_ms"])
+    print("Receive      : %d ms" % summary["receive_ms"])
+    print("Write        : %d ms" % summary["write_ms"])
+    print("Verify       : %d ms" % summary["verify_ms"])
+    print("Retries      : %d" % summary["retries"])
+    print("Stalls       : %d (longest gap %d ms)" % (summary["stalls"], summary["max_gap_ms"]))
+    if "tls" in summary:
+        tls = summary["tls"]
+        print("TLS          : %d of %d handshakes resumed, full %d ms, resumed %d ms (since reset)" %
+              (tls["resumed"], tls["handshakes"], tls["full_ms"], tls["resumed_ms"]))
+    if "mqtt" in summary:
+        mqtt = summary["mqtt"]
+        print("MQTT         : %d connects, %d avoided, keep-alive %d s" %
+              (mqtt["connects"], mqtt["avoided"], mqtt["keep_alive_s"]))
+    for name, state in sorted(summary["states"].items(), key=lambda item: item[1]["at_ms"]):
+        print("  %-18s at %8d ms, %8d ms, %d times" % (name, state["at_ms"], state["ms"], state["n"]))
+
+
+def compare(baseline, result, tolerance=TOLERANCE):
+    regressions = []
+    for key in HIGHER_IS_BETTER:
+        if result[key] < baseline[key] * (1.0 - tolerance / 100.0):
+            regressions.append("%s dropped from %d to %d" % (key, baseline[key], result[key]))
+    for key in LOWER_IS_BETTER:
+        # Times of a few ms vary by a tick, only larger ones are compared
+        if baseline[key] >= 100 and result[key] > baseline[key] * (1.0 + tolerance / 100.0):
+            regressions.append("%s grew from %d to %d ms" % (key, baseline[key], result[key]))
+    for key in MUST_NOT_GROW:
+        if result[key] > baseline[key]:
+            regressions.append("%s grew from %d to %d" % (key, baseline[key], result[key]))
+    return regressions
+
+
+def wait_for_summary(kit, timeout=TIMEOUT_S):
+    import paho.mqtt.client as mqtt
+
+    topic = COMPANY_TOPIC_PREPEND + "/APP_" + kit + "/telemetry/bench"
+    summaries = []
+
+    def on_message(client, userdata, message):
+        summaries.append(json.loads(message.payload.decode()))
+
+    client = mqtt.Client("ota_bench" + str(os.getpid()))
+    client.on_message = on_message
+    client.tls_set(os.path.join(SCRIPT_DIR, CA_CERTS), os.path.join(SCRIPT_DIR, CERT_FILE),
+                   os.path.join(SCRIPT_DIR, KEY_FILE), cert_reqs=ssl.CERT_NONE)
+    client.tls_insecure_set(True)
+    client.connect(BROKER_ADDRESS, BROKER_PORT, 60)
+    client.subscribe(topic, 1)
+    print("Waiting for the summary on '" + topic + "', reset the device to start the update")
+
+    end = time.time() + timeout
+    while not summaries and time.time() < end:
+        client.loop(0.5)
+    client.disconnect()
+    return summaries[0] if summaries else None
+
+
+def run(kit, publisher_args):
+    processes = []
+    try:
+        if os.environ.get("OTA_BENCH_NO_BROKER") != "1":
+            processes.append(subprocess.Popen(["mosquitto", "-c", "mosquitto.conf"], cwd=SCRIPT_DIR))
+            time.sleep(1)
+        processes.append(subprocess.Popen([sys.executable, "publisher.py", "tls", "-b", "ml", "-k", kit] +
+                                          publisher_args, cwd=SCRIPT_DIR))
+        return wait_for_summary(kit)
+    finally:
+        for process in reversed(processes):
+            process.terminate()
+            process.wait()
+
+
+def read_file(name):
+    with open(name, "r") as f:
+        return json.load(f)
+
+
+def write_file(name, summary):
+    with open(name, "w") as f:
+        json.dump(summary, f, indent=2, sort_keys=True)
+
+
+def main(argv):
+    if len(argv) >= 3 and argv[1] == "run":
+        summary = run(argv[2], argv[3:])
+        if summary is None:
+            print("No summary received")
+            return 1
+        print_summary(summary)
+        write_file(RESULT_FILE, summary)
+        print("Saved " + RESULT_FILE)
+    elif len(argv) in (3, 4) and argv[1] == "log":
+        summaries = read_log(argv[2])
+        if not summaries:
+            print("No " + LOG_PREFIX.strip() + " line in " + argv[2])
+            return 1
+        # The last line of an update has the verify time and the result
+        print_summary(summaries[-1])
+        if len(argv) == 4:
+            write_file(argv[3], summaries[-1])
+    elif len(argv) == 4 and argv[1] == "crypto":
+        baseline = read_log(argv[2], CRYPTO_LOG_PREFIX)
+        result = read_log(argv[3], CRYPTO_LOG_PREFIX)
+        if not baseline or not result:
+            print("No " + CRYPTO_LOG_PREFIX.strip() + " line in both logs")
+            return 1
+        compare_crypto(baseline[-1], result[-1])
+    elif len(argv) in (4, 5) and argv[1] == "compare":
+        tolerance = float(argv[4]) if len(argv) == 5 else TOLERANCE
+        regressions = compare(read_file(argv[2]), read_file(argv[3]), tolerance)
+        for regression in regressions:
+            print("REGRESSION: " + regression)
+        if regressions:
+            return 1
+        print("No regression (tolerance %.1f%%)" % tolerance)
+    else:
+        print(__doc__)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
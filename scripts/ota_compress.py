@@ -0,0 +1,243 @@
+"""Compressed OTA image tool
+Copyright (c) 2025 Infineon Technologies AG
+
+Compresses OTA images for the compressed transport, decompresses them, and
+measures the compression ratio. The stream format is described in
+factory_app_cm4/source/ota_compress.h. Blocks are compressed in the LZ4 block
+format and packed into frames of the OTA chunk size, so the device can decode
+every chunk on its own, in any order.
+
+Usage:
+    python ota_compress.py compress   <image> <stream> [<frame size>]
+    python ota_compress.py decompress <stream> <image>
+    python ota_compress.py bench      <image> [<frame size>]
+"""
+
+import struct
+import sys
+import time
+import zlib
+
+MAGIC = b"OTACOMPR"
+VERSION = 1
+HEADER_FORMAT = "<8sHHI"
+HEADER_SIZE = 16
+BLOCK_HEADER_FORMAT = "<IHH"
+BLOCK_HEADER_SIZE = 8
+STORED = 0x8000
+
+# Must match OTA_COMPRESS_BLOCK_SIZE on the device
+BLOCK_SIZE = 4096
+
+# Must match the chunk size of the download, CHUNK_SIZE in publisher.py
+FRAME_SIZE = 4096
+
+# A frame is closed when less than this is left for the next block
+MIN_BLOCK = 64
+
+# LZ4 block format limits
+MIN_MATCH = 4
+LAST_LITERALS = 5
+MF_LIMIT = 12
+MAX_OFFSET = 65535
+
+
+def lz4_write_length(out, length):
+    while length >= 255:
+        out.append(255)
+        length -= 255
+    out.append(length)
+
+
+def lz4_compress(data):
+    out = bytearray()
+    table = {}
+    anchor = 0
+    pos = 0
+    limit = len(data) - MF_LIMIT
+
+    while pos < limit:
+        key = data[pos:pos + MIN_MATCH]
+        candidate = table.get(key)
+        table[key] = pos
+        if candidate is None or pos - candidate > MAX_OFFSET:
+            pos += 1
+            continue
+
+        length = MIN_MATCH
+        max_length = len(data) - LAST_LITERALS - pos
+        while length < max_length and data[candidate + length] == data[pos + length]:
+            length += 1
+
+        literals = pos - anchor
+        out.append((min(literals, 15) << 4) | min(length - MIN_MATCH, 15))
+        if literals >= 15:
+            lz4_write_length(out, literals - 15)
+        out += data[anchor:pos]
+        out += struct.pack("<H", pos - candidate)
+        if length - MIN_MATCH >= 15:
+            lz4_write_length(out, length - MIN_MATCH - 15)
+
+        pos += length
+        anchor = pos
+
+    literals = len(data) - anchor
+    out.append(min(literals, 15) << 4)
+    if literals >= 15:
+        lz4_write_length(out, literals - 15)
+    out += data[anchor:]
+    return bytes(out)
+
+
+def lz4_decompress(data):
+    out = bytearray()
+    pos = 0
+    while pos < len(data):
+        token = data[pos]
+        pos += 1
+        length = token >> 4
+        if length == 15:
+            while True:
+                extra = data[pos]
+                pos += 1
+                length += extra
+                if extra != 255:
+                    break
+        out += data[pos:pos + length]
+        pos += length
+        if pos == len(data):
+            break
+
+        (offset,) = struct.unpack_from("<H", data, pos)
+        pos += 2
+        length = token & 0x0F
+        if length == 15:
+            while True:
+                extra = data[pos]
+                pos += 1
+                length += extra
+                if extra != 255:
+                    break
+        for _ in range(length + MIN_MATCH):
+            out.append(out[-offset])
+    return bytes(out)
+
+
+def compress(image, frame_size=FRAME_SIZE):
+    frames = []
+    frame = bytearray(struct.pack(HEADER_FORMAT, MAGIC, VERSION, frame_size, len(image)))
+    pos = 0
+
+    while pos < len(image):
+        space = frame_size - len(frame) - BLOCK_HEADER_SIZE
+        raw_len = min(BLOCK_SIZE, len(image) - pos)
+        body = None
+
+        # Shrink the block until it fits the rest of the frame
+        while space >= MIN_BLOCK and raw_len > 0:
+            raw = image[pos:pos + raw_len]
+            packed = lz4_compress(raw)
+            if len(packed) < raw_len:
+                body, flags = packed, 0
+            else:
+                body, flags = raw, STORED
+            if len(body) <= space:
+                break
+            raw_len = min(raw_len - 1, raw_len * space // len(body) - 8)
+            body = None
+
+        if body is None:
+            frames.append(bytes(frame) + bytes(frame_size - len(frame)))
+            frame = bytearray()
+            continue
+
+        frame += struct.pack(BLOCK_HEADER_FORMAT, pos, len(body), raw_len | flags) + body
+        pos += raw_len
+
+    frames.append(bytes(frame))
+    return b"".join(frames)
+
+
+def decompress(stream):
+    magic, version, frame_size, raw_size = struct.unpack_from(HEADER_FORMAT, stream)
+    if magic != MAGIC or version != VERSION:
+        raise ValueError("unsupported stream header")
+
+    image = bytearray(raw_size)
+    written = 0
+    for frame_offset in range(0, len(stream), frame_size):
+        frame = stream[frame_offset:frame_offset + frame_size]
+        pos = HEADER_SIZE if frame_offset == 0 else 0
+        while pos + BLOCK_HEADER_SIZE <= len(frame):
+            raw_offset, comp_len, raw_len = struct.unpack_from(BLOCK_HEADER_FORMAT, frame, pos)
+            pos += BLOCK_HEADER_SIZE
+            if comp_len == 0:
+                break
+            body = frame[pos:pos + comp_len]
+            pos += comp_len
+            if raw_len & STORED:
+                raw = body
+            else:
+                raw = lz4_decompress(body)
+            if len(raw) != raw_len & ~STORED:
+                raise ValueError("corrupt block in frame at %d" % frame_offset)
+            image[raw_offset:raw_offset + len(raw)] = raw
+            written += len(raw)
+
+    if written != raw_size:
+        raise ValueError("image is incomplete")
+    return bytes(image)
+
+
+def read_file(name):
+    with open(name, "rb") as f:
+        return f.read()
+
+
+def write_file(name, data):
+    with open(name, "wb") as f:
+        f.write(data)
+
+
+def bench(image, frame_size=FRAME_SIZE):
+    start = time.perf_counter()
+    stream = compress(image, frame_size)
+    compress_time = time.perf_counter() - start
+
+    start = time.perf_counter()
+    result = decompress(stream)
+    decompress_time = time.perf_counter() - start
+
+    frames = (len(stream) + frame_size - 1) // frame_size
+    print("Image           : %d bytes, %d chunks" % (len(image), (len(image) + frame_size - 1) // frame_size))
+    print("Stream          : %d bytes, %d chunks (%.1f%% of the image)" %
+          (len(stream), frames, 100.0 * len(stream) / len(image)))
+    print("zlib -9         : %d bytes (whole image, for comparison)" % len(zlib.compress(image, 9)))
+    print("Compress time   : %.3f s" % compress_time)
+    print("Decompress time : %.3f s" % decompress_time)
+    print("Round trip      : %s" % ("OK" if result == image else "FAILED"))
+    return result == image
+
+
+def main(argv):
+    if len(argv) in (4, 5) and argv[1] == "compress":
+        frame_size = int(argv[4]) if len(argv) == 5 else FRAME_SIZE
+        stream = compress(read_file(argv[2]), frame_size)
+        write_file(argv[3], stream)
+        print("Created %s: %d bytes" % (argv[3], len(stream)))
+    elif len(argv) == 4 and argv[1] == "decompress":
+        image = decompress(read_file(argv[2]))
+        write_file(argv[3], image)
+        print("Created %s: %d bytes" % (argv[3], len(image)))
+    elif len(argv) in (3, 4) and argv[1] == "bench":
+        frame_size = int(argv[3]) if len(argv) == 4 else FRAME_SIZE
+        if not bench(read_file(argv[2]), frame_size):
+            return 1
+    else:
+        print(__doc__)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
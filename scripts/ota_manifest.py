@@ -0,0 +1,154 @@
+"""OTA image manifest tool
+Copyright (c) 2025 Infineon Technologies AG
+
+Creates the signed Merkle manifest of an OTA image and checks it. The manifest
+holds a SHA-256 per block of the image and the signed root of the tree built
+over them, so the device can check every chunk as it arrives. The format is
+described in factory_app_cm4/source/ota_manifest.h. The manifest is sent in
+front of the unchanged MCUboot image; the device strips it again.
+
+Signing uses the openssl command line tool and the image signing key.
+
+Usage:
+    python ota_manifest.py create <image> <stream> [<key> [<block size>]]
+    python ota_manifest.py verify <stream> [<key>]
+"""
+
+import hashlib
+import os
+import struct
+import subprocess
+import sys
+import tempfile
+
+MAGIC = b"OTAMANIF"
+VERSION = 1
+HEADER_FORMAT = "<8sHHIIIIHH32s"
+HEADER_SIZE = 64
+SIG_SIZE = 72
+SIG_LEN = 71    # Most common length of an ECDSA P-256 signature in DER format
+HASH_SIZE = 32
+
+# Must match CHUNK_SIZE in publisher.py
+BLOCK_SIZE = 4096
+
+# Key the images are signed with, SIGN_KEY_FILE in user_config.mk
+KEY_FILE = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "keys", "cypress-test-ec-p256.pem")
+
+
+def leaf_hash(block):
+    return hashlib.sha256(b"\x00" + block).digest()
+
+
+def node_hash(left, right):
+    return hashlib.sha256(b"\x01" + left + right).digest()
+
+
+def merkle_root(leaves):
+    # RFC 6962: split at the largest power of two below the number of leaves
+    if len(leaves) == 1:
+        return leaves[0]
+    split = 1
+    while split * 2 < len(leaves):
+        split *= 2
+    return node_hash(merkle_root(leaves[:split]), merkle_root(leaves[split:]))
+
+
+def openssl(args, data):
+    with tempfile.NamedTemporaryFile(delete=False) as f:
+        f.write(data)
+        name = f.name
+    try:
+        return subprocess.run(["openssl"] + args + [name], capture_output=True)
+    finally:
+        os.unlink(name)
+
+
+def sign(data, key):
+    result = openssl(["dgst", "-sha256", "-sign", key], data)
+    if result.returncode != 0:
+        raise ValueError("signing failed: " + result.stderr.decode(errors="replace"))
+    return result.stdout
+
+
+def check_signature(data, signature, key):
+    with tempfile.NamedTemporaryFile(delete=False) as f:
+        f.write(signature)
+        sig_name = f.name
+    try:
+        return openssl(["dgst", "-sha256", "-prverify", key, "-signature", sig_name], data).returncode == 0
+    finally:
+        os.unlink(sig_name)
+
+
+def create(image, key=KEY_FILE, block_size=BLOCK_SIZE):
+    leaves = [leaf_hash(image[i:i + block_size]) for i in range(0, len(image), block_size)]
+    size = HEADER_SIZE + SIG_SIZE + HASH_SIZE * len(leaves)
+    data_offset = (size + block_size - 1) // block_size * block_size
+
+    header = struct.pack(HEADER_FORMAT, MAGIC, VERSION, HEADER_SIZE, block_size, len(image),
+                         len(leaves), data_offset, SIG_LEN, 0, merkle_root(leaves))
+
+    # The signature length is part of the signed header. ECDSA signatures in
+    # DER format vary in length, so sign until one has the announced length.
+    signature = sign(header, key)
+    while len(signature) != SIG_LEN:
+        signature = sign(header, key)
+
+    manifest = header + signature + bytes(SIG_SIZE - len(signature)) + b"".join(leaves)
+    return manifest + bytes(data_offset - len(manifest)) + image
+
+
+def verify(stream, key=KEY_FILE):
+    magic, version, header_size, block_size, image_size, block_count, data_offset, sig_len, _, root = \
+        struct.unpack_from(HEADER_FORMAT, stream)
+    if magic != MAGIC or version != VERSION or header_size != HEADER_SIZE:
+        raise ValueError("unsupported manifest header")
+
+    image = stream[data_offset:]
+    if len(image) != image_size:
+        raise ValueError("image size does not match the manifest")
+
+    leaves = [stream[HEADER_SIZE + SIG_SIZE + i * HASH_SIZE:HEADER_SIZE + SIG_SIZE + (i + 1) * HASH_SIZE]
+              for i in range(block_count)]
+    if merkle_root(leaves) != root:
+        raise ValueError("block hashes do not match the root")
+    if not check_signature(stream[:HEADER_SIZE], stream[HEADER_SIZE:HEADER_SIZE + sig_len], key):
+        raise ValueError("invalid signature")
+
+    for i in range(block_count):
+        if leaf_hash(image[i * block_size:(i + 1) * block_size]) != leaves[i]:
+            raise ValueError("block %d does not match its hash" % i)
+    return image
+
+
+def read_file(name):
+    with open(name, "rb") as f:
+        return f.read()
+
+
+def write_file(name, data):
+    with open(name, "wb") as f:
+        f.write(data)
+
+
+def main(argv):
+    if len(argv) in (4, 5, 6) and argv[1] == "create":
+        key = argv[4] if len(argv) >= 5 else KEY_FILE
+        block_size = int(argv[5]) if len(argv) == 6 else BLOCK_SIZE
+        image = read_file(argv[2])
+        stream = create(image, key, block_size)
+        write_file(argv[3], stream)
+        print("Created %s: %d bytes, manifest %d bytes" % (argv[3], len(stream), len(stream) - len(image)))
+    elif len(argv) in (3, 4) and argv[1] == "verify":
+        key = argv[3] if len(argv) == 4 else KEY_FILE
+        image = verify(read_file(argv[2]), key)
+        print("Manifest OK: %d bytes image" % len(image))
+    else:
+        print(__doc__)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -1,6 +1,7 @@
 import json
 import paho.mqtt.client as mqtt
 import os
+import queue
 import random
 import signal
 import struct
@@ -8,8 +9,12 @@ import sys
 import threading
 import time
 import traceback
+import zlib
 import re
 import ssl
+import delta_patch
+import ota_compress
+import ota_manifest
 
 random.seed()
 
@@ -178,10 +183,15 @@ random.seed()
 #       "SerialNumber":"ABC213450001",
 #       "Board":"CY8CPROTO_062_4343W",
 #       "Version":"1.2.0",
+#       "UniqueTopicName": "<my unique topic>",
 #       "Offset":"0",
-#       "Length":"4096"
+#       "Size":"4096"
 #   }
 #
+#   The Device may keep several chunk requests outstanding (OTA_CHUNK_WINDOW in
+#   the factory app Makefile). All chunk requests are answered on one
+#   persistent connection, in the order they arrive.
+#
 #==============================================================================
 # Debugging help
 #   To turn on logging, Set DEBUG_LOG to 1 (or use command line arg "-l")
@@ -275,6 +285,18 @@ MQTT_KEEP_ALIVE = 60 # in seconds
 # Size of each chunk of data sent to the Device when splitting the OTA Image
 CHUNK_SIZE = (4 * 1024)
 
+# Number of chunks published without waiting for the Device's acknowledgement
+# when pushing the whole OTA Image. Set with "-w <window>" on the command line.
+PUBLISH_WINDOW = 8
+
+# Back-pressure: at most MAX_DOWNLOADS Devices download at a time, set with
+# "-c <count>" (0 for no limit). Any other Device is answered "No Update
+# Available" with a "RetryAfter" hint of RETRY_AFTER seconds ("-r <secs>").
+# A download is over once its Device sent no request for DOWNLOAD_IDLE seconds.
+MAX_DOWNLOADS = 0
+RETRY_AFTER = 60
+DOWNLOAD_IDLE = 30
+
 # OTA header information - MUST match Device structure cy_ota_mqtt_chunk_payload_header_s
 #                          defined in ota-update/source/cy_ota_mqtt.c !!
 HEADER_SIZE = 32            # Total header size in bytes
@@ -304,6 +326,7 @@ class MQTTSender(mqtt.Client):
       super(MQTTSender, self).__init__(cname,**kwargs)
       self.connected_flag=False
       self.publish_mid=-1
+      self.publish_count=0
 
 
 class MQTTPublisher(mqtt.Client):
@@ -525,25 +548,75 @@ def on_send_connect(client, userdata, flags, rc):
 # -----------------------------------------------------------
 def on_send_publish(client, userdata, mid):
     client.publish_mid = mid
+    client.publish_count += 1
+
+
+# Chunk requests waiting for send_image_chunk_thread(): (message_string, unique_topic)
+chunk_requests = queue.Queue()
+chunk_thread = None
+
+# Unique topic of every running download and the time of its last request
+downloads = {}
+downloads_lock = threading.Lock()
+
+# -----------------------------------------------------------
+#   download_seen()
+#       Records a request of a running download.
+#   unique_topic    - The unique topic of the download
+#
+#   download_refused()
+#       Checks whether a new download has to wait for a running one.
+#   unique_topic    - The unique topic of the new download
+# -----------------------------------------------------------
+def download_seen(unique_topic):
+    with downloads_lock:
+        downloads[unique_topic] = time.time()
+
+def download_refused(unique_topic):
+    now = time.time()
+    with downloads_lock:
+        for topic in [topic for topic, seen in downloads.items() if now - seen > DOWNLOAD_IDLE]:
+            del downloads[topic]
+        return (MAX_DOWNLOADS > 0) and (unique_topic not in downloads) and (len(downloads) >= MAX_DOWNLOADS)
 
+# -----------------------------------------------------------
+#   image_identity()
+#       Returns ImageSize and ImageCRC of OTA_IMAGE_FILE for the job
+#       document. They are computed once and again only when the
+#       file changes, not for every job request.
+# -----------------------------------------------------------
+image_identity_cache = {}
+image_identity_lock = threading.Lock()
+
+def image_identity():
+    stat = os.stat(OTA_IMAGE_FILE)
+    key = (OTA_IMAGE_FILE, stat.st_size, stat.st_mtime_ns)
+    with image_identity_lock:
+        if image_identity_cache.get("key") != key:
+            with open(OTA_IMAGE_FILE, 'rb') as image:
+                image_data = image.read()
+            image_identity_cache["key"] = key
+            image_identity_cache["size"] = str(len(image_data))
+            image_identity_cache["crc"] = "%08x" % (zlib.crc32(image_data) & 0xFFFFFFFF)
+        return image_identity_cache["size"], image_identity_cache["crc"]
 
 # ---------------------------------------------------------
 #   send_image_chunk_thread()
 #       This is used in a separate thread.
-#       Call do_chunking() to send one chunk to the Device.
-#   message_string  - The Initial "Update Availability" message
-#   unique_topic    - The unique topic to send the OTA Image on.
+#       Answers the chunk requests queued in chunk_requests over one
+#       persistent connection. The chunks are published without waiting
+#       for each acknowledgement, so a Device that keeps several requests
+#       outstanding receives them back to back.
 # ---------------------------------------------------------
 
-def send_image_chunk_thread(message_string, unique_topic):
+def send_image_chunk_thread():
     global terminate
 
     # Create unique MQTT ID
     client_id = SEND_IMAGE_MQTT_CLIENT_ID + str(random.randint(0, 1024*1024*1024))
     client_id = str.ljust(client_id, 24)  # limit to 24 characters
     client_id = str.rstrip(client_id)
-    if DEBUG_LOG:
-        print("Send Image chunks: MQTT Connect on topic: " + unique_topic)
+    print("Send Image chunks: MQTT Connect with id: " + client_id)
 
     # Create a new client
     send_client = MQTTSender(client_id)
@@ -552,6 +625,7 @@ def send_image_chunk_thread(message_string, unique_topic):
 
     send_client.on_connect = on_send_connect
     send_client.on_publish = on_send_publish
+    send_client.max_inflight_messages_set(max(20, 2 * PUBLISH_WINDOW))
     if TLS_ENABLED:
         if BROKER_ADDRESS == MOSQUITTO_BROKER_LOCAL_ADDRESS:
             send_client.tls_set(ca_certs, certfile, keyfile, cert_reqs=ssl.CERT_NONE)
@@ -565,37 +639,37 @@ def send_image_chunk_thread(message_string, unique_topic):
         if terminate:
             exit(0)
 
-    try:
-        time_string = time.asctime()
-        if (DEBUG_LOG):
-            print("Send Chunk Begins..." + time_string + " ")
-
-        job_dict = json.loads(message_string)
-        offset = int(job_dict["Offset"])
-        size = int(job_dict["Size"])
+    while True:
+        if terminate:
+            exit(0)
 
-        pub_mqtt_msgs,pub_total_payloads = do_chunking(OTA_IMAGE_FILE, False, offset, size)
+        try:
+            message_string, unique_topic = chunk_requests.get(timeout=0.01)
+        except queue.Empty:
+            # Handle acknowledgements and keep-alive while idle
+            send_client.loop(0.01)
+            continue
 
-        # print(" Sending Chunk  offset:" + str(offset) + " size:" + str(size) + " packet sz: " + str( len(pub_mqtt_msgs[0])) + " to: " + unique_topic)
-        result,messageID = send_client.publish(unique_topic, pub_mqtt_msgs[0], PUBLISHER_PUBLISH_QOS)
-        while send_client.publish_mid != messageID:
-            send_client.loop(0.1)
-            time.sleep(0.1)
-            if terminate:
-                exit(0)
+        try:
+            job_dict = json.loads(message_string)
+            offset = int(job_dict["Offset"])
+            size = int(job_dict["Size"])
 
-        time_string = time.asctime()
-        if (DEBUG_LOG):
-            print("Send Chunk Ends..." + time_string )
+            pub_mqtt_msgs,pub_total_payloads = do_chunking(OTA_IMAGE_FILE, False, offset, size)
+            if len(pub_mqtt_msgs) == 0:
+                print("Send Chunk: offset " + str(offset) + " is beyond the end of the OTA Image")
+                continue
 
-    except Exception as e:
-        print("Exception Occurred... Exiting...")
-        print(str(e) + os.linesep)
-        traceback.print_exc()
-        exit(0)
+            if (DEBUG_LOG):
+                print(" Sending Chunk  offset:" + str(offset) + " size:" + str(size) + " to: " + unique_topic)
+            send_client.publish(unique_topic, pub_mqtt_msgs[0], PUBLISHER_PUBLISH_QOS)
+            send_client.loop(0.001)
 
-    # we're done
-    exit(0)
+        except Exception as e:
+            print("Exception Occurred... Exiting...")
+            print(str(e) + os.linesep)
+            traceback.print_exc()
+            exit(0)
 
 
 # -----------------------------------------------------------
@@ -622,6 +696,7 @@ def send_image_thread(message_string, unique_topic):
 
     send_client.on_connect = on_send_connect
     send_client.on_publish = on_send_publish
+    send_client.max_inflight_messages_set(max(20, PUBLISH_WINDOW))
     if TLS_ENABLED:
         if BROKER_ADDRESS == MOSQUITTO_BROKER_LOCAL_ADDRESS:
             send_client.tls_set(ca_certs, certfile, keyfile, cert_reqs=ssl.CERT_NONE)
@@ -637,21 +712,27 @@ def send_image_thread(message_string, unique_topic):
 
     try:
         time_string = time.asctime()
-        print("Publishing Begins..." + time_string + " ")
+        print("Publishing Begins..." + time_string + " (window " + str(PUBLISH_WINDOW) + ")")
         pub_mqtt_msgs,pub_total_payloads = do_chunking(OTA_IMAGE_FILE, True, 0, CHUNK_SIZE)
 
         # for chunk in pub_mqtt_msgs:
         for chunk in range(0,pub_total_payloads):
             if terminate:
                 exit(0)
+            download_seen(unique_topic)
             # print(" Sending Chunk " + str(chunk)  + " of " + str(pub_total_payloads) + " to: " + unique_topic)
-            result,messageID = send_client.publish(unique_topic, pub_mqtt_msgs[chunk], PUBLISHER_PUBLISH_QOS)
-            while send_client.publish_mid != messageID:
-                send_client.loop(0.1)
-                time.sleep(0.1)
+            send_client.publish(unique_topic, pub_mqtt_msgs[chunk], PUBLISHER_PUBLISH_QOS)
+            # Keep at most PUBLISH_WINDOW chunks unacknowledged
+            while (chunk + 1 - send_client.publish_count) >= PUBLISH_WINDOW:
+                send_client.loop(0.01)
                 if terminate:
                     exit(0)
 
+        while send_client.publish_count < pub_total_payloads:
+            send_client.loop(0.01)
+            if terminate:
+                exit(0)
+
         time_string = time.asctime()
         print("Publishing Ends..." + time_string )
 
@@ -677,6 +758,7 @@ def publisher_recv_message(client, userdata, message):
     global VERSION_MAJOR
     global VERSION_MINOR
     global VERSION_BUILD
+    global chunk_thread
     # print("message received " ,str(message.payload.decode("utf-8")))
     # print("message topic=",message.topic)
     # print("message qos=",message.qos)
@@ -711,6 +793,14 @@ def publisher_recv_message(client, userdata, message):
             job_dict = json.loads(job_source)
             job_dict["Message"]=AVAILABLE_REPONSE       # use NO_AVAILABLE_REPONSE if no update available
             job_dict["UniqueTopicName"] = unique_topic
+            # Identify the image, so the device can resume an interrupted download
+            job_dict["ImageSize"], job_dict["ImageCRC"] = image_identity()
+            if download_refused(unique_topic):
+                # Ask the Device to check again later (OTA_POLL=1 honours the hint)
+                job_dict["Message"] = NO_AVAILABLE_REPONSE
+                job_dict["RetryAfter"] = str(RETRY_AFTER)
+            else:
+                download_seen(unique_topic)
             job = json.dumps(job_dict)
         except Exception as e:
             print("Exception Occurred during json parse ... Exiting...")
@@ -730,6 +820,10 @@ def publisher_recv_message(client, userdata, message):
         client.publish(unique_topic, job, PUBLISHER_PUBLISH_QOS)
         return
 
+    # Every data request keeps its download running
+    if message_type in (MSG_TYPE_SEND_UPDATE, MSG_TYPE_SEND_DIRECT, MSG_TYPE_SEND_CHUNK):
+        download_seen(unique_topic)
+
 
     # Handle incoming "Send Update" request
     if message_type == MSG_TYPE_SEND_UPDATE:
@@ -766,10 +860,13 @@ def publisher_recv_message(client, userdata, message):
 
         # print( "Publisher: Send Chunk of OTA Image on topic:" + unique_topic )
 
-        # Create a new thread to send the data. This will allow for multiple, overlapping requests.
-        print("Publisher: Start Sending CHUNK Thread")
-        send_thread = threading.Thread(None, send_image_chunk_thread, None, args=(message_string, unique_topic))
-        send_thread.start()
+        # One thread answers all chunk requests, so a window of requests does
+        # not cost one connection per chunk.
+        if chunk_thread is None:
+            print("Publisher: Start Sending CHUNK Thread")
+            chunk_thread = threading.Thread(None, send_image_chunk_thread, None)
+            chunk_thread.start()
+        chunk_requests.put((message_string, unique_topic))
         return
 
     # Handle incoming "result" notification
@@ -872,18 +969,30 @@ def publisher_loop():
 if __name__ == "__main__":
     print("################################################################################################################################")
     print("Infineon Test MQTT Publisher.")
-    print("Usage: 'python publisher.py [tls] [-l] [-b <broker>] [-k <kit>] [-f <filepath>]'")
+    print("Usage: 'python publisher.py [tls] [-l] [-b <broker>] [-k <kit>] [-f <filepath>] [-w <window>] [-p <base>] [-z] [-m] [-c <count>] [-r <secs>]'")
     print("<broker>       | [a] or [amazon] | [e] or [eclipse] | [m] or [mosquitto] | [ml] or [mosquitto_local] |")
     print("<kit>          CY8CPROTO_062S2_43439 | CY8CPROTO_062_4343W | CY8CKIT_062S2_43012 | CY8CEVAL_062S2_LAI_4373M2 | CY8CEVAL_062S2_MUR_43439M2 |")
     print("<filepath>     The location of the OTA Image file to server to the device")
+    print("<window>       Number of unacknowledged chunks when pushing the OTA Image")
+    print("<base>         Image currently on the device. Serve a delta patch from <base> to the OTA Image instead of the full image")
+    print("-z             Serve the OTA Image compressed")
+    print("-m             Serve the OTA Image with a signed manifest of its block hashes in front")
+    print("<count>        Most Devices downloading at a time, others are told to retry later (0 for no limit)")
+    print("<secs>         RetryAfter hint sent to a Device that has to wait for <count>")
     print("Defaults: <non-TLS>")
     print("        : -f " + OTA_IMAGE_FILE)
     print("        : -b mosquitto_local ")
     print("        : -k " + KIT)
+    print("        : -w " + str(PUBLISH_WINDOW))
+    print("        : -c " + str(MAX_DOWNLOADS))
+    print("        : -r " + str(RETRY_AFTER))
     print("        : -l turn on extra logging")
     print("################################################################################################################################")
     last_arg = ""
     OTA_IMAGE_FILE_NEW = None
+    OTA_BASE_FILE = None
+    OTA_COMPRESS = False
+    OTA_MANIFEST = False
 
     for i, arg in enumerate(sys.argv):
         if arg == "-h" or arg == "--help":
@@ -906,6 +1015,18 @@ if __name__ == "__main__":
                 BROKER_ADDRESS = MOSQUITTO_BROKER_LOCAL_ADDRESS
         if last_arg == "-k":
             KIT = arg
+        if last_arg == "-w":
+            PUBLISH_WINDOW = max(1, int(arg))
+        if last_arg == "-p":
+            OTA_BASE_FILE = arg
+        if arg == "-z":
+            OTA_COMPRESS = True
+        if arg == "-m":
+            OTA_MANIFEST = True
+        if last_arg == "-c":
+            MAX_DOWNLOADS = max(0, int(arg))
+        if last_arg == "-r":
+            RETRY_AFTER = max(1, int(arg))
         last_arg = arg
 
     if OTA_IMAGE_FILE_NEW == None:
@@ -913,6 +1034,27 @@ if __name__ == "__main__":
     else:
         OTA_IMAGE_FILE = OTA_IMAGE_FILE_NEW
 
+    if OTA_BASE_FILE != None:
+        # The device applies the patch against its primary slot (OTA_DELTA=1)
+        patch = delta_patch.create_patch(delta_patch.read_file(OTA_BASE_FILE), delta_patch.read_file(OTA_IMAGE_FILE))
+        delta_patch.write_file(OTA_IMAGE_FILE + ".patch", patch)
+        print("Delta patch from " + OTA_BASE_FILE + ": " + str(len(patch)) + " bytes")
+        OTA_IMAGE_FILE = OTA_IMAGE_FILE + ".patch"
+    elif OTA_COMPRESS:
+        # The device decodes the stream frame by frame (OTA_COMPRESS=1), a frame is one chunk
+        image = ota_compress.read_file(OTA_IMAGE_FILE)
+        stream = ota_compress.compress(image, CHUNK_SIZE)
+        ota_compress.write_file(OTA_IMAGE_FILE + ".lz4", stream)
+        print("Compressed image: " + str(len(stream)) + " of " + str(len(image)) + " bytes")
+        OTA_IMAGE_FILE = OTA_IMAGE_FILE + ".lz4"
+    elif OTA_MANIFEST:
+        # The device checks every chunk against the manifest (OTA_MANIFEST=1), a block is one chunk
+        image = ota_manifest.read_file(OTA_IMAGE_FILE)
+        stream = ota_manifest.create(image, ota_manifest.KEY_FILE, CHUNK_SIZE)
+        ota_manifest.write_file(OTA_IMAGE_FILE + ".manifest", stream)
+        print("Manifest: " + str(len(stream) - len(image)) + " bytes in front of the image")
+        OTA_IMAGE_FILE = OTA_IMAGE_FILE + ".manifest"
+
 print("\n")
 
 if TLS_ENABLED:
@@ -922,6 +1064,9 @@ else:
 print("   Using BROKER: " + BROKER_ADDRESS)
 print("   Using    KIT: " + KIT)
 print("   Using   File: " + OTA_IMAGE_FILE)
+if os.path.isfile(OTA_IMAGE_FILE):
+    # Job documents reuse this until the file changes
+    print("   Image  CRC32: " + image_identity()[1])
 print("   extra debug : " + DEBUG_LOG_STRING)
 
 
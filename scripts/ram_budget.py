@@ -0,0 +1,183 @@
+"""RAM budget report
+Copyright (c) 2025 Infineon Technologies AG
+
+Reads the GNU ld map file of a build and prints the RAM used by every
+component: each source file of the application, each library, and what the
+linker script reserves itself (heap, stack). Only input sections placed in a
+RAM region of the memory configuration are counted, so .data is counted once
+at its run address.
+
+Usage:
+    python ram_budget.py <map file> [<budget json>]
+
+The optional budget is a JSON object of component name to the most bytes it
+may use, for example {"source/ota_task.c": 32768, "libc_nano": 2048}. A
+component over its budget is reported and the script exits with 1.
+"""
+
+import json
+import os
+import re
+import sys
+
+# Memory regions whose name contains one of these are RAM
+RAM_REGION_NAMES = ["ram"]
+
+# Library directories of a ModusToolbox build
+LIBRARY_DIRS = ["mtb_shared", "libs"]
+
+MEMORY_CONFIG_RE = re.compile(r"^(\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)")
+OUTPUT_SECTION_RE = re.compile(r"^(\.\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)")
+INPUT_SECTION_RE = re.compile(r"^ (\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)(?:\s+(\S.*))?\s*$")
+CONTINUATION_RE = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+SECTION_NAME_RE = re.compile(r"^ (\S+)$")
+
+
+def read_ram_regions(lines):
+    regions = []
+    in_config = False
+    for line in lines:
+        if line.startswith("Memory Configuration"):
+            in_config = True
+        elif line.startswith("Linker script and memory map"):
+            break
+        elif in_config:
+            m = MEMORY_CONFIG_RE.match(line)
+            if m and any(name in m.group(1).lower() for name in RAM_REGION_NAMES):
+                regions.append((m.group(1), int(m.group(2), 16), int(m.group(3), 16)))
+    return regions
+
+
+def component(obj):
+    obj = obj.replace("\\", "/")
+    m = re.match(r"^(.*/)?([^/]+)\.a\(", obj)
+    if m:
+        # Toolchain and prebuilt libraries
+        return m.group(2)
+    parts = obj.split("/")
+    for lib_dir in LIBRARY_DIRS:
+        if lib_dir in parts:
+            index = parts.index(lib_dir)
+            if index + 1 < len(parts):
+                return parts[index + 1]
+    # Application objects keep their path below the build configuration
+    for i in range(len(parts) - 1, 0, -1):
+        if parts[i] in ("source", "configs", "bsps"):
+            return "/".join(parts[i:])[:-2] + ".c"
+    return os.path.basename(obj)
+
+
+def in_ram(regions, addr):
+    return any(origin <= addr < origin + length for _, origin, length in regions)
+
+
+def read_usage(lines, regions):
+    usage = {}
+    in_map = False
+    output = None
+    pending = None
+
+    def add(name, section, addr, size):
+        if size == 0 or not in_ram(regions, addr):
+            return
+        kind = "data" if section.startswith(".data") or section.startswith(".ramfunc") else "bss"
+        entry = usage.setdefault(name, {"data": 0, "bss": 0})
+        entry[kind] += size
+        if output is not None:
+            output["counted"] += size
+
+    def close_output():
+        # Space the linker script reserves itself, e.g. the heap and the stack
+        if output is not None and in_ram(regions, output["addr"]):
+            rest = output["size"] - output["counted"]
+            if rest > 0:
+                kind = "data" if output["name"].startswith(".data") else "bss"
+                entry = usage.setdefault("(linker) " + output["name"], {"data": 0, "bss": 0})
+                entry[kind] += rest
+
+    for line in lines:
+        line = line.rstrip("\n")
+        if not in_map:
+            in_map = line.startswith("Linker script and memory map")
+            continue
+
+        m = OUTPUT_SECTION_RE.match(line)
+        if m:
+            close_output()
+            output = {"name": m.group(1), "addr": int(m.group(2), 16), "size": int(m.group(3), 16), "counted": 0}
+            pending = None
+            continue
+
+        m = INPUT_SECTION_RE.match(line)
+        if m:
+            section, addr, size, obj = m.group(1), int(m.group(2), 16), int(m.group(3), 16), m.group(4) or ""
+            if section == "*fill*":
+                # Alignment padding, part of the section but of no component
+                if output is not None:
+                    output["counted"] += size
+            elif obj:
+                add(component(obj.strip()), section, addr, size)
+            pending = None
+            continue
+
+        m = SECTION_NAME_RE.match(line)
+        if m:
+            pending = m.group(1)
+            continue
+
+        m = CONTINUATION_RE.match(line)
+        if m and pending is not None:
+            add(component(m.group(3).strip()), pending, int(m.group(1), 16), int(m.group(2), 16))
+            pending = None
+
+    close_output()
+    return usage
+
+
+def print_report(usage, regions, budget):
+    ram_size = sum(length for _, _, length in regions)
+    total = 0
+    over = []
+
+    print("%-48s %8s %8s %8s %6s %8s" % ("component", "data", "bss", "total", "ram %", "budget"))
+    for name, entry in sorted(usage.items(), key=lambda item: -(item[1]["data"] + item[1]["bss"])):
+        size = entry["data"] + entry["bss"]
+        total += size
+        limit = budget.get(name)
+        print("%-48s %8d %8d %8d %5.1f%% %8s" % (name, entry["data"], entry["bss"], size,
+                                                 100.0 * size / ram_size if ram_size else 0.0,
+                                                 "" if limit is None else str(limit)))
+        if limit is not None and size > limit:
+            over.append("%s uses %d of %d bytes" % (name, size, limit))
+
+    print("%-48s %8s %8s %8d %5.1f%%" % ("total", "", "", total, 100.0 * total / ram_size if ram_size else 0.0))
+    for name, origin, length in regions:
+        print("RAM region %s: 0x%08x, %d bytes" % (name, origin, length))
+    for message in over:
+        print("OVER BUDGET: " + message)
+    return over
+
+
+def main(argv):
+    if len(argv) not in (2, 3):
+        print(__doc__)
+        return 1
+
+    with open(argv[1], "r", errors="replace") as f:
+        lines = f.readlines()
+    budget = {}
+    if len(argv) == 3:
+        with open(argv[2], "r") as f:
+            budget = json.load(f)
+
+    regions = read_ram_regions(lines)
+    if not regions:
+        print("No RAM region in the memory configuration of " + argv[1])
+        return 1
+
+    over = print_report(read_usage(lines, regions), regions, budget)
+    return 1 if over else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))